@@ -1,7 +1,7 @@
 #include "DeviceController.h"
 #include "SerialPortService.h"
 #include "DeviceProtocol.h"
-#include "protocol/ProtocolParser.h"
+#include "domain/MonotonicClock.h"
 
 #include <QThread>
 #include <QDateTime>
@@ -9,15 +9,48 @@
 
 #include <QDebug>
 
+namespace {
+
+// 固定命令帧和期望回应：编译期编码的静态常量，以 fromRawData 包装后发送，不分配内存也不复制
+constexpr Frame<2> kPowerOnFrame = DeviceProtocol::powerOnFrame();
+constexpr Frame<2> kPowerOffFrame = DeviceProtocol::powerOffFrame();
+constexpr Frame<2> kV4ChannelOpenFrame = DeviceProtocol::v4ChannelOpenFrame();
+constexpr Frame<1> kStartExternalMeterFrame = DeviceProtocol::externalMeterStartFrame();
+constexpr Frame<2> kStartExternalMeterAck = DeviceProtocol::externalMeterStartAckFrame();
+constexpr Frame<1> kStopExternalMeterFrame = DeviceProtocol::externalMeterStopFrame();
+constexpr Frame<2> kStopExternalMeterAck = DeviceProtocol::externalMeterStopAckFrame();
+constexpr Frame<2> kRelayPowerConfirmFrame = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::PowerConfirm);
+constexpr Frame<2> kRelayRightFrame = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::Right);
+constexpr Frame<2> kRelaySw3Frame = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::Sw3);
+constexpr Frame<2> kRelaySw4Frame = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::Sw4);
+constexpr Frame<2> kRelaySw5Frame = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::Sw5);
+constexpr Frame<2> kRelaySw6Frame = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::Sw6);
+constexpr Frame<2> kIapJumpFrame = DeviceProtocol::iapJumpFrame();
+
+} // namespace
+
 DeviceController::DeviceController(SerialPortService *serialService, QObject *parent)
     : QObject(parent)
     , m_serialService(serialService)
     , m_isConnected(false)
-    , m_pendingCommand(Command::None)
     , m_confirmationTimer(new QTimer(this))
+    , m_readNs(0)
+    , m_lastSampleNs(0)
     , m_currentRange(Measurement::Range::MilliAmp)
     , m_currentChannel(Measurement::Channel::CH1)
-    , m_retryCount(0)
+    , m_preferredFormat(DeviceProtocol::MeasurementFormat::Float)
+    , m_measurementFormat(DeviceProtocol::MeasurementFormat::Float)
+    , m_scanChannelMask(ProtocolParser::kScanAllChannels)
+    , m_lastTransactionId(0)
+    , m_pipeliningEnabled(false)
+    , m_baudRate(DeviceProtocol::kBaud)
+    , m_connectBaudRate(DeviceProtocol::kBaud)
+    , m_maxBaudRate(BaudRate::kDefault)
+    , m_targetBaudRate(DeviceProtocol::kBaud)
+    , m_baudStage(BaudStage::Idle)
+    , m_baudTimer(new QTimer(this))
+    , m_keepaliveTimer(new QTimer(this))
+    , m_resyncPending(false)
 {
     Q_ASSERT(m_serialService != nullptr);
     setupConnections();
@@ -25,6 +58,11 @@ DeviceController::DeviceController(SerialPortService *serialService, QObject *pa
     // 配置确认定时器
     m_confirmationTimer->setSingleShot(true);
     connect(m_confirmationTimer, &QTimer::timeout, this, &DeviceController::onCommandConfirmationTimeout);
+    m_baudTimer->setSingleShot(true);
+    connect(m_baudTimer, &QTimer::timeout, this, &DeviceController::onBaudNegotiationTimeout);
+    m_keepaliveTimer->setSingleShot(true);
+    connect(m_keepaliveTimer, &QTimer::timeout, this, &DeviceController::onKeepaliveTimeout);
+    m_clock.start();
 }
 
 DeviceController::~DeviceController()
@@ -42,6 +80,8 @@ void DeviceController::setupConnections()
             this, &DeviceController::onSerialError);
     connect(m_serialService, &SerialPortService::portStatusChanged,
             this, &DeviceController::onPortStatusChanged);
+    connect(m_serialService, &SerialPortService::transactionFinished,
+            this, &DeviceController::onSerialTransactionFinished);
 }
 
 bool DeviceController::connectToDevice(const QString &portName, int baudRate)
@@ -55,8 +95,19 @@ bool DeviceController::connectToDevice(const QString &portName, int baudRate)
 
     if (m_serialService->openPort(portName, baudRate)) {
         m_isConnected = true;
+        m_baudRate = baudRate;
+        m_connectBaudRate = baudRate;
+        m_resyncPending = false;
+        applyMeasurementFormat(DeviceProtocol::MeasurementFormat::Float);
         emit logMessage(tr("成功连接到串口: %1 (%2,8,N,1)").arg(portName).arg(baudRate));
         emit connectionStatusChanged(true, portName);
+        if (m_maxBaudRate > baudRate) {
+            startBaudNegotiation();
+        }
+        // 协商期间格式选择命令在队列中等待，协商结束后第一个发送
+        if (m_preferredFormat != DeviceProtocol::MeasurementFormat::Float) {
+            selectMeasurementFormat(m_preferredFormat);
+        }
         return true;
     } else {
         emit logMessage(tr("连接失败: %1").arg(portName));
@@ -69,6 +120,9 @@ void DeviceController::disconnectDevice()
     if (m_isConnected) {
         // 获取当前连接的串口名称
         QString portName = m_serialService->portName();
+        m_baudTimer->stop();
+        m_keepaliveTimer->stop();
+        m_baudStage = BaudStage::Idle;
         m_serialService->closePort();
         m_isConnected = false;
         emit logMessage(tr("已断开连接: %1").arg(portName));
@@ -93,26 +147,18 @@ bool DeviceController::powerOn()
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("开机指令：开始向从机发送开机命令..."));
 
     // 开机帧：0xC0 0x01 0x01
-    QByteArray powerOnData = DeviceProtocol::buildPowerOn();
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, powerOnData);
+    QByteArray powerOnData = kPowerOnFrame.toRawByteArray();
+
+    // 期望回应 0x01 0x01
+    QByteArray expectedResponse = powerOnData;
+
+    bool success = submitCommand(Command::PowerOn, powerOnData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("开机指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(powerOnData)));
-        
-        // 开始等待确认，期望回应 0x01 0x01
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));
-        expectedResponse.append(static_cast<char>(0x01));
-        startCommandConfirmation(Command::PowerOn, powerOnData, expectedResponse);
+        emit logMessage(tr("开机指令已提交，DATA: %1").arg(DeviceProtocol::toHex(powerOnData)));
     } else {
         emit logMessage(tr("错误：开机命令发送失败"));
     }
@@ -127,26 +173,18 @@ bool DeviceController::powerOff()
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("关机指令：开始向从机发送关机命令..."));
 
     // 关机帧：0xC0 0x01 0x00
-    QByteArray powerOffData = DeviceProtocol::buildPowerOff();
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, powerOffData);
+    QByteArray powerOffData = kPowerOffFrame.toRawByteArray();
+
+    // 期望回应 0x01 0x00
+    QByteArray expectedResponse = powerOffData;
+
+    bool success = submitCommand(Command::PowerOff, powerOffData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("关机指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(powerOffData)));
-        
-        // 开始等待确认，期望回应 0x01 0x00
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));
-        expectedResponse.append(static_cast<char>(0x00));
-        startCommandConfirmation(Command::PowerOff, powerOffData, expectedResponse);
+        emit logMessage(tr("关机指令已提交，DATA: %1").arg(DeviceProtocol::toHex(powerOffData)));
     } else {
         emit logMessage(tr("错误：关机命令发送失败"));
     }
@@ -180,12 +218,6 @@ bool DeviceController::setVoltageControl(uint8_t channelId, double v1Voltage, do
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     // 通道名称映射
     QString channelName;
     switch (channelId) {
@@ -201,19 +233,15 @@ bool DeviceController::setVoltageControl(uint8_t channelId, double v1Voltage, do
                     .arg(v2Voltage, 0, 'f', 1));
 
     // 在组帧阶段将 V1/V2 编码为单字节（BCD）
-    QByteArray voltageControlData = DeviceProtocol::buildVoltageControl(channelId, v1Voltage, v2Voltage);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, voltageControlData);
+    QByteArray voltageControlData = DeviceProtocol::voltageControlFrame(channelId, v1Voltage, v2Voltage).toByteArray();
+
+    // 期望回应完整4字节：0x02 + 通道ID + V1电压BCD + V2电压码
+    QByteArray expectedResponse = voltageControlData;
+
+    bool success = submitCommand(Command::VoltageControl, voltageControlData, expectedResponse, QString("Voltage:%1").arg(channelId));
 
     if (success) {
-        emit logMessage(tr("电压控制指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(voltageControlData)));
-        
-        // 开始等待确认，期望回应完整4字节：0x02 + 通道ID + V1电压BCD + V2电压码
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x02));                              // 命令字
-        expectedResponse.append(static_cast<char>(channelId));                         // 通道ID
-        expectedResponse.append(static_cast<char>(DeviceProtocol::encodeVoltage(v1Voltage))); // V1电压BCD
-        expectedResponse.append(static_cast<char>(DeviceProtocol::encodeVoltage(v2Voltage)));  // V2电压码
-        startCommandConfirmation(Command::VoltageControl, voltageControlData, expectedResponse);
+        emit logMessage(tr("电压控制指令已提交，DATA: %1").arg(DeviceProtocol::toHex(voltageControlData)));
     } else {
         emit logMessage(tr("错误：电压控制命令发送失败"));
     }
@@ -240,12 +268,6 @@ bool DeviceController::setV123VoltageControl(uint8_t channelId, double voltage)
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     // 通道名称映射
     QString channelName;
     switch (channelId) {
@@ -258,18 +280,15 @@ bool DeviceController::setV123VoltageControl(uint8_t channelId, double voltage)
                     .arg(channelName)
                     .arg(voltage, 0, 'f', 1));
 
-    QByteArray data = DeviceProtocol::buildV123VoltageControl(channelId, voltage);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = DeviceProtocol::v123VoltageControlFrame(channelId, voltage).toByteArray();
+
+    // 期望回应3字节：0x02 + 通道ID + 电压BCD
+    QByteArray expectedResponse = data;
+
+    bool success = submitCommand(Command::V123VoltageControl, data, expectedResponse, QString("V123Voltage:%1").arg(channelId));
 
     if (success) {
-        emit logMessage(tr("V123电压控制指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
-        
-        // 开始等待确认，期望回应3字节：0x02 + 通道ID + 电压BCD
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x02));
-        expectedResponse.append(static_cast<char>(channelId));
-        expectedResponse.append(static_cast<char>(DeviceProtocol::encodeVoltage(voltage)));
-        startCommandConfirmation(Command::V123VoltageControl, data, expectedResponse);
+        emit logMessage(tr("V123电压控制指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：V123电压控制命令发送失败"));
     }
@@ -290,27 +309,18 @@ bool DeviceController::setV4VoltageControl(double voltage)
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("V4电压控制：开始向从机发送 电压=%1V 控制命令...")
                     .arg(voltage, 0, 'f', 2));
 
-    QByteArray data = DeviceProtocol::buildV4VoltageControl(voltage);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = DeviceProtocol::v4VoltageControlFrame(voltage).toByteArray();
+
+    // 期望回应3字节：0x02 + 0x04 + V4特定指令码
+    QByteArray expectedResponse = data;
+
+    bool success = submitCommand(Command::V4VoltageControl, data, expectedResponse, QStringLiteral("V4Voltage"));
 
     if (success) {
-        emit logMessage(tr("V4电压控制指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
-        
-        // 开始等待确认，期望回应3字节：0x02 + 0x04 + V4特定指令码
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x02));
-        expectedResponse.append(static_cast<char>(0x04));
-        expectedResponse.append(static_cast<char>(DeviceProtocol::encodeV4Voltage(voltage)));
-        startCommandConfirmation(Command::V4VoltageControl, data, expectedResponse);
+        emit logMessage(tr("V4电压控制指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：V4电压控制命令发送失败"));
     }
@@ -337,12 +347,6 @@ bool DeviceController::v123StepAdjust(uint8_t v123ChannelId, uint8_t action)
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     QString channelName;
     switch (v123ChannelId) {
     case 0x01: channelName = "V1"; break;
@@ -353,17 +357,14 @@ bool DeviceController::v123StepAdjust(uint8_t v123ChannelId, uint8_t action)
     QString actionName = (action == 0x01) ? tr("UP") : tr("DOWN");
     emit logMessage(tr("V123微调：开始向从机发送 通道=%1 动作=%2 命令...").arg(channelName).arg(actionName));
 
-    QByteArray data = DeviceProtocol::buildV123StepAdjust(v123ChannelId, action);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = DeviceProtocol::v123StepAdjustFrame(v123ChannelId, action).toByteArray();
 
-    if (success) {
-        emit logMessage(tr("V123微调指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
+    QByteArray expectedResponse = data;
+
+    bool success = submitCommand(Command::StepAdjust, data, expectedResponse);
 
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x06));
-        expectedResponse.append(static_cast<char>(v123ChannelId));
-        expectedResponse.append(static_cast<char>(action));
-        startCommandConfirmation(Command::StepAdjust, data, expectedResponse);
+    if (success) {
+        emit logMessage(tr("V123微调指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：V123微调命令发送失败"));
     }
@@ -384,26 +385,17 @@ bool DeviceController::v4StepAdjust(uint8_t action)
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     QString actionName = (action == 0x01) ? tr("UP") : tr("DOWN");
     emit logMessage(tr("V4微调：开始向从机发送 通道=V4, 动作=%1 命令...").arg(actionName));
 
-    QByteArray data = DeviceProtocol::buildV4StepAdjust(action);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = DeviceProtocol::v4StepAdjustFrame(action).toByteArray();
 
-    if (success) {
-        emit logMessage(tr("V4微调指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
+    QByteArray expectedResponse = data;
 
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x06));
-        expectedResponse.append(static_cast<char>(0x04)); // V4通道ID
-        expectedResponse.append(static_cast<char>(action));
-        startCommandConfirmation(Command::StepAdjust, data, expectedResponse);
+    bool success = submitCommand(Command::StepAdjust, data, expectedResponse);
+
+    if (success) {
+        emit logMessage(tr("V4微调指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：V4微调命令发送失败"));
     }
@@ -418,11 +410,6 @@ bool DeviceController::openVoltageChannel(uint8_t v123ChannelId, uint8_t v4Chann
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     // 验证v123通道
     if (v123ChannelId != 0x01 && v123ChannelId != 0x02 && v123ChannelId != 0x03) {
         emit logMessage(tr("错误：无效的通道ID 0x%1").arg(v123ChannelId, 2, 16, QChar('0')));
@@ -444,16 +431,14 @@ bool DeviceController::openVoltageChannel(uint8_t v123ChannelId, uint8_t v4Chann
 
     emit logMessage(tr("电压输出通道开启：开始向从机发送 通道=%1 开启命令...").arg(channelName));
 
-    QByteArray data = DeviceProtocol::buildVoltageChannelOpen(v123ChannelId, v4ChannelId);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = DeviceProtocol::voltageChannelOpenFrame(v123ChannelId, v4ChannelId).toByteArray();
+
+    QByteArray expectedResponse = data;
+
+    bool success = submitCommand(Command::VoltageChannelOpen, data, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("电压输出通道开启指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x12));
-        expectedResponse.append(static_cast<char>(v123ChannelId));
-        expectedResponse.append(static_cast<char>(v4ChannelId));
-        startCommandConfirmation(Command::VoltageChannelOpen, data, expectedResponse);
+        emit logMessage(tr("电压输出通道开启指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：电压输出通道开启命令发送失败"));
     }
@@ -468,11 +453,6 @@ bool DeviceController::openV123Channel(uint8_t v123ChannelId)
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     // 验证v123通道
     if (v123ChannelId != 0x01 && v123ChannelId != 0x02 && v123ChannelId != 0x03) {
         emit logMessage(tr("错误：无效的通道ID 0x%1").arg(v123ChannelId, 2, 16, QChar('0')));
@@ -488,15 +468,14 @@ bool DeviceController::openV123Channel(uint8_t v123ChannelId)
 
     emit logMessage(tr("V123通道开启：开始向从机发送 通道=%1 开启命令...").arg(channelName));
 
-    QByteArray data = DeviceProtocol::buildV123ChannelOpen(v123ChannelId);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = DeviceProtocol::v123ChannelOpenFrame(v123ChannelId).toByteArray();
+
+    QByteArray expectedResponse = data;
+
+    bool success = submitCommand(Command::V123ChannelOpen, data, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("V123通道开启指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x12));
-        expectedResponse.append(static_cast<char>(v123ChannelId));
-        startCommandConfirmation(Command::V123ChannelOpen, data, expectedResponse);
+        emit logMessage(tr("V123通道开启指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：V123通道开启命令发送失败"));
     }
@@ -511,22 +490,16 @@ bool DeviceController::openV4Channel()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("V4通道开启：开始向从机发送 V4 开启命令..."));
 
-    QByteArray data = DeviceProtocol::buildV4ChannelOpen();
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, data);
+    QByteArray data = kV4ChannelOpenFrame.toRawByteArray();
+
+    QByteArray expectedResponse = data;
+
+    bool success = submitCommand(Command::V4ChannelOpen, data, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("V4通道开启指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(data)));
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x12));
-        expectedResponse.append(static_cast<char>(0x04));
-        startCommandConfirmation(Command::V4ChannelOpen, data, expectedResponse);
+        emit logMessage(tr("V4通道开启指令已提交，DATA: %1").arg(DeviceProtocol::toHex(data)));
     } else {
         emit logMessage(tr("错误：V4通道开启命令发送失败"));
     }
@@ -541,12 +514,6 @@ bool DeviceController::sendTestCommand(const QByteArray &testData)
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     QByteArray actualTestData = testData;
     if (actualTestData.isEmpty()) {
         // 默认测试数据
@@ -556,14 +523,13 @@ bool DeviceController::sendTestCommand(const QByteArray &testData)
 
     emit logMessage(tr("开始与从机通信测试..."));
 
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, actualTestData);
+    // 期望回应与发送数据相同（移除阻塞等待）
+    QByteArray expectedResponse = actualTestData;
+
+    bool success = submitCommand(Command::TestCommand, actualTestData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("测试命令发送成功，DATA: %1").arg(DeviceProtocol::toHex(actualTestData)));
-        
-        // 开始等待确认，期望回应与发送数据相同（移除阻塞等待）
-        QByteArray expectedResponse = actualTestData;
-        startCommandConfirmation(Command::TestCommand, actualTestData, expectedResponse);
+        emit logMessage(tr("测试命令已提交，DATA: %1").arg(DeviceProtocol::toHex(actualTestData)));
     } else {
         emit logMessage(tr("错误：测试命令发送失败"));
     }
@@ -578,12 +544,6 @@ bool DeviceController::selectDetectionChannel(uint8_t rangeCode, uint8_t channel
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     // 验证档位码
     if (rangeCode != 0x01 && rangeCode != 0x02) {
         emit logMessage(tr("错误：无效的档位码 0x%1").arg(rangeCode, 2, 16, QChar('0')));
@@ -613,21 +573,18 @@ bool DeviceController::selectDetectionChannel(uint8_t rangeCode, uint8_t channel
     emit logMessage(tr("电流检测指令：开始向从机发送%1通道/%2档位选择命令...").arg(channelName).arg(rangeName));
 
     // 清空测量缓冲区
-    m_measureDataBuffer.clear();
+    m_measureDecoder.clear();
 
     // 电流检测帧构造：0xC0 0x03 rangeCode channelCode
-    QByteArray detectionData = DeviceProtocol::buildDetection(rangeCode, channelCode);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, detectionData);
+    QByteArray detectionData = DeviceProtocol::detectionFrame(rangeCode, channelCode).toByteArray();
+
+    // 期望回应完整3字节：0x03 + rangeCode + channelCode
+    QByteArray expectedResponse = detectionData;
+
+    bool success = submitCommand(Command::DetectionSelect, detectionData, expectedResponse, QStringLiteral("DetectionSelect"));
 
     if (success) {
-        emit logMessage(tr("电流检测指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(detectionData)));
-        
-        // 开始等待确认，期望回应完整3字节：0x03 + rangeCode + channelCode
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x03));         // 命令字
-        expectedResponse.append(static_cast<char>(rangeCode));    // 档位码
-        expectedResponse.append(static_cast<char>(channelCode));  // 通道码
-        startCommandConfirmation(Command::DetectionSelect, detectionData, expectedResponse);
+        emit logMessage(tr("电流检测指令已提交，DATA: %1").arg(DeviceProtocol::toHex(detectionData)));
     } else {
         emit logMessage(tr("错误：电流检测命令发送失败"));
     }
@@ -642,31 +599,22 @@ bool DeviceController::startExternalMeterDetection()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("启动外部电流表连续检测：开始向从机发送启动命令..."));
 
     // 清空测量缓冲区，准备接收新的测量数据
-    m_measureDataBuffer.clear();
+    m_measureDecoder.clear();
 
     // 启动外部电流表连续检测帧：0xC0 0x50
-    QByteArray commandData;
-    commandData.append(static_cast<char>(0x50));
+    QByteArray commandData = kStartExternalMeterFrame.toRawByteArray();
     
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, commandData);
+    // 期望回应2字节：0x50 0xAA
+    QByteArray expectedResponse = kStartExternalMeterAck.toRawByteArray();
+
+    bool success = submitCommand(Command::StartDetection, commandData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("启动外部电流表连续检测指令发送完成，DATA: %1")
+        emit logMessage(tr("启动外部电流表连续检测指令已提交，DATA: %1")
                        .arg(DeviceProtocol::toHex(commandData)));
-
-        // 期望回应2字节：0x50 0xAA
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x50));
-        expectedResponse.append(static_cast<char>(0xAA));
-        startCommandConfirmation(Command::StartDetection, commandData, expectedResponse);
     } else {
         emit logMessage(tr("错误：启动外部电流表连续检测命令发送失败"));
     }
@@ -681,28 +629,19 @@ bool DeviceController::stopExternalMeterDetection()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("停止外部电流表连续检测：开始向从机发送停止命令..."));
 
     // 停止外部电流表连续检测帧：0xC0 0x51
-    QByteArray commandData;
-    commandData.append(static_cast<char>(0x51));
+    QByteArray commandData = kStopExternalMeterFrame.toRawByteArray();
     
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, commandData);
+    // 期望回应2字节：0x51 0x55
+    QByteArray expectedResponse = kStopExternalMeterAck.toRawByteArray();
+
+    bool success = submitCommand(Command::StopExternalMeter, commandData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("停止外部电流表连续检测指令发送完成，DATA: %1")
+        emit logMessage(tr("停止外部电流表连续检测指令已提交，DATA: %1")
                        .arg(DeviceProtocol::toHex(commandData)));
-
-        // 期望回应2字节：0x51 0x55
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x51));
-        expectedResponse.append(static_cast<char>(0x55));
-        startCommandConfirmation(Command::StopExternalMeter, commandData, expectedResponse);
     } else {
         emit logMessage(tr("错误：停止外部电流表连续检测命令发送失败"));
     }
@@ -710,41 +649,122 @@ bool DeviceController::stopExternalMeterDetection()
     return success;
 }
 
-void DeviceController::cancelPendingCommand()
+bool DeviceController::submitPrecompiledCommand(Command command,
+                                                const QByteArray &frame,
+                                                const QByteArray &expectedResponse,
+                                                const QString &coalesceKey)
 {
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("【取消确认】取消等待中的命令确认: %1").arg(static_cast<int>(m_pendingCommand)));
-        cancelCommandConfirmation();
+    if (!isConnected()) {
+        emit logMessage(tr("错误：设备未连接"));
+        return false;
+    }
+
+    if (command == Command::StartDetection) {
+        // 与 startExternalMeterDetection 一致：丢弃上一次检测残留的测量数据
+        m_measureDecoder.clear();
     }
+
+    return submitCommand(command, frame, expectedResponse, coalesceKey);
 }
 
-bool DeviceController::pressPowerConfirmKey()
+bool DeviceController::selectMeasurementFormat(DeviceProtocol::MeasurementFormat format)
 {
     if (!isConnected()) {
         emit logMessage(tr("错误：设备未连接"));
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
+    return submitFormatSelect(format, false);
+}
+
+bool DeviceController::submitFormatSelect(DeviceProtocol::MeasurementFormat format, bool first)
+{
+    QByteArray frame;
+    if (format == DeviceProtocol::MeasurementFormat::MultiChannel) {
+        if (ProtocolParser::scanFrameSize(m_scanChannelMask) < 0) {
+            emit logMessage(tr("错误：多通道位图无效 0x%1").arg(m_scanChannelMask, 2, 16, QChar('0')));
+            return false;
+        }
+        frame = DeviceProtocol::multiChannelFormatFrame(m_scanChannelMask).toByteArray();
+    } else {
+        frame = DeviceProtocol::measurementFormatFrame(format).toByteArray();
+    }
+    return submitCommand(Command::SetMeasurementFormat, frame, frame,
+                         QStringLiteral("measurementFormat"), kFormatSelectTimeoutMs, first);
+}
+
+void DeviceController::applyMeasurementFormat(DeviceProtocol::MeasurementFormat format)
+{
+    const bool packed = format == DeviceProtocol::MeasurementFormat::PackedInt16 ||
+                        format == DeviceProtocol::MeasurementFormat::PackedDelta;
+    const bool scan = format == DeviceProtocol::MeasurementFormat::MultiChannel;
+    m_measurementFormat = format;
+    m_measureDecoder.setPackedFramesEnabled(packed);
+    m_measureDecoder.setScanFramesEnabled(scan);
+    m_responseMatcher.setPackedFramesEnabled(packed);
+    m_responseMatcher.setScanFramesEnabled(scan);
+}
+
+void DeviceController::cancelPendingCommand()
+{
+    if (!m_commandQueue.isEmpty()) {
+        emit logMessage(tr("【取消确认】取消等待中的命令确认: %1 等%2条")
+                        .arg(commandToString(m_commandQueue.first().command))
+                        .arg(m_commandQueue.size()));
+        cancelCommandConfirmation();
+    }
+}
+
+int DeviceController::pendingCommandCount() const
+{
+    return m_commandQueue.size();
+}
+
+void DeviceController::setPipeliningEnabled(bool enabled)
+{
+    m_pipeliningEnabled = enabled;
+    pumpCommandQueue();
+}
+
+bool DeviceController::isPipeliningEnabled() const
+{
+    return m_pipeliningEnabled;
+}
+
+const CommandLatencyStats &DeviceController::latencyStats() const
+{
+    return m_latencyStats;
+}
+
+void DeviceController::resetLatencyStats()
+{
+    m_latencyStats.reset();
+}
+
+int DeviceController::confirmationTimeoutMs()
+{
+    return kConfirmationTimeoutMs;
+}
+
+bool DeviceController::pressPowerConfirmKey()
+{
+    if (!isConnected()) {
+        emit logMessage(tr("错误：设备未连接"));
         return false;
     }
 
     emit logMessage(tr("继电器指令：开始向从机发送开机/确认键命令..."));
 
     // 继电器按键帧构造：0xC0 0x01 0x03（复用Power命令字）
-    QByteArray relayData = DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::PowerConfirm);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, relayData);
+    QByteArray relayData = kRelayPowerConfirmFrame.toRawByteArray();
+
+    // 期望回应完整2字节：0x01 + 0x03
+    QByteArray expectedResponse = relayData;
+
+    bool success = submitCommand(Command::RelayPowerConfirm, relayData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("继电器-确认键指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
-        
-        // 开始等待确认，期望回应完整2字节：0x01 + 0x03
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));  // 命令字（Power）
-        expectedResponse.append(static_cast<char>(0x03));  // 按键码
-        startCommandConfirmation(Command::RelayPowerConfirm, relayData, expectedResponse);
+        emit logMessage(tr("继电器-确认键指令已提交，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
     } else {
         emit logMessage(tr("错误：继电器-确认键命令发送失败"));
     }
@@ -759,26 +779,18 @@ bool DeviceController::pressRightKey()
         return false;
     }
 
-    // 检查是否有其他命令正在等待确认
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("继电器指令：开始向从机发送右键命令..."));
 
     // 继电器按键帧构造：0xC0 0x01 0x02（复用Power命令字）
-    QByteArray relayData = DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::Right);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, relayData);
+    QByteArray relayData = kRelayRightFrame.toRawByteArray();
+
+    // 期望回应完整2字节：0x01 + 0x02
+    QByteArray expectedResponse = relayData;
+
+    bool success = submitCommand(Command::RelayRight, relayData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("继电器-右键指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
-        
-        // 开始等待确认，期望回应完整2字节：0x01 + 0x02
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));  // 命令字（Power）
-        expectedResponse.append(static_cast<char>(0x02));  // 按键码
-        startCommandConfirmation(Command::RelayRight, relayData, expectedResponse);
+        emit logMessage(tr("继电器-右键指令已提交，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
     } else {
         emit logMessage(tr("错误：继电器-右键命令发送失败"));
     }
@@ -793,23 +805,16 @@ bool DeviceController::pressSw3Key()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("继电器指令：开始向从机发送SW3键命令..."));
 
-    QByteArray relayData = DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::Sw3);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, relayData);
+    QByteArray relayData = kRelaySw3Frame.toRawByteArray();
+
+    QByteArray expectedResponse = relayData;
+
+    bool success = submitCommand(Command::RelaySw3, relayData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("继电器-SW3键指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
-        
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));  // 命令字
-        expectedResponse.append(static_cast<char>(0x31));  // SW3按键码
-        startCommandConfirmation(Command::RelaySw3, relayData, expectedResponse);
+        emit logMessage(tr("继电器-SW3键指令已提交，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
     } else {
         emit logMessage(tr("错误：继电器-SW3键命令发送失败"));
     }
@@ -824,23 +829,16 @@ bool DeviceController::pressSw4Key()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("继电器指令：开始向从机发送SW4键命令..."));
 
-    QByteArray relayData = DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::Sw4);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, relayData);
+    QByteArray relayData = kRelaySw4Frame.toRawByteArray();
+
+    QByteArray expectedResponse = relayData;
+
+    bool success = submitCommand(Command::RelaySw4, relayData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("继电器-SW4键指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
-        
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));  // 命令字
-        expectedResponse.append(static_cast<char>(0x41));  // SW4按键码
-        startCommandConfirmation(Command::RelaySw4, relayData, expectedResponse);
+        emit logMessage(tr("继电器-SW4键指令已提交，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
     } else {
         emit logMessage(tr("错误：继电器-SW4键命令发送失败"));
     }
@@ -855,23 +853,16 @@ bool DeviceController::pressSw5Key()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("继电器指令：开始向从机发送SW5键命令..."));
 
-    QByteArray relayData = DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::Sw5);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, relayData);
+    QByteArray relayData = kRelaySw5Frame.toRawByteArray();
+
+    QByteArray expectedResponse = relayData;
+
+    bool success = submitCommand(Command::RelaySw5, relayData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("继电器-SW5键指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
-        
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));  // 命令字
-        expectedResponse.append(static_cast<char>(0x51));  // SW5按键码
-        startCommandConfirmation(Command::RelaySw5, relayData, expectedResponse);
+        emit logMessage(tr("继电器-SW5键指令已提交，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
     } else {
         emit logMessage(tr("错误：继电器-SW5键命令发送失败"));
     }
@@ -886,23 +877,16 @@ bool DeviceController::pressSw6Key()
         return false;
     }
 
-    if (m_pendingCommand != Command::None) {
-        emit logMessage(tr("错误：有其他命令正在等待确认，请稍后重试"));
-        return false;
-    }
-
     emit logMessage(tr("继电器指令：开始向从机发送SW6键命令..."));
 
-    QByteArray relayData = DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::Sw6);
-    bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, relayData);
+    QByteArray relayData = kRelaySw6Frame.toRawByteArray();
+
+    QByteArray expectedResponse = relayData;
+
+    bool success = submitCommand(Command::RelaySw6, relayData, expectedResponse);
 
     if (success) {
-        emit logMessage(tr("继电器-SW6键指令发送完成，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
-        
-        QByteArray expectedResponse;
-        expectedResponse.append(static_cast<char>(0x01));  // 命令字
-        expectedResponse.append(static_cast<char>(0x61));  // SW6按键码
-        startCommandConfirmation(Command::RelaySw6, relayData, expectedResponse);
+        emit logMessage(tr("继电器-SW6键指令已提交，DATA: %1").arg(DeviceProtocol::toHex(relayData)));
     } else {
         emit logMessage(tr("错误：继电器-SW6键命令发送失败"));
     }
@@ -918,12 +902,12 @@ bool DeviceController::sendIapJumpCommand()
     }
 
     // IAP跳转指令不需要等待确认（设备会复位）
-    // 因此不检查 m_pendingCommand 状态
+    // 因此不经过命令队列，直接发送
 
     emit logMessage(tr("IAP升级指令：开始向从机发送跳转到Bootloader命令..."));
 
     // 构造IAP跳转指令：0x99 0xAA
-    QByteArray iapData = DeviceProtocol::buildIapJump();
+    QByteArray iapData = kIapJumpFrame.toRawByteArray();
     bool success = sendAddressAndData(DeviceProtocol::kSlaveAddress, iapData);
 
     if (success) {
@@ -942,16 +926,15 @@ bool DeviceController::sendAddressAndData(uint8_t slaveAddress, const QByteArray
         return false;
     }
 
-    // 发送地址帧
-    if (!m_serialService->writeAddressByte(slaveAddress, DeviceProtocol::kWriteTimeoutMs)) {
-        return false;
-    }
-
-    // 发送数据帧
-    if (!m_serialService->writeData(data, DeviceProtocol::kWriteTimeoutMs)) {
+    // 提交地址帧+数据帧写事务，由串口I/O线程异步发送，写入结果通过 onSerialTransactionFinished 返回
+    quint64 transactionId = m_serialService->submitTransaction(slaveAddress, data, DeviceProtocol::kWriteTimeoutMs);
+    if (transactionId == 0) {
         return false;
     }
 
+    m_lastTransactionId = transactionId;
+    // 任何发送都使设备重新计算空闲时间
+    m_keepaliveTimer->start(BaudRate::kKeepaliveMs);
     return true;
 }
 
@@ -961,7 +944,7 @@ bool DeviceController::isValidVoltage(double voltage) const
     return voltage == 0.0 || (voltage >= 1.60 && voltage <= 10.80);
 }
 
-void DeviceController::onSerialDataReceived(const QByteArray &data)
+void DeviceController::onSerialDataReceived(const QByteArray &data, qint64 readNs)
 {
     // ===== 正常处理流程 =====
 #ifdef QT_DEBUG
@@ -969,121 +952,137 @@ void DeviceController::onSerialDataReceived(const QByteArray &data)
     emit logMessage(tr("收到从机回传: %1").arg(DeviceProtocol::toHex(data)));
 #endif
 
-    // 如果正在等待控制帧确认，有控制指令还未处理完，优先处理控制帧
-    // m_pendingCommand在DeviceController::startCommandConfirmation中被设置
-    if (m_pendingCommand != Command::None) {
-        m_receivedBuffer.append(data);
-        
-        // ===== 通用确认帧处理（其他命令） =====
-        // 立即检查是否有匹配的控制帧回应m_expectedResponse，缓冲区中可能混有测量的电流帧
-        if (ProtocolParser::checkResponseMatch(m_receivedBuffer, m_expectedResponse)) {
-
-            // 使用逐字节 uint8_t 比较查找匹配位置 
-            // QByteArray::indexOf 对 0xAA 等高字节值存在符号问题
-            int matchPos = -1;
-
-            // 单字节控制帧：逐字节查找
-            if (m_expectedResponse.size() == 1) {
-                uint8_t expectedByte = static_cast<uint8_t>(m_expectedResponse[0]);
-                for (int i = 0; i < m_receivedBuffer.size(); i++) {
-                    if (static_cast<uint8_t>(m_receivedBuffer[i]) == expectedByte) {
-                        matchPos = i;
-                        break;
-                    }
-                }
-
-            // 多字节控制帧：逐字节搜索
-            } else {
-                for (int i = 0; i <= m_receivedBuffer.size() - m_expectedResponse.size(); i++) {
-                    bool match = true;
-                    for (int j = 0; j < m_expectedResponse.size(); j++) {
-                        if (static_cast<uint8_t>(m_receivedBuffer[i + j]) != 
-                            static_cast<uint8_t>(m_expectedResponse[j])) {
-                            match = false;
-                            break;
-                        }
-                    }
-                    if (match) {
-                        matchPos = i;
-                        break;
-                    }
-                }
-            }
-            
-            // 提取匹配的控制帧
-            if (matchPos >= 0) {
-
-                // 提取子串（匹配的控制帧）
-                QByteArray matchedResponse = m_receivedBuffer.mid(matchPos, m_expectedResponse.size());
-                
-                // 保留控制帧之后的剩余数据，包含外部电流表测量帧
-                int afterMatchPos = matchPos + m_expectedResponse.size();
-                QByteArray remainingData;
-
-                // 检查是否有剩余数据（未超过缓冲区末尾）
-                if (afterMatchPos < m_receivedBuffer.size()) {
-
-                    // 存在剩余数据（电流测量帧）
-                    remainingData = m_receivedBuffer.mid(afterMatchPos);
-                }
-                
-                // 清空接收缓冲区（控制帧已处理）
-                m_receivedBuffer.clear();
-                
-                // 处理控制帧确认
-                handleCommandConfirmationSuccess(matchedResponse);
-                
-                // 将剩余数据加入测量缓冲区，继续解析外部电流表数据
-                if (!remainingData.isEmpty()) {
-                    m_measureDataBuffer.append(remainingData);
-                    
-                    // 解析外部电流表测量帧（带0x50帧头 + 4字节float）
-                    float externalValue = 0.0f;
-                    while (ProtocolParser::parseExternalMeasurementWithHeader(m_measureDataBuffer, externalValue)) {
-#ifdef QT_DEBUG
-                        emit logMessage(tr("收到外部电流表测量值: %1 mA").arg(externalValue, 0, 'f', 4));
-#endif
-                        emit externalMeasurementReceived(externalValue);
-                    }
-                }
-                
-                return; // 提前返回
+    // 波特率协商期间没有在途命令，也没有测量帧
+    if (m_baudStage != BaudStage::Idle) {
+        handleBaudNegotiationData(data);
+        return;
+    }
+
+    // 样本到达时刻以本块数据的读取时刻为基准推算
+    m_readNs = readNs;
+
+    // 没有在途命令：只有连续测量帧，直接交给测量帧解码器
+    if (inFlightCount() == 0) {
+        // 上次等待确认时残留的未完成帧（如命令已超时）接在本块数据之前，保证字节流不断档
+        if (m_responseMatcher.hasPendingBytes()) {
+            QByteArray rest = m_responseMatcher.takeRemaining();
+            rest.append(data);
+            decodeMeasurementFrames(rest);
+        } else {
+            decodeMeasurementFrames(data);
+        }
+        return;
+    }
+
+    // ===== 等待确认期间：确认帧与测量帧由状态机匹配器一次遍历识别 =====
+    // 流水线模式下可能有多条在途命令，按回应在字节流中出现的先后逐个确认
+    m_decodedValues.clear();
+    m_decodedChannels.clear();
+    m_decodedTrailingBytes.clear();
+    m_responseMatcher.feed(data);
+
+    QByteArray expected[kMaxInFlightCommands];
+    int queueIndex[kMaxInFlightCommands];
+    ResponseMatcher::Event event;
+
+    while (true) {
+        // 每次确认后在途命令都可能变化（确认信号的接收方可能提交新命令），因此每轮重新收集
+        int count = 0;
+        for (int i = 0; i < m_commandQueue.size() && count < kMaxInFlightCommands; ++i) {
+            if (m_commandQueue.at(i).sent) {
+                expected[count] = m_commandQueue.at(i).expectedResponse;
+                queueIndex[count] = i;
+                ++count;
             }
         }
-        
-        // 缓冲区清理逻辑优化
-        if (m_receivedBuffer.size() > 100) {
-            int lastPossibleStart = -1;
-            for (int i = m_receivedBuffer.size() - 1; i >= 0; i--) {
-                uint8_t byte = static_cast<uint8_t>(m_receivedBuffer[i]);
-                if (byte == 0x01 || byte == 0x02 || byte == 0x03 || 
-                    byte == 0x04 || byte == 0x12 || byte == 0x50) {
-                    lastPossibleStart = i;
-                    break;
-                }
+
+        if (count == 0) {
+            // 所有命令已确认：剩余数据交给测量帧解码器
+            if (m_responseMatcher.hasPendingBytes()) {
+                m_measureDecoder.feed(m_responseMatcher.takeRemaining(), m_decodedValues, &m_decodedChannels,
+                                      &m_decodedTrailingBytes);
+                checkFormatRevert();
             }
-            
-            if (lastPossibleStart > 0) {
-                m_receivedBuffer = m_receivedBuffer.mid(lastPossibleStart);
-            } else {
-                m_receivedBuffer.clear();
+            break;
+        }
+
+        if (!m_responseMatcher.next(expected, count, event)) {
+            break;  // 本块数据已处理完，未完成的帧保留到下一块
+        }
+
+        if (event.type == ResponseMatcher::Event::Measurement) {
+            m_decodedValues.append(event.value);
+            m_decodedChannels.append(0);
+            m_decodedTrailingBytes.append(m_responseMatcher.unscannedBytes());
+            continue;
+        }
+        if (event.type == ResponseMatcher::Event::MeasurementBatch) {
+            for (int i = 0; i < event.valueCount; ++i) {
+                m_decodedValues.append(event.values[i]);
+                m_decodedChannels.append(event.channels ? event.channels[i] : 0);
+                m_decodedTrailingBytes.append(m_responseMatcher.unscannedBytes());
             }
+            continue;
         }
 
+        // 处理控制帧确认（匹配的字节即期望回应本身）
+        completeCommand(queueIndex[event.expectationIndex], true, expected[event.expectationIndex], QString());
+    }
+
+    emitMeasurementBatch();
+}
+
+void DeviceController::decodeMeasurementFrames(const QByteArray &data)
+{
+    // 解析外部电流表测量帧（带0x50帧头 + 4字节float），一次遍历解码本块数据中的所有完整帧
+    m_decodedValues.clear();
+    m_decodedChannels.clear();
+    m_decodedTrailingBytes.clear();
+    m_measureDecoder.feed(data, m_decodedValues, &m_decodedChannels, &m_decodedTrailingBytes);
+    checkFormatRevert();
+    emitMeasurementBatch();
+}
+
+void DeviceController::checkFormatRevert()
+{
+    // 本批数据已按 float 帧正确解码，只需让之后的数据不再寻找打包帧/扫描帧帧头
+    if (m_measurementFormat != DeviceProtocol::MeasurementFormat::Float &&
+        m_measureDecoder.floatFrameRun() >= kFormatRevertFrames) {
+        emit logMessage(tr("连续收到 float 测量帧：设备已退回原始格式，按 float 帧解码"));
+        applyMeasurementFormat(DeviceProtocol::MeasurementFormat::Float);
+    }
+}
+
+void DeviceController::emitMeasurementBatch()
+{
+    if (m_decodedValues.isEmpty()) {
         return;
-    }   
+    }
 
-    // ===== 非等待确认帧状态，解析外部电流表测量帧 （连续发送测量帧，带0x50帧头）=====
-    m_measureDataBuffer.append(data);
-    
-    // 解析外部电流表测量帧（带0x50帧头 + 4字节float）
-    float externalValue = 0.0f;
-    while (ProtocolParser::parseExternalMeasurementWithHeader(m_measureDataBuffer, externalValue)) {
+    // 同一次读取的样本共用一个墙钟时间戳（只换算一次），单调时间戳按帧在数据块中的位置逐个推算
+    const QDateTime timestamp = MonotonicClock::toDateTime(m_readNs, MonotonicClock::epochWallMs());
+    const qint64 byteNs = BaudRate::byteTimeNs(m_baudRate);
+    m_measurementBatch.clear();
+    m_measurementBatch.reserve(m_decodedValues.size());
+
+    for (int i = 0; i < m_decodedValues.size(); ++i) {
+        const float externalValue = m_decodedValues.at(i);
 #ifdef QT_DEBUG
         emit logMessage(tr("收到外部电流表测量值: %1 mA").arg(externalValue, 0, 'f', 4));
 #endif
-        emit externalMeasurementReceived(externalValue);
-    }
+        Measurement measurement;
+        measurement.rawValue = externalValue;
+        measurement.range = Measurement::Range::MilliAmp;  // 外部电流表直接返回mA值
+        // 多通道扫描帧自带通道码（与 Measurement::Channel 取值相同），其他帧不区分通道
+        measurement.channel = static_cast<Measurement::Channel>(m_decodedChannels.at(i));
+        measurement.timestamp = timestamp;
+        // USB 转串口的缓冲可能使推算值早于上一批样本，限制为不递减，保证记录和图表的时间轴有序
+        m_lastSampleNs = qMax(m_lastSampleNs, m_readNs - m_decodedTrailingBytes.at(i) * byteNs);
+        measurement.monotonicNs = m_lastSampleNs;
+        m_measurementBatch.append(measurement);
+    }
+
+    emit externalMeasurementsReceived(m_measurementBatch);
 }
 
 void DeviceController::onSerialError(const QString &errorString)
@@ -1091,10 +1090,30 @@ void DeviceController::onSerialError(const QString &errorString)
     emit logMessage(tr("串口错误: %1").arg(errorString));
 }
 
+void DeviceController::onSerialTransactionFinished(quint64 transactionId, bool success, const QString &errorString)
+{
+    if (success) {
+        return;
+    }
+
+    emit logMessage(tr("错误：串口写入失败: %1").arg(errorString));
+
+    // 待确认命令的数据没有写出去，无需再等待回应超时
+    for (int i = 0; i < m_commandQueue.size(); ++i) {
+        if (m_commandQueue.at(i).sent && m_commandQueue.at(i).transactionId == transactionId) {
+            completeCommand(i, false, QByteArray(), tr("串口写入失败: %1").arg(errorString));
+            break;
+        }
+    }
+}
+
 void DeviceController::onPortStatusChanged(bool isOpen)
 {
     if (!isOpen && m_isConnected) {
-        // 串口意外关闭，取消待确认命令
+        // 串口意外关闭，取消待确认命令和波特率协商
+        m_baudTimer->stop();
+        m_keepaliveTimer->stop();
+        m_baudStage = BaudStage::Idle;
         cancelCommandConfirmation();
         m_isConnected = false;
         emit logMessage(tr("串口连接意外断开"));
@@ -1104,92 +1123,439 @@ void DeviceController::onPortStatusChanged(bool isOpen)
 
 void DeviceController::onCommandConfirmationTimeout()
 {
-    QString operationName = commandToString(m_pendingCommand);
-    emit logMessage(tr("命令确认超时 - %1").arg(operationName));
-    
-    // 检查是否需要重试
-    if (m_retryCount < kMaxRetries) {
-        m_retryCount++;
-        emit logMessage(tr("正在重试命令 (%1/%2) - %3").arg(m_retryCount).arg(kMaxRetries).arg(operationName));
-        
-        // 重新发送命令
-        if (sendAddressAndData(DeviceProtocol::kSlaveAddress, m_sentData)) {
-            // 重置定时器继续等待
-            m_confirmationTimer->start(kConfirmationTimeoutMs);
-            emit logMessage(tr("重试命令已发送，等待确认..."));
+    const qint64 now = m_clock.elapsed();
+
+    // 逐个处理已到期的在途命令；确认信号的接收方可能修改队列，因此每处理一个都重新查找
+    while (true) {
+        int index = -1;
+        for (int i = 0; i < m_commandQueue.size(); ++i) {
+            const PendingCommand &pending = m_commandQueue.at(i);
+            if (pending.sent && pending.deadlineMs <= now) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) {
+            break;
+        }
+
+        PendingCommand &pending = m_commandQueue[index];
+        QString operationName = commandToString(pending.command);
+        emit logMessage(tr("命令确认超时 - %1").arg(operationName));
+        m_latencyStats.recordTimeout(pending.command);
+
+        // 检查是否需要重试
+        if (pending.retryCount < kMaxRetries) {
+            pending.retryCount++;
+            emit logMessage(tr("正在重试命令 (%1/%2) - %3").arg(pending.retryCount).arg(kMaxRetries).arg(operationName));
+
+            // 重新发送命令
+            if (sendAddressAndData(DeviceProtocol::kSlaveAddress, pending.sentData)) {
+                // 重置截止时间继续等待
+                pending.transactionId = m_lastTransactionId;
+                pending.deadlineMs = now + pending.timeoutMs;
+                pending.sentAtNs = m_clock.nsecsElapsed();
+                m_latencyStats.recordRetry(pending.command);
+                emit logMessage(tr("重试命令已发送，等待确认..."));
+            } else {
+                completeCommand(index, false, QByteArray(), tr("重试发送失败"));
+            }
         } else {
-            handleCommandConfirmationFailure(tr("重试发送失败"));
+            // 超过最大重试次数
+            completeCommand(index, false, QByteArray(), tr("超时未收到确认回应，已超过最大重试次数"));
         }
-    } else {
-        // 超过最大重试次数
-        handleCommandConfirmationFailure(tr("超时未收到确认回应，已超过最大重试次数"));
     }
+
+    armConfirmationTimer();
 }
 
-void DeviceController::startCommandConfirmation(Command command, 
-                                                const QByteArray &sentData,
-                                                const QByteArray &expectedResponse)
+bool DeviceController::submitCommand(Command command,
+                                     const QByteArray &data,
+                                     const QByteArray &expectedResponse,
+                                     const QString &coalesceKey,
+                                     int timeoutMs,
+                                     bool first)
 {
-    // 取消之前的确认等待
-    cancelCommandConfirmation();
-    
-    m_pendingCommand = command;
-    m_sentData = sentData;
-    m_expectedResponse = expectedResponse;
-    m_receivedBuffer.clear();
-    m_retryCount = 0;
-    
-    QString operationName = commandToString(command);
-    
-    // 启动超时定时器。超时时间到时释放timeout触发DeviceController::onCommandConfirmationTimeout，执行重传。
-    m_confirmationTimer->start(kConfirmationTimeoutMs);
+    // 合并冗余命令：同一合并键且尚未发送的命令直接替换为最新内容，保持原有排队位置
+    if (!coalesceKey.isEmpty()) {
+        for (PendingCommand &pending : m_commandQueue) {
+            if (!pending.sent && pending.coalesceKey == coalesceKey) {
+                emit logMessage(tr("命令合并 - %1：尚未发送的 %2 已被新命令替换")
+                                .arg(commandToString(command))
+                                .arg(DeviceProtocol::toHex(pending.sentData)));
+                pending.command = command;
+                pending.sentData = data;
+                pending.expectedResponse = expectedResponse;
+                return true;
+            }
+        }
+    }
+
+    if (m_commandQueue.size() >= kMaxQueuedCommands) {
+        emit logMessage(tr("错误：命令队列已满（%1条），请稍后重试").arg(kMaxQueuedCommands));
+        return false;
+    }
+
+    PendingCommand pending;
+    pending.command = command;
+    pending.sentData = data;
+    pending.expectedResponse = expectedResponse;
+    pending.coalesceKey = coalesceKey;
+    pending.timeoutMs = timeoutMs;
+    pending.retryCount = 0;
+    pending.sent = false;
+    pending.deadlineMs = 0;
+    pending.sentAtNs = 0;
+    pending.transactionId = 0;
+    int position = m_commandQueue.size();
+    if (first) {
+        position = 0;
+        while (position < m_commandQueue.size() && m_commandQueue.at(position).sent) {
+            ++position;
+        }
+    }
+    m_commandQueue.insert(position, pending);
 
-    // 释放信号显示在文本框中
-    emit logMessage(tr("开始等待命令确认 - %1，期望回应: %2")
-                    .arg(operationName)
-                    .arg(DeviceProtocol::toHex(m_expectedResponse)));
+    if (inFlightCount() > 0) {
+        emit logMessage(tr("命令已排队 - %1（队列中共%2条）")
+                        .arg(commandToString(command))
+                        .arg(m_commandQueue.size()));
+    }
+
+    pumpCommandQueue();
+    return true;
 }
 
-void DeviceController::cancelCommandConfirmation()
+void DeviceController::pumpCommandQueue()
 {
-    if (m_pendingCommand != Command::None) {
+    // 链路退回默认速率后，等在途命令结束再重新协商（协商期间排队命令等待）
+    if (m_resyncPending && inFlightCount() == 0) {
+        m_resyncPending = false;
+        if (m_maxBaudRate > m_baudRate) {
+            startBaudNegotiation();
+        }
+    }
+
+    // 波特率协商期间暂停发送，协商结束后继续
+    if (m_baudStage != BaudStage::Idle) {
+        return;
+    }
+
+    // 按队列顺序发送，遇到当前不能发送的命令即停止，保证命令顺序
+    for (int i = 0; i < m_commandQueue.size(); ++i) {
+        if (m_commandQueue.at(i).sent) {
+            continue;
+        }
+        if (!canSendNow(m_commandQueue.at(i))) {
+            return;
+        }
+
+        PendingCommand &pending = m_commandQueue[i];
+        if (!sendAddressAndData(DeviceProtocol::kSlaveAddress, pending.sentData)) {
+            // completeCommand 内部会继续推进队列
+            completeCommand(i, false, QByteArray(), tr("命令发送失败"));
+            return;
+        }
+
+        pending.sent = true;
+        pending.transactionId = m_lastTransactionId;
+        pending.deadlineMs = m_clock.elapsed() + pending.timeoutMs;
+        pending.sentAtNs = m_clock.nsecsElapsed();
+        m_latencyStats.recordSent(pending.command);
+
+        // 释放信号显示在文本框中（保活每秒一次，不刷日志）
+        if (pending.command != Command::LinkKeepalive) {
+            emit logMessage(tr("开始等待命令确认 - %1，DATA: %2，期望回应: %3")
+                            .arg(commandToString(pending.command))
+                            .arg(DeviceProtocol::toHex(pending.sentData))
+                            .arg(DeviceProtocol::toHex(pending.expectedResponse)));
+        }
+    }
+
+    armConfirmationTimer();
+}
+
+bool DeviceController::canSendNow(const PendingCommand &candidate) const
+{
+    if (inFlightCount() == 0) {
+        return true;
+    }
+
+    // 未开启流水线时严格一问一答
+    if (!m_pipeliningEnabled || inFlightCount() >= kMaxInFlightCommands) {
+        return false;
+    }
+
+    if (!isPipelinable(candidate.command)) {
+        return false;
+    }
+
+    // 只有回应互相可区分的命令才能背靠背发送
+    for (const PendingCommand &pending : m_commandQueue) {
+        if (!pending.sent) {
+            continue;
+        }
+        if (!isPipelinable(pending.command)) {
+            return false;
+        }
+        if (pending.expectedResponse.contains(candidate.expectedResponse) ||
+            candidate.expectedResponse.contains(pending.expectedResponse)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DeviceController::isPipelinable(Command command)
+{
+    switch (command) {
+    case Command::TestCommand:          // 回显数据由调用方指定，无法保证可区分
+    case Command::DetectionSelect:      // 切换档位/通道，需要清空测量缓冲区
+    case Command::StartDetection:       // 之后进入连续测量帧模式
+    case Command::StopExternalMeter:    // 退出连续测量帧模式
+    case Command::SetMeasurementFormat: // 之后的测量帧按新格式解码
+        return false;
+    default:
+        return true;
+    }
+}
+
+int DeviceController::inFlightCount() const
+{
+    int count = 0;
+    for (const PendingCommand &pending : m_commandQueue) {
+        if (pending.sent) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void DeviceController::armConfirmationTimer()
+{
+    // 单个定时器按最早的截止时间启动。超时时间到时释放timeout触发DeviceController::onCommandConfirmationTimeout，执行重传。
+    qint64 earliest = -1;
+    for (const PendingCommand &pending : m_commandQueue) {
+        if (pending.sent && (earliest < 0 || pending.deadlineMs < earliest)) {
+            earliest = pending.deadlineMs;
+        }
+    }
+
+    if (earliest < 0) {
         m_confirmationTimer->stop();
-        m_pendingCommand = Command::None;
-        m_sentData.clear();
-        m_expectedResponse.clear();
-        m_receivedBuffer.clear();
-        m_retryCount = 0;
+        return;
     }
+
+    qint64 remaining = qMax<qint64>(0, earliest - m_clock.elapsed());
+    m_confirmationTimer->start(static_cast<int>(remaining));
 }
 
-void DeviceController::handleCommandConfirmationSuccess(const QByteArray &responseData)
+void DeviceController::cancelCommandConfirmation()
 {
-    QString operationName = commandToString(m_pendingCommand);
-    emit logMessage(tr("命令确认成功 - %1，收到回应: %2")
-                    .arg(operationName)
-                    .arg(DeviceProtocol::toHex(responseData)));
-    
-    Command command = m_pendingCommand;
-    QByteArray sentData = m_sentData;
-    
-    // 取消确认状态
-    cancelCommandConfirmation();
-    
-    // 发射确认成功信号（使用类型安全的Command枚举）
-    emit commandConfirmed(command, true, sentData, responseData);
+    m_confirmationTimer->stop();
+    m_commandQueue.clear();
+    m_responseMatcher.reset();
 }
 
-void DeviceController::handleCommandConfirmationFailure(const QString &reason)
+void DeviceController::completeCommand(int index, bool success, const QByteArray &responseData, const QString &reason)
 {
-    QString operationName = commandToString(m_pendingCommand);
-    emit logMessage(tr("命令确认失败 - %1: %2").arg(operationName).arg(reason));
-    
-    Command command = m_pendingCommand;
-    QByteArray sentData = m_sentData;
-    
-    // 取消确认状态
-    cancelCommandConfirmation();
-    
-    // 发射确认失败信号（使用类型安全的Command枚举）
-    emit commandConfirmed(command, false, sentData, QByteArray());
+    PendingCommand pending = m_commandQueue.takeAt(index);
+    QString operationName = commandToString(pending.command);
+
+    // 延迟从最近一次发送起算，重试命令不包含之前的超时等待
+    if (success && pending.sent) {
+        m_latencyStats.recordAck(pending.command, (m_clock.nsecsElapsed() - pending.sentAtNs) / 1000);
+    } else if (!success) {
+        m_latencyStats.recordFailure(pending.command);
+    }
+
+    if (pending.command == Command::LinkKeepalive) {
+        // 内部命令不发射确认信号，避免被执行引擎当作其等待的确认
+        armConfirmationTimer();
+        if (!success) {
+            resyncLink();
+        }
+        pumpCommandQueue();
+        return;
+    }
+
+    if (success) {
+        emit logMessage(tr("命令确认成功 - %1，收到回应: %2")
+                        .arg(operationName)
+                        .arg(DeviceProtocol::toHex(responseData)));
+    } else {
+        emit logMessage(tr("命令确认失败 - %1: %2").arg(operationName).arg(reason));
+    }
+
+    if (pending.command == Command::SetMeasurementFormat && pending.sentData.size() >= 2) {
+        if (success) {
+            applyMeasurementFormat(static_cast<DeviceProtocol::MeasurementFormat>(pending.sentData.at(1)));
+            emit logMessage(tr("测量帧格式已切换为 0x%1").arg(static_cast<uint8_t>(pending.sentData.at(1)), 2, 16, QChar('0')));
+        } else {
+            emit logMessage(tr("设备不支持测量帧格式选择，保持原始 float 测量帧"));
+        }
+    }
+
+    armConfirmationTimer();
+
+    // 发射确认信号（使用类型安全的Command枚举）
+    emit commandConfirmed(pending.command, success, pending.sentData, responseData);
+
+    // 继续发送排队中的命令
+    pumpCommandQueue();
+}
+
+void DeviceController::startBaudNegotiation()
+{
+    if (!isConnected() || m_baudStage != BaudStage::Idle || inFlightCount() > 0) {
+        return;
+    }
+
+    emit logMessage(tr("波特率协商：查询设备支持的波特率（上限 %1）...").arg(m_maxBaudRate));
+    m_targetBaudRate = m_baudRate;
+    enterBaudStage(BaudStage::QueryingCaps, DeviceProtocol::baudCapsQueryFrame().toByteArray(),
+                   BaudRate::kQueryTimeoutMs);
+}
+
+void DeviceController::enterBaudStage(BaudStage stage, const QByteArray &frame, int timeoutMs)
+{
+    m_baudStage = stage;
+    m_baudRxBuffer.clear();
+    if (!frame.isEmpty() && !sendAddressAndData(DeviceProtocol::kSlaveAddress, frame)) {
+        // 写入失败：设备没有收到请求，保持当前波特率
+        finishBaudNegotiation(tr("波特率协商：发送失败，保持 %1").arg(m_baudRate));
+        return;
+    }
+    m_baudTimer->start(timeoutMs);
+}
+
+void DeviceController::handleBaudNegotiationData(const QByteArray &data)
+{
+    m_baudRxBuffer.append(data);
+    const char header = static_cast<char>(DeviceProtocol::CommandId::BaudRate);
+
+    switch (m_baudStage) {
+    case BaudStage::QueryingCaps: {
+        // 回复 [0x60, 0xFF, 位图]；只回显两字节的旧版设备等到超时后按不支持处理
+        const int pos = m_baudRxBuffer.indexOf(QByteArray(1, header) + static_cast<char>(DeviceProtocol::kBaudCapsQuery));
+        if (pos < 0 || pos + 2 >= m_baudRxBuffer.size()) {
+            return;
+        }
+        const uint8_t mask = static_cast<uint8_t>(m_baudRxBuffer.at(pos + 2));
+        m_baudTimer->stop();
+        m_targetBaudRate = BaudRate::highestCommon(mask, m_maxBaudRate);
+        if (m_targetBaudRate <= m_baudRate) {
+            finishBaudNegotiation(tr("波特率协商：无更高的共同波特率，保持 %1").arg(m_baudRate));
+            return;
+        }
+        emit logMessage(tr("波特率协商：设备能力 0x%1，切换到 %2")
+                        .arg(mask, 2, 16, QChar('0')).arg(m_targetBaudRate));
+        const uint8_t code = static_cast<uint8_t>(BaudRate::codeOf(m_targetBaudRate));
+        enterBaudStage(BaudStage::Switching, DeviceProtocol::baudSwitchFrame(code).toByteArray(),
+                       BaudRate::kQueryTimeoutMs);
+        break;
+    }
+    case BaudStage::Switching: {
+        const uint8_t code = static_cast<uint8_t>(BaudRate::codeOf(m_targetBaudRate));
+        if (!m_baudRxBuffer.contains(DeviceProtocol::baudSwitchFrame(code).toByteArray())) {
+            return;
+        }
+        m_baudTimer->stop();
+        // 设备确认后已切换；本端切换失败时等待设备超时退回
+        if (!m_serialService->setBaudRate(m_targetBaudRate)) {
+            emit logMessage(tr("波特率协商：本机串口不支持 %1，等待设备退回").arg(m_targetBaudRate));
+            enterBaudStage(BaudStage::Reverting, QByteArray(), BaudRate::kRevertMs + BaudRate::kQueryTimeoutMs);
+            return;
+        }
+        enterBaudStage(BaudStage::Settling, QByteArray(), BaudRate::kSettleMs);
+        break;
+    }
+    case BaudStage::Verifying:
+        if (!m_baudRxBuffer.contains(DeviceProtocol::baudProbeFrame().toByteArray())) {
+            return;
+        }
+        m_baudTimer->stop();
+        m_baudRate = m_targetBaudRate;
+        finishBaudNegotiation(tr("波特率协商：已切换到 %1 并验证通过").arg(m_baudRate));
+        break;
+    case BaudStage::Settling:
+    case BaudStage::Reverting:
+    case BaudStage::Idle:
+        // 切换过程中的数据（含速率不匹配产生的乱码）丢弃
+        m_baudRxBuffer.clear();
+        break;
+    }
+}
+
+void DeviceController::onBaudNegotiationTimeout()
+{
+    switch (m_baudStage) {
+    case BaudStage::QueryingCaps:
+        finishBaudNegotiation(tr("波特率协商：设备不支持，保持 %1").arg(m_baudRate));
+        break;
+    case BaudStage::Switching:
+        // 确认丢失时无法判断设备是否已切换，等待设备超时退回
+        emit logMessage(tr("波特率协商：切换请求未确认，等待设备退回 %1").arg(m_baudRate));
+        enterBaudStage(BaudStage::Reverting, QByteArray(), BaudRate::kRevertMs + BaudRate::kQueryTimeoutMs);
+        break;
+    case BaudStage::Settling:
+        enterBaudStage(BaudStage::Verifying, DeviceProtocol::baudProbeFrame().toByteArray(),
+                       BaudRate::kQueryTimeoutMs);
+        break;
+    case BaudStage::Verifying:
+        // 新速率下通信失败：本端退回原速率，设备未收到有效探测帧也会自行退回
+        emit logMessage(tr("波特率协商：%1 验证失败，回退到 %2").arg(m_targetBaudRate).arg(m_baudRate));
+        m_serialService->setBaudRate(m_baudRate);
+        enterBaudStage(BaudStage::Reverting, QByteArray(), BaudRate::kRevertMs + BaudRate::kQueryTimeoutMs);
+        break;
+    case BaudStage::Reverting:
+        finishBaudNegotiation(tr("波特率协商：已回退到 %1").arg(m_baudRate));
+        break;
+    case BaudStage::Idle:
+        break;
+    }
+}
+
+void DeviceController::finishBaudNegotiation(const QString &message)
+{
+    m_baudTimer->stop();
+    m_baudStage = BaudStage::Idle;
+    m_baudRxBuffer.clear();
+    emit logMessage(message);
+    emit baudRateNegotiated(m_baudRate, m_baudRate > DeviceProtocol::kBaud);
+
+    // 继续发送协商期间排队的命令
+    pumpCommandQueue();
+}
+
+bool DeviceController::needsKeepalive() const
+{
+    return m_baudRate != m_connectBaudRate ||
+           m_measurementFormat != DeviceProtocol::MeasurementFormat::Float;
+}
+
+void DeviceController::onKeepaliveTimeout()
+{
+    if (!isConnected() || m_baudStage != BaudStage::Idle || !needsKeepalive()) {
+        return;
+    }
+
+    // 探测帧在任何速率下都有回显；合并键保证队列中最多一条
+    const QByteArray probe = DeviceProtocol::baudProbeFrame().toByteArray();
+    submitCommand(Command::LinkKeepalive, probe, probe, QStringLiteral("linkKeepalive"), BaudRate::kQueryTimeoutMs);
+}
+
+void DeviceController::resyncLink()
+{
+    emit logMessage(tr("链路保活无回应：设备已退回 %1 和 float 测量帧，本端同步退回后重新协商").arg(m_connectBaudRate));
+    m_serialService->setBaudRate(m_connectBaudRate);
+    m_baudRate = m_connectBaudRate;
+    applyMeasurementFormat(DeviceProtocol::MeasurementFormat::Float);
+    m_resyncPending = true;
+
+    // 与连接时相同：格式选择在协商之后、其他排队命令之前发送
+    if (m_preferredFormat != DeviceProtocol::MeasurementFormat::Float) {
+        submitFormatSelect(m_preferredFormat, true);
+    }
 }
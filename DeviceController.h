@@ -5,8 +5,15 @@
 #include <QString>
 #include <QByteArray>
 #include <QTimer>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
 #include "domain/Command.h"
 #include "domain/Measurement.h"
+#include "domain/CommandLatencyStats.h"
+#include "DeviceProtocol.h"
+#include "protocol/MeasurementFrameDecoder.h"
+#include "protocol/ResponseMatcher.h"
 
 class SerialPortService;
 
@@ -16,7 +23,10 @@ class SerialPortService;
  * 职责：
  * - 提供高级设备操作接口（开机、设置电压、测试通信等）
  * - 封装"地址+数据"的发送序列
+ * - 命令队列：按顺序发送、逐条匹配回应、合并冗余命令，可选流水线发送
  * - 统一超时和错误处理策略
+ * - 连接后与设备协商更高的波特率（查询能力 → 切换 → 探测验证，失败自动回退）
+ * - 连接后选择测量帧格式（打包帧每样本1~2字节并带CRC，设备不支持时保持原始 float 帧）
  * - 通过信号向UI层报告操作结果和日志
  */
 class DeviceController : public QObject
@@ -41,9 +51,66 @@ public:
      * @param portName 串口名称
      * @param baudRate 波特率，默认9600
      * @return 是否连接成功
+     *
+     * 连接成功后，若 maxBaudRate() 高于 baudRate，自动开始波特率协商；
+     * 协商期间提交的命令排队等待，协商结束后按原顺序发送。
+     * 协商到更高速率后，链路空闲 BaudRate::kKeepaliveMs 即发送探测帧保活，避免设备空闲退回默认速率；
+     * 探测帧无回应时本端退回默认速率并重新协商。
      */
     bool connectToDevice(const QString &portName, int baudRate = 9600);
 
+    /**
+     * @brief 设置连接后协商的最高波特率（不高于连接波特率时不协商）
+     * @param baudRate 最高波特率，默认 BaudRate::kDefault（不协商：旧版固件不认识协商帧）
+     */
+    void setMaxBaudRate(int baudRate) { m_maxBaudRate = baudRate; }
+    int maxBaudRate() const { return m_maxBaudRate; }
+
+    /**
+     * @brief 当前链路波特率（协商成功后为协商结果）
+     */
+    int currentBaudRate() const { return m_baudRate; }
+
+    /**
+     * @brief 是否正在协商波特率
+     */
+    bool isNegotiatingBaudRate() const { return m_baudStage != BaudStage::Idle; }
+
+    /**
+     * @brief 设置连接后选择的测量帧格式（默认 Float，即不发送格式选择命令）
+     *
+     * 格式选择命令在波特率协商之后、其他命令之前发送；设备不确认时保持 Float。
+     * 非 Float 格式下链路空闲同样保活；保活无回应（设备已复位）时重新选择，
+     * 连续收到 float 帧（设备已退回 Float）时解码随之退回 Float。
+     */
+    void setPreferredMeasurementFormat(DeviceProtocol::MeasurementFormat format) { m_preferredFormat = format; }
+    DeviceProtocol::MeasurementFormat preferredMeasurementFormat() const { return m_preferredFormat; }
+
+    /**
+     * @brief 设备已确认的测量帧格式
+     */
+    DeviceProtocol::MeasurementFormat measurementFormat() const { return m_measurementFormat; }
+
+    /**
+     * @brief 请求设备切换测量帧格式（应在开始检测前调用）
+     * @param format 测量帧格式
+     * @return 是否成功加入队列
+     */
+    bool selectMeasurementFormat(DeviceProtocol::MeasurementFormat format);
+
+    /**
+     * @brief 设置 MultiChannel 格式扫描的通道位图（bit0~bit3 = CH1~CH4，默认全部通道）
+     *
+     * 在选择 MultiChannel 格式时随格式选择命令发送，之后修改需重新选择格式才生效。
+     */
+    void setScanChannelMask(uint8_t mask) { m_scanChannelMask = mask; }
+    uint8_t scanChannelMask() const { return m_scanChannelMask; }
+
+    /**
+     * @brief CRC 校验失败而丢弃的打包测量帧数
+     */
+    qint64 measurementCrcErrors() const { return m_measureDecoder.crcErrors(); }
+
     /**
      * @brief 断开设备连接
      */
@@ -155,13 +222,62 @@ public:
     bool stopExternalMeterDetection();
 
     /**
+     * @brief 提交预编码的命令（测试计划编译器生成，参数已在编译时校验）
+     * @param command 命令类型
+     * @param frame 已编码的命令帧
+     * @param expectedResponse 期望的回应
+     * @param coalesceKey 合并键，为空表示不合并
+     * @return 是否成功加入队列
+     *
+     * 不重新组帧、不重复参数校验，仅保留命令本身的副作用（如启动检测前清空测量缓冲区）。
+     */
+    bool submitPrecompiledCommand(Command command,
+                                  const QByteArray &frame,
+                                  const QByteArray &expectedResponse,
+                                  const QString &coalesceKey = QString());
 
-     * @brief 取消当前正在等待的命令确认
+    /**
+     * @brief 取消所有正在等待确认和排队中的命令
      * 
-     * 用于紧急暂停等场景，强制取消当前等待的命令确认状态
+     * 用于紧急暂停等场景，强制清空命令队列（被取消的命令不发射 commandConfirmed）
      */
     void cancelPendingCommand();
 
+    /**
+     * @brief 获取命令队列中的命令数（包括在途和排队中的命令）
+     * @return 命令数
+     */
+    int pendingCommandCount() const;
+
+    /**
+     * @brief 启用/禁用流水线发送
+     * @param enabled 是否启用
+     *
+     * 启用后，回应可互相区分的命令无需等待前一条确认即可背靠背发送（最多 kMaxInFlightCommands 条）；
+     * 禁用时（默认）严格一问一答，命令在队列中排队依次发送。
+     */
+    void setPipeliningEnabled(bool enabled);
+
+    /**
+     * @brief 是否启用了流水线发送
+     */
+    bool isPipeliningEnabled() const;
+
+    /**
+     * @brief 各命令的确认延迟统计（发送、确认、超时、重试、失败次数与延迟直方图）
+     */
+    const CommandLatencyStats &latencyStats() const;
+
+    /**
+     * @brief 清空确认延迟统计
+     */
+    void resetLatencyStats();
+
+    /**
+     * @brief 命令确认超时时间（毫秒）
+     */
+    static int confirmationTimeoutMs();
+
     /**
      * @brief 按下继电器开机/确认键（单步按键）
      * @return 是否发送成功
@@ -219,6 +335,13 @@ signals:
      */
     void connectionStatusChanged(bool isConnected, const QString &portName);
 
+    /**
+     * @brief 波特率协商结束
+     * @param baudRate 协商后的链路波特率
+     * @param switched 是否切换到了更高的波特率
+     */
+    void baudRateNegotiated(int baudRate, bool switched);
+
     /**
      * @brief 设备数据接收
      * @param data 接收到的数据
@@ -235,19 +358,22 @@ signals:
     void commandConfirmed(Command command, bool success, const QByteArray &sentData, const QByteArray &responseData);
     
     /**
-     * @brief 外部电流表测量值接收
-     * @param valueMa 电流值（mA）
+     * @brief 外部电流表测量值批量接收
+     * @param measurements 一次串口读取中解码出的全部测量值（mA档，同一批共用一个墙钟时间戳）
      * 
-     * 数据来自外部RS485电流表（通过MCU转发的0x50帧）
+     * 数据来自外部RS485电流表（通过MCU转发的0x50帧）。
+     * 每个样本的 monotonicNs 由I/O线程的读取时刻和帧在数据块中的位置按波特率推算，与主线程的排队延迟无关。
+     * 每次读取只发射一次，避免连续测量时逐个样本发射信号导致GUI线程饱和。
      */
-    void externalMeasurementReceived(float valueMa);
+    void externalMeasurementsReceived(const QVector<Measurement> &measurements);
 
 private slots:
     /**
      * @brief 处理串口服务的数据接收
      * @param data 接收到的数据
+     * @param readNs I/O线程读取数据的时刻（MonotonicClock 时间轴，纳秒）
      */
-    void onSerialDataReceived(const QByteArray &data);
+    void onSerialDataReceived(const QByteArray &data, qint64 readNs);
 
     /**
      * @brief 处理串口服务的错误
@@ -261,12 +387,90 @@ private slots:
      */
     void onPortStatusChanged(bool isOpen);
 
+    /**
+     * @brief 处理串口写事务结束
+     * @param transactionId 事务编号
+     * @param success 是否写入成功
+     * @param errorString 失败原因
+     */
+    void onSerialTransactionFinished(quint64 transactionId, bool success, const QString &errorString);
+
     /**
      * @brief 处理命令确认超时
      */
     void onCommandConfirmationTimeout();
 
+    /**
+     * @brief 波特率协商当前阶段超时（或切换后的等待结束）
+     */
+    void onBaudNegotiationTimeout();
+
+    /**
+     * @brief 链路空闲保活（高于默认速率时发送探测帧）
+     */
+    void onKeepaliveTimeout();
+
 private:
+    /**
+     * @brief 波特率协商阶段
+     */
+    enum class BaudStage {
+        Idle,           ///< 未协商
+        QueryingCaps,   ///< 已发送能力查询，等待 [0x60, 0xFF, 位图]
+        Switching,      ///< 已发送切换请求，等待原速率下的回显
+        Settling,       ///< 双方已切换，等待 BaudRate::kSettleMs 后发送探测帧
+        Verifying,      ///< 已发送探测帧，等待新速率下的回显
+        Reverting       ///< 切换失败，等待设备自行退回默认速率
+    };
+
+    /**
+     * @brief 开始波特率协商（命令队列暂停发送）
+     */
+    void startBaudNegotiation();
+
+    /**
+     * @brief 协商期间处理接收数据（不经过确认匹配器和测量帧解码器）
+     * @param data 接收到的数据
+     */
+    void handleBaudNegotiationData(const QByteArray &data);
+
+    /**
+     * @brief 发送协商帧并进入下一阶段
+     * @param stage 下一阶段
+     * @param frame 协商帧（为空表示只等待）
+     * @param timeoutMs 本阶段等待时间
+     */
+    void enterBaudStage(BaudStage stage, const QByteArray &frame, int timeoutMs);
+
+    /**
+     * @brief 结束协商，恢复命令队列发送
+     * @param message 日志消息
+     */
+    void finishBaudNegotiation(const QString &message);
+
+    /**
+     * @brief 链路是否需要保活（设备空闲后会退回的状态）
+     */
+    bool needsKeepalive() const;
+
+    /**
+     * @brief 保活探测帧无回应：设备已退回默认速率和 Float 格式，本端同步退回，
+     *        在途命令结束后重新协商，并在其他排队命令之前重新选择测量帧格式
+     */
+    void resyncLink();
+
+    /**
+     * @brief 提交测量帧格式选择命令
+     * @param format 测量帧格式
+     * @param first 是否插到所有未发送的命令之前
+     * @return 是否成功加入队列
+     */
+    bool submitFormatSelect(DeviceProtocol::MeasurementFormat format, bool first);
+
+    /**
+     * @brief 打包/扫描格式下连续收到 kFormatRevertFrames 个 float 帧时退回 Float 解码
+     */
+    void checkFormatRevert();
 
     /**
      * @brief 初始化信号连接
@@ -277,7 +481,7 @@ private:
      * @brief 发送地址和数据的组合命令（底层）
      * @param slaveAddress 从机地址
      * @param data 数据内容
-     * @return 是否发送成功
+     * @return 是否成功提交到串口I/O线程（写入失败通过 onSerialTransactionFinished 处理）
      */
     bool sendAddressAndData(uint8_t slaveAddress, const QByteArray &data);
 
@@ -292,59 +496,143 @@ public:
 private:
 
     /**
-     * @brief 开始命令确认等待
+     * @brief 待确认命令（命令队列中的一项）
+     */
+    struct PendingCommand {
+        Command command;                ///< 命令类型
+        QByteArray sentData;            ///< 发送的命令数据
+        QByteArray expectedResponse;    ///< 期望的回应数据
+        QString coalesceKey;            ///< 合并键（非空时，同键且未发送的命令会被新命令替换）
+        int timeoutMs;                  ///< 确认超时时间
+        int retryCount;                 ///< 当前重试次数
+        bool sent;                      ///< 是否已发送（在途）
+        qint64 deadlineMs;              ///< 确认截止时间（m_clock 时间轴）
+        qint64 sentAtNs;                ///< 最近一次发送的时间（m_clock 时间轴，纳秒）
+        quint64 transactionId;          ///< 最近一次发送的串口写事务编号
+    };
+
+    /**
+     * @brief 提交命令到队列（替代"有其他命令正在等待确认"的拒绝逻辑）
      * @param command 命令类型
-     * @param sentData 发送的数据
+     * @param data 命令数据
      * @param expectedResponse 期望的回应
+     * @param coalesceKey 合并键，为空表示不合并（如微调命令每次都要生效）
+     * @param timeoutMs 确认超时时间
+     * @param first 是否插到所有未发送的命令之前（默认排在队尾）
+     * @return 是否成功加入队列
      */
-    void startCommandConfirmation(Command command, 
-                                  const QByteArray &sentData, 
-                                  const QByteArray &expectedResponse);
+    bool submitCommand(Command command,
+                       const QByteArray &data,
+                       const QByteArray &expectedResponse,
+                       const QString &coalesceKey = QString(),
+                       int timeoutMs = kConfirmationTimeoutMs,
+                       bool first = false);
 
     /**
-     * @brief 取消当前的命令确认等待
+     * @brief 切换测量帧解码格式（格式选择命令确认后调用）
+     * @param format 设备已确认的格式
      */
-    void cancelCommandConfirmation();
+    void applyMeasurementFormat(DeviceProtocol::MeasurementFormat format);
 
     /**
-     * @brief 检查接收到的数据是否匹配期望回应
-     * @param receivedData 接收到的数据
-     * @return 是否匹配
+     * @brief 发送队列中当前允许发送的命令
      */
-    bool checkResponseMatch(const QByteArray &receivedData);
+    void pumpCommandQueue();
 
     /**
-     * @brief 处理命令确认成功
-     * @param responseData 回应数据
+     * @brief 判断排队命令当前是否可以发送
+     * @param candidate 候选命令
+     * @return 没有在途命令，或流水线开启且回应与所有在途命令可区分时返回true
+     */
+    bool canSendNow(const PendingCommand &candidate) const;
+
+    /**
+     * @brief 命令类型是否允许流水线发送
+     */
+    static bool isPipelinable(Command command);
+
+    /**
+     * @brief 在途（已发送、等待确认）命令数
+     */
+    int inFlightCount() const;
+
+    /**
+     * @brief 按最早的在途命令截止时间启动确认定时器
      */
-    void handleCommandConfirmationSuccess(const QByteArray &responseData);
+    void armConfirmationTimer();
 
     /**
-     * @brief 处理命令确认失败
+     * @brief 清空命令队列和确认匹配器状态
+     */
+    void cancelCommandConfirmation();
+
+    /**
+     * @brief 结束一条命令（确认成功或失败），发射 commandConfirmed 并继续发送队列
+     * @param index 命令在队列中的位置
+     * @param success 是否确认成功
+     * @param responseData 回应数据
      * @param reason 失败原因
      */
-    void handleCommandConfirmationFailure(const QString &reason);
+    void completeCommand(int index, bool success, const QByteArray &responseData, const QString &reason);
+
+    /**
+     * @brief 将字节流送入测量帧解码器，并将解码出的测量值整批发射
+     * @param data 接收到的数据（可能包含多帧或不完整帧）
+     */
+    void decodeMeasurementFrames(const QByteArray &data);
+
+    /**
+     * @brief 将 m_decodedValues 中的测量值组成一批并发射（为空时不发射）
+     *
+     * 每个样本的到达时刻 = 读取时刻 - 帧尾之后的字节数 × 单字节传输时间。
+     */
+    void emitMeasurementBatch();
 
     // 成员变量
     SerialPortService *m_serialService;         ///< 串口服务指针
     bool m_isConnected;                         ///< 连接状态标志
 
     // 命令确认相关成员
-    Command m_pendingCommand;                   ///< 当前待确认的命令类型
-    QByteArray m_sentData;                      ///< 发送的命令数据
-    QByteArray m_expectedResponse;              ///< 期望的回应数据
-    QByteArray m_receivedBuffer;                ///< 接收数据缓冲区
+    QList<PendingCommand> m_commandQueue;       ///< 命令队列（在途命令在前，排队命令在后）
+    ResponseMatcher m_responseMatcher;          ///< 确认帧/测量帧增量匹配器（等待确认期间使用）
+    QElapsedTimer m_clock;                      ///< 确认截止时间的单调时钟
     QTimer *m_confirmationTimer;                ///< 确认超时定时器
+    CommandLatencyStats m_latencyStats;         ///< 各命令的确认延迟统计
 
     // 测量数据相关成员
-    QByteArray m_measureDataBuffer;             ///< 测量数据接收缓冲区
+    MeasurementFrameDecoder m_measureDecoder;   ///< 测量帧流式解码器（环形缓冲区）
+    QVector<float> m_decodedValues;             ///< 单次解码结果（复用，避免重复分配）
+    QVector<uint8_t> m_decodedChannels;         ///< 与 m_decodedValues 逐项对应的通道码（0 = 未区分通道）
+    QVector<int> m_decodedTrailingBytes;        ///< 与 m_decodedValues 逐项对应：帧尾之后本次读取的剩余字节数
+    qint64 m_readNs;                            ///< 当前处理的数据块的读取时刻（纳秒）
+    qint64 m_lastSampleNs;                      ///< 上一个样本的到达时刻（纳秒）
+    QVector<Measurement> m_measurementBatch;    ///< 单次读取的测量批次（复用，避免重复分配）
     Measurement::Range m_currentRange;          ///< 当前档位
     Measurement::Channel m_currentChannel;      ///< 当前通道
+    DeviceProtocol::MeasurementFormat m_preferredFormat;    ///< 连接后选择的测量帧格式
+    DeviceProtocol::MeasurementFormat m_measurementFormat;  ///< 设备已确认的测量帧格式
+    uint8_t m_scanChannelMask;                  ///< MultiChannel 格式的通道位图
 
     // 配置常量
     static constexpr int kConfirmationTimeoutMs = 5000;  ///< 确认超时时间（毫秒）- 增加容错性，应对20ms循环
     static constexpr int kMaxRetries = 2;                ///< 最大重试次数
-    int m_retryCount;                                   ///< 当前重试次数
+    static constexpr int kMaxQueuedCommands = 32;        ///< 命令队列最大长度
+    static constexpr int kFormatSelectTimeoutMs = 300;   ///< 格式选择确认超时（旧版设备不回应，不宜久等）
+    static constexpr int kFormatRevertFrames = 3;        ///< 打包/扫描格式下连续多少个 float 帧视为设备已退回 Float
+    static constexpr int kMaxInFlightCommands = 4;       ///< 流水线模式下最多在途命令数
+    quint64 m_lastTransactionId;                        ///< 最近一次提交的串口写事务编号
+    bool m_pipeliningEnabled;                           ///< 是否启用流水线发送
+
+    // 波特率协商相关成员
+    int m_baudRate;                                     ///< 当前链路波特率
+    int m_connectBaudRate;                              ///< 连接时的波特率（设备空闲或复位后退回的速率）
+    int m_maxBaudRate;                                  ///< 协商的最高波特率
+    int m_targetBaudRate;                               ///< 本次协商的目标波特率
+    BaudStage m_baudStage;                              ///< 协商阶段
+    QByteArray m_baudRxBuffer;                          ///< 协商期间收到的数据
+    QTimer *m_baudTimer;                                ///< 协商阶段定时器
+    QTimer *m_keepaliveTimer;                           ///< 链路空闲保活定时器（每次发送重新计时）
+    bool m_resyncPending;                               ///< 链路已退回默认速率，等待在途命令结束后重新协商
 };
 
 #endif // DEVICECONTROLLER_H
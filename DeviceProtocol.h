@@ -4,12 +4,14 @@
 #include <QtGlobal>
 #include <QByteArray>
 #include <QString>
+#include "protocol/Frame.h"
+#include "protocol/BaudRate.h"
 
 namespace DeviceProtocol {
 
 // 基本通信参数
 constexpr uint8_t kSlaveAddress = 0xC0;
-constexpr int kBaud = 9600;
+constexpr int kBaud = BaudRate::kDefault;
 constexpr int kWriteTimeoutMs = 1000;
 constexpr int kReadTimeoutMs = 1000;
 
@@ -23,6 +25,8 @@ enum class CommandId : uint8_t {
     StepAdjust = 0x06,          // 微调命令（上/下步进）
     PauseDetection = 0xAA,      // 暂停检测命令（0xAA在float32中几乎不会出现，避免与测量帧混淆）
     VoltageChannelOpen = 0x12,  // v1234电压输出通道开启命令
+    BaudRate = 0x60,            // 波特率协商命令（能力查询 / 切换 / 探测）
+    MeasurementFormat = 0x61,   // 测量帧格式选择命令
     IapJump = 0x99              // IAP跳转命令（跳转到Bootloader）
 };
 
@@ -33,6 +37,20 @@ constexpr uint8_t kIapJumpAck2 = 0xAA;
 // 与0xAA组成双字节确认[0xAA, 0x55]，避免与float数据误判
 constexpr uint8_t kPauseDetectionAck2 = 0x55;
 
+// 波特率协商第二字节：0x00~0x07 为切换请求（速率码，见 BaudRate::kRates），回显确认
+constexpr uint8_t kBaudCapsQuery = 0xFF;    // 能力查询 [0x60, 0xFF] → 回复 [0x60, 0xFF, 能力位图]
+constexpr uint8_t kBaudProbe = 0xFE;        // 新速率下的探测帧 [0x60, 0xFE] → 回显
+
+// 连续检测的测量帧格式（[0x61, 格式] → 回显，不支持的设备不回应，保持原始 float 帧）
+// 与波特率相同，设备复位或空闲超过 BaudRate::kIdleRevertMs 后恢复为 Float，上位机每次连接重新选择；
+// 非 Float 格式下上位机空闲保活，保活无回应后重新选择，连续收到 float 帧时退回 Float 解码
+enum class MeasurementFormat : uint8_t {
+    Float = 0x00,           ///< [0x50] + float，每样本5字节（默认）
+    PackedInt16 = 0x01,     ///< 0x52 打包帧，每样本2字节，带CRC16
+    PackedDelta = 0x02,     ///< 0x53 打包帧，每样本1字节差值（差值超出 int8 的批次由设备改用 0x52），带CRC16
+    MultiChannel = 0x03     ///< 0x54 多通道扫描帧，每次扫描同时输出位图选中的各通道 float，带CRC16
+};
+
 // 电流检测档位枚举
 enum class RangeCode : uint8_t {
     MilliAmp = 0x01,    ///< mA档
@@ -76,178 +94,186 @@ inline QString channelCodeToString(ChannelCode channel) {
 // 映射规则：整数位→高4位，小数第一位→低4位
 // 示例：9.9→0x99，0.1→0x01，5.9→0x59
 // 超过一位小数时四舍五入到一位，边界强制压回 [0.0, 9.9]
-inline uint8_t encodeVoltage(double voltage) {
-    // 四舍五入到一位小数
-    voltage = qRound(voltage * 10.0) / 10.0;
-    
-    // 边界处理：强制压回 [0.0, 9.9]
-    if (voltage < 0.0) voltage = 0.0;
-    if (voltage > 9.9) voltage = 9.9;
-    
-    // 分离整数位和小数位
-    int integerPart = static_cast<int>(voltage);           // 整数位：0-9
-    int decimalPart = static_cast<int>(qRound((voltage - integerPart) * 10.0)); // 小数第一位：0-9
-    
-    // BCD编码：高4位=整数位，低4位=小数位
-    return static_cast<uint8_t>((integerPart << 4) | decimalPart);
+// 以0.1V为单位的整数编码：直接拆分十位和个位，无浮点运算
+constexpr uint8_t encodeVoltageTenths(int tenths) {
+    return tenths < 0 ? 0x00
+         : tenths > 99 ? 0x99
+         : static_cast<uint8_t>(((tenths / 10) << 4) | (tenths % 10));
+}
+
+constexpr uint8_t encodeVoltage(double voltage) {
+    return encodeVoltageTenths(qRound(voltage * 10.0));
 }
 
 // V4电压映射：将电压值映射为下位机特定的指令码
 // 对于特殊电压值使用预定义的指令码，其他使用BCD编码
-inline uint8_t encodeV4Voltage(double voltage) {
-    // 四舍五入到两位小数
-    voltage = qRound(voltage * 100.0) / 100.0;
-    
-    // 特殊电压值映射（匹配下位机CMD_V4_VOLTAGE_xxx宏定义）
-    if (qAbs(voltage - 2.90) < 0.01) return 0x29;  // CMD_V4_VOLTAGE_2P9
-    if (qAbs(voltage - 3.20) < 0.01) return 0x32;  // CMD_V4_VOLTAGE_3P2
-    if (qAbs(voltage - 3.45) < 0.01) return 0xD9;  // CMD_V4_VOLTAGE_3P45 (特殊码)
-    if (qAbs(voltage - 3.65) < 0.01) return 0xDB;  // CMD_V4_VOLTAGE_3P65 (特殊码)
-    if (qAbs(voltage - 3.85) < 0.01) return 0xDD;  // CMD_V4_VOLTAGE_3P85 (特殊码)
-    if (qAbs(voltage - 3.90) < 0.01) return 0x39;  // CMD_V4_VOLTAGE_3P9
-    if (qAbs(voltage - 4.05) < 0.01) return 0xE5;  // CMD_V4_VOLTAGE_4P05 (特殊码)
-    if (qAbs(voltage - 4.70) < 0.01) return 0x47;  // CMD_V4_VOLTAGE_4P7
-    if (qAbs(voltage - 5.50) < 0.01) return 0x55;  // CMD_V4_VOLTAGE_5P5
-    if (qAbs(voltage - 0.00) < 0.01) return 0x00;  // CMD_V4_VOLTAGE_OFF
-    
-    // 其他电压值使用BCD编码（自定义电压）
-    return encodeVoltage(voltage);
+struct V4VoltageCode {
+    int centivolts;     ///< 电压（0.01V为单位）
+    uint8_t code;       ///< 下位机指令码
+};
+
+// 特殊电压值映射表（匹配下位机CMD_V4_VOLTAGE_xxx宏定义）
+constexpr V4VoltageCode kV4VoltageCodes[] = {
+    {290, 0x29},    // CMD_V4_VOLTAGE_2P9
+    {320, 0x32},    // CMD_V4_VOLTAGE_3P2
+    {345, 0xD9},    // CMD_V4_VOLTAGE_3P45 (特殊码)
+    {365, 0xDB},    // CMD_V4_VOLTAGE_3P65 (特殊码)
+    {385, 0xDD},    // CMD_V4_VOLTAGE_3P85 (特殊码)
+    {390, 0x39},    // CMD_V4_VOLTAGE_3P9
+    {405, 0xE5},    // CMD_V4_VOLTAGE_4P05 (特殊码)
+    {470, 0x47},    // CMD_V4_VOLTAGE_4P7
+    {550, 0x55},    // CMD_V4_VOLTAGE_5P5
+    {0,   0x00}     // CMD_V4_VOLTAGE_OFF
+};
+constexpr int kV4VoltageCodeCount = sizeof(kV4VoltageCodes) / sizeof(kV4VoltageCodes[0]);
+
+// 以0.01V为单位的整数编码：查表，未命中时四舍五入到0.1V后使用BCD编码（自定义电压）
+constexpr uint8_t encodeV4VoltageCentivolts(int centivolts, int index = 0) {
+    return index >= kV4VoltageCodeCount
+               ? encodeVoltageTenths(centivolts >= 0 ? (centivolts + 5) / 10 : -1)
+         : kV4VoltageCodes[index].centivolts == centivolts
+               ? kV4VoltageCodes[index].code
+               : encodeV4VoltageCentivolts(centivolts, index + 1);
+}
+
+// 四舍五入到两位小数后查表
+constexpr uint8_t encodeV4Voltage(double voltage) {
+    return encodeV4VoltageCentivolts(qRound(voltage * 100.0));
+}
+
+// ========== 定长帧（constexpr，参数为常量时编译期编码，不分配内存） ==========
+
+// 控制开机/关机帧：命令字(0x01) + 0x01/0x00
+constexpr Frame<2> powerOnFrame() { return Frame<2>(CommandId::Power, 0x01); }
+constexpr Frame<2> powerOffFrame() { return Frame<2>(CommandId::Power, 0x00); }
+
+// 控制输出电压帧（四字节）：命令字 + 通道ID + V1电压BCD + V2电压码
+constexpr Frame<4> voltageControlFrame(uint8_t channelId, double v1Voltage, double v2Voltage) {
+    return Frame<4>(CommandId::Voltage, channelId, encodeVoltage(v1Voltage), encodeVoltage(v2Voltage));
+}
+
+// V123电压控制帧（三字节）：命令字(0x02) + 通道ID(0x01/0x02/0x03) + 电压BCD
+constexpr Frame<3> v123VoltageControlFrame(uint8_t channelId, double voltage) {
+    return Frame<3>(CommandId::Voltage, channelId, encodeVoltage(voltage));
+}
+
+// V4电压控制帧（三字节）：命令字(0x02) + 通道ID(0x04) + 特定指令码
+constexpr Frame<3> v4VoltageControlFrame(double voltage) {
+    return Frame<3>(CommandId::Voltage, 0x04, encodeV4Voltage(voltage));
+}
+
+// 电压输出通道开启帧（三字节）：命令字(0x12) + V123通道ID + V4通道ID
+constexpr Frame<3> voltageChannelOpenFrame(uint8_t v123ChannelId, uint8_t v4ChannelId) {
+    return Frame<3>(CommandId::VoltageChannelOpen, v123ChannelId, v4ChannelId);
+}
+
+// V123/V4通道开启帧（两字节）：命令字(0x12) + 通道ID
+constexpr Frame<2> v123ChannelOpenFrame(uint8_t v123ChannelId) {
+    return Frame<2>(CommandId::VoltageChannelOpen, v123ChannelId);
 }
+constexpr Frame<2> v4ChannelOpenFrame() { return Frame<2>(CommandId::VoltageChannelOpen, 0x04); }
 
-// 控制开机帧构造
-inline QByteArray buildPowerOn() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Power)));
-    data.append(static_cast<char>(0x01));
-    return data;
+// 电流检测通道选择帧（三字节）：命令字 + 档位码 + 通道码（原一体化命令，保留兼容）
+constexpr Frame<3> detectionFrame(uint8_t rangeCode, uint8_t channelCode) {
+    return Frame<3>(CommandId::Detection, rangeCode, channelCode);
 }
 
-// 控制关机帧构造
-inline QByteArray buildPowerOff() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Power)));
-    data.append(static_cast<char>(0x00));
-    return data;
+// 开始/暂停检测帧（一字节）：仅命令字
+constexpr Frame<1> startDetectionFrame() { return Frame<1>(CommandId::StartDetection); }
+constexpr Frame<1> pauseDetectionFrame() { return Frame<1>(CommandId::PauseDetection); }
+
+// 外部电流表连续检测启动/停止帧（一字节）及其确认帧（双字节）：0x50 → [0x50, 0xAA]，0x51 → [0x51, 0x55]
+constexpr Frame<1> externalMeterStartFrame() { return Frame<1>(CommandId::StartDetection); }
+constexpr Frame<2> externalMeterStartAckFrame() { return Frame<2>(CommandId::StartDetection, 0xAA); }
+constexpr Frame<1> externalMeterStopFrame() { return Frame<1>(0x51); }
+constexpr Frame<2> externalMeterStopAckFrame() { return Frame<2>(0x51, 0x55); }
+
+// 【协议改进】暂停检测期望回复帧（双字节）：[0xAA, 0x55]
+constexpr Frame<2> pauseDetectionExpectedResponseFrame() {
+    return Frame<2>(CommandId::PauseDetection, kPauseDetectionAck2);
+}
+
+// 微调帧（三字节）：命令字(0x06) + 通道ID + 指令码(0x01=UP,0x02=DOWN)
+constexpr Frame<3> v123StepAdjustFrame(uint8_t v123ChannelId, uint8_t action) {
+    return Frame<3>(CommandId::StepAdjust, v123ChannelId, action);
 }
+constexpr Frame<3> v4StepAdjustFrame(uint8_t action) { return Frame<3>(CommandId::StepAdjust, 0x04, action); }
+
+// 继电器按键模拟帧（两字节）：命令字 + 按键码（复用Power命令字）
+constexpr Frame<2> relayKeyFrame(RelayKeyCode keyCode) { return Frame<2>(CommandId::Power, keyCode); }
+
+// 波特率协商帧（两字节）：命令字(0x60) + 查询码/速率码/探测码，切换请求与探测帧的确认为回显
+constexpr Frame<2> baudCapsQueryFrame() { return Frame<2>(CommandId::BaudRate, kBaudCapsQuery); }
+constexpr Frame<2> baudSwitchFrame(uint8_t rateCode) { return Frame<2>(CommandId::BaudRate, rateCode); }
+constexpr Frame<2> baudProbeFrame() { return Frame<2>(CommandId::BaudRate, kBaudProbe); }
+
+// 测量帧格式选择帧（两字节）：命令字(0x61) + 格式码，确认为回显
+constexpr Frame<2> measurementFormatFrame(MeasurementFormat format) {
+    return Frame<2>(CommandId::MeasurementFormat, format);
+}
+
+// 多通道测量帧格式选择帧（三字节）：命令字(0x61) + 0x03 + 通道位图（bit0~bit3 = CH1~CH4），确认为回显
+constexpr Frame<3> multiChannelFormatFrame(uint8_t channelMask) {
+    return Frame<3>(CommandId::MeasurementFormat, MeasurementFormat::MultiChannel, channelMask);
+}
+
+// IAP跳转指令帧（两字节）：0x99 + 0xAA
+constexpr Frame<2> iapJumpFrame() { return Frame<2>(CommandId::IapJump, kIapJumpAck2); }
+
+// 编码表与下位机约定的编译期校验
+static_assert(encodeVoltage(2.2) == 0x22 && encodeVoltage(9.94) == 0x99 && encodeVoltage(-1.0) == 0x00,
+              "BCD voltage encoding mismatch");
+static_assert(encodeV4Voltage(2.9) == 0x29 && encodeV4Voltage(3.45) == 0xD9 && encodeV4Voltage(4.05) == 0xE5,
+              "V4 voltage code table mismatch");
+static_assert(encodeV4Voltage(3.3) == 0x33, "V4 custom voltage must fall back to BCD");
+
+// ========== QByteArray 帧构造（兼容原接口，每帧一次分配） ==========
+
+inline QByteArray buildPowerOn() { return powerOnFrame().toByteArray(); }
+inline QByteArray buildPowerOff() { return powerOffFrame().toByteArray(); }
 
-// 控制输出电压帧构造（四字节）：命令字 + 通道ID + V1电压BCD + V2电压码
 inline QByteArray buildVoltageControl(uint8_t channelId, double v1Voltage, double v2Voltage) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Voltage)));  // 第1字节：命令字(0x02)
-    data.append(static_cast<char>(channelId));                                 // 第2字节：通道ID(0x01/0x02/0x03)
-    // 在组帧阶段将数值电压编码为单字节BCD
-    data.append(static_cast<char>(encodeVoltage(v1Voltage)));                 // 第3字节：V1电压BCD
-    data.append(static_cast<char>(encodeVoltage(v2Voltage)));                 // 第4字节：V2电压码
-    return data;
+    return voltageControlFrame(channelId, v1Voltage, v2Voltage).toByteArray();
 }
 
-// V123电压控制帧构造（三字节）：命令字(0x02) + 通道ID(0x01/0x02/0x03) + 电压BCD
 inline QByteArray buildV123VoltageControl(uint8_t channelId, double voltage) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Voltage)));  // 第1字节：命令字(0x02)
-    data.append(static_cast<char>(channelId));                                 // 第2字节：通道ID(0x01/0x02/0x03)
-    data.append(static_cast<char>(encodeVoltage(voltage)));                   // 第3字节：电压BCD
-    return data;
+    return v123VoltageControlFrame(channelId, voltage).toByteArray();
 }
 
-// V4电压控制帧构造（三字节）：命令字(0x02) + 通道ID(0x04) + 特定指令码
 inline QByteArray buildV4VoltageControl(double voltage) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Voltage)));  // 第1字节：命令字(0x02)
-    data.append(static_cast<char>(0x04));                                      // 第2字节：V4通道ID固定为0x04
-    data.append(static_cast<char>(encodeV4Voltage(voltage)));                 // 第3字节：V4特定指令码
-    return data;
+    return v4VoltageControlFrame(voltage).toByteArray();
 }
 
 inline QByteArray buildVoltageChannelOpen(uint8_t v123ChannelId, uint8_t v4ChannelId) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::VoltageChannelOpen)));
-    data.append(static_cast<char>(v123ChannelId));
-    data.append(static_cast<char>(v4ChannelId));
-    return data;
+    return voltageChannelOpenFrame(v123ChannelId, v4ChannelId).toByteArray();
 }
 
-// V123通道开启帧构造（两字节）：命令字(0x12) + 通道ID(0x01/0x02/0x03)
 inline QByteArray buildV123ChannelOpen(uint8_t v123ChannelId) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::VoltageChannelOpen)));
-    data.append(static_cast<char>(v123ChannelId));
-    return data;
+    return v123ChannelOpenFrame(v123ChannelId).toByteArray();
 }
 
-// V4通道开启帧构造（两字节）：命令字(0x12) + 通道ID(0x04)
-inline QByteArray buildV4ChannelOpen() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::VoltageChannelOpen)));
-    data.append(static_cast<char>(0x04)); // V4通道ID固定为0x04
-    return data;
-}
+inline QByteArray buildV4ChannelOpen() { return v4ChannelOpenFrame().toByteArray(); }
 
-// 电流检测通道选择帧构造（三字节）：命令字 + 档位码 + 通道码（原一体化命令，保留兼容）
 inline QByteArray buildDetection(uint8_t rangeCode, uint8_t channelCode) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Detection))); // 第1字节：命令字
-    data.append(static_cast<char>(rangeCode));                                  // 第2字节：档位码
-    data.append(static_cast<char>(channelCode));                                // 第3字节：通道码
-    return data;
-}
-
-inline QByteArray buildStartDetection() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::StartDetection))); // 第1字节：命令字
-    return data;
+    return detectionFrame(rangeCode, channelCode).toByteArray();
 }
 
-// 暂停检测帧构造（一字节）：仅命令字
-inline QByteArray buildPauseDetection() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::PauseDetection))); // 第1字节：命令字 0xAA
-    return data;
-}
+inline QByteArray buildStartDetection() { return startDetectionFrame().toByteArray(); }
+inline QByteArray buildPauseDetection() { return pauseDetectionFrame().toByteArray(); }
 
-// 【协议改进】暂停检测期望回复帧构造（双字节）：[0xAA, 0x55]
-// 用于上位机验证暂停确认
 inline QByteArray buildPauseDetectionExpectedResponse() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::PauseDetection))); // 0xAA
-    data.append(static_cast<char>(kPauseDetectionAck2));                              // 0x55
-    return data;
+    return pauseDetectionExpectedResponseFrame().toByteArray();
 }
 
-// V123微调帧构造（三字节）：命令字(0x06) + 通道ID(0x01/0x02/0x03) + 指令码(0x01=UP,0x02=DOWN)
 inline QByteArray buildV123StepAdjust(uint8_t v123ChannelId, uint8_t action) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::StepAdjust)));
-    data.append(static_cast<char>(v123ChannelId));
-    data.append(static_cast<char>(action));
-    return data;
+    return v123StepAdjustFrame(v123ChannelId, action).toByteArray();
 }
 
-// V4微调帧构造（三字节）：命令字(0x06) + 通道ID(0x04) + 指令码(0x01=UP,0x02=DOWN)
-inline QByteArray buildV4StepAdjust(uint8_t action) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::StepAdjust)));
-    data.append(static_cast<char>(0x04)); // V4通道ID
-    data.append(static_cast<char>(action));
-    return data;
-}
+inline QByteArray buildV4StepAdjust(uint8_t action) { return v4StepAdjustFrame(action).toByteArray(); }
 
-// 继电器按键模拟帧构造（两字节）：命令字 + 按键码（复用Power命令字）
-inline QByteArray buildRelayKey(RelayKeyCode keyCode) {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::Power)));  // 第1字节：命令字（Power）
-    data.append(static_cast<char>(static_cast<uint8_t>(keyCode)));           // 第2字节：按键码
-    return data;
-}
+inline QByteArray buildRelayKey(RelayKeyCode keyCode) { return relayKeyFrame(keyCode).toByteArray(); }
 
-// IAP跳转指令帧构造（两字节）：0x99 + 0xAA
-// 用于通知APP跳转到Bootloader进行固件升级
-inline QByteArray buildIapJump() {
-    QByteArray data;
-    data.append(static_cast<char>(static_cast<uint8_t>(CommandId::IapJump))); // 第1字节：命令字 0x99
-    data.append(static_cast<char>(kIapJumpAck2));                              // 第2字节：确认码 0xAA
-    return data;
-}
+inline QByteArray buildIapJump() { return iapJumpFrame().toByteArray(); }
 
 // 十六进制字符串
 inline QString toHex(const QByteArray &bytes) {
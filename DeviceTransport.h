@@ -0,0 +1,83 @@
+#ifndef DEVICETRANSPORT_H
+#define DEVICETRANSPORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief 设备传输层接口（运行在SerialPortService的I/O线程中）
+ *
+ * 职责：
+ * - 定义SerialPortService与底层传输之间的槽函数/信号约定
+ * - 具体实现：SerialPortWorker（真实串口）、SimulatedDeviceTransport（进程内模拟设备）
+ *
+ * 槽函数由SerialPortService通过队列连接跨线程调用，实现类不应被其他对象直接调用。
+ */
+class DeviceTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceTransport(QObject *parent = nullptr) : QObject(parent) {}
+    ~DeviceTransport() override {}
+
+public slots:
+    /**
+     * @brief 打开传输（由SerialPortService以阻塞队列连接调用）
+     * @param portName 串口名称
+     * @param baudRate 波特率
+     * @return 是否成功打开
+     */
+    virtual bool openPort(const QString &portName, int baudRate) = 0;
+
+    /**
+     * @brief 关闭传输，丢弃所有未完成的事务（每个事务都会以失败结束）
+     */
+    virtual void closePort() = 0;
+
+    /**
+     * @brief 在已打开的传输上切换波特率（不丢弃未完成的事务）
+     * @param baudRate 新波特率
+     * @return 是否切换成功
+     */
+    virtual bool setBaudRate(int baudRate) = 0;
+
+    /**
+     * @brief 追加一个写事务到队列
+     * @param id 事务编号（由SerialPortService分配）
+     * @param address 地址字节（MarkParity发送）
+     * @param payload 数据字节（SpaceParity发送）
+     * @param timeoutMs 事务超时时间
+     */
+    virtual void enqueueTransaction(quint64 id, quint8 address, const QByteArray &payload, int timeoutMs) = 0;
+
+signals:
+    /**
+     * @brief 有数据可读时发射
+     * @param data 接收到的数据
+     * @param readNs 读取时刻（MonotonicClock 时间轴，纳秒），在I/O线程中读取数据时记录
+     */
+    void dataReceived(const QByteArray &data, qint64 readNs);
+
+    /**
+     * @brief 传输错误发生时发射
+     * @param errorString 错误描述
+     */
+    void errorOccurred(const QString &errorString);
+
+    /**
+     * @brief 传输因致命错误被动关闭时发射（主动调用closePort不发射）
+     */
+    void portLost();
+
+    /**
+     * @brief 写事务结束时发射
+     * @param id 事务编号
+     * @param success 是否写入成功
+     * @param errorString 失败原因（成功时为空）
+     */
+    void transactionFinished(quint64 id, bool success, const QString &errorString);
+};
+
+#endif // DEVICETRANSPORT_H
@@ -0,0 +1,185 @@
+#include "ErrorHistoryDialog.h"
+#include "storage/ErrorRecordStore.h"
+#include "storage/ErrorRecordReader.h"
+#include <QTableWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QDateTimeEdit>
+#include <QFileInfo>
+
+ErrorHistoryDialog::ErrorHistoryDialog(ErrorRecordStore *store, QWidget *parent)
+    : QDialog(parent)
+    , m_store(store)
+    , m_serialEdit(nullptr)
+    , m_fixtureEdit(nullptr)
+    , m_errorTypeEdit(nullptr)
+    , m_fromEdit(nullptr)
+    , m_toEdit(nullptr)
+    , m_queryButton(nullptr)
+    , m_closeButton(nullptr)
+    , m_summaryLabel(nullptr)
+    , m_table(nullptr)
+{
+    initUI();
+    onQueryClicked();
+}
+
+void ErrorHistoryDialog::initUI()
+{
+    setWindowTitle(tr("失效历史"));
+    setMinimumSize(1000, 500);
+    resize(1200, 650);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(15, 15, 15, 15);
+
+    // 查询条件
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    m_serialEdit = new QLineEdit(this);
+    m_serialEdit->setPlaceholderText(tr("板号"));
+    m_fixtureEdit = new QLineEdit(this);
+    m_fixtureEdit->setPlaceholderText(tr("治具"));
+    m_errorTypeEdit = new QLineEdit(this);
+    m_errorTypeEdit->setPlaceholderText(tr("错误类型"));
+
+    const QDateTime now = QDateTime::currentDateTime();
+    m_fromEdit = new QDateTimeEdit(now.addDays(-7), this);
+    m_fromEdit->setDisplayFormat("yyyy-MM-dd hh:mm");
+    m_fromEdit->setCalendarPopup(true);
+    m_toEdit = new QDateTimeEdit(now.addDays(1), this);
+    m_toEdit->setDisplayFormat("yyyy-MM-dd hh:mm");
+    m_toEdit->setCalendarPopup(true);
+
+    m_queryButton = new QPushButton(tr("查询"), this);
+    m_queryButton->setStyleSheet(
+        "QPushButton { font: 11pt; padding: 6px 20px; background-color: #3498db; "
+        "color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #5dade2; }"
+    );
+    connect(m_queryButton, &QPushButton::clicked, this, &ErrorHistoryDialog::onQueryClicked);
+    connect(m_serialEdit, &QLineEdit::returnPressed, this, &ErrorHistoryDialog::onQueryClicked);
+
+    filterLayout->addWidget(m_serialEdit);
+    filterLayout->addWidget(m_fixtureEdit);
+    filterLayout->addWidget(m_errorTypeEdit);
+    filterLayout->addWidget(new QLabel(tr("从"), this));
+    filterLayout->addWidget(m_fromEdit);
+    filterLayout->addWidget(new QLabel(tr("到"), this));
+    filterLayout->addWidget(m_toEdit);
+    filterLayout->addWidget(m_queryButton);
+    mainLayout->addLayout(filterLayout);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setStyleSheet("font: bold 12pt; color: #2c3e50;");
+    mainLayout->addWidget(m_summaryLabel);
+
+    // 表格
+    m_table = new QTableWidget(this);
+    m_table->setColumnCount(9);
+    m_table->setHorizontalHeaderLabels({
+        tr("时间"), tr("板号"), tr("治具"), tr("步骤"), tr("动作"),
+        tr("错误类型"), tr("详细信息"), tr("测量值"), tr("运行编号")
+    });
+    QHeaderView *header = m_table->horizontalHeader();
+    header->setSectionResizeMode(QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(6, QHeaderView::Stretch);           // 详细信息
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setAlternatingRowColors(true);
+    m_table->setStyleSheet(
+        "QTableWidget { font-size: 10pt; }"
+        "QTableWidget::item:selected { background-color: #3498db; color: white; }"
+    );
+    mainLayout->addWidget(m_table, 1);
+
+    // 按钮区域
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+
+    m_closeButton = new QPushButton(tr("关闭"), this);
+    m_closeButton->setStyleSheet(
+        "QPushButton { font: 12pt; padding: 8px 25px; background-color: #7f8c8d; "
+        "color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #95a5a6; }"
+    );
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    buttonLayout->addWidget(m_closeButton);
+
+    mainLayout->addLayout(buttonLayout);
+}
+
+void ErrorHistoryDialog::onQueryClicked()
+{
+    m_table->setRowCount(0);
+
+    if (!m_store) {
+        m_summaryLabel->setText(tr("错误记录库不可用"));
+        return;
+    }
+
+    // 等待刚产生的记录写入文件，保证查询结果包含本次测试
+    m_store->sync();
+    if (!QFileInfo::exists(m_store->filePath())) {
+        m_summaryLabel->setText(tr("暂无失效历史"));
+        return;
+    }
+
+    ErrorRecordReader reader;
+    QString errorString;
+    if (!reader.open(m_store->filePath(), &errorString)) {
+        m_summaryLabel->setText(tr("无法读取错误记录库: %1").arg(errorString));
+        return;
+    }
+
+    ErrorRecordReader::Filter filter;
+    filter.boardSerial = m_serialEdit->text().trimmed();
+    filter.fixture = m_fixtureEdit->text().trimmed();
+    filter.errorType = m_errorTypeEdit->text().trimmed();
+    filter.fromWallMs = m_fromEdit->dateTime().toMSecsSinceEpoch();
+    filter.toWallMs = m_toEdit->dateTime().toMSecsSinceEpoch();
+
+    const QVector<ErrorRecord> records = reader.query(filter, kMaxRows);
+    if (records.size() >= kMaxRows) {
+        m_summaryLabel->setText(tr("显示最近 %1 条记录（库中共 %2 条）").arg(records.size()).arg(reader.recordCount()));
+    } else {
+        m_summaryLabel->setText(tr("共 %1 条记录（库中共 %2 条）").arg(records.size()).arg(reader.recordCount()));
+    }
+
+    // 最新的记录显示在最上面
+    m_table->setRowCount(records.size());
+    for (int i = 0; i < records.size(); ++i) {
+        const ErrorRecord &record = records.at(records.size() - 1 - i);
+
+        m_table->setItem(i, 0, new QTableWidgetItem(record.timestamp.toString("yyyy-MM-dd hh:mm:ss")));
+        m_table->setItem(i, 1, new QTableWidgetItem(record.boardSerial.isEmpty() ? QString("-") : record.boardSerial));
+        m_table->setItem(i, 2, new QTableWidgetItem(record.fixture));
+        m_table->setItem(i, 3, new QTableWidgetItem(tr("第%1步: %2").arg(record.stepIndex + 1).arg(record.stepName)));
+        m_table->setItem(i, 4, new QTableWidgetItem(record.actionDescription));
+
+        QTableWidgetItem *typeItem = new QTableWidgetItem(record.errorType);
+        typeItem->setForeground(QBrush(QColor("#e74c3c")));  // 红色
+        m_table->setItem(i, 5, typeItem);
+
+        m_table->setItem(i, 6, new QTableWidgetItem(record.errorDetail));
+
+        QString measureText;
+        if (record.hasMeasurementData()) {
+            measureText = tr("%1 / %2 mA")
+                .arg(record.measuredValue, 0, 'f', 3)
+                .arg(record.thresholdValue, 0, 'f', 3);
+        } else {
+            measureText = "-";
+        }
+        QTableWidgetItem *measureItem = new QTableWidgetItem(measureText);
+        measureItem->setTextAlignment(Qt::AlignCenter);
+        m_table->setItem(i, 7, measureItem);
+
+        m_table->setItem(i, 8, new QTableWidgetItem(QString::number(record.runId)));
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef ERRORHISTORYDIALOG_H
+#define ERRORHISTORYDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+#include <QString>
+
+class QTableWidget;
+class QPushButton;
+class QLabel;
+class QLineEdit;
+class QDateTimeEdit;
+class ErrorRecordStore;
+
+/**
+ * @brief 失效历史查询对话框
+ *
+ * 从错误记录库中按板号、治具、错误类型和时间范围查询，显示最近的 kMaxRows 条记录。
+ */
+class ErrorHistoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kMaxRows = 2000;   ///< 单次查询最多显示的记录数
+
+    /**
+     * @brief 构造函数
+     * @param store 错误记录库（查询前等待已排队的记录写入）
+     * @param parent 父窗口
+     */
+    explicit ErrorHistoryDialog(ErrorRecordStore *store, QWidget *parent = nullptr);
+
+    ~ErrorHistoryDialog() override = default;
+
+private slots:
+    /**
+     * @brief 按当前条件查询
+     */
+    void onQueryClicked();
+
+private:
+    /**
+     * @brief 初始化UI
+     */
+    void initUI();
+
+private:
+    QPointer<ErrorRecordStore> m_store;     ///< 错误记录库
+    QLineEdit *m_serialEdit;                ///< 板号条件
+    QLineEdit *m_fixtureEdit;               ///< 治具条件
+    QLineEdit *m_errorTypeEdit;             ///< 错误类型条件
+    QDateTimeEdit *m_fromEdit;              ///< 起始时间
+    QDateTimeEdit *m_toEdit;                ///< 结束时间
+    QPushButton *m_queryButton;             ///< 查询按钮
+    QPushButton *m_closeButton;             ///< 关闭按钮
+    QLabel *m_summaryLabel;                 ///< 查询结果统计
+    QTableWidget *m_table;                  ///< 记录表格
+};
+
+#endif // ERRORHISTORYDIALOG_H
@@ -0,0 +1,304 @@
+#include "LatencyDiagnosticsDialog.h"
+#include "DeviceController.h"
+#include <QTableWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QLabel>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+namespace {
+
+QTableWidgetItem *numberItem(const QString &text)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString formatMs(qint64 us)
+{
+    return QString::number(us / 1000.0, 'f', 2);
+}
+
+/**
+ * @brief 填充一行统计
+ */
+void fillRow(QTableWidget *table, int row, const QString &sourceName,
+             const QString &commandName, const CommandLatencyRecord &record)
+{
+    const LatencyHistogram &h = record.ackLatency;
+    const bool hasSamples = h.count() > 0;
+
+    table->setItem(row, 0, new QTableWidgetItem(sourceName));
+    table->setItem(row, 1, new QTableWidgetItem(commandName));
+    table->setItem(row, 2, numberItem(QString::number(record.sent)));
+    table->setItem(row, 3, numberItem(QString::number(record.acked)));
+    table->setItem(row, 4, numberItem(QString::number(record.timeouts)));
+    table->setItem(row, 5, numberItem(QString::number(record.retries)));
+    table->setItem(row, 6, numberItem(QString::number(record.failures)));
+    table->setItem(row, 7, numberItem(hasSamples ? formatMs(h.valueAtPercentile(50)) : "-"));
+    table->setItem(row, 8, numberItem(hasSamples ? formatMs(h.valueAtPercentile(90)) : "-"));
+    table->setItem(row, 9, numberItem(hasSamples ? formatMs(h.valueAtPercentile(99)) : "-"));
+    table->setItem(row, 10, numberItem(hasSamples ? formatMs(h.maxValue()) : "-"));
+
+    // 有超时或失败的命令标红
+    if (record.timeouts > 0 || record.failures > 0) {
+        for (int column = 4; column <= 6; ++column) {
+            table->item(row, column)->setForeground(QBrush(QColor("#e74c3c")));
+        }
+    }
+}
+
+} // namespace
+
+LatencyDiagnosticsDialog::LatencyDiagnosticsDialog(const QVector<Source> &sources, QWidget *parent)
+    : QDialog(parent)
+    , m_sources(sources)
+    , m_summaryLabel(nullptr)
+    , m_table(nullptr)
+    , m_refreshButton(nullptr)
+    , m_resetButton(nullptr)
+    , m_exportCsvButton(nullptr)
+    , m_exportJsonButton(nullptr)
+    , m_closeButton(nullptr)
+    , m_refreshTimer(new QTimer(this))
+{
+    initUI();
+    loadData();
+
+    // 测试运行期间统计持续变化，定时刷新
+    m_refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &LatencyDiagnosticsDialog::loadData);
+    m_refreshTimer->start();
+}
+
+void LatencyDiagnosticsDialog::initUI()
+{
+    setWindowTitle(tr("命令延迟统计"));
+    setMinimumSize(900, 400);
+    resize(1000, 500);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(15, 15, 15, 15);
+
+    // 标题和统计
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setStyleSheet("font: bold 14pt; color: #2c3e50;");
+    mainLayout->addWidget(m_summaryLabel);
+
+    QLabel *hintLabel = new QLabel(
+        tr("延迟为命令发送到收到匹配确认的时间（重试命令从最近一次发送起算），确认超时 %1 ms")
+            .arg(DeviceController::confirmationTimeoutMs()), this);
+    hintLabel->setStyleSheet("color: #7f8c8d;");
+    mainLayout->addWidget(hintLabel);
+
+    // 表格
+    m_table = new QTableWidget(this);
+    m_table->setColumnCount(11);
+    m_table->setHorizontalHeaderLabels({
+        tr("工位"), tr("命令"), tr("发送"), tr("确认"), tr("超时"), tr("重试"), tr("失败"),
+        tr("p50(ms)"), tr("p90(ms)"), tr("p99(ms)"), tr("max(ms)")
+    });
+
+    QHeaderView *header = m_table->horizontalHeader();
+    header->setSectionResizeMode(QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(1, QHeaderView::Stretch);        // 命令
+
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setAlternatingRowColors(true);
+    m_table->setStyleSheet(
+        "QTableWidget { font-size: 10pt; }"
+        "QTableWidget::item:selected { background-color: #3498db; color: white; }"
+    );
+
+    mainLayout->addWidget(m_table, 1);
+
+    // 按钮区域
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+
+    const QString buttonStyle =
+        "QPushButton { font: 12pt; padding: 8px 20px; background-color: %1; "
+        "color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: %2; }";
+
+    m_refreshButton = new QPushButton(tr("刷新"), this);
+    m_refreshButton->setStyleSheet(buttonStyle.arg("#3498db", "#2980b9"));
+    connect(m_refreshButton, &QPushButton::clicked, this, &LatencyDiagnosticsDialog::loadData);
+    buttonLayout->addWidget(m_refreshButton);
+
+    m_resetButton = new QPushButton(tr("重置"), this);
+    m_resetButton->setStyleSheet(buttonStyle.arg("#e67e22", "#d35400"));
+    connect(m_resetButton, &QPushButton::clicked, this, &LatencyDiagnosticsDialog::onResetClicked);
+    buttonLayout->addWidget(m_resetButton);
+
+    buttonLayout->addStretch();
+
+    m_exportCsvButton = new QPushButton(tr("导出CSV"), this);
+    m_exportCsvButton->setStyleSheet(buttonStyle.arg("#16a085", "#1abc9c"));
+    connect(m_exportCsvButton, &QPushButton::clicked, this, &LatencyDiagnosticsDialog::onExportCsvClicked);
+    buttonLayout->addWidget(m_exportCsvButton);
+
+    m_exportJsonButton = new QPushButton(tr("导出JSON"), this);
+    m_exportJsonButton->setStyleSheet(buttonStyle.arg("#16a085", "#1abc9c"));
+    connect(m_exportJsonButton, &QPushButton::clicked, this, &LatencyDiagnosticsDialog::onExportJsonClicked);
+    buttonLayout->addWidget(m_exportJsonButton);
+
+    m_closeButton = new QPushButton(tr("关闭"), this);
+    m_closeButton->setStyleSheet(buttonStyle.arg("#7f8c8d", "#95a5a6"));
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    buttonLayout->addWidget(m_closeButton);
+
+    mainLayout->addLayout(buttonLayout);
+}
+
+void LatencyDiagnosticsDialog::loadData()
+{
+    // 预先计算行数：每个来源的各命令各一行，外加一行合计
+    int rowCount = 0;
+    for (const Source &source : m_sources) {
+        if (source.controller) {
+            rowCount += source.controller->latencyStats().commands().size() + 1;
+        }
+    }
+
+    // 刷新时保持用户的滚动位置
+    const int scrollValue = m_table->verticalScrollBar()->value();
+    m_table->setRowCount(rowCount);
+
+    int row = 0;
+    quint64 totalSent = 0;
+    quint64 totalTimeouts = 0;
+    for (const Source &source : m_sources) {
+        if (!source.controller) {
+            continue;
+        }
+
+        const CommandLatencyStats &stats = source.controller->latencyStats();
+        for (Command command : stats.commands()) {
+            fillRow(m_table, row++, source.name, commandToString(command), stats.record(command));
+        }
+
+        const CommandLatencyRecord total = stats.total();
+        fillRow(m_table, row, source.name, tr("合计"), total);
+        for (int column = 0; column < m_table->columnCount(); ++column) {
+            QFont font = m_table->item(row, column)->font();
+            font.setBold(true);
+            m_table->item(row, column)->setFont(font);
+        }
+        ++row;
+
+        totalSent += total.sent;
+        totalTimeouts += total.timeouts;
+    }
+
+    m_table->verticalScrollBar()->setValue(scrollValue);
+    m_summaryLabel->setText(tr("⏱ %1 个治具，共发送 %2 条命令，%3 次超时")
+                            .arg(m_sources.size()).arg(totalSent).arg(totalTimeouts));
+}
+
+void LatencyDiagnosticsDialog::onResetClicked()
+{
+    for (const Source &source : m_sources) {
+        if (source.controller) {
+            source.controller->resetLatencyStats();
+        }
+    }
+    loadData();
+}
+
+void LatencyDiagnosticsDialog::onExportCsvClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        tr("导出延迟统计"),
+        QDir::homePath() + QString("/pcba_latency_%1.csv")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        tr("CSV 文件 (*.csv)")
+    );
+
+    if (fileName.isEmpty()) {
+        return;  // 用户取消
+    }
+    if (!fileName.endsWith(".csv", Qt::CaseInsensitive)) {
+        fileName += ".csv";
+    }
+
+    QStringList lines;
+    lines << CommandLatencyStats::csvHeader();
+    for (const Source &source : m_sources) {
+        if (source.controller) {
+            lines << source.controller->latencyStats().toCsvLines(source.name);
+        }
+    }
+
+    // 带 BOM，Excel 打开时中文命令名不乱码
+    QByteArray content("\xEF\xBB\xBF");
+    content += lines.join("\n").toUtf8();
+    content += '\n';
+    writeExportFile(fileName, content);
+}
+
+void LatencyDiagnosticsDialog::onExportJsonClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        tr("导出延迟统计"),
+        QDir::homePath() + QString("/pcba_latency_%1.json")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        tr("JSON 文件 (*.json)")
+    );
+
+    if (fileName.isEmpty()) {
+        return;  // 用户取消
+    }
+    if (!fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        fileName += ".json";
+    }
+
+    QJsonArray fixtures;
+    for (const Source &source : m_sources) {
+        if (!source.controller) {
+            continue;
+        }
+        QJsonObject fixture = source.controller->latencyStats().toJson();
+        fixture.insert("fixture", source.name);
+        fixtures.append(fixture);
+    }
+
+    QJsonObject root;
+    root.insert("timestamp", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("confirmation_timeout_ms", DeviceController::confirmationTimeoutMs());
+    root.insert("fixtures", fixtures);
+    writeExportFile(fileName, QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+bool LatencyDiagnosticsDialog::writeExportFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        QMessageBox::critical(this, tr("错误"),
+            tr("无法打开文件进行写入:\n%1").arg(file.errorString()));
+        return false;
+    }
+
+    file.write(content);
+    file.close();
+
+    QMessageBox::information(this, tr("导出成功"),
+        tr("延迟统计已导出到:\n%1").arg(fileName));
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef LATENCYDIAGNOSTICSDIALOG_H
+#define LATENCYDIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include <QVector>
+#include <QPointer>
+#include <QString>
+
+class QTableWidget;
+class QPushButton;
+class QLabel;
+class QTimer;
+class DeviceController;
+
+/**
+ * @brief 命令延迟诊断对话框
+ *
+ * 以表格形式展示各治具每种命令的发送/确认/超时/重试/失败次数和确认延迟分位数（p50/p90/p99），
+ * 定时刷新，可导出 CSV（按治具比较）或 JSON（含直方图桶）。
+ */
+class LatencyDiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 统计来源（一个治具的设备控制器）
+     */
+    struct Source {
+        QString name;                           ///< 显示名称（串口名）
+        QPointer<DeviceController> controller;  ///< 设备控制器（销毁后自动跳过）
+    };
+
+    /**
+     * @brief 构造函数
+     * @param sources 统计来源列表
+     * @param parent 父窗口
+     */
+    explicit LatencyDiagnosticsDialog(const QVector<Source> &sources, QWidget *parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~LatencyDiagnosticsDialog() override = default;
+
+private slots:
+    /**
+     * @brief 重新加载统计数据到表格
+     */
+    void loadData();
+
+    /**
+     * @brief 清空所有来源的统计
+     */
+    void onResetClicked();
+
+    /**
+     * @brief 导出为 CSV
+     */
+    void onExportCsvClicked();
+
+    /**
+     * @brief 导出为 JSON
+     */
+    void onExportJsonClicked();
+
+private:
+    /**
+     * @brief 初始化UI
+     */
+    void initUI();
+
+    /**
+     * @brief 写入导出文件
+     * @return 是否成功
+     */
+    bool writeExportFile(const QString &fileName, const QByteArray &content);
+
+private:
+    QVector<Source> m_sources;          ///< 统计来源
+    QLabel *m_summaryLabel;             ///< 标题和汇总
+    QTableWidget *m_table;              ///< 统计表格
+    QPushButton *m_refreshButton;       ///< 刷新按钮
+    QPushButton *m_resetButton;         ///< 重置按钮
+    QPushButton *m_exportCsvButton;     ///< 导出CSV按钮
+    QPushButton *m_exportJsonButton;    ///< 导出JSON按钮
+    QPushButton *m_closeButton;         ///< 关闭按钮
+    QTimer *m_refreshTimer;             ///< 定时刷新
+
+    static constexpr int kRefreshIntervalMs = 1000;  ///< 刷新间隔（毫秒）
+};
+
+#endif // LATENCYDIAGNOSTICSDIALOG_H
@@ -1,16 +1,21 @@
 #include "MeasurementChartWidget.h"
 #include "InteractiveChartView.h"
 #include <QVBoxLayout>
-#include <QDateTime>
 #include <QFont>
 #include <QPen>
 #include <QBrush>
+#include <QtMath>
+#include <QFileDialog>
+#include "storage/MeasurementRecorder.h"
+#include "storage/MeasurementRecordingReader.h"
 
 MeasurementChartWidget::MeasurementChartWidget(QWidget *parent)
     : QWidget(parent)
+    , m_history(kHistoryCapacity)
+    , m_sampleTimesNs(m_history.capacity())
+    , m_channelHistory(kHistoryCapacity)
 {
     initChart();
-    m_chartStartMs = QDateTime::currentMSecsSinceEpoch();
 }
 
 MeasurementChartWidget::~MeasurementChartWidget()
@@ -115,9 +120,18 @@ void MeasurementChartWidget::initChart()
     // 初始位置会在resizeEvent中调整
     m_resetButton->raise();
 
+    // 创建回放按钮（位于重置按钮左侧）
+    m_replayButton = new QPushButton(tr("回放"), this);
+    m_replayButton->setStyleSheet(m_resetButton->styleSheet());
+    m_replayButton->setCursor(Qt::PointingHandCursor);
+    m_replayButton->setFixedSize(60, 30);
+    m_replayButton->raise();
+
     // 连接信号槽
     connect(m_resetButton, &QPushButton::clicked,
             this, &MeasurementChartWidget::onResetButtonClicked);
+    connect(m_replayButton, &QPushButton::clicked,
+            this, &MeasurementChartWidget::onReplayButtonClicked);
 
     connect(m_series, &QLineSeries::hovered,
             this, &MeasurementChartWidget::onSeriesHovered);
@@ -127,67 +141,186 @@ void MeasurementChartWidget::initChart()
 
     connect(m_chartView, &InteractiveChartView::viewportChanged,
             this, &MeasurementChartWidget::updateMarkerLines);
+
+    // 缩放/平移后按新的可见范围重新抽稀
+    connect(m_chartView, &InteractiveChartView::viewportChanged,
+            this, &MeasurementChartWidget::scheduleRefresh);
+
+    // 曲线刷新节流定时器：新数据只写入历史存储，由定时器统一推送到曲线
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout,
+            this, &MeasurementChartWidget::refreshSeries);
+}
+
+void MeasurementChartWidget::setUseOpenGL(bool enable)
+{
+    if (m_series)
+    {
+        m_series->setUseOpenGL(enable);
+    }
+    for (QLineSeries *series : m_channelSeries)
+    {
+        if (series)
+        {
+            series->setUseOpenGL(enable);
+        }
+    }
+}
+
+bool MeasurementChartWidget::useOpenGL() const
+{
+    return m_series && m_series->useOpenGL();
 }
 
 void MeasurementChartWidget::appendMeasurement(const Measurement &measurement)
+{
+    appendMeasurements(QVector<Measurement>(1, measurement));
+}
+
+void MeasurementChartWidget::appendMeasurements(const QVector<Measurement> &measurements)
 {
     if (!m_series || !m_axisX || !m_axisY || !m_avgTextItem)
         return;
 
-    // 1. 更新测量次数和累加电流值
-    m_measurementCount++;
-    double yValue = measurement.displayNumber();
-    m_totalCurrentSum += yValue;
-
-    // 2. 计算平均值
-    double avgValue = m_totalCurrentSum / m_measurementCount;
+    if (measurements.isEmpty())
+        return;
 
-    // 3. 添加数据点
-    m_series->append(static_cast<double>(m_measurementCount), yValue);
+    // 1. 更新测量次数和累加电流值，数据只写入历史存储，不直接触碰曲线
+    //    带通道码的样本按通道存储，测量次数和平均值只统计主通道
+    //    主曲线样本同时保存到达时刻（读取边界处推算的单调时间），供悬停和区间标定显示时间
+    double yValue = 0.0;
+    for (const Measurement &measurement : measurements)
+    {
+        yValue = measurement.displayNumber();
+        const int slot = MultiChannelHistory::slotOf(measurement.channel);
+        if (slot >= 0)
+        {
+            m_channelHistory.append(slot, yValue);
+            if (slot != m_channelHistory.primarySlot())
+            {
+                continue;
+            }
+        }
+        else
+        {
+            m_history.append(yValue);
+        }
+        if (m_chartStartNs < 0)
+        {
+            m_chartStartNs = measurement.monotonicNs;
+        }
+        const qint64 index = primaryHistory().totalCount() - 1;
+        m_sampleTimesNs[static_cast<int>(index % m_sampleTimesNs.size())] = measurement.monotonicNs;
+        m_measurementCount++;
+        m_totalCurrentSum += yValue;
+    }
 
-    // 更新单位显示
-    m_axisY->setTitleText(QString("Current (%1)").arg(measurement.unit()));
+    m_lastValue = yValue;
+    m_lastUnit = measurements.last().unit();
+    m_axesDirty = true;
 
-    // 4. 动态调整X轴范围
-    if (m_measurementCount > m_axisX->max())
+    // 长时间运行时曲线只保留最近的样本（内存固定），覆盖开始时提示一次，完整数据以测量记录为准
+    if (!m_historyWrapped && primaryHistory().totalCount() > primaryHistory().capacity())
     {
-        m_axisX->setRange(0.0, m_measurementCount + 20);
+        m_historyWrapped = true;
+        emit logMessage(tr("曲线历史已满 %1 个样本，此后只显示最近的样本").arg(primaryHistory().capacity()));
     }
-    else
+
+    // 2. 由节流定时器统一刷新曲线、坐标轴和平均值
+    scheduleRefresh();
+
+    // 3. 发射信号
+    emit measurementAdded(m_measurementCount, yValue);
+}
+
+void MeasurementChartWidget::scheduleRefresh()
+{
+    if (m_refreshTimer && !m_refreshTimer->isActive())
     {
-        m_axisX->setRange(0.0, qMax(100.0, static_cast<double>(m_measurementCount)));
+        m_refreshTimer->start();
     }
+}
 
-    // 5. 动态调整Y轴范围
-    double axisYMax = yValue * 1.2;
-    if (axisYMax < 1.0)
-        axisYMax = 1.0;
-    m_axisY->setRange(0.0, axisYMax);
+void MeasurementChartWidget::refreshSeries()
+{
+    if (!m_series || !m_axisX || !m_axisY || !m_avgTextItem)
+        return;
 
-    // 6. 更新平均值显示
-    QString avgText = QString("Avg: %1 %2")
-                          .arg(avgValue, 0, 'f', 3)
-                          .arg(measurement.unit());
-    m_avgTextItem->setText(avgText);
+    // 1. 有新数据时更新坐标轴和平均值（与逐点添加时的规则一致，以最新测量值为准）
+    if (m_axesDirty)
+    {
+        m_axesDirty = false;
+
+        // 更新单位显示
+        m_axisY->setTitleText(QString("Current (%1)").arg(m_lastUnit));
+
+        // 动态调整X轴范围
+        if (m_measurementCount > m_axisX->max())
+        {
+            m_axisX->setRange(0.0, m_measurementCount + 20);
+        }
+        else
+        {
+            m_axisX->setRange(0.0, qMax(100.0, static_cast<double>(m_measurementCount)));
+        }
 
-    // 7. 调整平均值文本位置
-    QRectF plotArea = m_chart->plotArea();
-    qreal textWidth = m_avgTextItem->boundingRect().width();
-    m_avgTextItem->setPos(plotArea.right() - textWidth - 10,
-                          plotArea.top() + 10);
+        // 动态调整Y轴范围（多通道时以各通道最新值中的最大值为准）
+        double latestMax = m_lastValue;
+        for (int slot = 0; slot < MultiChannelHistory::kChannelCount; ++slot)
+        {
+            if (m_channelHistory.hasChannel(slot))
+            {
+                latestMax = qMax(latestMax, m_channelHistory.lastValue(slot));
+            }
+        }
+        double axisYMax = latestMax * 1.2;
+        if (axisYMax < 1.0)
+            axisYMax = 1.0;
+        m_axisY->setRange(0.0, axisYMax);
+
+        // 更新平均值显示
+        double avgValue = (m_measurementCount > 0) ? (m_totalCurrentSum / m_measurementCount) : 0.0;
+        QString avgText = QString("Avg: %1 %2")
+                              .arg(avgValue, 0, 'f', 3)
+                              .arg(m_lastUnit);
+        m_avgTextItem->setText(avgText);
+
+        // 调整平均值文本位置
+        QRectF plotArea = m_chart->plotArea();
+        qreal textWidth = m_avgTextItem->boundingRect().width();
+        m_avgTextItem->setPos(plotArea.right() - textWidth - 10,
+                              plotArea.top() + 10);
+    }
 
-    // 8. 控制点数
-    const int maxPoints = 2000;
-    if (m_series->count() > maxPoints)
+    // 2. 按可见范围和绘图区宽度抽稀，一次性替换曲线数据
+    //    X 坐标为测量次数（样本序号+1），多取一个点保证曲线延伸到边界
+    qint64 first = static_cast<qint64>(qFloor(m_axisX->min())) - 2;
+    qint64 last = static_cast<qint64>(qCeil(m_axisX->max()));
+    int buckets = qMax(1, static_cast<int>(m_chart->plotArea().width()));
+    primaryHistory().decimateMinMax(first, last, buckets, m_renderPoints);
+    m_series->replace(m_renderPoints);
+
+    //    其他通道按首次出现的扫描序号平移到同一 X 轴
+    const int primarySlot = m_channelHistory.primarySlot();
+    if (primarySlot >= 0)
     {
-        m_series->removePoints(0, m_series->count() - maxPoints);
+        m_series->setName(QString("CH%1").arg(primarySlot + 1));
     }
+    for (int slot = 0; slot < MultiChannelHistory::kChannelCount; ++slot)
+    {
+        if (slot == primarySlot || !m_channelHistory.hasChannel(slot))
+            continue;
 
-    // 9. 更新标定竖线位置
-    updateMarkerLines();
+        const qint64 offset = m_channelHistory.offset(slot);
+        m_channelHistory.channel(slot).decimateMinMax(first - offset, last - offset, buckets,
+                                                      m_renderPoints, offset);
+        channelSeries(slot)->replace(m_renderPoints);
+    }
 
-    // 10. 发射信号
-    emit measurementAdded(m_measurementCount, yValue);
+    // 3. 更新标定竖线位置
+    updateMarkerLines();
 }
 
 void MeasurementChartWidget::resetChart()
@@ -197,6 +330,14 @@ void MeasurementChartWidget::resetChart()
 
     // 1. 清空曲线数据
     m_series->clear();
+    m_history.clear();
+    clearChannels();
+    m_renderPoints.clear();
+    m_axesDirty = false;
+    if (m_refreshTimer)
+    {
+        m_refreshTimer->stop();
+    }
 
     // 2. 重置计数器
     m_measurementCount = 0;
@@ -233,8 +374,9 @@ void MeasurementChartWidget::resetChart()
     }
     m_markerLines.clear();
 
-    // 7. 重置起始时间
-    m_chartStartMs = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    // 7. 重置起始时刻（下一个样本到达时重新记录）
+    m_chartStartNs = -1;
+    m_historyWrapped = false;
 
     // 8. 发射信号
     emit chartReset();
@@ -246,8 +388,18 @@ void MeasurementChartWidget::clearData()
         return;
 
     m_series->clear();
+    m_history.clear();
+    clearChannels();
+    m_renderPoints.clear();
+    m_axesDirty = false;
+    if (m_refreshTimer)
+    {
+        m_refreshTimer->stop();
+    }
     m_measurementCount = 0;
     m_totalCurrentSum = 0.0;
+    m_chartStartNs = -1;
+    m_historyWrapped = false;
 
     if (m_avgTextItem)
     {
@@ -285,6 +437,58 @@ QPair<int, int> MeasurementChartWidget::markedRange() const
     return qMakePair(-1, -1);
 }
 
+RangeStats MeasurementChartWidget::markedRangeStats() const
+{
+    const QPair<int, int> range = markedRange();
+    if (range.first < 0)
+    {
+        return RangeStats();
+    }
+    return primaryHistory().rangeStats(range.first, range.second);
+}
+
+const SampleHistory &MeasurementChartWidget::primaryHistory() const
+{
+    const int slot = m_channelHistory.primarySlot();
+    return slot >= 0 ? m_channelHistory.channel(slot) : m_history;
+}
+
+double MeasurementChartWidget::sampleTimeMs(qint64 index) const
+{
+    const qint64 timeNs = m_sampleTimesNs.at(static_cast<int>(index % m_sampleTimesNs.size()));
+    return (timeNs - m_chartStartNs) / 1.0e6;
+}
+
+QLineSeries *MeasurementChartWidget::channelSeries(int slot)
+{
+    if (!m_channelSeries[slot])
+    {
+        QLineSeries *series = new QLineSeries();
+        series->setName(QString("CH%1").arg(slot + 1));
+        series->setUseOpenGL(m_series->useOpenGL());
+        m_chart->addSeries(series);
+        series->attachAxis(m_axisX);
+        series->attachAxis(m_axisY);
+        m_channelSeries[slot] = series;
+    }
+    return m_channelSeries[slot];
+}
+
+void MeasurementChartWidget::clearChannels()
+{
+    m_channelHistory.clear();
+    m_series->setName(QString());
+    for (QLineSeries *&series : m_channelSeries)
+    {
+        if (series)
+        {
+            m_chart->removeSeries(series);
+            delete series;
+            series = nullptr;
+        }
+    }
+}
+
 void MeasurementChartWidget::onSeriesHovered(const QPointF &point, bool state)
 {
     if (!m_tooltipItem || !m_crosshairLine)
@@ -295,18 +499,20 @@ void MeasurementChartWidget::onSeriesHovered(const QPointF &point, bool state)
         // 计算最近的整数索引
         int index = qRound(point.x()) - 1;
 
-        // 边界检查
-        if (index < 0 || index >= m_series->count())
+        // 边界检查（曲线上的点是抽稀后的结果，真实数据从历史存储读取）
+        const SampleHistory &history = primaryHistory();
+        if (!history.contains(index))
         {
             return;
         }
 
         // 获取真实数据点
-        QPointF actualPoint = m_series->at(index);
+        QPointF actualPoint(static_cast<double>(index + 1), history.at(index));
 
         // 更新提示文本
-        QString tooltipText = QString("Count: %1\nCurrent: %2")
+        QString tooltipText = QString("Count: %1\nTime: %2 s\nCurrent: %3")
                                   .arg((int)actualPoint.x())
+                                  .arg(sampleTimeMs(index) / 1000.0, 0, 'f', 3)
                                   .arg(actualPoint.y(), 0, 'f', 3);
         m_tooltipItem->setText(tooltipText);
         m_tooltipItem->setVisible(true);
@@ -353,6 +559,46 @@ void MeasurementChartWidget::onResetButtonClicked()
     resetChart();
 }
 
+void MeasurementChartWidget::onReplayButtonClicked()
+{
+    QString filePath = QFileDialog::getOpenFileName(this,
+                                                    tr("选择测量记录"),
+                                                    MeasurementRecorder::defaultDirectory(),
+                                                    tr("测量记录 (*.pcbarec);;所有文件 (*)"));
+    if (!filePath.isEmpty())
+    {
+        replayRecording(filePath);
+    }
+}
+
+bool MeasurementChartWidget::replayRecording(const QString &filePath)
+{
+    MeasurementRecordingReader reader;
+    QString errorString;
+    if (!reader.open(filePath, &errorString))
+    {
+        emit logMessage(tr("打开测量记录失败: %1").arg(errorString));
+        return false;
+    }
+
+    resetChart();
+
+    // 记录直接从映射区分批转换，超过历史容量时只载入最新的样本
+    constexpr qint64 kChunk = 64 * 1024;
+    const qint64 first = qMax<qint64>(0, reader.count() - m_history.capacity());
+    QVector<Measurement> chunk;
+    for (qint64 begin = first; begin < reader.count(); begin += kChunk)
+    {
+        reader.readMeasurements(begin, qMin(begin + kChunk, reader.count()), chunk);
+        appendMeasurements(chunk);
+    }
+
+    emit logMessage(tr("已回放测量记录: %1 (%2, %3 条)")
+                    .arg(filePath, reader.portName())
+                    .arg(reader.count() - first));
+    return true;
+}
+
 void MeasurementChartWidget::onChartRightClicked(const QPointF &point)
 {
     if (!m_series || !m_chart)
@@ -362,7 +608,7 @@ void MeasurementChartWidget::onChartRightClicked(const QPointF &point)
     int index = qRound(point.x()) - 1;
 
     // 2. 边界检查
-    if (index < 0 || index >= m_series->count())
+    if (!primaryHistory().contains(index))
     {
         return;
     }
@@ -418,19 +664,7 @@ void MeasurementChartWidget::onChartRightClicked(const QPointF &point)
         int startIndex = qMin(m_markedIndices[0], m_markedIndices[1]);
         int endIndex = qMax(m_markedIndices[0], m_markedIndices[1]);
 
-        double sum = 0.0;
-        int count = 0;
-        for (int i = startIndex; i <= endIndex; ++i)
-        {
-            if (i >= 0 && i < m_series->count())
-            {
-                sum += m_series->at(i).y();
-                count++;
-            }
-        }
-        double avgValue = (count > 0) ? (sum / count) : 0.0;
-
-        emit rangeMarked(startIndex, endIndex, avgValue);
+        emit rangeMarked(startIndex, endIndex, markedRangeStats().mean);
     }
 }
 
@@ -442,15 +676,16 @@ void MeasurementChartWidget::updateMarkerLines()
     for (int i = 0; i < m_markedIndices.size() && i < m_markerLines.size(); ++i)
     {
         int index = m_markedIndices[i];
+        const SampleHistory &history = primaryHistory();
 
-        if (index < 0 || index >= m_series->count())
+        if (!history.contains(index))
             continue;
 
         QGraphicsLineItem *markerLine = m_markerLines[i];
         if (!markerLine)
             continue;
 
-        QPointF actualPoint = m_series->at(index);
+        QPointF actualPoint(static_cast<double>(index + 1), history.at(index));
         QPointF chartPoint = m_chart->mapToPosition(actualPoint, m_series);
         QRectF plotArea = m_chart->plotArea();
 
@@ -468,23 +703,8 @@ void MeasurementChartWidget::updateAverageDisplay()
 
     if (m_markedIndices.size() == 2)
     {
-        // 计算区间平均值
-        int startIndex = qMin(m_markedIndices[0], m_markedIndices[1]);
-        int endIndex = qMax(m_markedIndices[0], m_markedIndices[1]);
-
-        double sum = 0.0;
-        int count = 0;
-
-        for (int i = startIndex; i <= endIndex; ++i)
-        {
-            if (i >= 0 && i < m_series->count())
-            {
-                sum += m_series->at(i).y();
-                count++;
-            }
-        }
-
-        double rangeAvg = (count > 0) ? (sum / count) : 0.0;
+        // 区间统计走历史索引，与区间长度无关
+        const RangeStats stats = markedRangeStats();
 
         // 获取单位
         QString unit = "";
@@ -496,9 +716,18 @@ void MeasurementChartWidget::updateAverageDisplay()
             unit = yTitle.mid(startPos + 1, endPos - startPos - 1);
         }
 
-        avgText = QString("Range Avg: %1 %2")
-                      .arg(rangeAvg, 0, 'f', 3)
-                      .arg(unit);
+        // 区间时长按两端样本的到达时刻计算，与采样是否均匀无关
+        const QPair<int, int> range = markedRange();
+        const double durationMs = sampleTimeMs(range.second) - sampleTimeMs(range.first);
+
+        avgText = QString("Range Avg: %1 %2  σ: %3  Min: %4  Max: %5  N: %6  Δt: %7 ms")
+                      .arg(stats.mean, 0, 'f', 3)
+                      .arg(unit)
+                      .arg(stats.stdDev(), 0, 'f', 3)
+                      .arg(stats.min, 0, 'f', 3)
+                      .arg(stats.max, 0, 'f', 3)
+                      .arg(stats.count)
+                      .arg(durationMs, 0, 'f', 1);
     }
     else
     {
@@ -531,4 +760,8 @@ void MeasurementChartWidget::resizeEvent(QResizeEvent *event)
     {
         m_resetButton->move(this->width() - m_resetButton->width() - 10, 10);
     }
+    if (m_replayButton && m_resetButton)
+    {
+        m_replayButton->move(m_resetButton->x() - m_replayButton->width() - 10, 10);
+    }
 }
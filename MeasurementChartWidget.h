@@ -10,7 +10,10 @@
 #include <QGraphicsLineItem>
 #include <QPushButton>
 #include <QVector>
+#include <QTimer>
 #include "domain/Measurement.h"
+#include "domain/SampleHistory.h"
+#include "domain/MultiChannelHistory.h"
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -22,7 +25,8 @@ class InteractiveChartView;
  * 独立的图表组件，用于显示电流测量数据曲线。
  * 
  * 功能：
- * - 实时显示测量数据曲线
+ * - 实时显示测量数据曲线（数据保存在环形历史存储中，按绘图宽度抽稀后节流刷新）
+ * - 多通道扫描数据按通道分别保存和绘制，各通道曲线共用同一抽稀路径和扫描时间基准
  * - 支持鼠标悬停查看数据点
  * - 支持右键标定两个点并计算区间平均值
  * - 支持重置曲线数据
@@ -50,6 +54,37 @@ public:
      */
     void appendMeasurement(const Measurement &measurement);
 
+    /**
+     * @brief 批量添加测量数据点到曲线
+     * @param measurements 一次串口读取解码出的全部测量数据
+     *
+     * 坐标轴、平均值文本和标定线每批只刷新一次
+     */
+    void appendMeasurements(const QVector<Measurement> &measurements);
+
+    /**
+     * @brief 回放测量记录文件（清空当前曲线后一次性载入）
+     * @param filePath 记录文件路径（MeasurementRecorder 生成）
+     * @return true 成功
+     *
+     * 记录超过历史容量时只载入最新的样本。
+     */
+    bool replayRecording(const QString &filePath);
+
+    /**
+     * @brief 启用/禁用曲线的 OpenGL 加速渲染
+     * @param enable 是否启用
+     *
+     * 启用后曲线由 OpenGL 绘制，长时间数据的刷新开销更低；
+     * 部分平台（如远程桌面）不支持 OpenGL，默认关闭。
+     */
+    void setUseOpenGL(bool enable);
+
+    /**
+     * @brief 是否启用了 OpenGL 加速渲染
+     */
+    bool useOpenGL() const;
+
     /**
      * @brief 重置图表（清空数据和标定点）
      */
@@ -80,10 +115,16 @@ public:
 
     /**
      * @brief 获取标定范围
-     * @return 标定点索引对（起始，结束），无标定返回(-1, -1)
+     * @return 标定点样本序号对（起始，结束），无标定返回(-1, -1)
      */
     QPair<int, int> markedRange() const;
 
+    /**
+     * @brief 获取标定范围的统计（均值、标准差、最小值、最大值、样本数）
+     * @return 区间内仍在历史存储中的样本的统计，无标定时 isEmpty()
+     */
+    RangeStats markedRangeStats() const;
+
 signals:
     /**
      * @brief 日志消息信号（替代直接调用外部日志函数）
@@ -92,9 +133,9 @@ signals:
     void logMessage(const QString &message);
 
     /**
-     * @brief 测量数据添加后发射
+     * @brief 测量数据添加后发射（批量添加时每批发射一次）
      * @param count 当前测量次数
-     * @param value 测量值
+     * @param value 测量值（批量添加时为批内最后一个值）
      */
     void measurementAdded(qint64 count, double value);
 
@@ -124,6 +165,11 @@ private slots:
      */
     void onResetButtonClicked();
 
+    /**
+     * @brief 处理回放按钮点击（选择记录文件并回放）
+     */
+    void onReplayButtonClicked();
+
     /**
      * @brief 处理图表上的右键点击事件
      * @param point 点击点的坐标（数值坐标）
@@ -135,6 +181,16 @@ private slots:
      */
     void updateMarkerLines();
 
+    /**
+     * @brief 请求刷新曲线（节流：定时器未启动时才启动）
+     */
+    void scheduleRefresh();
+
+    /**
+     * @brief 将历史存储按可见范围抽稀后推送到曲线，并更新坐标轴和平均值
+     */
+    void refreshSeries();
+
 private:
     /**
      * @brief 初始化图表组件
@@ -146,12 +202,38 @@ private:
      */
     void updateAverageDisplay();
 
+    /**
+     * @brief 主曲线的样本历史（有多通道数据时为主通道，否则为未区分通道的历史）
+     *
+     * 标定、悬停和区间统计都以主曲线为准。
+     */
+    const SampleHistory &primaryHistory() const;
+
+    /**
+     * @brief 主曲线样本相对图表起始时刻的时间（ms，调用方保证 primaryHistory().contains(index)）
+     */
+    double sampleTimeMs(qint64 index) const;
+
+    /**
+     * @brief 获取通道曲线（首次使用时创建并加入图表）
+     * @param slot 通道槽位（见 MultiChannelHistory::slotOf）
+     */
+    QLineSeries *channelSeries(int slot);
+
+    /**
+     * @brief 清空多通道数据并移除通道曲线
+     */
+    void clearChannels();
+
     /**
      * @brief 重写尺寸改变事件，动态调整重置按钮位置
      */
     void resizeEvent(QResizeEvent *event) override;
 
 private:
+    static constexpr int kHistoryCapacity = 2 * 1024 * 1024;   ///< 历史样本容量（约8MB）
+    static constexpr int kRefreshIntervalMs = 33;              ///< 曲线刷新间隔（约30帧/秒）
+
     // 图表核心组件
     QChart *m_chart = nullptr;                     ///< 图表对象
     InteractiveChartView *m_chartView = nullptr;   ///< 图表视图（支持交互）
@@ -166,11 +248,24 @@ private:
 
     // 控件
     QPushButton *m_resetButton = nullptr;               ///< 重置按钮
+    QPushButton *m_replayButton = nullptr;              ///< 回放记录按钮
 
     // 统计数据
     qint64 m_measurementCount = 0;                      ///< 测量次数计数器
     double m_totalCurrentSum = 0.0;                     ///< 电流值总和
-    qint64 m_chartStartMs = 0;                          ///< 图表起始时间（ms）
+    qint64 m_chartStartNs = -1;                         ///< 图表起始时刻（首个主曲线样本的到达时刻，ns；-1 表示尚无样本）
+
+    // 数据存储与刷新
+    SampleHistory m_history;                            ///< 测量样本历史（环形存储，未区分通道的样本）
+    QVector<qint64> m_sampleTimesNs;                    ///< 主曲线各样本的到达时刻（与主曲线历史同容量、按序号取模，约16MB）
+    MultiChannelHistory m_channelHistory;               ///< 多通道样本历史（按通道分别存储）
+    QLineSeries *m_channelSeries[MultiChannelHistory::kChannelCount] = {};  ///< 非主通道的曲线（按需创建）
+    QVector<QPointF> m_renderPoints;                    ///< 抽稀后的绘图点（复用）
+    QTimer *m_refreshTimer = nullptr;                   ///< 曲线刷新节流定时器
+    bool m_axesDirty = false;                           ///< 是否有新数据待刷新坐标轴
+    bool m_historyWrapped = false;                      ///< 主曲线历史是否已写满并开始覆盖最早的样本
+    double m_lastValue = 0.0;                           ///< 最新测量值
+    QString m_lastUnit;                                 ///< 最新测量值单位
 
     // 标定点相关
     QVector<int> m_markedIndices;                       ///< 标定点索引（最多2个）
@@ -0,0 +1,219 @@
+#include "OtaBatchManager.h"
+#include "OtaController.h"
+#include "protocol/BaudRate.h"
+
+OtaBatchManager::OtaBatchManager(QObject *parent)
+    : QObject(parent)
+    , m_finishedCount(0)
+    , m_batchId(0)
+    , m_resumeEnabled(true)
+    , m_deltaEnabled(true)
+    , m_maxBaudRate(BaudRate::kDefaultMax)
+{
+    qRegisterMetaType<OtaFirmwareImage>("OtaFirmwareImage");
+}
+
+OtaBatchManager::~OtaBatchManager()
+{
+    releaseWorkers();
+}
+
+bool OtaBatchManager::loadFirmware(const QString &filePath)
+{
+    if (isRunning()) {
+        emit logMessage(tr("批量升级正在进行中，无法更换固件"));
+        return false;
+    }
+
+    QString error;
+    if (!OtaFirmwareImage::load(filePath, m_image, &error)) {
+        emit logMessage(error);
+        return false;
+    }
+
+    emit logMessage(tr("固件加载成功: %1 (%2 字节, CRC32=0x%3)")
+                    .arg(filePath)
+                    .arg(m_image.size())
+                    .arg(m_image.crc32, 8, 16, QChar('0')));
+    return true;
+}
+
+int OtaBatchManager::start(const QStringList &portNames)
+{
+    if (isRunning()) {
+        emit logMessage(tr("批量升级正在进行中，请等待完成"));
+        return 0;
+    }
+    if (!m_image.isValid()) {
+        emit logMessage(tr("请先加载固件文件"));
+        return 0;
+    }
+    if (portNames.isEmpty()) {
+        return 0;
+    }
+
+    // 释放上一批的控制器和线程
+    releaseWorkers();
+    ++m_batchId;
+    m_finishedCount = 0;
+
+    // 先登记全部串口，启动失败的串口立即记为结束时不会提前判定整批完成
+    m_results.clear();
+    for (const QString &portName : portNames) {
+        PortResult result;
+        result.portName = portName;
+        result.percent = 0;
+        result.finished = false;
+        result.success = false;
+        m_results.append(result);
+    }
+
+    const int threadCount = qMin(portNames.size(), qMax(1, QThread::idealThreadCount()));
+    for (int i = 0; i < threadCount; ++i) {
+        QThread *thread = new QThread();
+        thread->setObjectName(QStringLiteral("OtaWorker%1").arg(i));
+        thread->start();
+        m_threads.append(thread);
+    }
+
+    int started = 0;
+    for (int i = 0; i < portNames.size(); ++i) {
+        OtaController *controller = createController(i);
+
+        // 控制器连同其串口和定时器移入工作线程，线程结束时在该线程内销毁
+        QThread *thread = m_threads.at(i % threadCount);
+        controller->moveToThread(thread);
+        connect(thread, &QThread::finished, controller, &QObject::deleteLater);
+        m_controllers.append(controller);
+
+        // 阻塞等待工作线程打开串口并发出握手（与 SerialPortService::openPort 相同）
+        bool ok = false;
+        QMetaObject::invokeMethod(controller, "startUpgrade", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(bool, ok),
+                                  Q_ARG(QString, portNames.at(i)),
+                                  Q_ARG(OtaFirmwareImage, m_image));
+        if (ok) {
+            ++started;
+        } else {
+            markFinished(i, false, tr("无法连接 Bootloader: %1").arg(portNames.at(i)));
+        }
+    }
+
+    emit logMessage(tr("批量升级已启动: %1/%2 个串口，%3 个工作线程")
+                    .arg(started).arg(portNames.size()).arg(threadCount));
+    emit progressChanged(overallPercent());
+    return started;
+}
+
+void OtaBatchManager::cancel()
+{
+    for (int i = 0; i < m_controllers.size(); ++i) {
+        if (i < m_results.size() && !m_results.at(i).finished) {
+            // 取消时控制器发射 upgradeFinished，按失败记入结果
+            QMetaObject::invokeMethod(m_controllers.at(i), "cancelUpgrade", Qt::BlockingQueuedConnection);
+        }
+    }
+}
+
+bool OtaBatchManager::isRunning() const
+{
+    return m_finishedCount < m_results.size();
+}
+
+int OtaBatchManager::overallPercent() const
+{
+    if (m_results.isEmpty()) {
+        return 0;
+    }
+
+    int sum = 0;
+    for (const PortResult &result : m_results) {
+        sum += result.finished ? 100 : result.percent;
+    }
+    return sum / m_results.size();
+}
+
+OtaController *OtaBatchManager::createController(int index)
+{
+    OtaController *controller = new OtaController();
+    controller->setResumeEnabled(m_resumeEnabled);
+    controller->setDeltaEnabled(m_deltaEnabled);
+    controller->setMaxBaudRate(m_maxBaudRate);
+
+    // 信号在工作线程中发射，以队列方式回到本线程；批次号不符的是上一批残留的信号
+    const quint32 batchId = m_batchId;
+    connect(controller, &OtaController::logMessage,
+            this, [this, index, batchId](const QString &message) {
+        if (batchId == m_batchId) {
+            emit portLogMessage(index, message);
+        }
+    });
+    connect(controller, &OtaController::progressChanged,
+            this, [this, index, batchId](int percent) {
+        if (batchId != m_batchId || m_results.at(index).finished) {
+            return;
+        }
+        m_results[index].percent = percent;
+        emit portProgressChanged(index, percent);
+        emit progressChanged(overallPercent());
+    });
+    connect(controller, &OtaController::upgradeFinished,
+            this, [this, index, batchId](bool success, const QString &message) {
+        if (batchId == m_batchId) {
+            markFinished(index, success, message);
+        }
+    });
+
+    return controller;
+}
+
+void OtaBatchManager::markFinished(int index, bool success, const QString &message)
+{
+    PortResult &result = m_results[index];
+    if (result.finished) {
+        return;
+    }
+
+    result.finished = true;
+    result.success = success;
+    result.message = message;
+    if (success) {
+        result.percent = 100;
+    }
+    ++m_finishedCount;
+
+    emit portFinished(index, success, message);
+    emit progressChanged(overallPercent());
+
+    if (m_finishedCount == m_results.size()) {
+        int succeeded = 0;
+        for (const PortResult &item : m_results) {
+            if (item.success) {
+                ++succeeded;
+            }
+        }
+        emit logMessage(tr("批量升级完成: 成功 %1/%2").arg(succeeded).arg(m_results.size()));
+        emit batchFinished(succeeded, m_results.size());
+    }
+}
+
+void OtaBatchManager::releaseWorkers()
+{
+    // 先断开信号，取消和销毁过程中不再回调
+    for (OtaController *controller : m_controllers) {
+        controller->disconnect(this);
+        QMetaObject::invokeMethod(controller, "cancelUpgrade", Qt::BlockingQueuedConnection);
+    }
+    m_controllers.clear();
+
+    // 线程退出时销毁其中的控制器（关闭串口）
+    for (QThread *thread : m_threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    m_threads.clear();
+
+    m_results.clear();
+    m_finishedCount = 0;
+}
@@ -0,0 +1,173 @@
+#ifndef OTABATCHMANAGER_H
+#define OTABATCHMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include "OtaFirmwareImage.h"
+
+class OtaController;
+
+/**
+ * @brief 多板并行 OTA 升级管理器
+ *
+ * 职责：
+ * - 固件文件只加载、校验一次，作为共享只读镜像交给每个串口的 OtaController
+ * - 每个选中的串口一个 OtaController 状态机，分布在若干工作线程中并行升级，互不阻塞
+ * - 汇总所有串口的进度，并逐个报告每个串口的升级结果
+ *
+ * 工作线程数不超过 CPU 核数，串口多于线程时多个控制器共用一个线程的事件循环
+ * （升级过程以串口和定时器事件驱动，单个线程足以同时推进多块板）。
+ * 各控制器按固件 CRC32 和协商的包大小映射同一个帧缓存文件（见 OtaFrameCache）。
+ *
+ * 设备应已处于 Bootloader 模式（与单板升级“串口未打开”时的流程相同）。
+ */
+class OtaBatchManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 单个串口的升级结果
+     */
+    struct PortResult {
+        QString portName;       ///< 串口名称
+        int percent;            ///< 当前进度（0-100）
+        bool finished;          ///< 是否已结束
+        bool success;           ///< 是否升级成功（finished 时有效）
+        QString message;        ///< 结果消息
+    };
+
+    explicit OtaBatchManager(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数（取消进行中的升级并结束工作线程）
+     */
+    ~OtaBatchManager() override;
+
+    /**
+     * @brief 加载固件文件（整批共用）
+     * @param filePath 固件文件路径 (.bin)
+     * @return true 成功
+     */
+    bool loadFirmware(const QString &filePath);
+
+    /**
+     * @brief 已加载的固件镜像
+     */
+    const OtaFirmwareImage &firmware() const { return m_image; }
+
+    /**
+     * @brief 在所有串口上同时开始升级
+     * @param portNames 串口列表
+     * @return 成功启动的串口数（启动失败的串口直接记为失败）
+     */
+    int start(const QStringList &portNames);
+
+    /**
+     * @brief 取消所有进行中的升级
+     */
+    void cancel();
+
+    /**
+     * @brief 是否有串口正在升级
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 整批进度（已结束的串口按 100% 计）
+     */
+    int overallPercent() const;
+
+    /**
+     * @brief 各串口的升级结果
+     */
+    const QVector<PortResult> &results() const { return m_results; }
+
+    /**
+     * @brief 设置是否允许断点续传（之后启动的升级生效）
+     */
+    void setResumeEnabled(bool enabled) { m_resumeEnabled = enabled; }
+
+    /**
+     * @brief 设置是否允许差分升级（之后启动的升级生效）
+     */
+    void setDeltaEnabled(bool enabled) { m_deltaEnabled = enabled; }
+
+    /**
+     * @brief 设置升级时允许的最高波特率（之后启动的升级生效）
+     */
+    void setMaxBaudRate(int baudRate) { m_maxBaudRate = baudRate; }
+
+signals:
+    /**
+     * @brief 日志消息（整批）
+     * @param message 日志内容
+     */
+    void logMessage(const QString &message);
+
+    /**
+     * @brief 串口日志消息
+     * @param index 串口序号
+     * @param message 日志内容
+     */
+    void portLogMessage(int index, const QString &message);
+
+    /**
+     * @brief 串口进度更新
+     * @param index 串口序号
+     * @param percent 该串口的进度
+     */
+    void portProgressChanged(int index, int percent);
+
+    /**
+     * @brief 单个串口升级结束
+     * @param index 串口序号
+     * @param success 是否成功
+     * @param message 结果消息
+     */
+    void portFinished(int index, bool success, const QString &message);
+
+    /**
+     * @brief 整批进度更新
+     * @param percent 整批进度
+     */
+    void progressChanged(int percent);
+
+    /**
+     * @brief 所有串口均已结束
+     * @param succeeded 升级成功的串口数
+     * @param total 串口总数
+     */
+    void batchFinished(int succeeded, int total);
+
+private:
+    /**
+     * @brief 创建控制器并连接信号（控制器随后移入工作线程）
+     */
+    OtaController *createController(int index);
+
+    /**
+     * @brief 记录串口结束并检查整批是否完成
+     */
+    void markFinished(int index, bool success, const QString &message);
+
+    /**
+     * @brief 结束工作线程并释放控制器
+     */
+    void releaseWorkers();
+
+    OtaFirmwareImage m_image;                   ///< 共享的固件镜像
+    QVector<PortResult> m_results;              ///< 各串口的升级结果
+    QVector<OtaController *> m_controllers;     ///< 各串口的控制器（运行在工作线程中）
+    QVector<QThread *> m_threads;               ///< 工作线程
+    int m_finishedCount;                        ///< 已结束的串口数
+    quint32 m_batchId;                          ///< 批次号（丢弃上一批控制器残留的排队信号）
+    bool m_resumeEnabled;                       ///< 是否允许断点续传
+    bool m_deltaEnabled;                        ///< 是否允许差分升级
+    int m_maxBaudRate;                          ///< 允许的最高波特率
+};
+
+#endif // OTABATCHMANAGER_H
@@ -1,12 +1,25 @@
 #include "OtaController.h"
+#include "protocol/BaudRate.h"
 #include <QDebug>
 #include <QFileInfo>
 
 OtaController::OtaController(QObject *parent)
     : QObject(parent)
     , m_serialPort(new QSerialPort(this))
-    , m_currentPacket(0)
     , m_totalPackets(0)
+    , m_packetSize(OtaProtocol::PACKET_DATA_SIZE)
+    , m_windowSize(OtaProtocol::DEFAULT_WINDOW_SIZE)
+    , m_legacyHandshake(false)
+    , m_windowBase(0)
+    , m_ackedPackets(0)
+    , m_resendRound(0)
+    , m_resumeEnabled(true)
+    , m_deltaEnabled(true)
+    , m_resumeFrom(0)
+    , m_maxBaudRate(BaudRate::kDefaultMax)
+    , m_baudRate(BaudRate::kDefault)
+    , m_baudSwitchFailed(false)
+    , m_baudDelayPending(false)
     , m_state(Idle)
     , m_retryCount(0)
     , m_timeoutTimer(new QTimer(this))
@@ -35,20 +48,48 @@ bool OtaController::startUpgrade(const QString &portName, const QString &firmwar
     }
 
     // 加载固件文件
-    if (!loadFirmware(firmwarePath)) {
+    OtaFirmwareImage image;
+    QString error;
+    if (!OtaFirmwareImage::load(firmwarePath, image, &error)) {
+        emit logMessage(error);
         emit logMessage(tr("加载固件文件失败: %1").arg(firmwarePath));
         return false;
     }
 
+    return startUpgrade(portName, image);
+}
+
+bool OtaController::startUpgrade(const QString &portName, const OtaFirmwareImage &image)
+{
+    // 检查当前状态
+    if (isUpgrading()) {
+        emit logMessage(tr("升级正在进行中，请等待完成"));
+        return false;
+    }
+
+    if (!image.isValid()) {
+        emit logMessage(tr("固件镜像无效"));
+        return false;
+    }
+    applyFirmware(image);
+
     // 打开串口
     if (!openSerialPort(portName)) {
         emit logMessage(tr("打开串口失败: %1").arg(portName));
         return false;
     }
 
-    // 初始化状态
-    m_currentPacket = 0;
+    // 初始化状态（传输参数在握手响应中协商）
     m_retryCount = 0;
+    m_legacyHandshake = false;
+    m_windowSize = OtaProtocol::DEFAULT_WINDOW_SIZE;
+    m_windowBase = 0;
+    m_ackedPackets = 0;
+    m_resumeFrom = 0;
+    m_deltaBaseCrcs.clear();
+    m_fwInfo.flags = 0;
+    m_baudSwitchFailed = false;
+    m_baudDelayPending = false;
     m_rxBuffer.clear();
 
     // 发送握手
@@ -77,7 +118,8 @@ bool OtaController::openSerialPort(const QString &portName)
     }
 
     m_serialPort->setPortName(portName);
-    m_serialPort->setBaudRate(9600);          // Bootloader 使用 9600bps
+    m_baudRate = BaudRate::kDefault;
+    m_serialPort->setBaudRate(m_baudRate);    // Bootloader 上电以 9600bps 握手
     m_serialPort->setDataBits(QSerialPort::Data8);
     m_serialPort->setParity(QSerialPort::NoParity);
     m_serialPort->setStopBits(QSerialPort::OneStop);
@@ -88,7 +130,7 @@ bool OtaController::openSerialPort(const QString &portName)
         return false;
     }
 
-    emit logMessage(tr("OTA 串口已打开: %1 @ 9600bps").arg(portName));
+    emit logMessage(tr("OTA 串口已打开: %1 @ %2bps").arg(portName).arg(m_serialPort->baudRate()));
     return true;
 }
 
@@ -100,63 +142,41 @@ void OtaController::closeSerialPort()
     }
 }
 
-bool OtaController::loadFirmware(const QString &filePath)
+void OtaController::applyFirmware(const OtaFirmwareImage &image)
 {
-    QFile file(filePath);
-    
-    if (!file.exists()) {
-        emit logMessage(tr("固件文件不存在: %1").arg(filePath));
-        return false;
-    }
-
-    if (!file.open(QIODevice::ReadOnly)) {
-        emit logMessage(tr("无法打开固件文件: %1").arg(file.errorString()));
-        return false;
-    }
-
-    m_firmwareData = file.readAll();
-    file.close();
-
-    if (m_firmwareData.isEmpty()) {
-        emit logMessage(tr("固件文件为空"));
-        return false;
-    }
-
-    // 检查固件大小（APP 区最大约 54KB）
-    constexpr uint32_t APP_SIZE_MAX = 54 * 1024;
-    if (static_cast<uint32_t>(m_firmwareData.size()) > APP_SIZE_MAX) {
-        emit logMessage(tr("固件文件过大: %1 字节，最大允许 %2 字节")
-                        .arg(m_firmwareData.size())
-                        .arg(APP_SIZE_MAX));
-        return false;
-    }
+    m_firmwareData = image.data;
 
     // 填充固件信息
-    m_fwInfo.firmware_size = static_cast<uint32_t>(m_firmwareData.size());
-    m_fwInfo.firmware_crc32 = OtaProtocol::calculateCRC32(
-        reinterpret_cast<const uint8_t*>(m_firmwareData.constData()),
-        m_fwInfo.firmware_size);
-    m_fwInfo.packet_size = OtaProtocol::PACKET_DATA_SIZE;
-    m_fwInfo.packet_count = (m_fwInfo.firmware_size + OtaProtocol::PACKET_DATA_SIZE - 1) 
-                            / OtaProtocol::PACKET_DATA_SIZE;
+    m_fwInfo.firmware_size = image.size();
+    m_fwInfo.firmware_crc32 = image.crc32;
     m_fwInfo.version_major = 1;
     m_fwInfo.version_minor = 0;
     m_fwInfo.version_patch = 0;
-    m_fwInfo.reserved = 0;
+    m_fwInfo.flags = 0;
 
-    m_totalPackets = m_fwInfo.packet_count;
+    updatePacketLayout(OtaProtocol::PACKET_DATA_SIZE);
 
-    emit logMessage(tr("固件加载成功: %1 字节, %2 个数据包, CRC32=0x%3")
+    emit logMessage(tr("固件加载成功: %1 字节, CRC32=0x%2")
                     .arg(m_fwInfo.firmware_size)
-                    .arg(m_totalPackets)
                     .arg(m_fwInfo.firmware_crc32, 8, 16, QChar('0')));
+}
 
-    return true;
+void OtaController::updatePacketLayout(uint16_t packetSize)
+{
+    m_packetSize = packetSize;
+    m_fwInfo.packet_size = packetSize;
+    m_fwInfo.packet_count = static_cast<uint16_t>((m_fwInfo.firmware_size + packetSize - 1) / packetSize);
+    m_totalPackets = m_fwInfo.packet_count;
 }
 
 void OtaController::sendHandshake()
 {
-    QByteArray frame = OtaProtocol::buildHandshakeFrame();
+    // 携带期望的包大小和窗口；旧版 Bootloader 不识别时退回空数据区握手
+    QByteArray frame = m_legacyHandshake
+            ? OtaProtocol::buildHandshakeFrame()
+            : OtaProtocol::buildHandshakeFrame(OtaProtocol::DATA_MAX_LEN, OtaProtocol::MAX_WINDOW_SIZE,
+                                               OtaProtocol::FEATURE_RESUME | OtaProtocol::FEATURE_DELTA |
+                                               OtaProtocol::FEATURE_BAUD_SWITCH);
     m_serialPort->write(frame);
     m_serialPort->flush();
     
@@ -174,34 +194,188 @@ void OtaController::sendStartUpgrade()
     startTimeoutTimer(5000);  // 擦除 Flash 需要较长时间
 }
 
+void OtaController::planTransfer(const OtaProtocol::DeviceCaps &caps)
+{
+    m_resumeFrom = 0;
+    m_deltaBaseCrcs.clear();
+    m_fwInfo.flags = 0;
+
+    // 续传：设备上有同一固件未完成的升级
+    if (m_resumeEnabled && (caps.features & OtaProtocol::FEATURE_RESUME) &&
+        caps.resume_seq != OtaProtocol::RESUME_SEQ_NONE &&
+        caps.resume_crc32 == m_fwInfo.firmware_crc32 &&
+        caps.resume_seq < m_totalPackets) {
+        m_resumeFrom = static_cast<uint16_t>(caps.resume_seq + 1);
+        m_fwInfo.flags |= OtaProtocol::UPGRADE_FLAG_RESUME;
+        emit logMessage(tr("断点续传: 设备已提交 %1/%2 个数据包").arg(m_resumeFrom).arg(m_totalPackets));
+        return;
+    }
+
+    // 差分：已安装固件的逐包 CRC 可用（该固件曾在本机加载过）
+    if (m_deltaEnabled && (caps.features & OtaProtocol::FEATURE_DELTA) && caps.installed_crc32 != 0 &&
+        OtaFrameCache::loadPacketCrcs(caps.installed_crc32, m_packetSize, m_deltaBaseCrcs)) {
+        m_fwInfo.flags |= OtaProtocol::UPGRADE_FLAG_DELTA;
+        emit logMessage(tr("差分升级: 基准固件 CRC32=0x%1")
+                        .arg(caps.installed_crc32, 8, 16, QChar('0')));
+        return;
+    }
+
+    m_deltaBaseCrcs.clear();
+}
+
+bool OtaController::startBaudSwitch(const OtaProtocol::DeviceCaps &caps)
+{
+    if (m_baudSwitchFailed || m_baudRate != BaudRate::kDefault ||
+        !(caps.features & OtaProtocol::FEATURE_BAUD_SWITCH) || caps.baud_mask == 0) {
+        return false;
+    }
+
+    const int target = BaudRate::highestCommon(caps.baud_mask, m_maxBaudRate);
+    if (target <= m_baudRate) {
+        return false;
+    }
+
+    m_baudRate = target;
+    m_serialPort->write(OtaProtocol::buildSetBaudFrame(static_cast<uint8_t>(BaudRate::codeOf(target))));
+    m_serialPort->flush();
+
+    emit logMessage(tr("请求切换波特率到 %1bps...").arg(target));
+    setState(SwitchingBaud);
+    startTimeoutTimer(BaudRate::kQueryTimeoutMs);
+    return true;
+}
+
+void OtaController::revertBaudRate()
+{
+    emit logMessage(tr("波特率 %1bps 切换失败，退回 %2bps").arg(m_baudRate).arg(BaudRate::kDefault));
+    m_baudRate = BaudRate::kDefault;
+    m_serialPort->setBaudRate(m_baudRate);
+    m_serialPort->clear();
+    m_rxBuffer.clear();
+    m_baudSwitchFailed = true;
+
+    // 等待设备未收到新速率下的握手而自行退回，然后以 9600 重新握手
+    setState(Connecting);
+    m_baudDelayPending = true;
+    startTimeoutTimer(BaudRate::kRevertMs);
+}
+
+void OtaController::startDataTransfer()
+{
+    m_windowBase = 0;
+    m_ackedPackets = 0;
+    m_packetStates.fill(PacketPending, m_totalPackets);
+    m_packetRetries.fill(0, m_totalPackets);
+    m_packetRounds.fill(0, m_totalPackets);
+    m_resendRound = 0;
+
+    // 续传：已提交的包视为已确认
+    for (uint16_t seq = 0; seq < m_resumeFrom && seq < m_totalPackets; ++seq) {
+        m_packetStates[seq] = PacketAcked;
+        ++m_ackedPackets;
+    }
+
+    // 差分：内容未变化的包视为已确认
+    if (!m_deltaBaseCrcs.isEmpty()) {
+        const QVector<uint32_t> &crcs = m_frameCache.packetCrcs();
+        int compareCount = qMin(m_deltaBaseCrcs.size(), crcs.size());
+        uint16_t skipped = 0;
+        for (int seq = 0; seq < compareCount; ++seq) {
+            if (m_packetStates[seq] != PacketAcked && crcs[seq] == m_deltaBaseCrcs[seq]) {
+                m_packetStates[seq] = PacketAcked;
+                ++m_ackedPackets;
+                ++skipped;
+            }
+        }
+        emit logMessage(tr("差分升级: 跳过 %1/%2 个未变化的数据包").arg(skipped).arg(m_totalPackets));
+    }
+
+    while (m_windowBase < m_totalPackets && m_packetStates[m_windowBase] == PacketAcked) {
+        ++m_windowBase;
+    }
+    emit progressChanged(static_cast<int>(m_ackedPackets * 100 / m_totalPackets));
+
+    sendNextDataPacket();
+}
+
 void OtaController::sendNextDataPacket()
 {
-    if (m_currentPacket >= m_totalPackets) {
-        // 所有数据包发送完成，发送结束帧
+    if (m_windowBase >= m_totalPackets) {
+        // 所有数据包均已确认，发送结束帧
         setState(WaitingFinish);
         sendFinish();
         return;
     }
 
-    // 计算当前包的数据范围
-    uint32_t offset = m_currentPacket * OtaProtocol::PACKET_DATA_SIZE;
-    uint16_t dataLen = qMin(static_cast<uint32_t>(OtaProtocol::PACKET_DATA_SIZE),
-                            m_fwInfo.firmware_size - offset);
+    // 窗口内的新包和待重传包按序号顺序发送（设备按序写入 Flash）
+    // 窗口按未确认的包计数，差分跳过的包不占用窗口
+    int budget = m_windowSize;
+    for (uint32_t seq = m_windowBase; seq < m_totalPackets && budget > 0; ++seq) {
+        uint8_t state = m_packetStates[static_cast<int>(seq)];
+        if (state == PacketAcked) {
+            continue;
+        }
+        --budget;
+        if (state == PacketPending || state == PacketResend) {
+            sendDataPacket(static_cast<uint16_t>(seq));
+        }
+    }
 
-    // 构建并发送数据包
-    QByteArray frame = OtaProtocol::buildDataFrame(
-        m_currentPacket,
-        reinterpret_cast<const uint8_t*>(m_firmwareData.constData() + offset),
-        dataLen);
-    
-    m_serialPort->write(frame);
-    m_serialPort->flush();
+    // 超时从最近一次进展开始计时
+    startTimeoutTimer(2000);
+}
+
+void OtaController::sendDataPacket(uint16_t seq)
+{
+    // 帧已预先生成，直接发送缓存切片（不逐包 flush，窗口内的包由串口驱动连续发出）
+    m_serialPort->write(m_frameCache.frame(seq));
+    m_packetStates[seq] = PacketInFlight;
+    m_packetRounds[seq] = m_resendRound;
+}
+
+void OtaController::handleDataAck(uint16_t seq)
+{
+    if (seq < m_windowBase || seq >= m_totalPackets || m_packetStates[seq] == PacketAcked) {
+        // 重复或越界的确认
+        return;
+    }
+
+    m_packetStates[seq] = PacketAcked;
+    ++m_ackedPackets;
+
+    // 窗口起点前移到第一个未确认的包
+    while (m_windowBase < m_totalPackets && m_packetStates[m_windowBase] == PacketAcked) {
+        ++m_windowBase;
+    }
 
     // 更新进度
-    int percent = static_cast<int>((m_currentPacket + 1) * 100 / m_totalPackets);
-    emit progressChanged(percent);
+    emit progressChanged(static_cast<int>(m_ackedPackets * 100 / m_totalPackets));
+}
 
-    startTimeoutTimer(2000);
+bool OtaController::markForResend(uint16_t seq)
+{
+    if (seq >= m_totalPackets || m_packetStates[seq] != PacketInFlight) {
+        return true;
+    }
+
+    if (++m_packetRetries[seq] > MAX_RETRY) {
+        return false;
+    }
+
+    m_packetStates[seq] = PacketResend;
+    return true;
+}
+
+bool OtaController::startResendRound(uint32_t &failedSeq)
+{
+    ++m_resendRound;
+    for (uint32_t seq = m_windowBase; seq < m_totalPackets; ++seq) {
+        if (!markForResend(static_cast<uint16_t>(seq))) {
+            failedSeq = seq;
+            return false;
+        }
+    }
+    return true;
 }
 
 void OtaController::sendFinish()
@@ -268,6 +442,11 @@ void OtaController::onSerialDataReady()
         QByteArray frame = m_rxBuffer.left(frameLen);
         m_rxBuffer = m_rxBuffer.mid(frameLen);
 
+        // 切换波特率后的等待期间收到的帧来自切换前后的速率交叠，丢弃
+        if (m_baudDelayPending) {
+            continue;
+        }
+
         // 处理响应
         stopTimeoutTimer();
         processResponse(frame);
@@ -281,6 +460,52 @@ void OtaController::processResponse(const QByteArray &response)
     // 处理错误响应
     if (cmd == OtaProtocol::CMD_ERROR) {
         uint8_t errCode = OtaProtocol::parseErrorCode(response);
+
+        // 设备拒绝切换波特率：保持 9600 继续升级
+        if (m_state == SwitchingBaud) {
+            emit logMessage(tr("设备拒绝切换波特率，保持 %1bps").arg(BaudRate::kDefault));
+            m_baudRate = BaudRate::kDefault;
+            m_baudSwitchFailed = true;
+            m_retryCount = 0;
+            setState(StartingUpgrade);
+            sendStartUpgrade();
+            return;
+        }
+
+        // 新速率下握手出错：按切换失败处理
+        if (m_state == VerifyingBaud) {
+            revertBaudRate();
+            return;
+        }
+
+        // 旧版 Bootloader 不识别握手能力字段，改用空数据区握手重试
+        if (m_state == Connecting && !m_legacyHandshake &&
+            (errCode == OtaProtocol::ERR_FRAME_FORMAT || errCode == OtaProtocol::ERR_UNKNOWN)) {
+            emit logMessage(tr("设备不支持传输参数协商，使用默认参数握手"));
+            m_legacyHandshake = true;
+            sendHandshake();
+            return;
+        }
+
+        // 数据包序号或校验错误：设备按序接收，出错包前后尚未确认的在途包都会被丢弃，整窗重传。
+        // 窗口内在丢包之后发出的包各自还会引起一次 ERR_SEQ，它们属于上一轮，已随本轮重传，忽略
+        if (m_state == SendingData &&
+            (errCode == OtaProtocol::ERR_SEQ || errCode == OtaProtocol::ERR_CRC)) {
+            uint32_t seq = OtaProtocol::parseResponseSeq(response);
+            if (seq < m_totalPackets && m_packetRounds[static_cast<int>(seq)] != m_resendRound) {
+                // 收帧时已停止超时定时器，本轮重传仍在等待确认，重新计时
+                startTimeoutTimer(2000);
+                return;
+            }
+            uint32_t failedSeq = 0;
+            if (!startResendRound(failedSeq)) {
+                finishUpgrade(false, tr("数据包 %1 重传次数已用完").arg(failedSeq));
+                return;
+            }
+            sendNextDataPacket();
+            return;
+        }
+
         QString errMsg;
         switch (errCode) {
             case OtaProtocol::ERR_FRAME_FORMAT: errMsg = tr("帧格式错误"); break;
@@ -300,7 +525,48 @@ void OtaController::processResponse(const QByteArray &response)
     switch (m_state) {
         case Connecting:
             if (cmd == OtaProtocol::CMD_HANDSHAKE_ACK) {
-                emit logMessage(tr("握手成功"));
+                OtaProtocol::DeviceCaps caps;
+                if (OtaProtocol::parseHandshakeCaps(response, caps)) {
+                    caps.packet_size = qBound(OtaProtocol::PACKET_SIZE_MIN, caps.packet_size, OtaProtocol::DATA_MAX_LEN);
+                    caps.window = qBound<uint8_t>(1, caps.window, OtaProtocol::MAX_WINDOW_SIZE);
+                }
+                m_windowSize = caps.window;
+                updatePacketLayout(caps.packet_size);
+
+                emit logMessage(tr("握手成功: 数据包 %1 字节, 窗口 %2, 共 %3 个数据包")
+                                .arg(m_packetSize).arg(m_windowSize).arg(m_totalPackets));
+
+                if (!m_frameCache.prepare(m_firmwareData, m_fwInfo.firmware_crc32, m_packetSize)) {
+                    finishUpgrade(false, tr("生成数据帧缓存失败"));
+                    break;
+                }
+                planTransfer(caps);
+
+                m_retryCount = 0;
+                if (startBaudSwitch(caps)) {
+                    break;
+                }
+                setState(StartingUpgrade);
+                sendStartUpgrade();
+            }
+            break;
+
+        case SwitchingBaud:
+            if (cmd == OtaProtocol::CMD_SET_BAUD_ACK) {
+                // 设备以原速率确认后已切换，本端切换后稍等再以新速率握手验证
+                if (!m_serialPort->setBaudRate(m_baudRate)) {
+                    revertBaudRate();
+                    break;
+                }
+                setState(VerifyingBaud);
+                m_baudDelayPending = true;
+                startTimeoutTimer(BaudRate::kSettleMs);
+            }
+            break;
+
+        case VerifyingBaud:
+            if (cmd == OtaProtocol::CMD_HANDSHAKE_ACK) {
+                emit logMessage(tr("已切换到 %1bps").arg(m_baudRate));
                 m_retryCount = 0;
                 setState(StartingUpgrade);
                 sendStartUpgrade();
@@ -311,18 +577,20 @@ void OtaController::processResponse(const QByteArray &response)
             if (cmd == OtaProtocol::CMD_START_ACK) {
                 emit logMessage(tr("设备准备就绪，开始传输固件..."));
                 m_retryCount = 0;
-                m_currentPacket = 0;
                 setState(SendingData);
-                sendNextDataPacket();
+                startDataTransfer();
             }
             break;
 
         case SendingData:
             if (cmd == OtaProtocol::CMD_DATA_ACK) {
-                m_retryCount = 0;
-                m_currentPacket++;
-                sendNextDataPacket();
+                // 停等模式下旧版设备的确认不一定回显序号，按窗口起点处理
+                uint16_t seq = (m_windowSize == 1) ? m_windowBase
+                                                   : OtaProtocol::parseResponseSeq(response);
+                handleDataAck(seq);
             }
+            // 收到任何帧都会停止超时定时器，由此重新填充窗口并重新计时
+            sendNextDataPacket();
             break;
 
         case WaitingFinish:
@@ -339,6 +607,34 @@ void OtaController::processResponse(const QByteArray &response)
 
 void OtaController::onTimeout()
 {
+    // 数据传输阶段：窗口内所有未确认的包重传，按包计数重传次数
+    if (m_state == SendingData) {
+        uint32_t failedSeq = 0;
+        if (!startResendRound(failedSeq)) {
+            finishUpgrade(false, tr("通讯超时，数据包 %1 重试次数已用完").arg(failedSeq));
+            return;
+        }
+        emit logMessage(tr("超时，从数据包 %1 开始重传...").arg(m_windowBase));
+        sendNextDataPacket();
+        return;
+    }
+
+    // 切换波特率后的等待结束
+    if (m_baudDelayPending) {
+        m_baudDelayPending = false;
+        sendHandshake();
+        if (m_state == VerifyingBaud) {
+            startTimeoutTimer(BaudRate::kQueryTimeoutMs);
+        }
+        return;
+    }
+
+    // 切换确认或新速率下的握手超时：不重试，直接退回 9600
+    if (m_state == SwitchingBaud || m_state == VerifyingBaud) {
+        revertBaudRate();
+        return;
+    }
+
     m_retryCount++;
 
     if (m_retryCount > MAX_RETRY) {
@@ -351,14 +647,13 @@ void OtaController::onTimeout()
     // 根据当前状态重发
     switch (m_state) {
         case Connecting:
+            // 旧版 Bootloader 可能直接丢弃带能力字段的握手帧，重试时改用旧版握手
+            m_legacyHandshake = true;
             sendHandshake();
             break;
         case StartingUpgrade:
             sendStartUpgrade();
             break;
-        case SendingData:
-            sendNextDataPacket();
-            break;
         case WaitingFinish:
             sendFinish();
             break;
@@ -6,17 +6,29 @@
 #include <QFile>
 #include <QTimer>
 #include <QByteArray>
+#include <QVector>
 #include "OtaProtocol.h"
+#include "OtaFrameCache.h"
+#include "OtaFirmwareImage.h"
 
 /**
  * @brief OTA 升级控制器
  * 
  * 职责：
- * - 管理独立的 9600bps 串口连接（与现有业务串口分离）
+ * - 管理独立的 OTA 串口连接（与现有业务串口分离），以 9600bps 握手
+ * - Bootloader 支持时切换到双方共同的最高波特率，重新握手验证，失败退回 9600 继续升级
  * - 读取 .bin 固件文件并分包发送
  * - 实现 OTA 协议状态机
- * - 处理超时重传
+ * - 握手时协商数据包大小和发送窗口，窗口内的多个数据包连续发送，不逐包等待响应
+ * - 处理超时重传，以及按 CMD_DATA_ACK / ERR_SEQ 的序号选择性重传
+ *   （每次丢包或超时计为一轮重传，本轮之前发出的包引起的错误不再重复计数）
+ * - 断点续传：设备在握手中报告未完成升级的最后提交序号，同一固件从该序号之后继续
+ * - 差分升级：与设备已安装固件逐包比较 CRC32，只发送变化的数据包
+ * - 数据帧由 OtaFrameCache 预先生成并映射，发送时不再组帧
  * - 发送进度更新信号
+ *
+ * 可以移入工作线程运行（串口和定时器都是子对象，随控制器一起移动），
+ * 此时通过队列调用 startUpgrade(portName, image) / cancelUpgrade()，见 OtaBatchManager。
  */
 class OtaController : public QObject
 {
@@ -29,6 +41,8 @@ public:
     enum State {
         Idle,               ///< 空闲状态
         Connecting,         ///< 正在连接（握手）
+        SwitchingBaud,      ///< 等待切换波特率确认
+        VerifyingBaud,      ///< 以新波特率重新握手验证
         StartingUpgrade,    ///< 发送开始升级命令
         SendingData,        ///< 发送数据包中
         WaitingFinish,      ///< 等待完成确认
@@ -56,10 +70,18 @@ public:
      */
     bool startUpgrade(const QString &portName, const QString &firmwarePath);
 
+    /**
+     * @brief 使用已加载的固件镜像开始 OTA 升级（不再读取文件和计算整体 CRC32）
+     * @param portName 串口名称
+     * @param image 固件镜像（与其他控制器共享同一份数据）
+     * @return true 启动成功，false 启动失败
+     */
+    Q_INVOKABLE bool startUpgrade(const QString &portName, const OtaFirmwareImage &image);
+
     /**
      * @brief 取消升级
      */
-    void cancelUpgrade();
+    Q_INVOKABLE void cancelUpgrade();
 
     /**
      * @brief 获取当前状态
@@ -73,6 +95,24 @@ public:
      */
     bool isUpgrading() const { return m_state != Idle && m_state != Completed && m_state != Error; }
 
+    /**
+     * @brief 设置是否允许断点续传（默认允许，设备支持时生效）
+     */
+    void setResumeEnabled(bool enabled) { m_resumeEnabled = enabled; }
+    bool isResumeEnabled() const { return m_resumeEnabled; }
+
+    /**
+     * @brief 设置是否允许差分升级（默认允许，设备支持且有已安装固件的逐包 CRC 时生效）
+     */
+    void setDeltaEnabled(bool enabled) { m_deltaEnabled = enabled; }
+    bool isDeltaEnabled() const { return m_deltaEnabled; }
+
+    /**
+     * @brief 设置升级时允许的最高波特率（9600 表示不切换）
+     */
+    void setMaxBaudRate(int baudRate) { m_maxBaudRate = baudRate; }
+    int maxBaudRate() const { return m_maxBaudRate; }
+
 signals:
     /**
      * @brief 升级进度更新信号
@@ -124,11 +164,10 @@ private:
     void closeSerialPort();
 
     /**
-     * @brief 加载固件文件
-     * @param filePath 文件路径
-     * @return true 成功
+     * @brief 使用固件镜像并填充固件信息
+     * @param image 固件镜像
      */
-    bool loadFirmware(const QString &filePath);
+    void applyFirmware(const OtaFirmwareImage &image);
 
     /**
      * @brief 发送握手帧
@@ -141,10 +180,67 @@ private:
     void sendStartUpgrade();
 
     /**
-     * @brief 发送下一个数据包
+     * @brief 按协商的数据包大小重新计算分包信息
+     * @param packetSize 数据包大小
+     */
+    void updatePacketLayout(uint16_t packetSize);
+
+    /**
+     * @brief 根据设备能力决定续传起点或差分基准，设置 FirmwareInfo::flags
+     * @param caps 握手响应中的设备能力
+     */
+    void planTransfer(const OtaProtocol::DeviceCaps &caps);
+
+    /**
+     * @brief 设备支持时请求切换到共同的最高波特率
+     * @param caps 握手响应中的设备能力
+     * @return true 已发送切换请求（进入 SwitchingBaud）
+     */
+    bool startBaudSwitch(const OtaProtocol::DeviceCaps &caps);
+
+    /**
+     * @brief 切换失败：退回 9600，等待设备自行退回后重新握手
+     */
+    void revertBaudRate();
+
+    /**
+     * @brief 开始数据传输（重置窗口状态，跳过已提交/未变化的包后填充发送窗口）
+     */
+    void startDataTransfer();
+
+    /**
+     * @brief 在发送窗口内发送尚未发送或需要重传的数据包
+     *
+     * 所有数据包确认后发送结束帧。
      */
     void sendNextDataPacket();
 
+    /**
+     * @brief 发送指定序号的数据包
+     * @param seq 包序号
+     */
+    void sendDataPacket(uint16_t seq);
+
+    /**
+     * @brief 处理数据包确认
+     * @param seq 被确认的包序号
+     */
+    void handleDataAck(uint16_t seq);
+
+    /**
+     * @brief 将数据包标记为需要重传
+     * @param seq 包序号
+     * @return false 该包重传次数已用完
+     */
+    bool markForResend(uint16_t seq);
+
+    /**
+     * @brief 开始新一轮重传：窗口内所有在途的包标记为需要重传，各计一次重传
+     * @param failedSeq 重传次数用完时输出该包序号
+     * @return false 某个包重传次数已用完
+     */
+    bool startResendRound(uint32_t &failedSeq);
+
     /**
      * @brief 发送完成帧
      */
@@ -186,11 +282,43 @@ private:
     QByteArray m_rxBuffer;              ///< 接收缓冲区
 
     // 固件相关
-    QByteArray m_firmwareData;          ///< 固件数据
+    QByteArray m_firmwareData;          ///< 固件数据（与固件镜像共享，只读）
     OtaProtocol::FirmwareInfo m_fwInfo; ///< 固件信息
-    uint16_t m_currentPacket;           ///< 当前包序号
     uint16_t m_totalPackets;            ///< 总包数
 
+    // 发送窗口
+    /**
+     * @brief 数据包发送状态
+     */
+    enum PacketState : uint8_t {
+        PacketPending,                  ///< 尚未发送
+        PacketInFlight,                 ///< 已发送，等待确认
+        PacketResend,                   ///< 需要重传
+        PacketAcked                     ///< 已确认
+    };
+    uint16_t m_packetSize;              ///< 协商后的数据包大小
+    uint8_t m_windowSize;               ///< 协商后的发送窗口
+    bool m_legacyHandshake;             ///< 设备不识别能力字段，改用旧版握手
+    uint16_t m_windowBase;              ///< 窗口起点（最小的未确认包序号）
+    uint16_t m_ackedPackets;            ///< 已确认的包数
+    QVector<uint8_t> m_packetStates;    ///< 每个包的发送状态（PacketState）
+    QVector<uint8_t> m_packetRetries;   ///< 每个包的重传次数
+    QVector<quint32> m_packetRounds;    ///< 每个包最近一次发送时的重传轮次
+    quint32 m_resendRound;              ///< 当前重传轮次（每次丢包或超时加一）
+
+    // 续传与差分
+    OtaFrameCache m_frameCache;         ///< 预生成的数据帧缓存
+    bool m_resumeEnabled;               ///< 是否允许断点续传
+    bool m_deltaEnabled;                ///< 是否允许差分升级
+    uint16_t m_resumeFrom;              ///< 续传起始包序号（0 表示从头开始）
+    QVector<uint32_t> m_deltaBaseCrcs;  ///< 已安装固件的逐包 CRC32（为空表示不做差分）
+
+    // 波特率切换
+    int m_maxBaudRate;                  ///< 允许的最高波特率
+    int m_baudRate;                     ///< 当前串口波特率（切换中为目标波特率）
+    bool m_baudSwitchFailed;            ///< 本次升级切换失败过，不再尝试
+    bool m_baudDelayPending;            ///< 超时定时器当前用于切换后的等待，而非响应超时
+
     // 状态机
     State m_state;                      ///< 当前状态
     int m_retryCount;                   ///< 重试计数
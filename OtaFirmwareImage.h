@@ -0,0 +1,75 @@
+#ifndef OTAFIRMWAREIMAGE_H
+#define OTAFIRMWAREIMAGE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <cstdint>
+#include "OtaProtocol.h"
+
+/**
+ * @brief OTA 固件镜像（加载后不再修改）
+ *
+ * 固件数据以隐式共享的 QByteArray 保存，复制镜像只增加引用计数，
+ * 多个 OtaController（包括运行在不同线程中的）共用同一份只读数据，CRC32 只在加载时计算一次。
+ */
+struct OtaFirmwareImage {
+    static constexpr uint32_t kMaxSize = 54 * 1024;     ///< APP 区最大约 54KB
+
+    QString filePath;           ///< 固件文件路径
+    QByteArray data;            ///< 固件数据（只读）
+    uint32_t crc32;             ///< 整个固件的 CRC32
+
+    OtaFirmwareImage() : crc32(0) {}
+
+    bool isValid() const { return !data.isEmpty(); }
+    uint32_t size() const { return static_cast<uint32_t>(data.size()); }
+
+    /**
+     * @brief 加载固件文件并计算 CRC32
+     * @param path 固件文件路径（.bin）
+     * @param[out] image 加载结果
+     * @param errorString 失败原因（可选）
+     * @return true 成功
+     */
+    static bool load(const QString &path, OtaFirmwareImage &image, QString *errorString = nullptr)
+    {
+        QFile file(path);
+        QString error;
+
+        if (!file.exists()) {
+            error = QObject::tr("固件文件不存在: %1").arg(path);
+        } else if (!file.open(QIODevice::ReadOnly)) {
+            error = QObject::tr("无法打开固件文件: %1").arg(file.errorString());
+        } else {
+            image.data = file.readAll();
+            file.close();
+            if (image.data.isEmpty()) {
+                error = QObject::tr("固件文件为空");
+            } else if (image.size() > kMaxSize) {
+                error = QObject::tr("固件文件过大: %1 字节，最大允许 %2 字节")
+                        .arg(image.data.size())
+                        .arg(kMaxSize);
+            }
+        }
+
+        if (!error.isEmpty()) {
+            image = OtaFirmwareImage();
+            if (errorString) {
+                *errorString = error;
+            }
+            return false;
+        }
+
+        image.filePath = path;
+        image.crc32 = OtaProtocol::calculateCRC32(reinterpret_cast<const uint8_t*>(image.data.constData()),
+                                                  image.size());
+        return true;
+    }
+};
+
+Q_DECLARE_METATYPE(OtaFirmwareImage)
+
+#endif // OTAFIRMWAREIMAGE_H
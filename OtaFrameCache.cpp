@@ -0,0 +1,185 @@
+#include "OtaFrameCache.h"
+#include "OtaProtocol.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+constexpr quint32 CRC_SIDECAR_MAGIC = 0x4F504331;   // "OPC1"
+}
+
+OtaFrameCache::OtaFrameCache()
+    : m_data(nullptr)
+    , m_firmwareSize(0)
+    , m_firmwareCrc32(0)
+    , m_packetSize(0)
+    , m_packetCount(0)
+    , m_fullFrameSize(0)
+{
+}
+
+OtaFrameCache::~OtaFrameCache()
+{
+    clear();
+}
+
+bool OtaFrameCache::prepare(const QByteArray &firmware, uint32_t firmwareCrc32, uint16_t packetSize)
+{
+    if (firmware.isEmpty() || packetSize == 0) {
+        return false;
+    }
+
+    // 同一固件、同一包大小的缓存已就绪，直接复用
+    if (isValid() && m_firmwareCrc32 == firmwareCrc32 && m_packetSize == packetSize &&
+        m_firmwareSize == static_cast<uint32_t>(firmware.size())) {
+        return true;
+    }
+
+    clear();
+
+    m_firmwareSize = static_cast<uint32_t>(firmware.size());
+    m_firmwareCrc32 = firmwareCrc32;
+    m_packetSize = packetSize;
+    m_packetCount = static_cast<int>((m_firmwareSize + packetSize - 1) / packetSize);
+    m_fullFrameSize = OtaProtocol::FRAME_MIN_LEN + packetSize;
+
+    // 逐包 CRC32
+    m_packetCrcs.resize(m_packetCount);
+    for (int i = 0; i < m_packetCount; ++i) {
+        uint32_t offset = static_cast<uint32_t>(i) * packetSize;
+        uint32_t length = qMin<uint32_t>(packetSize, m_firmwareSize - offset);
+        m_packetCrcs[i] = OtaProtocol::calculateCRC32(
+            reinterpret_cast<const uint8_t*>(firmware.constData() + offset), length);
+    }
+    savePacketCrcs(firmwareCrc32);
+
+    const uint32_t lastDataLen = m_firmwareSize - static_cast<uint32_t>(m_packetCount - 1) * packetSize;
+    const qint64 expectedSize = static_cast<qint64>(m_packetCount - 1) * m_fullFrameSize
+                                + OtaProtocol::FRAME_MIN_LEN + lastDataLen;
+
+    // 优先使用已有的缓存文件，大小不符时重新生成
+    const QString path = cacheFilePath(firmwareCrc32, packetSize, "frm");
+    if (!QFileInfo::exists(path) || QFileInfo(path).size() != expectedSize) {
+        QDir().mkpath(cacheDirectory());
+        QSaveFile out(path);
+        if (out.open(QIODevice::WriteOnly)) {
+            out.write(buildFrames(firmware));
+            out.commit();
+        }
+    }
+
+    m_file.setFileName(path);
+    if (m_file.size() == expectedSize && m_file.open(QIODevice::ReadOnly)) {
+        uchar *mapped = m_file.map(0, expectedSize);
+        if (mapped) {
+            m_data = reinterpret_cast<const char*>(mapped);
+            return true;
+        }
+        m_file.close();
+    }
+
+    // 缓存目录不可用：退化为内存帧缓冲
+    m_memoryFrames = buildFrames(firmware);
+    m_data = m_memoryFrames.constData();
+    return true;
+}
+
+void OtaFrameCache::clear()
+{
+    if (m_file.isOpen()) {
+        m_file.close();     // close() 会解除所有映射
+    }
+    m_memoryFrames.clear();
+    m_data = nullptr;
+    m_packetCount = 0;
+    m_packetCrcs.clear();
+}
+
+QByteArray OtaFrameCache::frame(uint16_t seq) const
+{
+    if (!isValid() || seq >= m_packetCount) {
+        return QByteArray();
+    }
+
+    const uint32_t offset = static_cast<uint32_t>(seq) * m_packetSize;
+    const uint32_t dataLen = qMin<uint32_t>(m_packetSize, m_firmwareSize - offset);
+    return QByteArray::fromRawData(m_data + static_cast<qint64>(seq) * m_fullFrameSize,
+                                   static_cast<int>(OtaProtocol::FRAME_MIN_LEN + dataLen));
+}
+
+QByteArray OtaFrameCache::buildFrames(const QByteArray &firmware) const
+{
+    QByteArray frames;
+    frames.reserve(m_packetCount * m_fullFrameSize);
+
+    for (int i = 0; i < m_packetCount; ++i) {
+        uint32_t offset = static_cast<uint32_t>(i) * m_packetSize;
+        uint16_t dataLen = static_cast<uint16_t>(qMin<uint32_t>(m_packetSize, m_firmwareSize - offset));
+        frames.append(OtaProtocol::buildDataFrame(
+            static_cast<uint16_t>(i),
+            reinterpret_cast<const uint8_t*>(firmware.constData() + offset),
+            dataLen));
+    }
+
+    return frames;
+}
+
+void OtaFrameCache::savePacketCrcs(uint32_t firmwareCrc32) const
+{
+    QDir().mkpath(cacheDirectory());
+
+    QSaveFile out(cacheFilePath(firmwareCrc32, m_packetSize, "crc"));
+    if (!out.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&out);
+    stream << CRC_SIDECAR_MAGIC << static_cast<quint16>(m_packetSize)
+           << static_cast<quint32>(m_packetCrcs.size());
+    for (uint32_t crc : m_packetCrcs) {
+        stream << static_cast<quint32>(crc);
+    }
+    out.commit();
+}
+
+bool OtaFrameCache::loadPacketCrcs(uint32_t firmwareCrc32, uint16_t packetSize, QVector<uint32_t> &crcs)
+{
+    QFile in(cacheFilePath(firmwareCrc32, packetSize, "crc"));
+    if (!in.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&in);
+    quint32 magic = 0;
+    quint16 storedPacketSize = 0;
+    quint32 count = 0;
+    stream >> magic >> storedPacketSize >> count;
+    if (magic != CRC_SIDECAR_MAGIC || storedPacketSize != packetSize || count > 0xFFFF) {
+        return false;
+    }
+
+    crcs.resize(static_cast<int>(count));
+    for (quint32 i = 0; i < count; ++i) {
+        quint32 crc = 0;
+        stream >> crc;
+        crcs[static_cast<int>(i)] = crc;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+QString OtaFrameCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/ota";
+}
+
+QString OtaFrameCache::cacheFilePath(uint32_t firmwareCrc32, uint16_t packetSize, const char *suffix)
+{
+    return QString("%1/%2_%3.%4")
+            .arg(cacheDirectory())
+            .arg(firmwareCrc32, 8, 16, QChar('0'))
+            .arg(packetSize)
+            .arg(QLatin1String(suffix));
+}
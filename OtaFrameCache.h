@@ -0,0 +1,107 @@
+#ifndef OTAFRAMECACHE_H
+#define OTAFRAMECACHE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+/**
+ * @brief OTA 数据帧缓存
+ *
+ * 职责：
+ * - 按固件 CRC32 和数据包大小，一次性生成全部 CMD_DATA_PACKET 帧并保存到缓存文件
+ * - 通过 QFile::map 映射缓存文件，发送时直接切片（QByteArray::fromRawData），不再逐包组帧和计算 CRC16
+ * - 保存每个数据包的 CRC32 列表（侧车文件），供差分升级与设备上已安装的固件逐包比较
+ *
+ * 缓存文件按固件内容命名，同一固件重复升级（例如断线后重试）时直接复用。
+ * 缓存目录不可写或映射失败时退化为内存中的帧缓冲，行为不变。
+ */
+class OtaFrameCache
+{
+public:
+    OtaFrameCache();
+    ~OtaFrameCache();
+
+    /**
+     * @brief 为固件准备数据帧缓存（已存在且有效时直接映射）
+     * @param firmware 固件数据
+     * @param firmwareCrc32 固件 CRC32
+     * @param packetSize 数据包大小
+     * @return true 成功
+     */
+    bool prepare(const QByteArray &firmware, uint32_t firmwareCrc32, uint16_t packetSize);
+
+    /**
+     * @brief 释放映射和缓冲
+     */
+    void clear();
+
+    /**
+     * @brief 缓存是否可用
+     */
+    bool isValid() const { return m_data != nullptr; }
+
+    /**
+     * @brief 数据包数量
+     */
+    int packetCount() const { return m_packetCount; }
+
+    /**
+     * @brief 获取指定序号的完整数据帧
+     * @param seq 包序号
+     * @return 指向缓存区的帧切片（不拷贝，缓存有效期内可用）
+     */
+    QByteArray frame(uint16_t seq) const;
+
+    /**
+     * @brief 每个数据包的 CRC32（用于差分比较）
+     */
+    const QVector<uint32_t> &packetCrcs() const { return m_packetCrcs; }
+
+    /**
+     * @brief 读取某个固件的逐包 CRC32 列表
+     * @param firmwareCrc32 固件 CRC32
+     * @param packetSize 数据包大小
+     * @param[out] crcs 逐包 CRC32
+     * @return true 找到对应的侧车文件
+     */
+    static bool loadPacketCrcs(uint32_t firmwareCrc32, uint16_t packetSize, QVector<uint32_t> &crcs);
+
+    /**
+     * @brief 缓存目录
+     */
+    static QString cacheDirectory();
+
+private:
+    /**
+     * @brief 缓存文件路径
+     * @param firmwareCrc32 固件 CRC32
+     * @param packetSize 数据包大小
+     * @param suffix 文件后缀（"frm" 帧缓存，"crc" 逐包 CRC）
+     */
+    static QString cacheFilePath(uint32_t firmwareCrc32, uint16_t packetSize, const char *suffix);
+
+    /**
+     * @brief 生成全部数据帧
+     */
+    QByteArray buildFrames(const QByteArray &firmware) const;
+
+    /**
+     * @brief 保存逐包 CRC32 侧车文件
+     */
+    void savePacketCrcs(uint32_t firmwareCrc32) const;
+
+    QFile m_file;                       ///< 帧缓存文件（映射期间保持打开）
+    QByteArray m_memoryFrames;          ///< 映射失败时的内存帧缓冲
+    const char *m_data;                 ///< 帧数据起始地址（映射区或内存缓冲）
+    uint32_t m_firmwareSize;            ///< 固件大小
+    uint32_t m_firmwareCrc32;           ///< 固件 CRC32
+    uint16_t m_packetSize;              ///< 数据包大小
+    int m_packetCount;                  ///< 数据包数量
+    int m_fullFrameSize;                ///< 满包帧长度（最后一包可能更短）
+    QVector<uint32_t> m_packetCrcs;     ///< 逐包 CRC32
+};
+
+#endif // OTAFRAMECACHE_H
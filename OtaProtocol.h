@@ -22,7 +22,22 @@ constexpr uint8_t FRAME_TAIL = 0x5A;
 constexpr uint16_t DATA_MAX_LEN = 256;      // 单帧最大数据长度
 constexpr uint16_t FRAME_MIN_LEN = 10;      // 帧最小长度（不含数据）
 
-constexpr uint16_t PACKET_DATA_SIZE = 128;  // 每个数据包的固件数据大小
+constexpr uint16_t PACKET_DATA_SIZE = 128;  // 默认数据包大小（设备未协商时使用）
+constexpr uint16_t PACKET_SIZE_MIN = 16;    // 协商数据包大小下限
+
+constexpr uint8_t DEFAULT_WINDOW_SIZE = 1;  // 默认发送窗口（停等模式）
+constexpr uint8_t MAX_WINDOW_SIZE = 8;      // 上位机支持的最大发送窗口
+
+constexpr uint16_t HANDSHAKE_CAPS_LEN = 3;  // 握手能力字段长度：packet_size(2) + window(1)
+constexpr uint16_t HANDSHAKE_REQ_LEN = 4;   // 握手请求数据长度：能力字段 + features(1)
+constexpr uint16_t HANDSHAKE_EXT_LEN = 14;  // 扩展握手响应长度：能力字段 + features(1) + resume_seq(2) + resume_crc32(4) + installed_crc32(4)
+constexpr uint16_t HANDSHAKE_BAUD_LEN = 15; // 带波特率能力的握手响应长度：扩展字段 + baud_mask(1)
+
+constexpr uint8_t FEATURE_RESUME = 0x01;    // 支持断点续传
+constexpr uint8_t FEATURE_DELTA = 0x02;     // 支持差分升级（只写变化的数据包）
+constexpr uint8_t FEATURE_BAUD_SWITCH = 0x04;   // 支持切换波特率（速率码见 protocol/BaudRate.h）
+
+constexpr uint16_t RESUME_SEQ_NONE = 0xFFFF;    // 设备没有可续传的升级
 
 /******************************************************************************
  * 命令定义（与 Bootloader 对齐）
@@ -39,6 +54,9 @@ enum Command : uint8_t {
     
     CMD_FINISH          = 0x04,     // 完成升级（PC → MCU）
     CMD_FINISH_ACK      = 0x84,     // 完成响应（MCU → PC）
+
+    CMD_SET_BAUD        = 0x05,     // 切换波特率（PC → MCU，数据区为速率码）
+    CMD_SET_BAUD_ACK    = 0x85,     // 切换确认（MCU → PC，以原速率发送后切换）
     
     CMD_ERROR           = 0xFF,     // 错误响应（MCU → PC）
 };
@@ -71,10 +89,31 @@ struct FirmwareInfo {
     uint8_t  version_major;         // 固件版本号
     uint8_t  version_minor;
     uint8_t  version_patch;
-    uint8_t  reserved;
+    uint8_t  flags;                 // 升级标志（UpgradeFlag，原 reserved 字段，旧版设备为 0）
 };
 #pragma pack(pop)
 
+/******************************************************************************
+ * 升级标志（FirmwareInfo::flags）
+ ******************************************************************************/
+enum UpgradeFlag : uint8_t {
+    UPGRADE_FLAG_RESUME = 0x01,     // 续传：不擦除已提交的数据包
+    UPGRADE_FLAG_DELTA  = 0x02,     // 差分：按包擦写，未发送的包保持原内容
+};
+
+/******************************************************************************
+ * 设备传输能力（CMD_HANDSHAKE_ACK 数据区，多字节字段均为大端）
+ ******************************************************************************/
+struct DeviceCaps {
+    uint16_t packet_size;           // 设备采用的数据包大小
+    uint8_t  window;                // 设备采用的发送窗口
+    uint8_t  features;              // 支持的功能（FEATURE_*）
+    uint16_t resume_seq;            // 最后提交的包序号（RESUME_SEQ_NONE 表示无）
+    uint32_t resume_crc32;          // 未完成升级的固件 CRC32
+    uint32_t installed_crc32;       // 当前已安装固件的 CRC32（0 表示未知）
+    uint8_t  baud_mask;             // 支持的速率码位图（0 表示不支持切换）
+};
+
 /******************************************************************************
  * CRC 计算函数
  ******************************************************************************/
@@ -210,6 +249,36 @@ inline QByteArray buildHandshakeFrame()
     return buildFrame(CMD_HANDSHAKE, 0, nullptr, 0);
 }
 
+/**
+ * @brief 构建带传输能力的握手帧
+ * @param packetSize 上位机期望的数据包大小
+ * @param windowSize 上位机支持的最大发送窗口
+ * @param features 上位机支持的功能（FEATURE_*）
+ * @return 握手帧数据
+ *
+ * 数据区：packet_size(2, 大端) + window(1) + features(1)，设备在 CMD_HANDSHAKE_ACK 中回复
+ * 实际采用的参数（见 DeviceCaps）；不支持协商的设备回复空数据区，此时使用默认值。
+ */
+inline QByteArray buildHandshakeFrame(uint16_t packetSize, uint8_t windowSize, uint8_t features)
+{
+    uint8_t caps[HANDSHAKE_REQ_LEN];
+    caps[0] = static_cast<uint8_t>((packetSize >> 8) & 0xFF);
+    caps[1] = static_cast<uint8_t>(packetSize & 0xFF);
+    caps[2] = windowSize;
+    caps[3] = features;
+    return buildFrame(CMD_HANDSHAKE, 0, caps, HANDSHAKE_REQ_LEN);
+}
+
+/**
+ * @brief 构建切换波特率帧
+ * @param rateCode 速率码（BaudRate::codeOf）
+ * @return 切换波特率帧数据
+ */
+inline QByteArray buildSetBaudFrame(uint8_t rateCode)
+{
+    return buildFrame(CMD_SET_BAUD, 0, &rateCode, 1);
+}
+
 /**
  * @brief 构建开始升级帧
  * @param info 固件信息
@@ -284,6 +353,59 @@ inline uint8_t parseErrorCode(const QByteArray &frame)
     return static_cast<uint8_t>(frame[7]);
 }
 
+/**
+ * @brief 解析响应帧，提取序号
+ * @param frame 接收到的帧数据
+ * @return 序号（数据包响应为被确认的包序号，错误响应为出错的包序号）
+ */
+inline uint16_t parseResponseSeq(const QByteArray &frame)
+{
+    if (frame.size() < FRAME_MIN_LEN) {
+        return 0;
+    }
+
+    return static_cast<uint16_t>((static_cast<uint8_t>(frame[5]) << 8) |
+                                  static_cast<uint8_t>(frame[6]));
+}
+
+/**
+ * @brief 解析握手响应中的传输能力
+ * @param frame 握手响应帧
+ * @param[out] caps 设备能力（未携带的字段填默认值：无续传、已安装固件未知）
+ * @return true 响应携带能力字段，false 旧版设备（未携带）
+ */
+inline bool parseHandshakeCaps(const QByteArray &frame, DeviceCaps &caps)
+{
+    caps.packet_size = PACKET_DATA_SIZE;
+    caps.window = DEFAULT_WINDOW_SIZE;
+    caps.features = 0;
+    caps.resume_seq = RESUME_SEQ_NONE;
+    caps.resume_crc32 = 0;
+    caps.installed_crc32 = 0;
+    caps.baud_mask = 0;
+
+    if (frame.size() < FRAME_MIN_LEN + HANDSHAKE_CAPS_LEN) {
+        return false;
+    }
+
+    const uint8_t *d = reinterpret_cast<const uint8_t*>(frame.constData()) + 7;
+    caps.packet_size = static_cast<uint16_t>((d[0] << 8) | d[1]);
+    caps.window = d[2];
+
+    if (frame.size() >= FRAME_MIN_LEN + HANDSHAKE_EXT_LEN) {
+        caps.features = d[3];
+        caps.resume_seq = static_cast<uint16_t>((d[4] << 8) | d[5]);
+        caps.resume_crc32 = (static_cast<uint32_t>(d[6]) << 24) | (static_cast<uint32_t>(d[7]) << 16) |
+                            (static_cast<uint32_t>(d[8]) << 8) | d[9];
+        caps.installed_crc32 = (static_cast<uint32_t>(d[10]) << 24) | (static_cast<uint32_t>(d[11]) << 16) |
+                               (static_cast<uint32_t>(d[12]) << 8) | d[13];
+    }
+    if (frame.size() >= FRAME_MIN_LEN + HANDSHAKE_BAUD_LEN && (caps.features & FEATURE_BAUD_SWITCH)) {
+        caps.baud_mask = d[14];
+    }
+    return true;
+}
+
 } // namespace OtaProtocol
 
 #endif // OTAPROTOCOL_H
@@ -0,0 +1,153 @@
+#include "SerialHotplugWatcher.h"
+#include <QCoreApplication>
+#include <QSocketNotifier>
+
+#if defined(Q_OS_LINUX)
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <dbt.h>
+#endif
+
+namespace {
+
+#if defined(Q_OS_LINUX)
+/**
+ * @brief 判断一条 uevent 是否为串口设备的插入/移除
+ *
+ * 消息格式："action@devpath\0KEY=VALUE\0KEY=VALUE\0..."
+ */
+bool isTtyHotplugEvent(const char *data, int length)
+{
+    bool isAddOrRemove = false;
+    bool isTty = false;
+    int pos = 0;
+    while (pos < length) {
+        const char *field = data + pos;
+        const int fieldLength = static_cast<int>(::strnlen(field, static_cast<size_t>(length - pos)));
+        if (pos == 0) {
+            isAddOrRemove = ::strncmp(field, "add@", 4) == 0 || ::strncmp(field, "remove@", 7) == 0;
+        } else if (::strcmp(field, "SUBSYSTEM=tty") == 0) {
+            isTty = true;
+        }
+        pos += fieldLength + 1;
+    }
+    return isAddOrRemove && isTty;
+}
+#endif
+
+} // namespace
+
+SerialHotplugWatcher::SerialHotplugWatcher(QObject *parent)
+    : QObject(parent)
+    , m_ueventSocket(-1)
+    , m_filterInstalled(false)
+    , m_active(false)
+{
+}
+
+SerialHotplugWatcher::~SerialHotplugWatcher()
+{
+    stop();
+}
+
+bool SerialHotplugWatcher::start()
+{
+    if (m_active) {
+        return true;
+    }
+
+#if defined(Q_OS_LINUX)
+    m_ueventSocket = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (m_ueventSocket < 0) {
+        return false;
+    }
+
+    sockaddr_nl address;
+    std::memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;      // 内核广播组
+    if (::bind(m_ueventSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(m_ueventSocket);
+        m_ueventSocket = -1;
+        return false;
+    }
+
+    m_notifier.reset(new QSocketNotifier(m_ueventSocket, QSocketNotifier::Read));
+    connect(m_notifier.data(), &QSocketNotifier::activated,
+            this, &SerialHotplugWatcher::onUeventReadable);
+    m_active = true;
+#elif defined(Q_OS_WIN)
+    // 端口设备的 WM_DEVICECHANGE 会广播给所有顶层窗口，无需额外注册
+    if (!QCoreApplication::instance()) {
+        return false;
+    }
+    QCoreApplication::instance()->installNativeEventFilter(this);
+    m_filterInstalled = true;
+    m_active = true;
+#endif
+    return m_active;
+}
+
+void SerialHotplugWatcher::stop()
+{
+    m_notifier.reset();
+#if defined(Q_OS_LINUX)
+    if (m_ueventSocket >= 0) {
+        ::close(m_ueventSocket);
+        m_ueventSocket = -1;
+    }
+#endif
+    if (m_filterInstalled && QCoreApplication::instance()) {
+        QCoreApplication::instance()->removeNativeEventFilter(this);
+    }
+    m_filterInstalled = false;
+    m_active = false;
+}
+
+bool SerialHotplugWatcher::nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+{
+    Q_UNUSED(result);
+#if defined(Q_OS_WIN)
+    if (eventType != "windows_generic_MSG") {
+        return false;
+    }
+    const MSG *msg = static_cast<const MSG*>(message);
+    if (msg->message == WM_DEVICECHANGE &&
+        (msg->wParam == DBT_DEVICEARRIVAL || msg->wParam == DBT_DEVICEREMOVECOMPLETE)) {
+        const DEV_BROADCAST_HDR *header = reinterpret_cast<const DEV_BROADCAST_HDR*>(msg->lParam);
+        if (header && header->dbch_devicetype == DBT_DEVTYP_PORT) {
+            emit devicesChanged();
+        }
+    }
+#else
+    Q_UNUSED(eventType);
+    Q_UNUSED(message);
+#endif
+    return false;   // 不拦截，其他窗口照常处理
+}
+
+void SerialHotplugWatcher::onUeventReadable()
+{
+#if defined(Q_OS_LINUX)
+    // 一次插拔会产生多条 uevent（usb、tty 等），读完后最多通知一次
+    bool changed = false;
+    char buffer[8192];
+    for (;;) {
+        const ssize_t length = ::recv(m_ueventSocket, buffer, sizeof(buffer) - 1, 0);
+        if (length <= 0) {
+            break;
+        }
+        buffer[length] = '\0';
+        if (isTtyHotplugEvent(buffer, static_cast<int>(length))) {
+            changed = true;
+        }
+    }
+    if (changed) {
+        emit devicesChanged();
+    }
+#endif
+}
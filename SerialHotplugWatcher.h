@@ -0,0 +1,69 @@
+#ifndef SERIALHOTPLUGWATCHER_H
+#define SERIALHOTPLUGWATCHER_H
+
+#include <QObject>
+#include <QAbstractNativeEventFilter>
+#include <QScopedPointer>
+
+class QSocketNotifier;
+
+/**
+ * @brief 串口热插拔通知
+ *
+ * 职责：
+ * - 订阅操作系统的设备插拔通知，代替周期性枚举串口
+ * - Linux：监听内核 uevent（NETLINK_KOBJECT_UEVENT），只关注 tty 子系统的 add/remove
+ * - Windows：过滤 WM_DEVICECHANGE 广播中的端口设备（DBT_DEVTYP_PORT）到达/移除
+ *
+ * 只报告"串口可能发生了变化"，不解析具体端口；由 SerialPortManager 延迟一小段时间后重新枚举。
+ * 其他平台或通知不可用时 start() 返回 false，调用方应退回到定时轮询。
+ */
+class SerialHotplugWatcher : public QObject, public QAbstractNativeEventFilter
+{
+    Q_OBJECT
+
+public:
+    explicit SerialHotplugWatcher(QObject *parent = nullptr);
+    ~SerialHotplugWatcher() override;
+
+    /**
+     * @brief 开始监听
+     * @return 当前平台的热插拔通知是否可用
+     */
+    bool start();
+
+    /**
+     * @brief 停止监听
+     */
+    void stop();
+
+    /**
+     * @brief 是否正在监听
+     */
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief 原生事件过滤（Windows 下接收 WM_DEVICECHANGE）
+     */
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
+
+signals:
+    /**
+     * @brief 有串口设备插入或移除
+     */
+    void devicesChanged();
+
+private slots:
+    /**
+     * @brief 读取 uevent 套接字上的全部消息（Linux）
+     */
+    void onUeventReadable();
+
+private:
+    int m_ueventSocket;                             ///< uevent 套接字（-1 表示未打开）
+    QScopedPointer<QSocketNotifier> m_notifier;     ///< uevent 可读通知
+    bool m_filterInstalled;                         ///< 是否已安装原生事件过滤器
+    bool m_active;                                  ///< 是否正在监听
+};
+
+#endif // SERIALHOTPLUGWATCHER_H
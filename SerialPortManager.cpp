@@ -1,4 +1,5 @@
 #include "SerialPortManager.h"
+#include "SerialHotplugWatcher.h"
 #include <QSerialPort>
 #include <algorithm>
 
@@ -7,7 +8,8 @@ SerialPortManager::SerialPortManager(QObject *parent)
 
     // 创建定时器对象，将返回的指针赋值给m_dT
     ,
-      m_detectionTimer(new QTimer(this)), m_isMonitoring(false)
+      m_detectionTimer(new QTimer(this)), m_settleTimer(new QTimer(this)),
+      m_hotplugWatcher(new SerialHotplugWatcher(this)), m_isMonitoring(false)
 {
     // 配置检测定时器
     initializeComponents();
@@ -27,6 +29,10 @@ void SerialPortManager::initializeComponents()
     m_detectionTimer->setSingleShot(false); // 非单次定时器
     m_detectionTimer->setInterval(2000);    // 默认2秒间隔
 
+    // 热插拔通知先于设备节点创建到达，且一次插拔会连续通知多次，合并为一次延迟检测
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(kHotplugSettleMs);
+
     // 初始化状态
     m_isMonitoring = false;
 }
@@ -38,6 +44,12 @@ void SerialPortManager::initConnections()
     // 定时结束，调用检测串口函数，暂存可用的串口列表，发送当前识别到的串口以及新增或减少的串口的信号
     connect(m_detectionTimer.data(), &QTimer::timeout,
             this, &SerialPortManager::onDetectionTimerTimeout);
+
+    // 热插拔通知：延迟合并后检测
+    connect(m_hotplugWatcher.data(), &SerialHotplugWatcher::devicesChanged,
+            this, &SerialPortManager::onHotplugNotified);
+    connect(m_settleTimer.data(), &QTimer::timeout,
+            this, &SerialPortManager::detectPorts);
 }
 
 void SerialPortManager::startMonitoring(int intervalMs)
@@ -47,8 +59,10 @@ void SerialPortManager::startMonitoring(int intervalMs)
         return; // 已经在监控中
     }
 
-    // 设置监测器的检测间隔时间
-    m_detectionTimer->setInterval(intervalMs);
+    // 热插拔通知可用时轮询只作兜底，间隔放宽；否则按指定间隔轮询
+    const bool hotplug = m_hotplugWatcher->start();
+    const int fallbackIntervalMs = kFallbackPollIntervalMs;
+    m_detectionTimer->setInterval(hotplug ? qMax(intervalMs, fallbackIntervalMs) : intervalMs);
 
     // 监测函数
     // 立即进行一次检测
@@ -69,6 +83,8 @@ void SerialPortManager::stopMonitoring()
     }
 
     m_detectionTimer->stop();
+    m_settleTimer->stop();
+    m_hotplugWatcher->stop();
     m_isMonitoring = false;
 }
 
@@ -82,6 +98,11 @@ bool SerialPortManager::isMonitoring() const
     return m_isMonitoring;
 }
 
+bool SerialPortManager::isHotplugActive() const
+{
+    return m_hotplugWatcher->isActive();
+}
+
 void SerialPortManager::detectPorts()
 {
     // 识别到的可用的串口列表
@@ -117,6 +138,11 @@ void SerialPortManager::onDetectionTimerTimeout()
     detectPorts();
 }
 
+void SerialPortManager::onHotplugNotified()
+{
+    m_settleTimer->start();
+}
+
 bool SerialPortManager::isUsbSerialDevice(const QSerialPortInfo &portInfo) const
 {
     // 获取设备描述和厂商信息（转为小写便于比较）
@@ -7,6 +7,8 @@
 #include <QStringList>
 #include <QScopedPointer>
 
+class SerialHotplugWatcher;
+
 /**
  * @brief 串口设备管理器
  * 
@@ -14,12 +16,18 @@
  * - 检测USB转串口设备
  * - 管理可用串口列表
  * - 通过信号通知UI更新
+ *
+ * 优先使用系统的热插拔通知（SerialHotplugWatcher），收到通知后稍作延迟再枚举串口；
+ * 定时轮询只作为兜底（热插拔可用时间隔放宽到 kFallbackPollIntervalMs）。
  */
 class SerialPortManager : public QObject
 {
     Q_OBJECT
 
 public:
+    static constexpr int kFallbackPollIntervalMs = 30000;  ///< 热插拔通知可用时的兜底轮询间隔
+    static constexpr int kHotplugSettleMs = 300;           ///< 收到插拔通知后等待设备节点就绪的时间
+
     /**
      * @brief 构造函数，explicit防止隐式转换
      * @param parent 父对象指针
@@ -32,8 +40,8 @@ public:
     ~SerialPortManager() override;
 
     /**
-     * @brief 开始检测串口，并开启定时器，监测串口的状态，默认2000ms检测一次。
-     * @param intervalMs 检测间隔（毫秒），占位参数，默认2000ms。
+     * @brief 开始检测串口：订阅热插拔通知，并开启定时器兜底轮询
+     * @param intervalMs 热插拔通知不可用时的轮询间隔（毫秒），默认2000ms。
      */
     void startMonitoring(int intervalMs = 2000);
 
@@ -54,6 +62,12 @@ public:
      */
     bool isMonitoring() const;
 
+    /**
+     * @brief 是否正在使用系统热插拔通知
+     * @return false表示仅靠定时轮询
+     */
+    bool isHotplugActive() const;
+
 public slots:
     /**
      * @brief 立即检测串口（手动触发）
@@ -85,6 +99,11 @@ private slots:
      */
     void onDetectionTimerTimeout();
 
+    /**
+     * @brief 收到热插拔通知，延迟 kHotplugSettleMs 后检测（连续通知只检测一次）
+     */
+    void onHotplugNotified();
+
 private:
     /**
      * @brief 初始化组件，配置检测定时器
@@ -113,6 +132,8 @@ private:
     // 成员变量
     // 智能指针类模板，确保在当前作用域消失时所指向的对象会被删除。
     QScopedPointer<QTimer> m_detectionTimer;    ///< 检测定时器
+    QScopedPointer<QTimer> m_settleTimer;       ///< 热插拔通知后的延迟检测定时器
+    QScopedPointer<SerialHotplugWatcher> m_hotplugWatcher;  ///< 系统热插拔通知
     QStringList m_currentPorts;                 ///< 当前串口列表
     bool m_isMonitoring;                        ///< 监控状态标志
 };
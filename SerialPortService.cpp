@@ -1,27 +1,53 @@
 #include "SerialPortService.h"
+#include "SerialPortWorker.h"
+#include "SimulatedDeviceTransport.h"
 #include "DeviceProtocol.h"
 
 SerialPortService::SerialPortService(QObject *parent)
     : QObject(parent)
-    , m_serialPort(new QSerialPort(this))
+    , m_serialWorker(new SerialPortWorker())
+    , m_simulator(new SimulatedDeviceTransport())
+    , m_worker(m_serialWorker)
     , m_isOpen(false)
+    , m_nextTransactionId(1)
 {
-    setupConnections();
+    setupWorker();
 }
 
 SerialPortService::~SerialPortService()
 {
     closePort();
+
+    m_ioThread.quit();
+    m_ioThread.wait();
+}
+
+void SerialPortService::setupWorker()
+{
+    m_ioThread.setObjectName(QStringLiteral("SerialPortIO"));
+    attachTransport(m_serialWorker);
+    attachTransport(m_simulator);
+
+    m_ioThread.start();
 }
 
-void SerialPortService::setupConnections()
+void SerialPortService::attachTransport(DeviceTransport *transport)
 {
-    // 连接串口信号
-    // 有新数据到来，触发读串口中数据的操作
-    connect(m_serialPort, &QSerialPort::readyRead,
-            this, &SerialPortService::onReadyRead);
-    connect(m_serialPort, &QSerialPort::errorOccurred,
-            this, &SerialPortService::onErrorOccurred);
+    // 工作对象移入I/O线程，线程结束时在I/O线程内销毁
+    transport->moveToThread(&m_ioThread);
+    connect(&m_ioThread, &QThread::finished,
+            transport, &QObject::deleteLater);
+
+    // 连接工作对象信号（跨线程，自动使用队列连接）
+    // 有新数据到来，转发给DeviceController处理
+    connect(transport, &DeviceTransport::dataReceived,
+            this, &SerialPortService::dataReceived);
+    connect(transport, &DeviceTransport::errorOccurred,
+            this, &SerialPortService::errorOccurred);
+    connect(transport, &DeviceTransport::transactionFinished,
+            this, &SerialPortService::transactionFinished);
+    connect(transport, &DeviceTransport::portLost,
+            this, &SerialPortService::onPortLost);
 }
 
 bool SerialPortService::openPort(const QString &portName, int baudRate)
@@ -30,141 +56,82 @@ bool SerialPortService::openPort(const QString &portName, int baudRate)
         closePort();
     }
 
-    m_serialPort->setPortName(portName);
-    m_serialPort->setBaudRate(baudRate);
-    configurePort();
+    // 按串口名选择传输对象
+    m_worker = SimulatedDeviceTransport::isSimulatedPort(portName) ? m_simulator : m_serialWorker;
+
+    // 阻塞等待I/O线程完成打开操作
+    bool opened = false;
+    QMetaObject::invokeMethod(m_worker, "openPort", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, opened),
+                              Q_ARG(QString, portName),
+                              Q_ARG(int, baudRate));
 
-    if (m_serialPort->open(QIODevice::ReadWrite)) {
+    if (opened) {
+        m_portName = portName;
         m_isOpen = true;
         emit portStatusChanged(true);
         return true;
     } else {
-        emit errorOccurred(tr("无法打开串口 %1: %2").arg(portName, m_serialPort->errorString()));
         return false;
     }
 }
 
 void SerialPortService::closePort()
 {
-    if (m_serialPort && m_serialPort->isOpen()) {
-        m_serialPort->close();
-    }
-    
+    // 阻塞等待I/O线程完成关闭操作
+    QMetaObject::invokeMethod(m_worker, "closePort", Qt::BlockingQueuedConnection);
+
     if (m_isOpen) {
         m_isOpen = false;
         emit portStatusChanged(false);
     }
 }
 
-bool SerialPortService::isOpen() const
+bool SerialPortService::setBaudRate(int baudRate)
 {
-    return m_isOpen && m_serialPort && m_serialPort->isOpen();
-}
+    if (!m_isOpen) {
+        return false;
+    }
 
-QString SerialPortService::portName() const
-{
-    return m_serialPort ? m_serialPort->portName() : QString();
+    bool switched = false;
+    QMetaObject::invokeMethod(m_worker, "setBaudRate", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, switched),
+                              Q_ARG(int, baudRate));
+    return switched;
 }
 
-void SerialPortService::configurePort()
+bool SerialPortService::isOpen() const
 {
-    // 配置串口参数：8数据位，1停止位，无流控
-    m_serialPort->setDataBits(QSerialPort::Data8);
-    m_serialPort->setParity(QSerialPort::SpaceParity);   // 默认为数据帧模式
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    return m_isOpen;
 }
 
-bool SerialPortService::writeAddressByte(uint8_t address, int timeoutMs)
+QString SerialPortService::portName() const
 {
-    if (!isOpen()) {
-        return false;
-    }
-
-    // 切换到MarkParity (9th bit = 1) 用于地址帧
-    m_serialPort->setParity(QSerialPort::MarkParity);
-
-    QByteArray addressData;
-    addressData.append(static_cast<char>(address));
-
-    qint64 bytesWritten = m_serialPort->write(addressData);
-    if (bytesWritten != addressData.size()) {
-        return false;
-    }
-
-    // 等待发送完成
-    if (!m_serialPort->waitForBytesWritten(timeoutMs)) {
-        return false;
-    }
-
-    // 立即切换回SpaceParity (9th bit = 0) 用于后续数据帧
-    m_serialPort->setParity(QSerialPort::SpaceParity);
-
-    return true;
+    return m_portName;
 }
 
-bool SerialPortService::writeData(const QByteArray &data, int timeoutMs)
+quint64 SerialPortService::submitTransaction(uint8_t address, const QByteArray &data, int timeoutMs)
 {
     if (!isOpen() || data.isEmpty()) {
-        return false;
-    }
-
-    // 确保使用SpaceParity (9th bit = 0) 用于数据帧
-    m_serialPort->setParity(QSerialPort::SpaceParity);
-
-    qint64 bytesWritten = m_serialPort->write(data);
-    if (bytesWritten != data.size()) {
-        return false;
-    }
-
-    // 等待发送完成
-    if (!m_serialPort->waitForBytesWritten(timeoutMs)) {
-        return false;
+        return 0;
     }
 
-    return true;
-}
-
-void SerialPortService::onReadyRead()
-{
-    if (!m_serialPort) {
-        return;
-    }
-
-    // 读取串口的中的数据
-    QByteArray data = m_serialPort->readAll();
-    if (!data.isEmpty()) {
+    quint64 id = m_nextTransactionId++;
 
-        // 释放信号，触发DeviceController::onSerialDataReceived处理接收到的数据——接收数据
-        emit dataReceived(data);
-    }
+    // 排队到I/O线程执行，不等待写入完成
+    QMetaObject::invokeMethod(m_worker, "enqueueTransaction", Qt::QueuedConnection,
+                              Q_ARG(quint64, id),
+                              Q_ARG(quint8, address),
+                              Q_ARG(QByteArray, data),
+                              Q_ARG(int, timeoutMs));
+    return id;
 }
 
-void SerialPortService::onErrorOccurred(QSerialPort::SerialPortError error)
+void SerialPortService::onPortLost()
 {
-    if (error == QSerialPort::NoError) {
-        return;
-    }
-
-    QString errorString = m_serialPort ? m_serialPort->errorString() : tr("未知串口错误");
-    emit errorOccurred(errorString);
-    
-    // 检测致命错误类型，需要主动关闭串口
-    bool isFatalError = false;
-    switch (error) {
-    case QSerialPort::ResourceError:       // 资源错误（设备被拔出）
-    case QSerialPort::DeviceNotFoundError: // 设备未找到
-    case QSerialPort::PermissionError:     // 权限错误（设备被占用或没有权限）
-    case QSerialPort::UnknownError:        // 未知错误
-        isFatalError = true;
-        break;
-    default:
-        // 其他错误（如超时、写入错误等）可能是暂时性的，不主动关闭
-        break;
-    }
-    
-    // 遇到致命错误时主动关闭串口并通知上层
-    if (isFatalError && m_isOpen) {
-        closePort();  // 会自动发射 portStatusChanged(false)
+    // I/O线程已关闭串口，这里只同步状态并通知上层
+    if (m_isOpen) {
+        m_isOpen = false;
+        emit portStatusChanged(false);
     }
 }
@@ -2,19 +2,24 @@
 #define SERIALPORTSERVICE_H
 
 #include <QObject>
-#include <QSerialPort>
-#include <QTimer>
+#include <QThread>
 #include <QByteArray>
 #include <QString>
 
+class DeviceTransport;
+
 /**
  * @brief 串口服务类
  *
  * 职责：
- * - 封装QSerialPort的底层操作
- * - 提供原子的地址帧和数据帧发送
- * - 管理9位地址/数据协议的校验位切换
- * - 通过信号提供非阻塞的数据接收和错误通知
+ * - 在独立的I/O线程中运行传输对象：SerialPortWorker（独占QSerialPort）或
+ *   SimulatedDeviceTransport（串口名以 "SIM" 开头时使用的进程内模拟设备）
+ * - 提供原子的(地址帧, 数据帧)写事务，异步执行，不阻塞调用线程
+ * - 管理9位地址/数据协议的校验位切换（在I/O线程内完成）
+ * - 通过信号提供非阻塞的数据接收、写事务完成和错误通知
+ *
+ * 打开/关闭串口仍为同步调用（阻塞等待I/O线程完成，耗时很短）；
+ * 写事务只负责排队，结果通过 transactionFinished 信号返回。
  */
 class SerialPortService : public QObject
 {
@@ -28,23 +33,30 @@ public:
     explicit SerialPortService(QObject *parent = nullptr);
 
     /**
-     * @brief 析构函数
+     * @brief 析构函数（关闭串口并结束I/O线程）
      */
     ~SerialPortService() override;
 
     /**
      * @brief 打开串口
-     * @param portName 串口名称
+     * @param portName 串口名称（"SIM" 或 "SIM:参数" 表示模拟设备）
      * @param baudRate 波特率，默认9600
      * @return 是否成功打开
      */
     bool openPort(const QString &portName, int baudRate = 9600);
 
     /**
-     * @brief 关闭串口
+     * @brief 关闭串口（未完成的写事务以失败结束）
      */
     void closePort();
 
+    /**
+     * @brief 切换已打开串口的波特率（阻塞等待I/O线程完成）
+     * @param baudRate 新波特率
+     * @return 是否切换成功
+     */
+    bool setBaudRate(int baudRate);
+
     /**
      * @brief 检查串口是否已打开
      * @return true表示已打开
@@ -58,27 +70,23 @@ public:
     QString portName() const;
 
     /**
-     * @brief 发送地址字节（使用MarkParity，9th bit = 1）
+     * @brief 提交一个写事务：地址字节（MarkParity）+ 数据字节（SpaceParity）
      * @param address 地址字节
-     * @param timeoutMs 写入超时时间，默认1000ms
-     * @return 是否发送成功
-     */
-    bool writeAddressByte(uint8_t address, int timeoutMs = 1000);
-
-    /**
-     * @brief 发送数据字节（使用SpaceParity，9th bit = 0）
      * @param data 要发送的数据
-     * @param timeoutMs 写入超时时间，默认1000ms
-     * @return 是否发送成功
+     * @param timeoutMs 事务写入超时时间，默认1000ms
+     * @return 事务编号；串口未打开或数据为空时返回0
+     *
+     * 事务按提交顺序在I/O线程中执行，完成后发射 transactionFinished。
      */
-    bool writeData(const QByteArray &data, int timeoutMs = 1000);
+    quint64 submitTransaction(uint8_t address, const QByteArray &data, int timeoutMs = 1000);
 
 signals:
     /**
      * @brief 有数据可读时发射
      * @param data 接收到的数据
+     * @param readNs 读取时刻（MonotonicClock 时间轴，纳秒），不含事件队列的排队延迟
      */
-    void dataReceived(const QByteArray &data);
+    void dataReceived(const QByteArray &data, qint64 readNs);
 
     /**
      * @brief 串口错误发生时发射
@@ -92,32 +100,39 @@ signals:
      */
     void portStatusChanged(bool isOpen);
 
-private slots:
     /**
-     * @brief 处理串口数据可读事件
+     * @brief 写事务结束时发射
+     * @param id 事务编号（submitTransaction 的返回值）
+     * @param success 是否写入成功
+     * @param errorString 失败原因（成功时为空）
      */
-    void onReadyRead();
+    void transactionFinished(quint64 id, bool success, const QString &errorString);
 
+private slots:
     /**
-     * @brief 处理串口错误事件
-     * @param error 错误码
+     * @brief 处理I/O线程报告的串口被动关闭（设备拔出等致命错误）
      */
-    void onErrorOccurred(QSerialPort::SerialPortError error);
+    void onPortLost();
 
 private:
     /**
-     * @brief 初始化信号连接
+     * @brief 初始化I/O线程和信号连接
      */
-    void setupConnections();
+    void setupWorker();
 
     /**
-     * @brief 配置串口参数
+     * @brief 将传输对象移入I/O线程并连接信号
      */
-    void configurePort();
+    void attachTransport(DeviceTransport *transport);
 
     // 成员变量
-    QSerialPort *m_serialPort;     ///< 串口对象
+    QThread m_ioThread;                 ///< 串口I/O线程
+    DeviceTransport *m_serialWorker;    ///< 真实串口传输对象（属于I/O线程）
+    DeviceTransport *m_simulator;       ///< 模拟设备传输对象（属于I/O线程）
+    DeviceTransport *m_worker;          ///< 当前使用的传输对象
+    QString m_portName;            ///< 当前串口名称
     bool m_isOpen;                 ///< 串口状态标志
+    quint64 m_nextTransactionId;   ///< 下一个写事务编号
 };
 
 #endif // SERIALPORTSERVICE_H
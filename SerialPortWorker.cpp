@@ -0,0 +1,221 @@
+#include "SerialPortWorker.h"
+#include "domain/MonotonicClock.h"
+
+SerialPortWorker::SerialPortWorker(QObject *parent)
+    : DeviceTransport(parent)
+    , m_serialPort(new QSerialPort(this))
+    , m_transactionTimer(new QTimer(this))
+    , m_stage(Stage::Idle)
+    , m_bytesPending(0)
+{
+    m_current.id = 0;
+    m_current.address = 0;
+    m_current.timeoutMs = 0;
+
+    m_transactionTimer->setSingleShot(true);
+
+    connect(m_serialPort, &QSerialPort::readyRead,
+            this, &SerialPortWorker::onReadyRead);
+    connect(m_serialPort, &QSerialPort::bytesWritten,
+            this, &SerialPortWorker::onBytesWritten);
+    connect(m_serialPort, &QSerialPort::errorOccurred,
+            this, &SerialPortWorker::onErrorOccurred);
+    connect(m_transactionTimer, &QTimer::timeout,
+            this, &SerialPortWorker::onTransactionTimeout);
+}
+
+SerialPortWorker::~SerialPortWorker()
+{
+    closePort();
+}
+
+bool SerialPortWorker::openPort(const QString &portName, int baudRate)
+{
+    closePort();
+
+    m_serialPort->setPortName(portName);
+    m_serialPort->setBaudRate(baudRate);
+
+    // 配置串口参数：8数据位，1停止位，无流控
+    m_serialPort->setDataBits(QSerialPort::Data8);
+    m_serialPort->setParity(QSerialPort::SpaceParity);   // 默认为数据帧模式
+    m_serialPort->setStopBits(QSerialPort::OneStop);
+    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!m_serialPort->open(QIODevice::ReadWrite)) {
+        emit errorOccurred(tr("无法打开串口 %1: %2").arg(portName, m_serialPort->errorString()));
+        return false;
+    }
+
+    return true;
+}
+
+void SerialPortWorker::closePort()
+{
+    abortAllTransactions(tr("串口已关闭"));
+
+    if (m_serialPort->isOpen()) {
+        m_serialPort->close();
+    }
+}
+
+bool SerialPortWorker::setBaudRate(int baudRate)
+{
+    return m_serialPort->isOpen() && m_serialPort->setBaudRate(baudRate);
+}
+
+void SerialPortWorker::enqueueTransaction(quint64 id, quint8 address, const QByteArray &payload, int timeoutMs)
+{
+    Transaction transaction;
+    transaction.id = id;
+    transaction.address = address;
+    transaction.payload = payload;
+    transaction.timeoutMs = timeoutMs;
+    m_queue.enqueue(transaction);
+
+    startNextTransaction();
+}
+
+void SerialPortWorker::startNextTransaction()
+{
+    if (m_stage != Stage::Idle || m_queue.isEmpty()) {
+        return;
+    }
+
+    m_current = m_queue.dequeue();
+
+    if (!m_serialPort->isOpen()) {
+        m_stage = Stage::Address;
+        finishCurrentTransaction(false, tr("串口未打开"));
+        return;
+    }
+
+    // 第一阶段：切换到MarkParity (9th bit = 1) 发送地址帧
+    m_stage = Stage::Address;
+    m_transactionTimer->start(m_current.timeoutMs);
+
+    QByteArray addressData;
+    addressData.append(static_cast<char>(m_current.address));
+    if (!writeWithParity(QSerialPort::MarkParity, addressData)) {
+        finishCurrentTransaction(false, tr("地址字节写入失败: %1").arg(m_serialPort->errorString()));
+    }
+}
+
+bool SerialPortWorker::writeWithParity(QSerialPort::Parity parity, const QByteArray &data)
+{
+    m_serialPort->setParity(parity);
+
+    m_bytesPending = data.size();
+    qint64 bytesWritten = m_serialPort->write(data);
+    return bytesWritten == data.size();
+}
+
+void SerialPortWorker::onBytesWritten(qint64 bytes)
+{
+    if (m_stage == Stage::Idle) {
+        return;
+    }
+
+    m_bytesPending -= bytes;
+    if (m_bytesPending > 0) {
+        return;
+    }
+
+    if (m_stage == Stage::Address) {
+        // 地址字节已写出，第二阶段：切换回SpaceParity (9th bit = 0) 发送数据帧
+        if (m_current.payload.isEmpty()) {
+            finishCurrentTransaction(true, QString());
+            return;
+        }
+
+        m_stage = Stage::Payload;
+        if (!writeWithParity(QSerialPort::SpaceParity, m_current.payload)) {
+            finishCurrentTransaction(false, tr("数据写入失败: %1").arg(m_serialPort->errorString()));
+        }
+    } else {
+        finishCurrentTransaction(true, QString());
+    }
+}
+
+void SerialPortWorker::finishCurrentTransaction(bool success, const QString &errorString)
+{
+    if (m_stage == Stage::Idle) {
+        return;
+    }
+
+    m_transactionTimer->stop();
+    m_stage = Stage::Idle;
+    m_bytesPending = 0;
+
+    // 失败时确保恢复为数据帧模式，避免影响下一个事务
+    if (!success && m_serialPort->isOpen()) {
+        m_serialPort->setParity(QSerialPort::SpaceParity);
+    }
+
+    quint64 id = m_current.id;
+    m_current.payload.clear();
+    emit transactionFinished(id, success, errorString);
+
+    startNextTransaction();
+}
+
+void SerialPortWorker::abortAllTransactions(const QString &reason)
+{
+    // 先清空队列，避免 finishCurrentTransaction 继续启动排队事务
+    QQueue<Transaction> queued;
+    queued.swap(m_queue);
+
+    if (m_stage != Stage::Idle) {
+        finishCurrentTransaction(false, reason);
+    }
+
+    for (const Transaction &transaction : queued) {
+        emit transactionFinished(transaction.id, false, reason);
+    }
+}
+
+void SerialPortWorker::onTransactionTimeout()
+{
+    finishCurrentTransaction(false, tr("写入超时（%1ms）").arg(m_current.timeoutMs));
+}
+
+void SerialPortWorker::onReadyRead()
+{
+    // 读取串口的中的数据（读取时刻在I/O线程中记录，不受主线程事件排队影响）
+    const qint64 readNs = MonotonicClock::nowNs();
+    QByteArray data = m_serialPort->readAll();
+    if (!data.isEmpty()) {
+
+        // 释放信号，经SerialPortService转发到DeviceController::onSerialDataReceived——接收数据
+        emit dataReceived(data, readNs);
+    }
+}
+
+void SerialPortWorker::onErrorOccurred(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) {
+        return;
+    }
+
+    emit errorOccurred(m_serialPort->errorString());
+
+    // 检测致命错误类型，需要主动关闭串口
+    bool isFatalError = false;
+    switch (error) {
+    case QSerialPort::ResourceError:       // 资源错误（设备被拔出）
+    case QSerialPort::DeviceNotFoundError: // 设备未找到
+    case QSerialPort::PermissionError:     // 权限错误（设备被占用或没有权限）
+    case QSerialPort::UnknownError:        // 未知错误
+        isFatalError = true;
+        break;
+    default:
+        // 其他错误（如超时、写入错误等）可能是暂时性的，不主动关闭
+        break;
+    }
+
+    // 遇到致命错误时主动关闭串口并通知上层
+    if (isFatalError && m_serialPort->isOpen()) {
+        closePort();
+        emit portLost();
+    }
+}
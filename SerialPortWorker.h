@@ -0,0 +1,110 @@
+#ifndef SERIALPORTWORKER_H
+#define SERIALPORTWORKER_H
+
+#include <QSerialPort>
+#include <QTimer>
+#include <QQueue>
+#include <QByteArray>
+#include <QString>
+#include "DeviceTransport.h"
+
+/**
+ * @brief 串口I/O工作对象（运行在独立的I/O线程中）
+ *
+ * 职责：
+ * - 独占QSerialPort，所有串口读写都在I/O线程内完成
+ * - 按顺序执行(地址, 数据)写事务：MarkParity写地址 → 写完后切SpaceParity写数据
+ * - 通过 bytesWritten 异步推进事务，不调用 waitForBytesWritten，写入期间读取不受影响
+ * - 每个事务独立超时，完成/失败通过信号通知
+ *
+ * 该类只应由 SerialPortService 创建和调用（通过队列连接跨线程调用槽函数），
+ * 信号定义见 DeviceTransport。
+ */
+class SerialPortWorker : public DeviceTransport
+{
+    Q_OBJECT
+
+public:
+    explicit SerialPortWorker(QObject *parent = nullptr);
+    ~SerialPortWorker() override;
+
+public slots:
+    /**
+     * @brief 打开串口（由SerialPortService以阻塞队列连接调用）
+     * @param portName 串口名称
+     * @param baudRate 波特率
+     * @return 是否成功打开
+     */
+    bool openPort(const QString &portName, int baudRate) override;
+
+    /**
+     * @brief 关闭串口，丢弃所有未完成的事务（每个事务都会以失败结束）
+     */
+    void closePort() override;
+    bool setBaudRate(int baudRate) override;
+
+    /**
+     * @brief 追加一个写事务到队列
+     * @param id 事务编号（由SerialPortService分配）
+     * @param address 地址字节（MarkParity发送）
+     * @param payload 数据字节（SpaceParity发送）
+     * @param timeoutMs 事务超时时间（从开始写地址字节计时）
+     */
+    void enqueueTransaction(quint64 id, quint8 address, const QByteArray &payload, int timeoutMs) override;
+
+private slots:
+    void onReadyRead();
+    void onBytesWritten(qint64 bytes);
+    void onErrorOccurred(QSerialPort::SerialPortError error);
+    void onTransactionTimeout();
+
+private:
+    /**
+     * @brief 写事务
+     */
+    struct Transaction {
+        quint64 id;
+        quint8 address;
+        QByteArray payload;
+        int timeoutMs;
+    };
+
+    /**
+     * @brief 事务执行阶段
+     */
+    enum class Stage {
+        Idle,           ///< 空闲
+        Address,        ///< 正在写地址字节
+        Payload         ///< 正在写数据字节
+    };
+
+    /**
+     * @brief 队列非空且空闲时开始下一个事务
+     */
+    void startNextTransaction();
+
+    /**
+     * @brief 以指定校验位写入数据
+     * @return 数据是否全部交给串口驱动
+     */
+    bool writeWithParity(QSerialPort::Parity parity, const QByteArray &data);
+
+    /**
+     * @brief 结束当前事务并继续处理队列
+     */
+    void finishCurrentTransaction(bool success, const QString &errorString);
+
+    /**
+     * @brief 以失败结束当前事务和所有排队事务
+     */
+    void abortAllTransactions(const QString &reason);
+
+    QSerialPort *m_serialPort;          ///< 串口对象（属于I/O线程）
+    QTimer *m_transactionTimer;         ///< 当前事务超时定时器
+    QQueue<Transaction> m_queue;        ///< 待执行事务队列
+    Transaction m_current;              ///< 当前事务
+    Stage m_stage;                      ///< 当前事务阶段
+    qint64 m_bytesPending;              ///< 当前阶段尚未写完的字节数
+};
+
+#endif // SERIALPORTWORKER_H
@@ -0,0 +1,422 @@
+#include "SimulatedDeviceTransport.h"
+#include "DeviceProtocol.h"
+#include "domain/MonotonicClock.h"
+#include "protocol/BaudRate.h"
+#include "protocol/ProtocolParser.h"
+#include <QFile>
+#include <QStringList>
+#include <cstring>
+
+constexpr const char *SimulatedDeviceTransport::kPortPrefix;
+constexpr int SimulatedDeviceTransport::kMaxBytesPerTick;
+
+SimulatedDeviceTransport::SimulatedDeviceTransport(QObject *parent)
+    : DeviceTransport(parent)
+    , m_tickTimer(new QTimer(this))
+    , m_isOpen(false)
+    , m_baudRate(DeviceProtocol::kBaud)
+    , m_deviceBaudRate(BaudRate::kDefault)
+    , m_revertDueMs(-1)
+    , m_lastFrameMs(0)
+    , m_format(DeviceProtocol::MeasurementFormat::Float)
+    , m_scanMask(0)
+    , m_streaming(false)
+    , m_streamStartNs(0)
+    , m_samplesSent(0)
+    , m_replayPos(0)
+{
+    m_tickTimer->setInterval(kTickIntervalMs);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_tickTimer, &QTimer::timeout, this, &SimulatedDeviceTransport::onTick);
+}
+
+SimulatedDeviceTransport::~SimulatedDeviceTransport()
+{
+    closePort();
+}
+
+bool SimulatedDeviceTransport::isSimulatedPort(const QString &portName)
+{
+    return portName == QLatin1String(kPortPrefix) ||
+           portName.startsWith(QLatin1String(kPortPrefix) + QLatin1Char(':'));
+}
+
+bool SimulatedDeviceTransport::parsePortName(const QString &portName, Config &config, QString *errorString)
+{
+    int colon = portName.indexOf(QLatin1Char(':'));
+    if (colon < 0) {
+        return true;
+    }
+
+    const QStringList options = portName.mid(colon + 1).split(QLatin1Char(','), QString::SkipEmptyParts);
+    for (const QString &option : options) {
+        int eq = option.indexOf(QLatin1Char('='));
+        const QString key = option.left(eq).trimmed();
+        const QString value = (eq < 0) ? QString() : option.mid(eq + 1).trimmed();
+
+        bool ok = true;
+        if (key == QLatin1String("rate")) {
+            config.sampleRateHz = value.toDouble(&ok);
+            ok = ok && config.sampleRateHz >= 0.0;
+        } else if (key == QLatin1String("chunk")) {
+            config.chunkSize = value.toInt(&ok);
+            ok = ok && config.chunkSize >= 0;
+        } else if (key == QLatin1String("latency")) {
+            config.ackLatencyMs = value.toInt(&ok);
+            ok = ok && config.ackLatencyMs >= 0;
+        } else if (key == QLatin1String("level")) {
+            config.level = value.toDouble(&ok);
+        } else if (key == QLatin1String("noise")) {
+            config.noise = value.toDouble(&ok);
+            ok = ok && config.noise >= 0.0;
+        } else if (key == QLatin1String("replay")) {
+            config.replayPath = value;
+            ok = !value.isEmpty();
+        } else if (key == QLatin1String("speed")) {
+            config.replaySpeed = value.toDouble(&ok);
+            ok = ok && config.replaySpeed >= 0.0;
+        } else if (key == QLatin1String("maxbaud")) {
+            config.maxBaudRate = value.toInt(&ok);
+            ok = ok && BaudRate::codeOf(config.maxBaudRate) >= 0;
+        } else if (key == QLatin1String("packed")) {
+            config.packedFrames = value.toInt(&ok) != 0;
+        } else if (key == QLatin1String("batch")) {
+            config.packedBatch = value.toInt(&ok);
+            ok = ok && config.packedBatch >= 1 && config.packedBatch <= ProtocolParser::kPackedMaxSamples;
+        } else if (key == QLatin1String("channels")) {
+            const int mask = value.toInt(&ok, 0);
+            ok = ok && (mask == 0 || ProtocolParser::scanFrameSize(static_cast<uint8_t>(mask)) > 0);
+            config.channelMask = static_cast<uint8_t>(mask);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            if (errorString) {
+                *errorString = tr("模拟设备参数无效: %1").arg(option);
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SimulatedDeviceTransport::openPort(const QString &portName, int baudRate)
+{
+    closePort();
+
+    Config config;
+    QString error;
+    if (!parsePortName(portName, config, &error)) {
+        emit errorOccurred(error);
+        return false;
+    }
+
+    if (!config.replayPath.isEmpty()) {
+        QFile file(config.replayPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit errorOccurred(tr("无法打开回放文件 %1: %2").arg(config.replayPath, file.errorString()));
+            return false;
+        }
+        m_replayData = file.readAll();
+        m_replayPos = 0;
+    }
+
+    m_config = config;
+    m_baudRate = baudRate > 0 ? baudRate : DeviceProtocol::kBaud;
+    m_deviceBaudRate = BaudRate::kDefault;     // 设备上电为默认速率
+    m_revertDueMs = -1;
+    m_lastFrameMs = 0;
+    m_format = DeviceProtocol::MeasurementFormat::Float;
+    m_scanMask = 0;
+    m_random.seed(1);
+    m_clock.start();
+    m_isOpen = true;
+    m_tickTimer->start();
+    return true;
+}
+
+void SimulatedDeviceTransport::closePort()
+{
+    if (!m_isOpen) {
+        return;
+    }
+
+    m_tickTimer->stop();
+    m_isOpen = false;
+    m_streaming = false;
+    m_replies.clear();
+    m_output.clear();
+    m_replayData.clear();
+    m_replayPos = 0;
+}
+
+bool SimulatedDeviceTransport::setBaudRate(int baudRate)
+{
+    if (!m_isOpen || baudRate <= 0) {
+        return false;
+    }
+    m_baudRate = baudRate;
+    return true;
+}
+
+void SimulatedDeviceTransport::enqueueTransaction(quint64 id, quint8 address, const QByteArray &payload, int timeoutMs)
+{
+    Q_UNUSED(timeoutMs);
+
+    if (!m_isOpen) {
+        emit transactionFinished(id, false, tr("串口未打开"));
+        return;
+    }
+
+    // 写入即完成；只应答发给本从机地址的命令
+    emit transactionFinished(id, true, QString());
+
+    // 速率不一致时设备收到的是乱码
+    if (address != DeviceProtocol::kSlaveAddress || m_baudRate != m_deviceBaudRate) {
+        return;
+    }
+
+    // 新速率下收到有效帧，确认切换成功
+    m_revertDueMs = -1;
+    m_lastFrameMs = m_clock.elapsed();
+
+    PendingReply reply;
+    reply.dueMs = m_clock.elapsed() + m_config.ackLatencyMs;
+    reply.bytes = respondTo(payload);
+    if (!reply.bytes.isEmpty()) {
+        m_replies.enqueue(reply);
+    }
+}
+
+QByteArray SimulatedDeviceTransport::respondTo(const QByteArray &payload)
+{
+    if (payload.isEmpty()) {
+        return QByteArray();
+    }
+
+    QByteArray reply;
+    switch (static_cast<uint8_t>(payload.at(0))) {
+    case 0x50:  // 启动外部电流表连续检测
+        reply.append(static_cast<char>(0x50));
+        reply.append(static_cast<char>(0xAA));
+        break;
+    case 0x51:  // 停止外部电流表连续检测
+        reply.append(static_cast<char>(0x51));
+        reply.append(static_cast<char>(0x55));
+        break;
+    case 0xAA:  // 暂停检测
+        reply = DeviceProtocol::buildPauseDetectionExpectedResponse();
+        break;
+    case 0x05:  // 开始检测（旧版单字节确认）
+        reply.append(static_cast<char>(0x05));
+        break;
+    case static_cast<uint8_t>(DeviceProtocol::CommandId::BaudRate): {
+        const uint8_t sub = payload.size() > 1 ? static_cast<uint8_t>(payload.at(1)) : DeviceProtocol::kBaudProbe;
+        if (sub == DeviceProtocol::kBaudCapsQuery) {
+            uint8_t mask = 0;
+            for (int code = 0; code < BaudRate::kRateCount; ++code) {
+                if (BaudRate::rateOf(code) <= m_config.maxBaudRate) {
+                    mask |= static_cast<uint8_t>(1u << code);
+                }
+            }
+            reply = payload.left(2);
+            reply.append(static_cast<char>(mask));
+        } else if (sub == DeviceProtocol::kBaudProbe ||
+                   (sub < BaudRate::kRateCount && BaudRate::rateOf(sub) <= m_config.maxBaudRate)) {
+            reply = payload.left(2);    // 切换请求在投递确认后生效（见 onTick）
+        }
+        break;
+    }
+    case static_cast<uint8_t>(DeviceProtocol::CommandId::MeasurementFormat):
+        if (m_config.packedFrames && payload.size() >= 2 &&
+            static_cast<uint8_t>(payload.at(1)) <= static_cast<uint8_t>(DeviceProtocol::MeasurementFormat::PackedDelta)) {
+            reply = payload.left(2);    // 投递确认后生效（见 onTick）
+        } else if (payload.size() >= 3 &&
+                   static_cast<uint8_t>(payload.at(1)) == static_cast<uint8_t>(DeviceProtocol::MeasurementFormat::MultiChannel)) {
+            // 位图须非空且在设备支持的通道以内
+            const uint8_t mask = static_cast<uint8_t>(payload.at(2));
+            if (mask != 0 && (mask & ~m_config.channelMask) == 0) {
+                reply = payload.left(3);
+            }
+        }
+        break;
+    default:    // 其他控制命令回显
+        reply = payload;
+        break;
+    }
+
+    return reply;
+}
+
+void SimulatedDeviceTransport::onTick()
+{
+    // 先投递到期的确认帧，再追加测量数据，保持与真实设备相同的先后顺序
+    const qint64 nowMs = m_clock.elapsed();
+    if (m_revertDueMs >= 0 && nowMs >= m_revertDueMs) {
+        m_deviceBaudRate = BaudRate::kDefault;
+        m_revertDueMs = -1;
+    }
+    // 空闲退回：速率和测量帧格式都恢复默认
+    if (m_revertDueMs < 0 && nowMs - m_lastFrameMs >= BaudRate::kIdleRevertMs) {
+        m_deviceBaudRate = BaudRate::kDefault;
+        m_format = DeviceProtocol::MeasurementFormat::Float;
+        m_scanMask = 0;
+    }
+
+    while (!m_replies.isEmpty() && m_replies.head().dueMs <= nowMs) {
+        const QByteArray bytes = m_replies.dequeue().bytes;
+        if (m_baudRate == m_deviceBaudRate) {
+            m_output.append(bytes);
+        }
+
+        const uint8_t command = static_cast<uint8_t>(bytes.at(0));
+        if (command == static_cast<uint8_t>(DeviceProtocol::CommandId::BaudRate) && bytes.size() == 2 &&
+            static_cast<uint8_t>(bytes.at(1)) < BaudRate::kRateCount) {
+            // 以原速率确认后切换，等待新速率下的探测帧
+            m_deviceBaudRate = BaudRate::rateOf(static_cast<uint8_t>(bytes.at(1)));
+            m_revertDueMs = nowMs + BaudRate::kRevertMs;
+        } else if (command == static_cast<uint8_t>(DeviceProtocol::CommandId::MeasurementFormat) && bytes.size() >= 2) {
+            m_format = static_cast<DeviceProtocol::MeasurementFormat>(bytes.at(1));
+            m_scanMask = bytes.size() >= 3 ? static_cast<uint8_t>(bytes.at(2)) : 0;
+        } else if (command == 0x50 || command == 0x05) {
+            m_streaming = true;
+            m_streamStartNs = m_clock.nsecsElapsed();
+            m_samplesSent = 0;
+        } else if (command == 0x51 || command == 0xAA) {
+            m_streaming = false;
+        }
+    }
+
+    if (!m_replayData.isEmpty()) {
+        generateReplay();
+    } else if (m_streaming) {
+        generateSamples();
+    }
+
+    flushOutput();
+}
+
+void SimulatedDeviceTransport::generateSamples()
+{
+    const double elapsedSec = (m_clock.nsecsElapsed() - m_streamStartNs) / 1e9;
+    qint64 due = static_cast<qint64>(elapsedSec * m_config.sampleRateHz) - m_samplesSent;
+    due = qMin<qint64>(due, kMaxBytesPerTick / 5);
+    if (due <= 0) {
+        return;
+    }
+
+    std::uniform_real_distribution<double> jitter(-m_config.noise, m_config.noise);
+
+    if (m_format == DeviceProtocol::MeasurementFormat::MultiChannel) {
+        generateScanSamples(due, jitter);
+        return;
+    }
+    if (m_format != DeviceProtocol::MeasurementFormat::Float) {
+        generatePackedSamples(due, jitter);
+        return;
+    }
+
+    const int base = m_output.size();
+    m_output.resize(base + static_cast<int>(due) * 5);
+    char *dst = m_output.data() + base;
+    for (qint64 i = 0; i < due; ++i) {
+        const float value = static_cast<float>(m_config.level + jitter(m_random));
+        dst[0] = static_cast<char>(0x50);
+        std::memcpy(dst + 1, &value, sizeof(float));  // 小端序，与下位机一致
+        dst += 5;
+    }
+    m_samplesSent += due;
+}
+
+void SimulatedDeviceTransport::generatePackedSamples(qint64 due, std::uniform_real_distribution<double> &jitter)
+{
+    // 以基准值为中心、0.1uA 为步长量化，凑满一批才发送（与下位机按批上传一致）
+    const float base = static_cast<float>(m_config.level);
+    const float scale = 1e-4f;
+    int16_t samples[ProtocolParser::kPackedMaxSamples];
+
+    for (; due >= m_config.packedBatch; due -= m_config.packedBatch) {
+        for (int i = 0; i < m_config.packedBatch; ++i) {
+            const int q = qRound(jitter(m_random) / scale);
+            samples[i] = static_cast<int16_t>(qBound(-32768, q, 32767));
+        }
+
+        QByteArray frame;
+        if (m_format == DeviceProtocol::MeasurementFormat::PackedDelta) {
+            frame = ProtocolParser::encodePackedFrame(ProtocolParser::kPackedDeltaHeader, base, scale,
+                                                      samples, m_config.packedBatch);
+        }
+        if (frame.isEmpty()) {
+            // 差值超出 int8 范围的批次改用 int16 帧
+            frame = ProtocolParser::encodePackedFrame(ProtocolParser::kPackedInt16Header, base, scale,
+                                                      samples, m_config.packedBatch);
+        }
+        m_output.append(frame);
+        m_samplesSent += m_config.packedBatch;
+    }
+}
+
+void SimulatedDeviceTransport::generateScanSamples(qint64 due, std::uniform_real_distribution<double> &jitter)
+{
+    float values[ProtocolParser::kScanMaxChannels];
+
+    for (qint64 scan = 0; scan < due; ++scan) {
+        int count = 0;
+        for (int bit = 0; bit < ProtocolParser::kScanMaxChannels; ++bit) {
+            if (m_scanMask & (1u << bit)) {
+                values[count++] = static_cast<float>(m_config.level * (bit + 1) + jitter(m_random));
+            }
+        }
+        m_output.append(ProtocolParser::encodeScanFrame(m_scanMask, values));
+    }
+    m_samplesSent += due;
+}
+
+void SimulatedDeviceTransport::generateReplay()
+{
+    int due;
+    if (m_config.replaySpeed <= 0.0) {
+        due = kMaxBytesPerTick;
+    } else {
+        // 9位协议每字节11位：起始位 + 8数据位 + 校验位 + 停止位
+        const double bytesPerSec = m_baudRate / 11.0 * m_config.replaySpeed;
+        const qint64 target = static_cast<qint64>(m_clock.nsecsElapsed() / 1e9 * bytesPerSec);
+        due = static_cast<int>(qMin<qint64>(target - m_replayPos, kMaxBytesPerTick));
+    }
+
+    due = qMin(due, m_replayData.size() - m_replayPos);
+    if (due <= 0) {
+        return;
+    }
+
+    m_output.append(m_replayData.constData() + m_replayPos, due);
+    m_replayPos += due;
+    if (m_replayPos >= m_replayData.size()) {
+        m_replayData.clear();
+        m_replayPos = 0;
+    }
+}
+
+void SimulatedDeviceTransport::flushOutput()
+{
+    if (m_output.isEmpty()) {
+        return;
+    }
+
+    // 最后一个分片按当前时刻读到，之前的分片按线路传输时间前推，与真实串口的到达时刻一致
+    const qint64 readNs = MonotonicClock::nowNs();
+    if (m_config.chunkSize <= 0 || m_output.size() <= m_config.chunkSize) {
+        emit dataReceived(m_output, readNs);
+        m_output.clear();
+        return;
+    }
+
+    const qint64 byteNs = BaudRate::byteTimeNs(m_baudRate);
+    for (int pos = 0; pos < m_output.size(); pos += m_config.chunkSize) {
+        const int end = qMin(pos + m_config.chunkSize, m_output.size());
+        emit dataReceived(m_output.mid(pos, m_config.chunkSize), readNs - (m_output.size() - end) * byteNs);
+    }
+    m_output.clear();
+}
@@ -0,0 +1,169 @@
+#ifndef SIMULATEDDEVICETRANSPORT_H
+#define SIMULATEDDEVICETRANSPORT_H
+
+#include <QTimer>
+#include <QQueue>
+#include <QByteArray>
+#include <QString>
+#include <QElapsedTimer>
+#include <random>
+#include "DeviceTransport.h"
+#include "DeviceProtocol.h"
+#include "protocol/ProtocolParser.h"
+
+/**
+ * @brief 进程内模拟设备（运行在SerialPortService的I/O线程中）
+ *
+ * 职责：
+ * - 代替真实串口应答控制命令：多数命令回显，0x50→[0x50,0xAA]，0x51→[0x51,0x55]，
+ *   0xAA→[0xAA,0x55]，0x05→[0x05]
+ * - 模拟波特率协商：0x60 能力查询返回 maxbaud 以内的速率位图，切换确认后设备改用新速率，
+ *   收发速率不一致时双方数据都丢弃，切换后 BaudRate::kRevertMs 内未收到探测帧则退回默认速率，
+ *   之后空闲（未收到有效帧）BaudRate::kIdleRevertMs 同样退回，测量帧格式同时恢复 Float
+ * - 开始检测后按设定速率产生 0x50 + float 测量帧；选择打包格式（0x61）后每 batch 个样本产生一个 0x52/0x53 打包帧
+ * - 选择多通道格式后每次扫描产生一个 0x54 扫描帧，第 k 个通道（CH1 为 0）的基准为 level * (k + 1)
+ * - 回放抓取的原始字节流，速度可设为波特率的倍数或不限速
+ * - 按设定的分片大小发射 dataReceived，用于复现最坏的串口分片情况
+ *
+ * 串口名以 "SIM" 开头时由SerialPortService选用，参数写在冒号后，逗号分隔：
+ *   SIM:rate=2000,chunk=1,latency=0,level=1.5,noise=0.05,maxbaud=921600,packed=1,batch=20,channels=15
+ *   SIM:replay=/path/capture.bin,speed=10
+ * 脱离硬件测量解析器、DeviceController和TestSequenceRunner的吞吐量与确认延迟。
+ */
+class SimulatedDeviceTransport : public DeviceTransport
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 模拟参数
+     */
+    struct Config {
+        double sampleRateHz;    ///< 测量帧速率（帧/秒），rate=
+        int chunkSize;          ///< 每次 dataReceived 的最大字节数，0 表示不分片，chunk=
+        int ackLatencyMs;       ///< 命令确认延迟（毫秒），latency=
+        double level;           ///< 测量值基准（mA），level=
+        double noise;           ///< 测量值随机波动幅度（mA），noise=
+        QString replayPath;     ///< 回放文件（原始接收字节流），replay=
+        double replaySpeed;     ///< 回放速度（波特率的倍数，0 表示不限速），speed=
+        int maxBaudRate;        ///< 设备支持的最高波特率（9600 表示不支持协商），maxbaud=
+        bool packedFrames;      ///< 是否支持打包测量帧（不支持时不回应格式选择），packed=
+        int packedBatch;        ///< 打包帧的样本数，batch=
+        uint8_t channelMask;    ///< 支持多通道扫描的通道位图（0 表示不支持 MultiChannel 格式），channels=
+
+        Config()
+            : sampleRateHz(100.0)
+            , chunkSize(0)
+            , ackLatencyMs(2)
+            , level(1.0)
+            , noise(0.05)
+            , replaySpeed(1.0)
+            , maxBaudRate(115200)
+            , packedFrames(true)
+            , packedBatch(10)
+            , channelMask(ProtocolParser::kScanAllChannels)
+        {}
+    };
+
+    static constexpr const char *kPortPrefix = "SIM";   ///< 模拟设备串口名前缀
+
+    explicit SimulatedDeviceTransport(QObject *parent = nullptr);
+    ~SimulatedDeviceTransport() override;
+
+    /**
+     * @brief 串口名是否表示模拟设备
+     */
+    static bool isSimulatedPort(const QString &portName);
+
+    /**
+     * @brief 解析模拟设备串口名中的参数
+     * @param portName 串口名（如 "SIM:rate=1000,chunk=3"）
+     * @param[out] config 解析结果（未给出的参数保持默认值）
+     * @param errorString 失败原因（可选）
+     * @return true 成功
+     */
+    static bool parsePortName(const QString &portName, Config &config, QString *errorString = nullptr);
+
+public slots:
+    bool openPort(const QString &portName, int baudRate) override;
+    void closePort() override;
+    bool setBaudRate(int baudRate) override;
+    void enqueueTransaction(quint64 id, quint8 address, const QByteArray &payload, int timeoutMs) override;
+
+private slots:
+    /**
+     * @brief 定时推进：投递到期的确认帧、产生测量帧/回放数据并发射
+     */
+    void onTick();
+
+private:
+    /**
+     * @brief 等待投递的确认帧
+     */
+    struct PendingReply {
+        qint64 dueMs;           ///< 投递时间（相对打开时刻）
+        QByteArray bytes;       ///< 确认帧
+    };
+
+    static constexpr int kTickIntervalMs = 1;           ///< 推进间隔
+    static constexpr int kMaxBytesPerTick = 64 * 1024;  ///< 单次推进最多产生的字节数（保持事件循环响应）
+
+    /**
+     * @brief 生成命令的应答并更新检测状态
+     * @param payload 命令数据（不含地址字节）
+     * @return 应答字节
+     */
+    QByteArray respondTo(const QByteArray &payload);
+
+    /**
+     * @brief 追加到期的测量帧
+     */
+    void generateSamples();
+
+    /**
+     * @brief 将到期的样本按批编码为打包测量帧（不足一批的留到下次）
+     * @param due 到期样本数
+     * @param jitter 测量值随机波动
+     */
+    void generatePackedSamples(qint64 due, std::uniform_real_distribution<double> &jitter);
+
+    /**
+     * @brief 将到期的扫描编码为多通道扫描帧
+     * @param due 到期扫描数
+     * @param jitter 测量值随机波动
+     */
+    void generateScanSamples(qint64 due, std::uniform_real_distribution<double> &jitter);
+
+    /**
+     * @brief 追加到期的回放数据
+     */
+    void generateReplay();
+
+    /**
+     * @brief 按分片大小发射待发送数据
+     */
+    void flushOutput();
+
+    Config m_config;                    ///< 当前模拟参数
+    QTimer *m_tickTimer;                ///< 推进定时器
+    QElapsedTimer m_clock;              ///< 打开时刻起计时
+    bool m_isOpen;                      ///< 是否已打开
+    int m_baudRate;                     ///< 上位机端波特率（回放限速依据）
+    int m_deviceBaudRate;               ///< 模拟设备端波特率
+    qint64 m_revertDueMs;               ///< 未收到探测帧时退回默认速率的时刻（-1 表示无）
+    qint64 m_lastFrameMs;               ///< 最近一次收到有效帧的时刻（空闲退回的依据）
+    QQueue<PendingReply> m_replies;     ///< 等待投递的确认帧
+    QByteArray m_output;                ///< 待发射数据
+
+    DeviceProtocol::MeasurementFormat m_format;     ///< 模拟设备当前的测量帧格式
+    uint8_t m_scanMask;                 ///< 当前扫描的通道位图（MultiChannel 格式）
+    bool m_streaming;                   ///< 是否正在产生测量帧
+    qint64 m_streamStartNs;             ///< 开始检测的时刻
+    qint64 m_samplesSent;               ///< 本次检测已产生的帧数
+    std::minstd_rand m_random;          ///< 测量值随机源（固定种子，结果可复现）
+
+    QByteArray m_replayData;            ///< 回放数据
+    int m_replayPos;                    ///< 已回放字节数
+};
+
+#endif // SIMULATEDDEVICETRANSPORT_H
@@ -0,0 +1,697 @@
+#include "StationWidget.h"
+#include "log/LogView.h"
+#include "ErrorRecordDialog.h"
+#include "OtaBatchManager.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QSplitter>
+#include <QLabel>
+#include <QListView>
+#include <QListWidget>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QCloseEvent>
+#include <QSerialPortInfo>
+#include <QApplication>
+#include <QFileDialog>
+
+StationWidget::StationWidget(const QVector<StepSpec> &steps, const QString &excludedPort, QWidget *parent)
+    : QWidget(parent)
+    , m_scheduler(new StationScheduler(this))
+    , m_otaBatch(new OtaBatchManager(this))
+    , m_steps(steps)
+    , m_excludedPort(excludedPort)
+    , m_portList(nullptr)
+    , m_baudSpin(nullptr)
+    , m_pipelineCheck(nullptr)
+    , m_fixtureTable(nullptr)
+    , m_logView(nullptr)
+    , m_statusLabel(nullptr)
+    , m_confirmLabel(nullptr)
+    , m_confirmQueueLabel(nullptr)
+    , m_confirmYesButton(nullptr)
+    , m_confirmNoButton(nullptr)
+    , m_refreshButton(nullptr)
+    , m_connectButton(nullptr)
+    , m_upgradeButton(nullptr)
+    , m_startButton(nullptr)
+    , m_pauseButton(nullptr)
+    , m_stopButton(nullptr)
+    , m_closeButton(nullptr)
+    , m_isPaused(false)
+{
+    initUI();
+    initConnections();
+    onRefreshPortsClicked();
+    updateButtonStates();
+}
+
+StationWidget::~StationWidget()
+{
+}
+
+void StationWidget::setLogFileSink(LogFileSink *sink)
+{
+    m_logView->setFileSink(sink, tr("多工位"));
+}
+
+void StationWidget::setErrorRecordStore(ErrorRecordStore *store)
+{
+    m_scheduler->setErrorRecordStore(store);
+}
+
+void StationWidget::setYieldAggregator(YieldAggregator *aggregator)
+{
+    m_scheduler->setYieldAggregator(aggregator);
+}
+
+void StationWidget::closeEvent(QCloseEvent *event)
+{
+    if (m_scheduler->isRunning()) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, tr("多工位测试"), tr("治具测试正在进行，关闭窗口将停止所有治具，是否继续？"),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply != QMessageBox::Yes) {
+            event->ignore();
+            return;
+        }
+    }
+    if (m_otaBatch->isRunning()) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, tr("批量升级"), tr("固件升级正在进行，关闭窗口将取消所有升级，是否继续？"),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply != QMessageBox::Yes) {
+            event->ignore();
+            return;
+        }
+        m_otaBatch->cancel();
+    }
+
+    // 停止测试并释放串口，单工位界面可以重新使用这些串口
+    m_scheduler->clearFixtures();
+    rebuildFixtureTable();
+    setConfirmationPanelActive(false);
+    updateButtonStates();
+
+    event->accept();
+}
+
+void StationWidget::initUI()
+{
+    // 设置窗口属性
+    setWindowTitle(tr("多工位测试"));
+    setMinimumSize(900, 600);
+    resize(1000, 700);
+
+    // 设置窗口标志：独立窗口
+    setWindowFlags(Qt::Window);
+
+    // 创建主布局
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(10, 10, 10, 10);
+
+    // ========== 标题区域 ==========
+    QLabel *titleLabel = new QLabel(tr("PCBA 多工位测试"), this);
+    titleLabel->setStyleSheet("font: bold 18pt; color: #2c3e50;");
+    titleLabel->setAlignment(Qt::AlignCenter);
+    mainLayout->addWidget(titleLabel);
+
+    // ========== 状态标签 ==========
+    m_statusLabel = new QLabel(tr("状态: 未连接治具"), this);
+    m_statusLabel->setStyleSheet("font: 12pt; color: #7f8c8d; padding: 5px;");
+    mainLayout->addWidget(m_statusLabel);
+
+    // ========== 内容区域（分割器） ==========
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+
+    // ----- 串口选择 -----
+    QWidget *portContainer = new QWidget(this);
+    QVBoxLayout *portLayout = new QVBoxLayout(portContainer);
+    portLayout->setContentsMargins(0, 0, 0, 0);
+
+    QLabel *portLabel = new QLabel(tr("治具串口:"), this);
+    portLabel->setStyleSheet("font: bold 11pt; color: #34495e;");
+    portLayout->addWidget(portLabel);
+
+    m_portList = new QListWidget(this);
+    m_portList->setStyleSheet("QListWidget { font-size: 11pt; }");
+    portLayout->addWidget(m_portList, 1);
+
+    QHBoxLayout *baudLayout = new QHBoxLayout();
+    baudLayout->addWidget(new QLabel(tr("波特率:"), this));
+    m_baudSpin = new QSpinBox(this);
+    m_baudSpin->setRange(1200, 921600);
+    m_baudSpin->setValue(9600);
+    baudLayout->addWidget(m_baudSpin, 1);
+    portLayout->addLayout(baudLayout);
+
+    m_pipelineCheck = new QCheckBox(tr("流水线发送"), this);
+    m_pipelineCheck->setToolTip(tr("回应可区分的命令不等前一条确认即背靠背发送"));
+    portLayout->addWidget(m_pipelineCheck);
+
+    m_refreshButton = new QPushButton(tr("刷新串口"), this);
+    portLayout->addWidget(m_refreshButton);
+
+    m_connectButton = new QPushButton(tr("连接治具"), this);
+    portLayout->addWidget(m_connectButton);
+
+    m_upgradeButton = new QPushButton(tr("批量升级"), this);
+    m_upgradeButton->setToolTip(tr("同时升级所有勾选串口上的设备（设备需已处于 Bootloader 模式）"));
+    portLayout->addWidget(m_upgradeButton);
+
+    splitter->addWidget(portContainer);
+
+    // ----- 治具表格与日志 -----
+    QSplitter *rightSplitter = new QSplitter(Qt::Vertical, this);
+
+    m_fixtureTable = new QTableWidget(this);
+    m_fixtureTable->setColumnCount(6);
+    m_fixtureTable->setHorizontalHeaderLabels({tr("工位"), tr("串口"), tr("状态"), tr("进度"), tr("结果"), tr("错误数")});
+    m_fixtureTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_fixtureTable->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
+    m_fixtureTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_fixtureTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_fixtureTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_fixtureTable->setAlternatingRowColors(true);
+    m_fixtureTable->setToolTip(tr("双击查看该治具的错误记录"));
+    m_fixtureTable->setStyleSheet(
+        "QTableWidget { font-size: 11pt; }"
+        "QTableWidget::item:selected { background-color: #3498db; color: white; }"
+    );
+    rightSplitter->addWidget(m_fixtureTable);
+
+    QWidget *logContainer = new QWidget(this);
+    QVBoxLayout *logLayout = new QVBoxLayout(logContainer);
+    logLayout->setContentsMargins(0, 0, 0, 0);
+
+    QLabel *logLabel = new QLabel(tr("执行日志:"), this);
+    logLabel->setStyleSheet("font: bold 11pt; color: #34495e;");
+    logLayout->addWidget(logLabel);
+
+    m_logView = new LogView(this);
+    m_logView->setTimestampFormat("[hh:mm:ss.zzz]");
+    m_logView->listView()->setStyleSheet(
+        "QListView { font-family: 'Consolas', 'Microsoft YaHei'; font-size: 10pt; "
+        "background-color: #2c3e50; color: #ecf0f1; }"
+    );
+    logLayout->addWidget(m_logView);
+    rightSplitter->addWidget(logContainer);
+    rightSplitter->setSizes({300, 250});
+
+    splitter->addWidget(rightSplitter);
+    splitter->setSizes({200, 800});
+    mainLayout->addWidget(splitter, 1);
+
+    // ========== 用户确认区域 ==========
+    QHBoxLayout *confirmLayout = new QHBoxLayout();
+    confirmLayout->setSpacing(15);
+
+    m_confirmLabel = new QLabel(tr("无待确认项"), this);
+    m_confirmLabel->setWordWrap(true);
+    m_confirmLabel->setStyleSheet("font: 12pt; color: #2c3e50; padding: 5px;");
+    confirmLayout->addWidget(m_confirmLabel, 1);
+
+    m_confirmQueueLabel = new QLabel(this);
+    m_confirmQueueLabel->setStyleSheet("font: 11pt; color: #7f8c8d;");
+    confirmLayout->addWidget(m_confirmQueueLabel);
+
+    m_confirmYesButton = new QPushButton(tr("是"), this);
+    m_confirmYesButton->setStyleSheet(
+        "QPushButton { font: bold 12pt; padding: 10px 25px; background-color: #27ae60; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #2ecc71; }"
+        "QPushButton:disabled { background-color: #95a5a6; }"
+    );
+    confirmLayout->addWidget(m_confirmYesButton);
+
+    m_confirmNoButton = new QPushButton(tr("否"), this);
+    m_confirmNoButton->setStyleSheet(
+        "QPushButton { font: bold 12pt; padding: 10px 25px; background-color: #e74c3c; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #c0392b; }"
+        "QPushButton:disabled { background-color: #95a5a6; }"
+    );
+    confirmLayout->addWidget(m_confirmNoButton);
+
+    mainLayout->addLayout(confirmLayout);
+    setConfirmationPanelActive(false);
+
+    // ========== 按钮区域 ==========
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->setSpacing(15);
+
+    m_startButton = new QPushButton(tr("▶ 全部开始"), this);
+    m_startButton->setStyleSheet(
+        "QPushButton { font: bold 12pt; padding: 10px 25px; background-color: #27ae60; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #2ecc71; }"
+        "QPushButton:disabled { background-color: #95a5a6; }"
+    );
+    buttonLayout->addWidget(m_startButton);
+
+    m_pauseButton = new QPushButton(tr("⏸ 全部暂停"), this);
+    m_pauseButton->setStyleSheet(
+        "QPushButton { font: bold 12pt; padding: 10px 25px; background-color: #f39c12; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #f1c40f; }"
+        "QPushButton:disabled { background-color: #95a5a6; }"
+    );
+    buttonLayout->addWidget(m_pauseButton);
+
+    m_stopButton = new QPushButton(tr("⏹ 全部停止"), this);
+    m_stopButton->setStyleSheet(
+        "QPushButton { font: bold 12pt; padding: 10px 25px; background-color: #e74c3c; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #c0392b; }"
+        "QPushButton:disabled { background-color: #95a5a6; }"
+    );
+    buttonLayout->addWidget(m_stopButton);
+
+    buttonLayout->addStretch();
+
+    m_closeButton = new QPushButton(tr("关闭"), this);
+    m_closeButton->setStyleSheet(
+        "QPushButton { font: 12pt; padding: 10px 25px; background-color: #7f8c8d; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #95a5a6; }"
+    );
+    buttonLayout->addWidget(m_closeButton);
+
+    mainLayout->addLayout(buttonLayout);
+
+    setLayout(mainLayout);
+}
+
+void StationWidget::initConnections()
+{
+    // 按钮信号
+    connect(m_refreshButton, &QPushButton::clicked, this, &StationWidget::onRefreshPortsClicked);
+    connect(m_connectButton, &QPushButton::clicked, this, &StationWidget::onConnectClicked);
+    connect(m_upgradeButton, &QPushButton::clicked, this, &StationWidget::onBatchUpgradeClicked);
+    connect(m_startButton, &QPushButton::clicked, this, &StationWidget::onStartClicked);
+    connect(m_pauseButton, &QPushButton::clicked, this, &StationWidget::onPauseClicked);
+    connect(m_stopButton, &QPushButton::clicked, this, &StationWidget::onStopClicked);
+    connect(m_closeButton, &QPushButton::clicked, this, &QWidget::close);
+    connect(m_fixtureTable, &QTableWidget::cellDoubleClicked, this, &StationWidget::onFixtureDoubleClicked);
+
+    // 用户确认按钮：回答队列头部的请求
+    connect(m_confirmYesButton, &QPushButton::clicked, this, [this]() {
+        setConfirmationPanelActive(false);
+        m_scheduler->answerConfirmation(true);
+    });
+    connect(m_confirmNoButton, &QPushButton::clicked, this, [this]() {
+        setConfirmationPanelActive(false);
+        m_scheduler->answerConfirmation(false);
+    });
+
+    // StationScheduler 信号
+    connect(m_scheduler, &StationScheduler::fixtureLogMessage,
+            this, &StationWidget::onFixtureLogMessage);
+    connect(m_scheduler, &StationScheduler::fixtureUpdated,
+            this, &StationWidget::onFixtureUpdated);
+    connect(m_scheduler, &StationScheduler::fixtureFinished,
+            this, &StationWidget::onFixtureFinished);
+    connect(m_scheduler, &StationScheduler::allFinished,
+            this, &StationWidget::onAllFinished);
+    connect(m_scheduler, &StationScheduler::confirmationRequested,
+            this, &StationWidget::onConfirmationRequested);
+    connect(m_scheduler, &StationScheduler::confirmationQueueChanged,
+            this, &StationWidget::onConfirmationQueueChanged);
+
+    // OtaBatchManager 信号
+    connect(m_otaBatch, &OtaBatchManager::logMessage, this, [this](const QString &message) {
+        appendLog(message);
+    });
+    connect(m_otaBatch, &OtaBatchManager::portLogMessage, this, [this](int index, const QString &message) {
+        appendLog(QString("[%1] %2").arg(m_otaBatch->results().at(index).portName, message));
+    });
+    connect(m_otaBatch, &OtaBatchManager::portFinished,
+            this, &StationWidget::onBatchPortFinished);
+    connect(m_otaBatch, &OtaBatchManager::progressChanged,
+            this, &StationWidget::onBatchProgressChanged);
+    connect(m_otaBatch, &OtaBatchManager::batchFinished,
+            this, &StationWidget::onBatchFinished);
+}
+
+// ========== 按钮槽函数 ==========
+
+void StationWidget::onRefreshPortsClicked()
+{
+    // 保留已勾选的串口
+    QStringList checkedPorts;
+    for (int i = 0; i < m_portList->count(); ++i) {
+        if (m_portList->item(i)->checkState() == Qt::Checked) {
+            checkedPorts << m_portList->item(i)->text();
+        }
+    }
+
+    m_portList->clear();
+    const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+    for (const QSerialPortInfo &info : ports) {
+        if (info.portName() == m_excludedPort) {
+            continue;
+        }
+        QListWidgetItem *item = new QListWidgetItem(info.portName(), m_portList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(checkedPorts.contains(info.portName()) ? Qt::Checked : Qt::Unchecked);
+        item->setToolTip(info.description());
+    }
+}
+
+void StationWidget::onConnectClicked()
+{
+    QStringList portNames;
+    for (int i = 0; i < m_portList->count(); ++i) {
+        if (m_portList->item(i)->checkState() == Qt::Checked) {
+            portNames << m_portList->item(i)->text();
+        }
+    }
+
+    if (portNames.isEmpty()) {
+        QMessageBox::warning(this, tr("多工位测试"), tr("请先勾选治具串口"));
+        return;
+    }
+
+    int connected = m_scheduler->setupFixtures(portNames, m_baudSpin->value(), m_pipelineCheck->isChecked());
+    m_scheduler->loadSteps(m_steps);
+    rebuildFixtureTable();
+
+    appendLog(tr("已连接 %1/%2 个治具").arg(connected).arg(portNames.size()), connected < portNames.size());
+    if (connected < portNames.size()) {
+        QMessageBox::warning(this, tr("多工位测试"),
+                             tr("部分串口连接失败，仅 %1 个治具可用").arg(connected));
+    }
+
+    m_statusLabel->setText(tr("状态: 已连接 %1 个治具").arg(connected));
+    m_statusLabel->setStyleSheet(QString("font: 12pt; color: %1; padding: 5px;")
+                                 .arg(connected > 0 ? "#27ae60" : "#7f8c8d"));
+    updateButtonStates();
+}
+
+void StationWidget::onBatchUpgradeClicked()
+{
+    if (m_otaBatch->isRunning()) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, tr("批量升级"), tr("确定要取消所有串口的固件升级吗？"),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::Yes) {
+            m_otaBatch->cancel();
+        }
+        return;
+    }
+
+    QStringList portNames;
+    for (int i = 0; i < m_portList->count(); ++i) {
+        if (m_portList->item(i)->checkState() == Qt::Checked) {
+            portNames << m_portList->item(i)->text();
+        }
+    }
+
+    if (portNames.isEmpty()) {
+        QMessageBox::warning(this, tr("批量升级"), tr("请先勾选要升级的串口"));
+        return;
+    }
+
+    QString filePath = QFileDialog::getOpenFileName(
+        this,
+        tr("选择固件文件"),
+        QString(),
+        tr("二进制文件 (*.bin);;所有文件 (*.*)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    m_logView->clear();
+
+    // 固件只加载、校验一次，所有串口共用
+    if (!m_otaBatch->loadFirmware(filePath)) {
+        QMessageBox::critical(this, tr("批量升级"), tr("加载固件文件失败: %1").arg(filePath));
+        return;
+    }
+
+    // 升级使用独立的串口连接，先释放治具占用的串口
+    if (m_scheduler->fixtureCount() > 0) {
+        m_scheduler->clearFixtures();
+        rebuildFixtureTable();
+        setConfirmationPanelActive(false);
+        appendLog(tr("已断开治具连接，开始批量升级"));
+    }
+
+    m_statusLabel->setText(tr("状态: 批量升级中 0%"));
+    m_statusLabel->setStyleSheet("font: 12pt; color: #3498db; padding: 5px;");
+
+    m_otaBatch->start(portNames);
+    updateButtonStates();
+}
+
+void StationWidget::onStartClicked()
+{
+    if (m_steps.isEmpty()) {
+        QMessageBox::warning(this, tr("多工位测试"), tr("没有可执行的测试步骤"));
+        return;
+    }
+
+    m_logView->clear();
+    setConfirmationPanelActive(false);
+    m_scheduler->startAll();
+
+    m_statusLabel->setText(tr("状态: 运行中"));
+    m_statusLabel->setStyleSheet("font: 12pt; color: #3498db; padding: 5px;");
+    updateButtonStates();
+}
+
+void StationWidget::onPauseClicked()
+{
+    if (m_isPaused) {
+        m_scheduler->resumeAll();
+        m_isPaused = false;
+    } else {
+        m_scheduler->pauseAll();
+        m_isPaused = true;
+    }
+    updateButtonStates();
+}
+
+void StationWidget::onStopClicked()
+{
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, tr("确认停止"), tr("确定要停止所有治具的测试吗？"),
+        QMessageBox::Yes | QMessageBox::No);
+
+    if (reply == QMessageBox::Yes) {
+        m_scheduler->stopAll();
+        setConfirmationPanelActive(false);
+        m_isPaused = false;
+        updateButtonStates();
+    }
+}
+
+void StationWidget::onFixtureDoubleClicked(int row, int column)
+{
+    Q_UNUSED(column);
+
+    if (row < 0 || row >= m_scheduler->fixtureCount()) {
+        return;
+    }
+
+    // 显示该治具的错误记录
+    ErrorRecordDialog dialog(m_scheduler->fixtureErrorRecords(row), this);
+    dialog.setWindowTitle(tr("错误记录 - %1").arg(m_scheduler->fixturePortName(row)));
+    dialog.exec();
+}
+
+// ========== StationScheduler 信号槽 ==========
+
+void StationWidget::onFixtureLogMessage(int index, const QString &message)
+{
+    bool isError = message.contains(tr("失败")) || message.contains(tr("错误")) || message.contains(tr("超时"));
+    appendLog(QString("[%1] %2").arg(m_scheduler->fixturePortName(index), message), isError);
+}
+
+void StationWidget::onFixtureUpdated(int index)
+{
+    if (index < 0 || index >= m_fixtureTable->rowCount()) {
+        return;
+    }
+
+    const QVector<StationScheduler::FixtureSummary> summaries = m_scheduler->summary();
+    if (index >= summaries.size()) {
+        return;
+    }
+    const StationScheduler::FixtureSummary &item = summaries.at(index);
+
+    m_fixtureTable->item(index, 2)->setText(stateText(item.state));
+
+    QString progress;
+    TestSequenceRunner *runner = m_scheduler->fixtureRunner(index);
+    if (item.currentStep >= 0 && runner && item.currentStep < runner->steps().size()) {
+        progress = tr("%1/%2 %3").arg(item.currentStep + 1).arg(item.totalCount)
+                   .arg(runner->steps().at(item.currentStep).name);
+    }
+    m_fixtureTable->item(index, 3)->setText(progress);
+
+    QTableWidgetItem *resultItem = m_fixtureTable->item(index, 4);
+    if (item.finished) {
+        resultItem->setText(item.allPassed ? tr("通过 %1/%2").arg(item.passedCount).arg(item.totalCount)
+                                           : tr("失败 %1/%2").arg(item.passedCount).arg(item.totalCount));
+        resultItem->setForeground(QBrush(QColor(item.allPassed ? "#27ae60" : "#e74c3c")));
+    } else {
+        resultItem->setText(QString());
+    }
+
+    m_fixtureTable->item(index, 5)->setText(QString::number(item.errorCount));
+
+    updateButtonStates();
+}
+
+void StationWidget::onFixtureFinished(int index, bool allPassed, int passedCount, int totalCount)
+{
+    appendLog(tr("[%1] 测试完成: %2 (%3/%4)")
+              .arg(m_scheduler->fixturePortName(index))
+              .arg(allPassed ? tr("全部通过") : tr("存在失败"))
+              .arg(passedCount).arg(totalCount),
+              !allPassed);
+}
+
+void StationWidget::onAllFinished(int passedFixtures, int totalFixtures)
+{
+    bool allPassed = passedFixtures == totalFixtures;
+    m_statusLabel->setText(tr("状态: 全部完成，通过 %1/%2 个治具").arg(passedFixtures).arg(totalFixtures));
+    m_statusLabel->setStyleSheet(QString("font: 12pt; color: %1; padding: 5px;")
+                                 .arg(allPassed ? "#27ae60" : "#e74c3c"));
+    m_isPaused = false;
+    updateButtonStates();
+}
+
+void StationWidget::onConfirmationRequested(int index, const QString &portName, const QString &message)
+{
+    Q_UNUSED(index);
+
+    m_confirmLabel->setText(QString("[%1] %2").arg(portName, message));
+    setConfirmationPanelActive(true);
+    QApplication::alert(this);
+}
+
+void StationWidget::onConfirmationQueueChanged(int pendingCount)
+{
+    if (pendingCount <= 0) {
+        m_confirmQueueLabel->clear();
+        setConfirmationPanelActive(false);
+    } else {
+        m_confirmQueueLabel->setText(tr("待确认: %1").arg(pendingCount));
+    }
+}
+
+// ========== OtaBatchManager 信号槽 ==========
+
+void StationWidget::onBatchPortFinished(int index, bool success, const QString &message)
+{
+    appendLog(tr("[%1] 升级%2: %3")
+              .arg(m_otaBatch->results().at(index).portName)
+              .arg(success ? tr("成功") : tr("失败"))
+              .arg(message),
+              !success);
+}
+
+void StationWidget::onBatchProgressChanged(int percent)
+{
+    if (m_otaBatch->isRunning()) {
+        int finished = 0;
+        for (const OtaBatchManager::PortResult &result : m_otaBatch->results()) {
+            if (result.finished) {
+                ++finished;
+            }
+        }
+        m_statusLabel->setText(tr("状态: 批量升级中 %1%（已结束 %2/%3）")
+                               .arg(percent).arg(finished).arg(m_otaBatch->results().size()));
+    }
+}
+
+void StationWidget::onBatchFinished(int succeeded, int total)
+{
+    bool allSucceeded = succeeded == total;
+    m_statusLabel->setText(tr("状态: 批量升级完成，成功 %1/%2").arg(succeeded).arg(total));
+    m_statusLabel->setStyleSheet(QString("font: 12pt; color: %1; padding: 5px;")
+                                 .arg(allSucceeded ? "#27ae60" : "#e74c3c"));
+    updateButtonStates();
+    QApplication::alert(this);
+}
+
+// ========== 辅助函数 ==========
+
+void StationWidget::rebuildFixtureTable()
+{
+    int count = m_scheduler->fixtureCount();
+    m_fixtureTable->setRowCount(count);
+
+    for (int i = 0; i < count; ++i) {
+        m_fixtureTable->setItem(i, 0, new QTableWidgetItem(QString::number(i + 1)));
+        m_fixtureTable->setItem(i, 1, new QTableWidgetItem(m_scheduler->fixturePortName(i)));
+        m_fixtureTable->setItem(i, 2, new QTableWidgetItem(stateText(TestSequenceRunner::State::Idle)));
+        m_fixtureTable->setItem(i, 3, new QTableWidgetItem());
+        m_fixtureTable->setItem(i, 4, new QTableWidgetItem());
+        m_fixtureTable->setItem(i, 5, new QTableWidgetItem(QString::number(0)));
+    }
+}
+
+void StationWidget::updateButtonStates()
+{
+    bool hasFixtures = m_scheduler->fixtureCount() > 0;
+    bool running = m_scheduler->isRunning();
+    bool upgrading = m_otaBatch->isRunning();
+
+    m_refreshButton->setEnabled(!running && !upgrading);
+    m_connectButton->setEnabled(!running && !upgrading);
+    m_portList->setEnabled(!running && !upgrading);
+    m_baudSpin->setEnabled(!running && !upgrading);
+    m_pipelineCheck->setEnabled(!running && !upgrading);
+    m_upgradeButton->setEnabled(!running);
+    m_upgradeButton->setText(upgrading ? tr("取消升级") : tr("批量升级"));
+
+    m_startButton->setEnabled(hasFixtures && !running && !upgrading);
+    m_pauseButton->setEnabled(running);
+    m_stopButton->setEnabled(running);
+
+    if (!running) {
+        m_isPaused = false;
+    }
+    m_pauseButton->setText(m_isPaused ? tr("▶ 全部继续") : tr("⏸ 全部暂停"));
+}
+
+void StationWidget::appendLog(const QString &message, bool isError)
+{
+    // 合并刷新和自动滚动由日志视图处理
+    m_logView->appendEntry(message, isError ? LogSeverity::Error : classifyLogMessage(message));
+}
+
+QString StationWidget::stateText(TestSequenceRunner::State state) const
+{
+    switch (state) {
+    case TestSequenceRunner::State::Idle:
+        return tr("就绪");
+    case TestSequenceRunner::State::Running:
+    case TestSequenceRunner::State::WaitingForMeasurement:
+    case TestSequenceRunner::State::WaitingForAck:
+        return tr("运行中");
+    case TestSequenceRunner::State::Paused:
+        return tr("已暂停");
+    case TestSequenceRunner::State::WaitingForUser:
+        return tr("等待确认");
+    case TestSequenceRunner::State::WaitingForPauseAck:
+        return tr("正在暂停");
+    case TestSequenceRunner::State::Finished:
+        return tr("已完成");
+    case TestSequenceRunner::State::Aborted:
+        return tr("已中止");
+    }
+    return QString();
+}
+
+void StationWidget::setConfirmationPanelActive(bool active)
+{
+    m_confirmYesButton->setEnabled(active);
+    m_confirmNoButton->setEnabled(active);
+    if (!active) {
+        m_confirmLabel->setText(tr("无待确认项"));
+    }
+}
@@ -0,0 +1,172 @@
+#ifndef STATIONWIDGET_H
+#define STATIONWIDGET_H
+
+#include <QWidget>
+#include "app/StationScheduler.h"
+#include "domain/StepSpec.h"
+
+class QTableWidget;
+class QListWidget;
+class LogView;
+class LogFileSink;
+class ErrorRecordStore;
+class YieldAggregator;
+class QPushButton;
+class QLabel;
+class QSpinBox;
+class QCheckBox;
+class OtaBatchManager;
+
+/**
+ * @brief 多工位测试界面
+ *
+ * 职责：
+ * - 选择多个治具串口并为每个串口建立独立的测试通道
+ * - 同时启动/暂停/停止所有治具的测试序列
+ * - 以表格汇总各治具的状态、进度、结果和错误数
+ * - 逐条显示各治具的用户确认请求（标明来源串口），避免多个弹窗同时出现
+ * - 对勾选的串口并行升级固件（设备需已处于 Bootloader 模式）
+ */
+class StationWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param steps 各治具执行的测试步骤
+     * @param excludedPort 已被单工位界面占用的串口（不在列表中显示）
+     * @param parent 父窗口
+     */
+    explicit StationWidget(const QVector<StepSpec> &steps,
+                           const QString &excludedPort,
+                           QWidget *parent = nullptr);
+    ~StationWidget() override;
+
+    /**
+     * @brief 更新测试步骤（下次连接治具时生效）
+     */
+    void setSteps(const QVector<StepSpec> &steps) { m_steps = steps; }
+
+    /**
+     * @brief 更新被占用的串口
+     */
+    void setExcludedPort(const QString &portName) { m_excludedPort = portName; }
+
+    /**
+     * @brief 设置日志文件输出（各治具日志写入同一日志文件）
+     */
+    void setLogFileSink(LogFileSink *sink);
+
+    /**
+     * @brief 设置错误记录库（各治具的错误记录写入同一记录库）
+     */
+    void setErrorRecordStore(ErrorRecordStore *store);
+
+    /**
+     * @brief 设置良率统计（各治具的结果汇总到同一统计）
+     */
+    void setYieldAggregator(YieldAggregator *aggregator);
+
+    /**
+     * @brief 多工位调度器（用于查看各治具的命令延迟统计）
+     */
+    StationScheduler *scheduler() const { return m_scheduler; }
+
+protected:
+    /**
+     * @brief 窗口关闭时停止所有治具并释放串口
+     */
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void onRefreshPortsClicked();
+    void onConnectClicked();
+    void onBatchUpgradeClicked();
+    void onStartClicked();
+    void onPauseClicked();
+    void onStopClicked();
+    void onFixtureDoubleClicked(int row, int column);
+
+    // StationScheduler 信号槽
+    void onFixtureLogMessage(int index, const QString &message);
+    void onFixtureUpdated(int index);
+    void onFixtureFinished(int index, bool allPassed, int passedCount, int totalCount);
+    void onAllFinished(int passedFixtures, int totalFixtures);
+    void onConfirmationRequested(int index, const QString &portName, const QString &message);
+    void onConfirmationQueueChanged(int pendingCount);
+
+    // OtaBatchManager 信号
+    void onBatchPortFinished(int index, bool success, const QString &message);
+    void onBatchProgressChanged(int percent);
+    void onBatchFinished(int succeeded, int total);
+
+private:
+    /**
+     * @brief 初始化UI组件
+     */
+    void initUI();
+
+    /**
+     * @brief 初始化信号槽连接
+     */
+    void initConnections();
+
+    /**
+     * @brief 按当前治具重建汇总表格
+     */
+    void rebuildFixtureTable();
+
+    /**
+     * @brief 更新按钮状态
+     */
+    void updateButtonStates();
+
+    /**
+     * @brief 追加日志消息
+     * @param message 日志内容
+     * @param isError 是否为错误消息
+     */
+    void appendLog(const QString &message, bool isError = false);
+
+    /**
+     * @brief 执行状态的显示文本
+     */
+    QString stateText(TestSequenceRunner::State state) const;
+
+    /**
+     * @brief 设置确认面板是否可操作
+     */
+    void setConfirmationPanelActive(bool active);
+
+private:
+    // 依赖
+    StationScheduler *m_scheduler;              ///< 多工位调度器
+    OtaBatchManager *m_otaBatch;                ///< 批量固件升级
+    QVector<StepSpec> m_steps;                  ///< 测试步骤
+    QString m_excludedPort;                     ///< 被占用的串口
+
+    // UI 控件
+    QListWidget *m_portList;                    ///< 串口选择列表
+    QSpinBox *m_baudSpin;                       ///< 波特率
+    QCheckBox *m_pipelineCheck;                 ///< 命令流水线发送开关（连接时生效）
+    QTableWidget *m_fixtureTable;               ///< 治具汇总表格
+    LogView *m_logView;                         ///< 日志显示框
+    QLabel *m_statusLabel;                      ///< 状态标签
+    QLabel *m_confirmLabel;                     ///< 确认消息
+    QLabel *m_confirmQueueLabel;                ///< 待确认数量
+    QPushButton *m_confirmYesButton;            ///< 确认通过按钮
+    QPushButton *m_confirmNoButton;             ///< 确认失败按钮
+    QPushButton *m_refreshButton;               ///< 刷新串口按钮
+    QPushButton *m_connectButton;               ///< 连接治具按钮
+    QPushButton *m_upgradeButton;               ///< 批量升级/取消升级按钮
+    QPushButton *m_startButton;                 ///< 开始按钮
+    QPushButton *m_pauseButton;                 ///< 暂停/继续按钮
+    QPushButton *m_stopButton;                  ///< 停止按钮
+    QPushButton *m_closeButton;                 ///< 关闭按钮
+
+    // 状态
+    bool m_isPaused;                            ///< 是否处于暂停状态
+};
+
+#endif // STATIONWIDGET_H
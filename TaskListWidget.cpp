@@ -1,40 +1,63 @@
 #include "TaskListWidget.h"
+#include "log/LogView.h"
 #include "DeviceController.h"
 #include "widget.h"
 #include "app/TestStepFactory.h"
+#include "app/PlanCompiler.h"
 #include "ErrorRecordDialog.h"
+#include "ErrorHistoryDialog.h"
+#include "LatencyDiagnosticsDialog.h"
+#include "YieldDashboardDialog.h"
+#include "app/YieldAggregator.h"
+#include "app/CycleTimeProfiler.h"
+#include "StationWidget.h"
+#include "storage/MeasurementRecorder.h"
+#include "storage/ErrorRecordStore.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QSplitter>
 #include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QSpinBox>
+#include <QCheckBox>
 #include <QTableWidget>
-#include <QTextEdit>
 #include <QPushButton>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QDateTime>
-#include <QScrollBar>
 #include <QFileDialog>
 #include <QJsonDocument>
 #include <QDir>
 #include <QInputDialog>
 #include <QCloseEvent>
 #include <QApplication>
+#include <algorithm>
 
 TaskListWidget::TaskListWidget(DeviceController *controller, Widget *mainWidget, QWidget *parent)
     : QWidget(parent)
     , m_deviceController(controller)
     , m_runner(nullptr)
+    , m_soak(nullptr)
+    , m_profiler(nullptr)
     , m_mainWidget(mainWidget)
     , m_stepTable(nullptr)
-    , m_logEdit(nullptr)
+    , m_logView(nullptr)
     , m_startButton(nullptr)
     , m_pauseButton(nullptr)
     , m_stopButton(nullptr)
     , m_closeButton(nullptr)
     , m_engineerButton(nullptr)
     , m_errorRecordButton(nullptr)
+    , m_errorHistoryButton(nullptr)
+    , m_stationButton(nullptr)
+    , m_latencyButton(nullptr)
+    , m_yieldButton(nullptr)
+    , m_stationWidget(nullptr)
     , m_statusLabel(nullptr)
+    , m_serialEdit(nullptr)
+    , m_loopSpin(nullptr)
+    , m_pipelineCheck(nullptr)
     , m_isPaused(false)
 {
     initUI();
@@ -46,8 +69,77 @@ TaskListWidget::TaskListWidget(DeviceController *controller, Widget *mainWidget,
     // 把工厂中创建好的测试步骤加载到执行引擎中👌
     m_runner->loadSteps(TestStepFactory::createPcbaTestSequence());
     
+    // 每次运行的耗时分解（在执行引擎的信号连接之前创建，序列完成提示之前先输出分解）
+    m_profiler = new CycleTimeProfiler(m_runner, this);
+    connect(m_profiler, &CycleTimeProfiler::runProfiled,
+            this, [this](const CycleTimeProfiler::RunProfile &profile) {
+        appendLog(tr("耗时分解: %1").arg(CycleTimeProfiler::describe(profile.total)));
+
+        // 列出最耗时的子动作，便于决定缩短哪些延时和超时
+        QVector<const CycleTimeProfiler::ActionTiming *> slowest;
+        for (const CycleTimeProfiler::ActionTiming &timing : profile.actions) {
+            slowest.append(&timing);
+        }
+        std::sort(slowest.begin(), slowest.end(),
+                  [](const CycleTimeProfiler::ActionTiming *a, const CycleTimeProfiler::ActionTiming *b) {
+            return a->time.total() > b->time.total();
+        });
+        for (int i = 0; i < qMin(3, slowest.size()); ++i) {
+            const CycleTimeProfiler::ActionTiming *timing = slowest.at(i);
+            appendLog(tr("  步骤 %1 / %2: %3")
+                      .arg(timing->stepIndex + 1)
+                      .arg(timing->actionName, CycleTimeProfiler::describe(timing->time)));
+        }
+    });
+    
     // 初始化信号槽连接
     initConnections();
+
+    // 循环测试：多次执行时内存中只保留汇总，明细写入错误记录库和日志文件
+    // 在执行引擎的信号连接之后创建，最后一次循环先由 onSequenceFinished 处理再结束循环
+    m_soak = new SoakController(m_runner, this);
+    connect(m_soak, &SoakController::iterationStarted,
+            this, &TaskListWidget::onSoakIterationStarted);
+    connect(m_soak, &SoakController::reportReady, this, [this](const SoakController::Report &report) {
+        appendLog(SoakController::describe(report));
+    });
+    connect(m_soak, &SoakController::logMessage, this, [this](const QString &message) {
+        appendLog(message);
+    });
+    connect(m_soak, &SoakController::finished, this, &TaskListWidget::onSoakFinished);
+
+    // 执行日志同时写入主界面的日志文件
+    if (m_mainWidget) {
+        m_logView->setFileSink(m_mainWidget->logFileSink(), tr("自动测试"));
+    }
+
+    // 错误记录同时写入错误记录库（后台线程写入，不阻塞执行引擎）
+    if (m_mainWidget && m_mainWidget->errorRecordStore()) {
+        connect(m_runner, &TestSequenceRunner::errorRecorded,
+                m_mainWidget->errorRecordStore(), &ErrorRecordStore::append);
+    }
+
+    // 步骤和电流检测结果汇总到跨运行的良率统计
+    if (m_mainWidget && m_mainWidget->yieldAggregator()) {
+        m_mainWidget->yieldAggregator()->attachRunner(m_runner);
+    }
+
+    // 测量记录中标记样本所属的测试步骤和子动作
+    if (m_mainWidget && m_mainWidget->measurementRecorder()) {
+        MeasurementRecorder *recorder = m_mainWidget->measurementRecorder();
+        connect(m_runner, &TestSequenceRunner::actionStarted, recorder,
+                [recorder](int stepIndex, int actionIndex, const SubAction &) {
+            recorder->setContext(stepIndex, actionIndex);
+        });
+        connect(m_runner, &TestSequenceRunner::sequenceFinished,
+                recorder, &MeasurementRecorder::clearContext);
+        connect(m_runner, &TestSequenceRunner::stateChanged, recorder,
+                [recorder](TestSequenceRunner::State state) {
+            if (state == TestSequenceRunner::State::Aborted || state == TestSequenceRunner::State::Idle) {
+                recorder->clearContext();
+            }
+        });
+    }
     
     // 加载步骤到表格
     loadStepsToTable();
@@ -93,7 +185,40 @@ void TaskListWidget::initUI()
     // ========== 状态标签 ==========
     m_statusLabel = new QLabel(tr("状态: 就绪"), this);
     m_statusLabel->setStyleSheet("font: 12pt; color: #27ae60; padding: 5px;");
-    mainLayout->addWidget(m_statusLabel);
+
+    // 板号输入框：扫码枪录入后回车直接开始测试
+    m_serialEdit = new QLineEdit(this);
+    m_serialEdit->setPlaceholderText(tr("扫描或输入板号（可选）"));
+    m_serialEdit->setMaximumWidth(300);
+    m_serialEdit->setStyleSheet("font: 12pt; padding: 4px;");
+
+    QHBoxLayout *statusLayout = new QHBoxLayout();
+    statusLayout->addWidget(m_statusLabel, 1);
+    statusLayout->addWidget(new QLabel(tr("板号:"), this));
+    statusLayout->addWidget(m_serialEdit);
+
+    // 循环次数：用于老化/耐久测试，0 表示一直循环直到停止
+    m_loopSpin = new QSpinBox(this);
+    m_loopSpin->setRange(0, 1000000);
+    m_loopSpin->setValue(1);
+    m_loopSpin->setSpecialValueText(tr("不限"));
+    m_loopSpin->setToolTip(tr("连续执行测试序列的次数，0 表示一直循环直到停止"));
+    m_loopSpin->setStyleSheet("font: 12pt; padding: 4px;");
+    statusLayout->addWidget(new QLabel(tr("循环:"), this));
+    statusLayout->addWidget(m_loopSpin);
+
+    // 命令流水线：设备控制器共用，对工程界面的手动命令同样生效
+    m_pipelineCheck = new QCheckBox(tr("流水线发送"), this);
+    m_pipelineCheck->setChecked(m_deviceController && m_deviceController->isPipeliningEnabled());
+    m_pipelineCheck->setToolTip(tr("回应可区分的命令不等前一条确认即背靠背发送"));
+    m_pipelineCheck->setStyleSheet("font: 12pt; padding: 4px;");
+    connect(m_pipelineCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        if (m_deviceController) {
+            m_deviceController->setPipeliningEnabled(checked);
+        }
+    });
+    statusLayout->addWidget(m_pipelineCheck);
+    mainLayout->addLayout(statusLayout);
 
     // ========== 内容区域（分割器） ==========
     QSplitter *splitter = new QSplitter(Qt::Vertical, this);
@@ -125,13 +250,13 @@ void TaskListWidget::initUI()
     logLabel->setStyleSheet("font: bold 11pt; color: #34495e;");
     logLayout->addWidget(logLabel);
     
-    m_logEdit = new QTextEdit(this);
-    m_logEdit->setReadOnly(true);
-    m_logEdit->setStyleSheet(
-        "QTextEdit { font-family: 'Consolas', 'Microsoft YaHei'; font-size: 10pt; "
+    m_logView = new LogView(this);
+    m_logView->setTimestampFormat("[hh:mm:ss.zzz]");
+    m_logView->listView()->setStyleSheet(
+        "QListView { font-family: 'Consolas', 'Microsoft YaHei'; font-size: 10pt; "
         "background-color: #2c3e50; color: #ecf0f1; }"
     );
-    logLayout->addWidget(m_logEdit);
+    logLayout->addWidget(m_logView);
     splitter->addWidget(logContainer);
 
     // 设置分割比例
@@ -176,6 +301,38 @@ void TaskListWidget::initUI()
     );
     buttonLayout->addWidget(m_errorRecordButton);
 
+    // 失效历史按钮
+    m_errorHistoryButton = new QPushButton(tr("🗂 失效历史"), this);
+    m_errorHistoryButton->setStyleSheet(
+        "QPushButton { font: 12pt; padding: 10px 25px; background-color: #8e44ad; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #9b59b6; }"
+    );
+    buttonLayout->addWidget(m_errorHistoryButton);
+
+    // 命令延迟统计按钮
+    m_latencyButton = new QPushButton(tr("⏱ 延迟统计"), this);
+    m_latencyButton->setStyleSheet(
+        "QPushButton { font: 12pt; padding: 10px 25px; background-color: #2c3e50; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #34495e; }"
+    );
+    buttonLayout->addWidget(m_latencyButton);
+
+    // 良率统计按钮
+    m_yieldButton = new QPushButton(tr("📈 良率统计"), this);
+    m_yieldButton->setStyleSheet(
+        "QPushButton { font: 12pt; padding: 10px 25px; background-color: #2980b9; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #3498db; }"
+    );
+    buttonLayout->addWidget(m_yieldButton);
+
+    // 多工位测试按钮
+    m_stationButton = new QPushButton(tr("🖧 多工位测试"), this);
+    m_stationButton->setStyleSheet(
+        "QPushButton { font: 12pt; padding: 10px 25px; background-color: #16a085; color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: #1abc9c; }"
+    );
+    buttonLayout->addWidget(m_stationButton);
+
     m_engineerButton = new QPushButton(tr("🔧 工程界面"), this);
     m_engineerButton->setStyleSheet(
         "QPushButton { font: 12pt; padding: 10px 25px; background-color: #e67e22; color: white; border-radius: 5px; }"
@@ -204,6 +361,15 @@ void TaskListWidget::initConnections()
     connect(m_closeButton, &QPushButton::clicked, this, &QWidget::close);
     connect(m_engineerButton, &QPushButton::clicked, this, &TaskListWidget::onEngineerModeClicked);
     connect(m_errorRecordButton, &QPushButton::clicked, this, &TaskListWidget::onErrorRecordClicked);
+    connect(m_errorHistoryButton, &QPushButton::clicked, this, &TaskListWidget::onErrorHistoryClicked);
+    connect(m_serialEdit, &QLineEdit::returnPressed, this, [this]() {
+        if (m_startButton->isEnabled()) {
+            onStartClicked();
+        }
+    });
+    connect(m_stationButton, &QPushButton::clicked, this, &TaskListWidget::onStationClicked);
+    connect(m_latencyButton, &QPushButton::clicked, this, &TaskListWidget::onLatencyClicked);
+    connect(m_yieldButton, &QPushButton::clicked, this, &TaskListWidget::onYieldClicked);
 
     // TestSequenceRunner 信号
     connect(m_runner, &TestSequenceRunner::stateChanged, 
@@ -216,6 +382,8 @@ void TaskListWidget::initConnections()
             this, &TaskListWidget::onActionStarted);
     connect(m_runner, &TestSequenceRunner::userConfirmRequired, 
             this, &TaskListWidget::onUserConfirmRequired);
+    connect(m_runner, &TestSequenceRunner::userConfirmCancelled,
+            this, &TaskListWidget::onUserConfirmCancelled);
     connect(m_runner, &TestSequenceRunner::logMessage, 
             this, &TaskListWidget::onRunnerLogMessage);
     connect(m_runner, &TestSequenceRunner::sequenceFinished, 
@@ -293,20 +461,20 @@ void TaskListWidget::updateButtonStates()
         m_stopButton->setEnabled(true);
         break;
     }
+
+    // 循环测试的两次执行之间执行引擎处于已完成状态，仍可停止整个循环
+    if (m_soak->isRunning()) {
+        m_startButton->setEnabled(false);
+        m_stopButton->setEnabled(true);
+    }
+    m_loopSpin->setEnabled(m_startButton->isEnabled());
+    m_pipelineCheck->setEnabled(m_startButton->isEnabled());
 }
 
 void TaskListWidget::appendLog(const QString &message, bool isError)
 {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    QString color = isError ? "#e74c3c" : "#ecf0f1";
-    QString formattedMsg = QString("<span style='color: #7f8c8d;'>[%1]</span> "
-                                   "<span style='color: %2;'>%3</span>")
-                           .arg(timestamp, color, message.toHtmlEscaped());
-    m_logEdit->append(formattedMsg);
-    
-    // 自动滚动到底部
-    QScrollBar *scrollBar = m_logEdit->verticalScrollBar();
-    scrollBar->setValue(scrollBar->maximum());
+    // 合并刷新和自动滚动由日志视图处理
+    m_logView->appendEntry(message, isError ? LogSeverity::Error : classifyLogMessage(message));
 }
 
 void TaskListWidget::setRowStatus(int row, const QString &status, bool isSuccess)
@@ -328,6 +496,18 @@ void TaskListWidget::setRowStatus(int row, const QString &status, bool isSuccess
     }
 }
 
+void TaskListWidget::resetRowStatuses()
+{
+    for (int i = 0; i < m_stepTable->rowCount(); ++i) {
+
+        // 设置指定行的状态文本及背景色
+        setRowStatus(i, tr("待执行"), true);
+    }
+
+    // 将每个单元格的背景恢复为默认状态，从而清除所有行的高亮显示。
+    clearRowHighlights();
+}
+
 void TaskListWidget::highlightRow(int row)
 {
     clearRowHighlights();
@@ -371,19 +551,28 @@ void TaskListWidget::onStartClicked()
     }
 
     // 重置表格状态
-    for (int i = 0; i < m_stepTable->rowCount(); ++i) {
-
-        // 设置指定行的状态文本及背景色
-        setRowStatus(i, tr("待执行"), true);
-    }
-
-    // 将每个单元格的背景恢复为默认状态，从而清除所有行的高亮显示。
-    clearRowHighlights();
+    resetRowStatuses();
     
     // 清空日志
-    m_logEdit->clear();
+    m_logView->clear();
     
+    // 错误记录带上板号和治具，便于按板追溯
+    const QString serial = m_serialEdit->text().trimmed();
+    m_runner->setBoardSerial(serial);
+    m_runner->setFixtureName(m_deviceController->currentPortName());
+
     appendLog(tr("========== 开始自动化测试 =========="));
+    if (!serial.isEmpty()) {
+        appendLog(tr("板号: %1").arg(serial));
+    }
+
+    if (m_loopSpin->value() != 1) {
+        SoakController::Config config;
+        config.iterations = m_loopSpin->value();
+        m_soak->start(config);
+        updateButtonStates();
+        return;
+    }
     m_runner->start();
 }
 
@@ -406,6 +595,10 @@ void TaskListWidget::onStopClicked()
                                     QMessageBox::No);
     if (ret == QMessageBox::Yes) {
         appendLog(tr("用户停止测试"), true);
+        if (m_soak->isRunning()) {
+            m_soak->stop();
+            return;
+        }
         m_runner->stop();
     }
 }
@@ -446,6 +639,78 @@ void TaskListWidget::onErrorRecordClicked()
     dialog.exec();
 }
 
+void TaskListWidget::onErrorHistoryClicked()
+{
+    if (!m_mainWidget || !m_mainWidget->errorRecordStore()) {
+        QMessageBox::warning(this, tr("失效历史"), tr("错误记录库未初始化"));
+        return;
+    }
+
+    ErrorHistoryDialog dialog(m_mainWidget->errorRecordStore(), this);
+    dialog.exec();
+}
+
+void TaskListWidget::onLatencyClicked()
+{
+    // 单工位控制器和多工位各治具的控制器一并显示，便于比较
+    QVector<LatencyDiagnosticsDialog::Source> sources;
+    LatencyDiagnosticsDialog::Source mainSource;
+    mainSource.name = m_deviceController->currentPortName().isEmpty()
+                      ? tr("单工位") : m_deviceController->currentPortName();
+    mainSource.controller = m_deviceController;
+    sources.append(mainSource);
+
+    if (m_stationWidget) {
+        StationScheduler *scheduler = m_stationWidget->scheduler();
+        for (int i = 0; i < scheduler->fixtureCount(); ++i) {
+            LatencyDiagnosticsDialog::Source source;
+            source.name = scheduler->fixturePortName(i);
+            source.controller = scheduler->fixtureController(i);
+            sources.append(source);
+        }
+    }
+
+    LatencyDiagnosticsDialog dialog(sources, this);
+    dialog.exec();
+}
+
+void TaskListWidget::onYieldClicked()
+{
+    if (!m_mainWidget || !m_mainWidget->yieldAggregator()) {
+        QMessageBox::warning(this, tr("良率统计"), tr("良率统计未初始化"));
+        return;
+    }
+
+    // 非模态：测试进行中看板保持打开并定时刷新
+    if (!m_yieldDialog) {
+        m_yieldDialog = new YieldDashboardDialog(m_mainWidget->yieldAggregator(), this);
+        m_yieldDialog->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    m_yieldDialog->show();
+    m_yieldDialog->raise();
+    m_yieldDialog->activateWindow();
+}
+
+void TaskListWidget::onStationClicked()
+{
+    // 多工位测试使用当前加载的测试步骤，并跳过单工位已占用的串口
+    if (!m_stationWidget) {
+        m_stationWidget = new StationWidget(m_runner->steps(), m_deviceController->currentPortName(), this);
+        if (m_mainWidget) {
+            m_stationWidget->setLogFileSink(m_mainWidget->logFileSink());
+            m_stationWidget->setErrorRecordStore(m_mainWidget->errorRecordStore());
+            m_stationWidget->setYieldAggregator(m_mainWidget->yieldAggregator());
+        }
+    } else {
+        m_stationWidget->setSteps(m_runner->steps());
+        m_stationWidget->setExcludedPort(m_deviceController->currentPortName());
+    }
+
+    m_stationWidget->show();
+    m_stationWidget->raise();
+    m_stationWidget->activateWindow();
+}
+
 // ========== TestSequenceRunner 信号槽 ==========
 
 void TaskListWidget::onRunnerStateChanged(TestSequenceRunner::State newState)
@@ -525,15 +790,33 @@ void TaskListWidget::onActionStarted(int stepIndex, int actionIndex, const SubAc
 
 void TaskListWidget::onUserConfirmRequired(const QString &message)
 {
-    // 弹出确认对话框
-    int ret = QMessageBox::question(this, tr("请确认"),
-                                    message,
-                                    QMessageBox::Yes | QMessageBox::No,
-                                    QMessageBox::Yes);
-    
+    // 弹出确认对话框（请求作废时由 onUserConfirmCancelled 关闭）
+    const quint64 token = m_runner->confirmToken();
+    QMessageBox box(QMessageBox::Question, tr("请确认"), message,
+                    QMessageBox::Yes | QMessageBox::No, this);
+    box.setDefaultButton(QMessageBox::Yes);
+    m_confirmBox = &box;
+    int ret = box.exec();
+    if (m_confirmBox == &box) {
+        m_confirmBox = nullptr;
+    }
+
+    if (ret == QMessageBox::Cancel) {
+        appendLog(tr("确认请求已取消"));
+        return;
+    }
+
     bool confirmed = (ret == QMessageBox::Yes);
     appendLog(tr("用户确认: %1").arg(confirmed ? tr("是") : tr("否")));
-    m_runner->userConfirm(confirmed);
+    m_runner->userConfirm(confirmed, token);
+}
+
+void TaskListWidget::onUserConfirmCancelled(quint64 token)
+{
+    Q_UNUSED(token)
+    if (m_confirmBox) {
+        m_confirmBox->done(QMessageBox::Cancel);
+    }
 }
 
 void TaskListWidget::onRunnerLogMessage(const QString &message)
@@ -559,9 +842,19 @@ void TaskListWidget::onSequenceFinished(bool allPassed, int passedCount, int tot
         icon = QMessageBox::Warning;
         appendLog(tr("========== 测试完成: 部分失败 =========="), true);
     }
+
+    // 循环测试中不弹出结果框，结束时统一提示
+    if (m_soak->isRunning()) {
+        emit testFinished(allPassed, passedCount, totalCount);
+        return;
+    }
     
     QMessageBox msgBox(icon, tr("测试结果"), resultMsg, QMessageBox::Ok, this);
     msgBox.exec();
+
+    // 选中已录入的板号，扫描下一块板时直接覆盖
+    m_serialEdit->selectAll();
+    m_serialEdit->setFocus();
     
     emit testFinished(allPassed, passedCount, totalCount);
 }
@@ -577,6 +870,36 @@ void TaskListWidget::onCurrentCheckResult(int stepIndex, double value, double th
               !passed);
 }
 
+// ========== 循环测试 ==========
+
+void TaskListWidget::onSoakIterationStarted(qint64 iteration)
+{
+    // 第一次由 onStartClicked 重置；之后每次只重置表格，日志视图自身有容量上限
+    if (iteration > 1) {
+        resetRowStatuses();
+        appendLog(tr("========== 第 %1 次循环 ==========").arg(iteration));
+    }
+}
+
+void TaskListWidget::onSoakFinished(const SoakController::Report &report, const QString &abortReason)
+{
+    updateButtonStates();
+
+    QString resultMsg = tr("循环 %1 次：通过 %2，失败 %3\n平均周期 %4 ms")
+                        .arg(report.iterations).arg(report.passed).arg(report.failed)
+                        .arg(report.cycleStats.mean, 0, 'f', 0);
+    if (!abortReason.isEmpty()) {
+        resultMsg += tr("\n\n中止原因: %1").arg(abortReason);
+    }
+    const bool allPassed = abortReason.isEmpty() && report.failed == 0;
+    QMessageBox msgBox(allPassed ? QMessageBox::Information : QMessageBox::Warning,
+                       tr("循环测试结果"), resultMsg, QMessageBox::Ok, this);
+    msgBox.exec();
+
+    m_serialEdit->selectAll();
+    m_serialEdit->setFocus();
+}
+
 // ========== 导入/导出配置 ==========
 
 void TaskListWidget::exportConfiguration()
@@ -661,23 +984,15 @@ void TaskListWidget::importConfiguration()
     QByteArray jsonData = file.readAll();
     file.close();
 
-    // 解析 JSON
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
-
-    if (parseError.error != QJsonParseError::NoError) {
-        QMessageBox::critical(this, tr("错误"), 
-            tr("JSON 解析失败:\n%1").arg(parseError.errorString()));
-        return;
-    }
-
-    // 反序列化步骤
-    QVector<StepSpec> steps = StepSpec::stepsFromJson(doc);
-
-    if (steps.isEmpty()) {
-        QMessageBox::warning(this, tr("警告"), tr("导入的配置文件中没有有效的测试步骤。"));
+    // 解析并编译（同一配置文件再次导入时直接使用缓存的编译结果）
+    CompiledPlan plan;
+    QStringList errors;
+    if (!PlanCompiler::loadFromJson(jsonData, plan, &errors)) {
+        QMessageBox::critical(this, tr("错误"),
+            tr("测试配置无效:\n%1").arg(errors.join("\n")));
         return;
     }
+    const QVector<StepSpec> &steps = plan.steps;
 
     // 确认是否覆盖当前配置
     QMessageBox::StandardButton ret = QMessageBox::question(
@@ -693,7 +1008,7 @@ void TaskListWidget::importConfiguration()
     }
 
     // 加载到执行引擎
-    m_runner->loadSteps(steps);
+    m_runner->loadPlan(plan);
 
     // 刷新表格显示
     loadStepsToTable();
@@ -2,22 +2,31 @@
 #define TASKLISTWIDGET_H
 
 #include <QWidget>
+#include <QPointer>
 #include "app/TestSequenceRunner.h"
+#include "app/SoakController.h"
 #include "domain/StepSpec.h"
 
 class DeviceController;
 class Widget;
+class StationWidget;
 class QTableWidget;
-class QTextEdit;
+class LogView;
 class QPushButton;
 class QLabel;
+class QLineEdit;
+class QSpinBox;
+class QCheckBox;
+class CycleTimeProfiler;
+class YieldDashboardDialog;
+class QMessageBox;
 
 /**
  * @brief 任务列表窗口（自动化测试控制台）
  *
  * 职责：
  * - 显示自动测试步骤列表
- * - 提供测试启动/暂停/停止控制
+ * - 提供测试启动/暂停/停止控制（循环次数不为1时由 SoakController 反复执行）
  * - 显示测试日志和执行状态
  * - 处理用户交互确认弹窗
  */
@@ -75,6 +84,10 @@ private slots:
     void onStopClicked();
     void onEngineerModeClicked();
     void onErrorRecordClicked();    ///< 查看错误记录按钮槽函数
+    void onErrorHistoryClicked();   ///< 失效历史按钮槽函数
+    void onStationClicked();        ///< 多工位测试按钮槽函数
+    void onLatencyClicked();        ///< 命令延迟统计按钮槽函数
+    void onYieldClicked();          ///< 良率统计按钮槽函数
 
     // TestSequenceRunner 信号槽
     void onRunnerStateChanged(TestSequenceRunner::State newState);
@@ -82,10 +95,15 @@ private slots:
     void onStepFinished(int stepIndex, bool success, const QString &message);
     void onActionStarted(int stepIndex, int actionIndex, const SubAction &action);
     void onUserConfirmRequired(const QString &message);
+    void onUserConfirmCancelled(quint64 token);
     void onRunnerLogMessage(const QString &message);
     void onSequenceFinished(bool allPassed, int passedCount, int totalCount);
     void onCurrentCheckResult(int stepIndex, double value, double threshold, bool passed);
 
+    // SoakController 信号槽
+    void onSoakIterationStarted(qint64 iteration);
+    void onSoakFinished(const SoakController::Report &report, const QString &abortReason);
+
 private:
     /**
      * @brief 初始化UI组件
@@ -122,6 +140,11 @@ private:
      */
     void setRowStatus(int row, const QString &status, bool isSuccess = true);
 
+    /**
+     * @brief 所有行恢复为待执行并清除高亮
+     */
+    void resetRowStatuses();
+
     /**
      * @brief 高亮当前执行行
      * @param row 行索引
@@ -137,18 +160,30 @@ private:
     // 依赖
     DeviceController *m_deviceController;       ///< 设备控制器指针
     TestSequenceRunner *m_runner;               ///< 测试序列执行引擎
+    SoakController *m_soak;                     ///< 循环测试控制器
+    CycleTimeProfiler *m_profiler;              ///< 测试周期耗时分解
     Widget *m_mainWidget;                       ///< 主界面指针（用于跳转）
 
     // UI 控件
     QTableWidget *m_stepTable;                  ///< 测试步骤表格
-    QTextEdit *m_logEdit;                       ///< 日志显示框
+    LogView *m_logView;                         ///< 日志显示框
     QPushButton *m_startButton;                 ///< 开始按钮
     QPushButton *m_pauseButton;                 ///< 暂停/继续按钮
     QPushButton *m_stopButton;                  ///< 停止按钮
     QPushButton *m_closeButton;                 ///< 关闭按钮
     QPushButton *m_engineerButton;              ///< 工程界面按钮
     QPushButton *m_errorRecordButton;           ///< 错误记录按钮
+    QPushButton *m_errorHistoryButton;          ///< 失效历史按钮
+    QPushButton *m_stationButton;               ///< 多工位测试按钮
+    QPushButton *m_latencyButton;               ///< 命令延迟统计按钮
+    QPushButton *m_yieldButton;                 ///< 良率统计按钮
+    QPointer<YieldDashboardDialog> m_yieldDialog; ///< 良率看板（非模态，首次打开时创建）
+    QPointer<QMessageBox> m_confirmBox;         ///< 正在显示的用户确认对话框
+    StationWidget *m_stationWidget;             ///< 多工位测试窗口（首次打开时创建）
     QLabel *m_statusLabel;                      ///< 状态标签
+    QLineEdit *m_serialEdit;                    ///< 被测板序列号输入框（扫码枪录入）
+    QSpinBox *m_loopSpin;                       ///< 循环次数（1 为单次，0 为不限）
+    QCheckBox *m_pipelineCheck;                 ///< 命令流水线发送开关
 
     // 状态
     bool m_isPaused;                            ///< 是否处于暂停状态
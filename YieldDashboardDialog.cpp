@@ -0,0 +1,316 @@
+#include "YieldDashboardDialog.h"
+#include "app/YieldAggregator.h"
+#include <QTableWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QLabel>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cmath>
+
+namespace {
+
+QTableWidgetItem *numberItem(const QString &text)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString formatPercent(double rate)
+{
+    return QString::number(rate * 100.0, 'f', 1) + QLatin1Char('%');
+}
+
+QString formatMa(double value)
+{
+    return QString::number(value, 'f', 3);
+}
+
+QTableWidget *createTable(const QStringList &headers, QWidget *parent)
+{
+    QTableWidget *table = new QTableWidget(parent);
+    table->setColumnCount(headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setAlternatingRowColors(true);
+    table->setStyleSheet(
+        "QTableWidget { font-size: 10pt; }"
+        "QTableWidget::item:selected { background-color: #3498db; color: white; }"
+    );
+    return table;
+}
+
+} // namespace
+
+YieldDashboardDialog::YieldDashboardDialog(YieldAggregator *aggregator, QWidget *parent)
+    : QDialog(parent)
+    , m_aggregator(aggregator)
+    , m_summaryLabel(nullptr)
+    , m_stepTable(nullptr)
+    , m_currentTable(nullptr)
+    , m_resetButton(nullptr)
+    , m_exportCsvButton(nullptr)
+    , m_exportJsonButton(nullptr)
+    , m_closeButton(nullptr)
+    , m_refreshTimer(new QTimer(this))
+{
+    initUI();
+    loadData();
+
+    // 测试进行中统计持续变化，定时刷新
+    m_refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &YieldDashboardDialog::loadData);
+    m_refreshTimer->start();
+}
+
+void YieldDashboardDialog::initUI()
+{
+    setWindowTitle(tr("良率统计"));
+    setMinimumSize(1000, 550);
+    resize(1150, 700);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(15, 15, 15, 15);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setStyleSheet("font: bold 14pt; color: #2c3e50;");
+    mainLayout->addWidget(m_summaryLabel);
+
+    QLabel *hintLabel = new QLabel(
+        tr("\"近%1次\"为最近 %1 次的滑动窗口统计；近期均值偏离累计中位数超过 %2% 时标黄")
+            .arg(YieldAggregator::kWindowSize).arg(static_cast<int>(kDriftWarningRatio * 100)), this);
+    hintLabel->setStyleSheet("color: #7f8c8d;");
+    mainLayout->addWidget(hintLabel);
+
+    // 步骤通过率
+    QLabel *stepLabel = new QLabel(tr("步骤通过率"), this);
+    stepLabel->setStyleSheet("font: bold 11pt; color: #34495e;");
+    mainLayout->addWidget(stepLabel);
+
+    m_stepTable = createTable({
+        tr("步骤"), tr("执行"), tr("通过"), tr("通过率"), tr("近%1次").arg(YieldAggregator::kWindowSize)
+    }, this);
+    mainLayout->addWidget(m_stepTable, 1);
+
+    // 电流分布
+    QLabel *currentLabel = new QLabel(tr("电流分布（mA）"), this);
+    currentLabel->setStyleSheet("font: bold 11pt; color: #34495e;");
+    mainLayout->addWidget(currentLabel);
+
+    m_currentTable = createTable({
+        tr("检测"), tr("阈值"), tr("样本"), tr("超限"), tr("min"), tr("p1"), tr("p10"),
+        tr("p50"), tr("p90"), tr("p99"), tr("max"), tr("近%1次均值").arg(YieldAggregator::kWindowSize)
+    }, this);
+    mainLayout->addWidget(m_currentTable, 1);
+
+    // 按钮区域
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+
+    const QString buttonStyle =
+        "QPushButton { font: 12pt; padding: 8px 20px; background-color: %1; "
+        "color: white; border-radius: 5px; }"
+        "QPushButton:hover { background-color: %2; }";
+
+    m_resetButton = new QPushButton(tr("重置"), this);
+    m_resetButton->setStyleSheet(buttonStyle.arg("#e67e22", "#d35400"));
+    connect(m_resetButton, &QPushButton::clicked, this, &YieldDashboardDialog::onResetClicked);
+    buttonLayout->addWidget(m_resetButton);
+
+    buttonLayout->addStretch();
+
+    m_exportCsvButton = new QPushButton(tr("导出CSV"), this);
+    m_exportCsvButton->setStyleSheet(buttonStyle.arg("#16a085", "#1abc9c"));
+    connect(m_exportCsvButton, &QPushButton::clicked, this, &YieldDashboardDialog::onExportCsvClicked);
+    buttonLayout->addWidget(m_exportCsvButton);
+
+    m_exportJsonButton = new QPushButton(tr("导出JSON"), this);
+    m_exportJsonButton->setStyleSheet(buttonStyle.arg("#16a085", "#1abc9c"));
+    connect(m_exportJsonButton, &QPushButton::clicked, this, &YieldDashboardDialog::onExportJsonClicked);
+    buttonLayout->addWidget(m_exportJsonButton);
+
+    m_closeButton = new QPushButton(tr("关闭"), this);
+    m_closeButton->setStyleSheet(buttonStyle.arg("#7f8c8d", "#95a5a6"));
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    buttonLayout->addWidget(m_closeButton);
+
+    mainLayout->addLayout(buttonLayout);
+}
+
+void YieldDashboardDialog::loadData()
+{
+    if (!m_aggregator) {
+        m_summaryLabel->setText(tr("统计不可用"));
+        return;
+    }
+
+    const YieldAggregator::PassStats &overall = m_aggregator->overall();
+    if (overall.runs == 0) {
+        m_summaryLabel->setText(tr("📈 尚无完成的测试"));
+    } else {
+        m_summaryLabel->setText(tr("📈 已测 %1 块，通过 %2 块，良率 %3（近%4次 %5）")
+                                .arg(overall.runs).arg(overall.passes)
+                                .arg(formatPercent(overall.passRate()))
+                                .arg(overall.window.size())
+                                .arg(formatPercent(overall.windowPassRate())));
+    }
+
+    // 刷新时保持用户的滚动位置
+    const int stepScroll = m_stepTable->verticalScrollBar()->value();
+    const QVector<const YieldAggregator::PassStats *> steps = m_aggregator->steps();
+    m_stepTable->setRowCount(steps.size());
+    for (int row = 0; row < steps.size(); ++row) {
+        const YieldAggregator::PassStats &stats = *steps.at(row);
+        m_stepTable->setItem(row, 0, new QTableWidgetItem(tr("第%1步: %2").arg(stats.stepIndex + 1).arg(stats.name)));
+        m_stepTable->setItem(row, 1, numberItem(QString::number(stats.runs)));
+        m_stepTable->setItem(row, 2, numberItem(QString::number(stats.passes)));
+        m_stepTable->setItem(row, 3, numberItem(formatPercent(stats.passRate())));
+        m_stepTable->setItem(row, 4, numberItem(formatPercent(stats.windowPassRate())));
+
+        // 近期通过率低于累计通过率时标红
+        if (stats.windowPassRate() < stats.passRate()) {
+            m_stepTable->item(row, 4)->setForeground(QBrush(QColor("#e74c3c")));
+        }
+    }
+    m_stepTable->verticalScrollBar()->setValue(stepScroll);
+
+    const int currentScroll = m_currentTable->verticalScrollBar()->value();
+    const QVector<const YieldAggregator::CurrentStats *> checks = m_aggregator->currentChecks();
+    m_currentTable->setRowCount(checks.size());
+    for (int row = 0; row < checks.size(); ++row) {
+        const YieldAggregator::CurrentStats &stats = *checks.at(row);
+        const TDigest &d = stats.digest;
+        const double median = d.quantile(0.50);
+
+        m_currentTable->setItem(row, 0, new QTableWidgetItem(
+            tr("第%1步: %2 / 动作%3").arg(stats.stepIndex + 1).arg(stats.stepName).arg(stats.actionIndex + 1)));
+        m_currentTable->setItem(row, 1, numberItem((stats.isUpperLimit ? QStringLiteral("≤ ") : QStringLiteral("≥ "))
+                                                   + formatMa(stats.threshold)));
+        m_currentTable->setItem(row, 2, numberItem(QString::number(d.count())));
+        m_currentTable->setItem(row, 3, numberItem(QString::number(stats.failures)));
+        m_currentTable->setItem(row, 4, numberItem(formatMa(d.minValue())));
+        m_currentTable->setItem(row, 5, numberItem(formatMa(d.quantile(0.01))));
+        m_currentTable->setItem(row, 6, numberItem(formatMa(d.quantile(0.10))));
+        m_currentTable->setItem(row, 7, numberItem(formatMa(median)));
+        m_currentTable->setItem(row, 8, numberItem(formatMa(d.quantile(0.90))));
+        m_currentTable->setItem(row, 9, numberItem(formatMa(d.quantile(0.99))));
+        m_currentTable->setItem(row, 10, numberItem(formatMa(d.maxValue())));
+        m_currentTable->setItem(row, 11, numberItem(formatMa(stats.window.mean())));
+
+        if (stats.failures > 0) {
+            m_currentTable->item(row, 3)->setForeground(QBrush(QColor("#e74c3c")));
+        }
+        // 近期均值明显偏离累计中位数：电流漂移
+        if (stats.window.size() > 0 && std::abs(median) > 0.0 &&
+            std::abs(stats.window.mean() - median) / std::abs(median) > kDriftWarningRatio) {
+            m_currentTable->item(row, 11)->setBackground(QBrush(QColor("#f9e79f")));
+        }
+    }
+    m_currentTable->verticalScrollBar()->setValue(currentScroll);
+}
+
+void YieldDashboardDialog::onResetClicked()
+{
+    if (!m_aggregator) {
+        return;
+    }
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, tr("良率统计"), tr("确定要清空全部良率和电流分布统计吗？"),
+        QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+    if (reply != QMessageBox::Yes) {
+        return;
+    }
+
+    m_aggregator->reset();
+    loadData();
+}
+
+void YieldDashboardDialog::onExportCsvClicked()
+{
+    if (!m_aggregator) {
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        tr("导出良率统计"),
+        QDir::homePath() + QString("/pcba_yield_%1.csv")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        tr("CSV 文件 (*.csv)")
+    );
+
+    if (fileName.isEmpty()) {
+        return;  // 用户取消
+    }
+    if (!fileName.endsWith(".csv", Qt::CaseInsensitive)) {
+        fileName += ".csv";
+    }
+
+    QStringList lines;
+    lines << YieldAggregator::csvHeader();
+    lines << m_aggregator->toCsvLines();
+
+    // 带 BOM，Excel 打开时中文步骤名不乱码
+    QByteArray content("\xEF\xBB\xBF");
+    content += lines.join("\n").toUtf8();
+    content += '\n';
+    writeExportFile(fileName, content);
+}
+
+void YieldDashboardDialog::onExportJsonClicked()
+{
+    if (!m_aggregator) {
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        tr("导出良率统计"),
+        QDir::homePath() + QString("/pcba_yield_%1.json")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        tr("JSON 文件 (*.json)")
+    );
+
+    if (fileName.isEmpty()) {
+        return;  // 用户取消
+    }
+    if (!fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        fileName += ".json";
+    }
+
+    QJsonObject root = m_aggregator->toJson();
+    root.insert("timestamp", QDateTime::currentDateTime().toString(Qt::ISODate));
+    writeExportFile(fileName, QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+bool YieldDashboardDialog::writeExportFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        QMessageBox::critical(this, tr("错误"),
+            tr("无法打开文件进行写入:\n%1").arg(file.errorString()));
+        return false;
+    }
+
+    file.write(content);
+    file.close();
+
+    QMessageBox::information(this, tr("导出成功"),
+        tr("良率统计已导出到:\n%1").arg(fileName));
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef YIELDDASHBOARDDIALOG_H
+#define YIELDDASHBOARDDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+
+class QTableWidget;
+class QPushButton;
+class QLabel;
+class QTimer;
+class YieldAggregator;
+
+/**
+ * @brief 良率与电流分布看板
+ *
+ * 显示整体良率、各步骤通过率（累计和最近 N 次）以及各电流检测动作的分位数，
+ * 最近 N 次的电流均值偏离累计中位数较多时标黄，提示待机/工作电流漂移。
+ * 定时刷新，可导出 CSV 或 JSON；非模态，测试进行中可一直开着。
+ */
+class YieldDashboardDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param aggregator 统计来源
+     * @param parent 父窗口
+     */
+    explicit YieldDashboardDialog(YieldAggregator *aggregator, QWidget *parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~YieldDashboardDialog() override = default;
+
+private slots:
+    /**
+     * @brief 重新加载统计数据到表格
+     */
+    void loadData();
+
+    /**
+     * @brief 清空统计
+     */
+    void onResetClicked();
+
+    /**
+     * @brief 导出为 CSV
+     */
+    void onExportCsvClicked();
+
+    /**
+     * @brief 导出为 JSON
+     */
+    void onExportJsonClicked();
+
+private:
+    /**
+     * @brief 初始化UI
+     */
+    void initUI();
+
+    /**
+     * @brief 写入导出文件
+     * @return 是否成功
+     */
+    bool writeExportFile(const QString &fileName, const QByteArray &content);
+
+private:
+    QPointer<YieldAggregator> m_aggregator;     ///< 统计来源
+    QLabel *m_summaryLabel;                     ///< 整体良率
+    QTableWidget *m_stepTable;                  ///< 步骤通过率表格
+    QTableWidget *m_currentTable;               ///< 电流分布表格
+    QPushButton *m_resetButton;                 ///< 重置按钮
+    QPushButton *m_exportCsvButton;             ///< 导出CSV按钮
+    QPushButton *m_exportJsonButton;            ///< 导出JSON按钮
+    QPushButton *m_closeButton;                 ///< 关闭按钮
+    QTimer *m_refreshTimer;                     ///< 定时刷新
+
+    static constexpr int kRefreshIntervalMs = 1000;     ///< 刷新间隔（毫秒）
+    static constexpr double kDriftWarningRatio = 0.10;  ///< 近期均值偏离累计中位数超过该比例时标黄
+};
+
+#endif // YIELDDASHBOARDDIALOG_H
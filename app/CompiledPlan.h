@@ -0,0 +1,112 @@
+#ifndef COMPILEDPLAN_H
+#define COMPILEDPLAN_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "domain/StepSpec.h"
+#include "domain/Command.h"
+
+/**
+ * @brief 编译后的子动作（扁平动作表中的一项）
+ *
+ * 命令帧、期望回应、合并键、超时和日志文本均在编译时生成，
+ * 执行引擎按表执行，不再在运行时解析 SubAction 字段或重新组帧。
+ */
+struct CompiledAction {
+    /**
+     * @brief 动作种类（执行引擎按种类分派）
+     */
+    enum Kind : quint8 {
+        DeviceCommand,      ///< 发送设备命令并等待ACK
+        Delay,              ///< 延时等待
+        UserConfirm,        ///< 用户交互确认
+        CheckCurrent        ///< 电流检测
+    };
+
+    /**
+     * @brief 命令对下位机检测状态的影响
+     */
+    enum DetectionEffect : qint8 {
+        DetectionStops = -1,    ///< 停止检测
+        DetectionUnchanged = 0, ///< 不影响
+        DetectionStarts = 1     ///< 开启检测
+    };
+
+    Kind kind;                  ///< 动作种类
+    Command command;            ///< 设备命令（DeviceCommand）
+    QByteArray frame;           ///< 已编码的命令帧（DeviceCommand）
+    QByteArray expectedResponse; ///< 期望的确认帧（DeviceCommand）
+    QString coalesceKey;        ///< 命令合并键，为空表示不合并（DeviceCommand）
+    DetectionEffect detection;  ///< 对检测状态的影响（DeviceCommand）
+    int timeoutMs;              ///< 等待时长：ACK超时 / 延时 / 测量超时（毫秒）
+    QString logText;            ///< 开始执行时的日志
+    QString failureText;        ///< 命令提交失败时的日志（DeviceCommand）
+    QString confirmMessage;     ///< 弹窗提示信息（UserConfirm）
+    double threshold;           ///< 电流阈值（CheckCurrent）
+    bool isUpperLimit;          ///< 阈值类型（CheckCurrent）
+    bool adaptive;              ///< 是否自适应稳定判定（CheckCurrent）
+    int settleWindowSamples;    ///< 自适应判定窗口样本数（CheckCurrent）
+    int minWaitMs;              ///< 判定前的最短等待时间，此前到达的样本不参与判定（CheckCurrent）
+    int gapMs;                  ///< 完成后到下一动作开始的间隔（已替换默认值，可为0）
+    int groupEnd;               ///< 所在并行组最后一个动作的步骤内下标（顺序执行时为自身下标）
+
+    CompiledAction()
+        : kind(Delay)
+        , command(Command::None)
+        , detection(DetectionUnchanged)
+        , timeoutMs(0)
+        , threshold(0.0)
+        , isUpperLimit(true)
+        , adaptive(false)
+        , settleWindowSamples(0)
+        , minWaitMs(0)
+        , gapMs(0)
+        , groupEnd(0)
+    {}
+};
+
+/**
+ * @brief 编译后的步骤（指向动作表中的一段）
+ */
+struct CompiledStep {
+    int firstAction;            ///< 第一个子动作在动作表中的下标
+    int actionCount;            ///< 子动作数量
+    int stepTimeoutMs;          ///< 步骤超时（已替换默认值）
+
+    CompiledStep() : firstAction(0), actionCount(0), stepTimeoutMs(0) {}
+};
+
+/**
+ * @brief 编译后的测试计划
+ *
+ * 由 PlanCompiler 从 QVector<StepSpec> 生成并校验，可按源 JSON 的哈希缓存为二进制文件。
+ * 保留原始步骤列表供界面显示和导出配置使用。
+ */
+struct CompiledPlan {
+    QByteArray sourceHash;              ///< 源 JSON 的 SHA-256（未从 JSON 编译时为空）
+    QVector<StepSpec> steps;            ///< 原始步骤列表
+    QVector<CompiledStep> stepTable;    ///< 步骤表（与 steps 一一对应）
+    QVector<CompiledAction> actions;    ///< 扁平动作表
+
+    bool isEmpty() const { return stepTable.isEmpty(); }
+    int stepCount() const { return stepTable.size(); }
+
+    /**
+     * @brief 获取指定步骤的第 index 个子动作（调用方保证下标有效）
+     */
+    const CompiledAction &action(int stepIndex, int actionIndex) const
+    {
+        return actions.at(stepTable.at(stepIndex).firstAction + actionIndex);
+    }
+
+    void clear()
+    {
+        sourceHash.clear();
+        steps.clear();
+        stepTable.clear();
+        actions.clear();
+    }
+};
+
+#endif // COMPILEDPLAN_H
@@ -0,0 +1,452 @@
+#include "CycleTimeProfiler.h"
+#include "domain/MonotonicClock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kNsPerMs = 1000000.0;
+
+QString formatMs(double value)
+{
+    return QString::number(value, 'f', 1);
+}
+
+/**
+ * @brief CSV 字段（含逗号、引号或换行时加引号）
+ */
+QString csvField(const QString &text)
+{
+    if (!text.contains(QLatin1Char(',')) && !text.contains(QLatin1Char('"')) && !text.contains(QLatin1Char('\n'))) {
+        return text;
+    }
+    QString quoted = text;
+    quoted.replace(QLatin1Char('"'), QStringLiteral("\"\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
+
+/**
+ * @brief 折叠栈的帧名（分号是帧分隔符）
+ */
+QString frameName(const QString &text)
+{
+    QString name = text;
+    name.replace(QLatin1Char(';'), QLatin1Char(','));
+    name.replace(QLatin1Char('\n'), QLatin1Char(' '));
+    return name;
+}
+
+QString stepFrame(int stepIndex, const QString &stepName)
+{
+    return frameName(QStringLiteral("%1. %2").arg(stepIndex + 1).arg(stepName));
+}
+
+QString actionFrame(int actionIndex, const QString &actionName)
+{
+    return frameName(QStringLiteral("%1. %2").arg(actionIndex + 1).arg(actionName));
+}
+
+/**
+ * @brief 按类别追加折叠栈行（数值为微秒，0 不输出）
+ */
+void appendFolded(QStringList &lines, const QString &stack, const double (&ms)[CycleTimeProfiler::kCategoryCount])
+{
+    for (int c = 0; c < CycleTimeProfiler::kCategoryCount; ++c) {
+        const qint64 us = std::llround(ms[c] * 1000.0);
+        if (us > 0) {
+            lines << QStringLiteral("%1;%2 %3").arg(stack, CycleTimeProfiler::categoryKey(c)).arg(us);
+        }
+    }
+}
+
+} // namespace
+
+CycleTimeProfiler::CycleTimeProfiler(TestSequenceRunner *runner, QObject *parent)
+    : QObject(parent)
+    , m_runner(runner)
+    , m_state(runner->state())
+    , m_active(false)
+    , m_lastNs(0)
+    , m_fixedFromNs(0)
+    , m_fixedUntilNs(0)
+    , m_entry(-1)
+    , m_runs(0)
+{
+    connect(m_runner, &TestSequenceRunner::stateChanged,
+            this, &CycleTimeProfiler::onStateChanged);
+    connect(m_runner, &TestSequenceRunner::stepStarted,
+            this, &CycleTimeProfiler::onStepStarted);
+    connect(m_runner, &TestSequenceRunner::actionStarted,
+            this, &CycleTimeProfiler::onActionStarted);
+    connect(m_runner, &TestSequenceRunner::actionFinished,
+            this, &CycleTimeProfiler::onActionFinished);
+    connect(m_runner, &TestSequenceRunner::sequenceFinished,
+            this, &CycleTimeProfiler::onSequenceFinished);
+}
+
+void CycleTimeProfiler::reset()
+{
+    m_runs = 0;
+    m_runTotals.clear();
+    m_summaries.clear();
+}
+
+QVector<const CycleTimeProfiler::ActionSummary *> CycleTimeProfiler::summaries() const
+{
+    QVector<const ActionSummary *> result;
+    result.reserve(m_summaries.size());
+    for (auto it = m_summaries.constBegin(); it != m_summaries.constEnd(); ++it) {
+        result.append(&it.value());
+    }
+    std::sort(result.begin(), result.end(), [](const ActionSummary *a, const ActionSummary *b) {
+        if (a->stepIndex != b->stepIndex) {
+            return a->stepIndex < b->stepIndex;
+        }
+        if (a->actionIndex != b->actionIndex) {
+            return a->actionIndex < b->actionIndex;
+        }
+        return a->stepName < b->stepName;
+    });
+    return result;
+}
+
+QString CycleTimeProfiler::categoryKey(int category)
+{
+    switch (category) {
+    case Host:          return QStringLiteral("host");
+    case DeviceAck:     return QStringLiteral("ack");
+    case Measurement:   return QStringLiteral("measurement");
+    case FixedDelay:    return QStringLiteral("delay");
+    case Operator:      return QStringLiteral("operator");
+    case Paused:        return QStringLiteral("paused");
+    }
+    return QString();
+}
+
+QString CycleTimeProfiler::categoryName(int category)
+{
+    switch (category) {
+    case Host:          return tr("主机处理");
+    case DeviceAck:     return tr("等待ACK");
+    case Measurement:   return tr("等待测量");
+    case FixedDelay:    return tr("固定延时");
+    case Operator:      return tr("操作员确认");
+    case Paused:        return tr("暂停");
+    }
+    return QString();
+}
+
+QString CycleTimeProfiler::describe(const Breakdown &breakdown)
+{
+    const double total = breakdown.total();
+
+    QVector<int> order;
+    for (int c = 0; c < kCategoryCount; ++c) {
+        if (breakdown.ms[c] > 0.0) {
+            order.append(c);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&breakdown](int a, int b) {
+        return breakdown.ms[a] > breakdown.ms[b];
+    });
+
+    QStringList parts;
+    for (int c : order) {
+        parts << tr("%1 %2 s (%3%)").arg(categoryName(c))
+                 .arg(breakdown.ms[c] / 1000.0, 0, 'f', 2)
+                 .arg(total > 0.0 ? breakdown.ms[c] * 100.0 / total : 0.0, 0, 'f', 0);
+    }
+    return tr("总计 %1 s：%2").arg(total / 1000.0, 0, 'f', 2).arg(parts.join(QStringLiteral("，")));
+}
+
+QString CycleTimeProfiler::csvHeader()
+{
+    return QStringLiteral("kind,run_id,status,step_index,step_name,action_index,action,runs,total_ms,"
+                          "host_ms,ack_ms,measurement_ms,delay_ms,operator_ms,paused_ms,window_total_ms,max_total_ms");
+}
+
+QStringList CycleTimeProfiler::runCsvLines(const RunProfile &profile)
+{
+    const QString runId = QString::number(profile.runId);
+    const QString status = !profile.completed ? QStringLiteral("aborted")
+                         : profile.passed ? QStringLiteral("passed") : QStringLiteral("failed");
+
+    QStringList lines;
+    QStringList fields;
+    fields << QStringLiteral("run") << runId << status << QString() << QString() << QString() << QString()
+           << QStringLiteral("1") << formatMs(profile.total.total());
+    for (double value : profile.total.ms) {
+        fields << formatMs(value);
+    }
+    fields << QString() << QString();
+    lines << fields.join(QLatin1Char(','));
+
+    for (const ActionTiming &timing : profile.actions) {
+        fields.clear();
+        fields << QStringLiteral("action") << runId << QString()
+               << QString::number(timing.stepIndex) << csvField(timing.stepName)
+               << QString::number(timing.actionIndex) << csvField(timing.actionName)
+               << QStringLiteral("1") << formatMs(timing.time.total());
+        for (double value : timing.time.ms) {
+            fields << formatMs(value);
+        }
+        fields << QString() << QString();
+        lines << fields.join(QLatin1Char(','));
+    }
+    return lines;
+}
+
+QStringList CycleTimeProfiler::runFoldedLines(const RunProfile &profile)
+{
+    QStringList lines;
+    Breakdown attributed;
+    for (const ActionTiming &timing : profile.actions) {
+        QString stack = stepFrame(timing.stepIndex, timing.stepName);
+        if (timing.actionIndex >= 0) {
+            stack += QLatin1Char(';') + actionFrame(timing.actionIndex, timing.actionName);
+        }
+        appendFolded(lines, stack, timing.time.ms);
+        for (int c = 0; c < kCategoryCount; ++c) {
+            attributed.ms[c] += timing.time.ms[c];
+        }
+    }
+
+    // 第一个步骤开始之前的时间
+    Breakdown rest;
+    for (int c = 0; c < kCategoryCount; ++c) {
+        rest.ms[c] = qMax(0.0, profile.total.ms[c] - attributed.ms[c]);
+    }
+    appendFolded(lines, frameName(tr("序列开销")), rest.ms);
+    return lines;
+}
+
+QStringList CycleTimeProfiler::toCsvLines() const
+{
+    QStringList lines;
+    QStringList fields;
+    Breakdown mean;
+    for (int c = 0; c < kCategoryCount; ++c) {
+        mean.ms[c] = m_runs > 0 ? m_runTotals.ms[c] / m_runs : 0.0;
+    }
+    fields << QStringLiteral("summary_run") << QString() << QString() << QString() << QString()
+           << QString() << QString() << QString::number(m_runs) << formatMs(mean.total());
+    for (double value : mean.ms) {
+        fields << formatMs(value);
+    }
+    fields << QString() << QString();
+    lines << fields.join(QLatin1Char(','));
+
+    for (const ActionSummary *summary : summaries()) {
+        fields.clear();
+        fields << QStringLiteral("summary_action") << QString() << QString()
+               << QString::number(summary->stepIndex) << csvField(summary->stepName)
+               << QString::number(summary->actionIndex) << csvField(summary->actionName)
+               << QString::number(summary->total.count) << formatMs(summary->total.mean);
+        for (const RangeStats &stats : summary->category) {
+            fields << formatMs(stats.mean);
+        }
+        fields << formatMs(summary->window.mean()) << formatMs(summary->total.max);
+        lines << fields.join(QLatin1Char(','));
+    }
+    return lines;
+}
+
+QStringList CycleTimeProfiler::toFoldedLines() const
+{
+    QStringList lines;
+    for (const ActionSummary *summary : summaries()) {
+        QString stack = stepFrame(summary->stepIndex, summary->stepName);
+        if (summary->actionIndex >= 0) {
+            stack += QLatin1Char(';') + actionFrame(summary->actionIndex, summary->actionName);
+        }
+        Breakdown mean;
+        for (int c = 0; c < kCategoryCount; ++c) {
+            mean.ms[c] = summary->category[c].mean;
+        }
+        appendFolded(lines, stack, mean.ms);
+    }
+    return lines;
+}
+
+void CycleTimeProfiler::onStateChanged(TestSequenceRunner::State state)
+{
+    const qint64 now = MonotonicClock::nowNs();
+    advance(now);
+    m_state = state;
+
+    if (state == TestSequenceRunner::State::Running && !m_active) {
+        // start() 在进入运行状态前已更新运行编号
+        m_run = RunProfile();
+        m_run.runId = m_runner->runId();
+        m_active = true;
+        m_lastNs = now;
+        m_fixedFromNs = m_fixedUntilNs = now;
+        m_entry = -1;
+    } else if (state == TestSequenceRunner::State::Aborted && m_active) {
+        finishRun(false, false);
+    }
+}
+
+void CycleTimeProfiler::onStepStarted(int stepIndex, const StepSpec &step)
+{
+    Q_UNUSED(step)
+
+    advance(MonotonicClock::nowNs());
+    m_entry = entryFor(stepIndex, -1);
+}
+
+void CycleTimeProfiler::onActionStarted(int stepIndex, int actionIndex, const SubAction &action)
+{
+    Q_UNUSED(action)
+
+    const qint64 now = MonotonicClock::nowNs();
+    advance(now);
+    m_entry = entryFor(stepIndex, actionIndex);
+
+    const CompiledPlan &plan = m_runner->plan();
+    if (m_entry >= 0 && plan.action(stepIndex, actionIndex).kind == CompiledAction::Delay) {
+        setFixedWindow(now, plan.action(stepIndex, actionIndex).timeoutMs);
+    }
+}
+
+void CycleTimeProfiler::onActionFinished(int stepIndex, int actionIndex, TestSequenceRunner::ActionResult result,
+                                         const QString &message)
+{
+    Q_UNUSED(result)
+    Q_UNUSED(message)
+
+    const qint64 now = MonotonicClock::nowNs();
+    advance(now);
+
+    // 之后到下一个动作开始的间隔计入刚结束的动作；并行组使用组内最后一个动作的间隔
+    const CompiledPlan &plan = m_runner->plan();
+    if (stepIndex >= 0 && stepIndex < plan.stepCount() &&
+        actionIndex >= 0 && actionIndex < plan.stepTable.at(stepIndex).actionCount) {
+        const int last = qMax(actionIndex, plan.action(stepIndex, actionIndex).groupEnd);
+        setFixedWindow(now, plan.action(stepIndex, last).gapMs);
+    }
+}
+
+void CycleTimeProfiler::onSequenceFinished(bool allPassed, int passedCount, int totalCount)
+{
+    Q_UNUSED(passedCount)
+    Q_UNUSED(totalCount)
+
+    if (m_active) {
+        advance(MonotonicClock::nowNs());
+        finishRun(true, allPassed);
+    }
+}
+
+void CycleTimeProfiler::advance(qint64 nowNs)
+{
+    const qint64 fromNs = m_lastNs;
+    m_lastNs = nowNs;
+    if (!m_active || nowNs <= fromNs) {
+        return;
+    }
+
+    Breakdown delta;
+    const double elapsedMs = (nowNs - fromNs) / kNsPerMs;
+    switch (m_state) {
+    case TestSequenceRunner::State::Running: {
+        const qint64 overlapNs = qMin(nowNs, m_fixedUntilNs) - qMax(fromNs, m_fixedFromNs);
+        const double fixedMs = overlapNs > 0 ? overlapNs / kNsPerMs : 0.0;
+        delta.ms[FixedDelay] = fixedMs;
+        delta.ms[Host] = elapsedMs - fixedMs;
+        break;
+    }
+    case TestSequenceRunner::State::WaitingForAck:
+        delta.ms[DeviceAck] = elapsedMs;
+        break;
+    case TestSequenceRunner::State::WaitingForMeasurement:
+        delta.ms[Measurement] = elapsedMs;
+        break;
+    case TestSequenceRunner::State::WaitingForUser:
+        delta.ms[Operator] = elapsedMs;
+        break;
+    case TestSequenceRunner::State::Paused:
+    case TestSequenceRunner::State::WaitingForPauseAck:
+        delta.ms[Paused] = elapsedMs;
+        break;
+    case TestSequenceRunner::State::Idle:
+    case TestSequenceRunner::State::Finished:
+    case TestSequenceRunner::State::Aborted:
+        return;
+    }
+
+    for (int c = 0; c < kCategoryCount; ++c) {
+        m_run.total.ms[c] += delta.ms[c];
+        if (m_entry >= 0) {
+            m_run.actions[m_entry].time.ms[c] += delta.ms[c];
+        }
+    }
+}
+
+int CycleTimeProfiler::entryFor(int stepIndex, int actionIndex)
+{
+    const CompiledPlan &plan = m_runner->plan();
+    if (stepIndex < 0 || stepIndex >= plan.stepCount() ||
+        actionIndex < -1 || actionIndex >= plan.stepTable.at(stepIndex).actionCount) {
+        return -1;
+    }
+
+    // 通常是最近的条目，从后往前找
+    for (int i = m_run.actions.size() - 1; i >= 0; --i) {
+        const ActionTiming &timing = m_run.actions.at(i);
+        if (timing.stepIndex == stepIndex && timing.actionIndex == actionIndex) {
+            return i;
+        }
+    }
+
+    ActionTiming timing;
+    timing.stepIndex = stepIndex;
+    timing.actionIndex = actionIndex;
+    timing.stepName = plan.steps.at(stepIndex).name;
+    timing.actionName = actionIndex >= 0 ? plan.action(stepIndex, actionIndex).logText : tr("步骤开销");
+    m_run.actions.append(timing);
+    return m_run.actions.size() - 1;
+}
+
+void CycleTimeProfiler::setFixedWindow(qint64 nowNs, int durationMs)
+{
+    m_fixedFromNs = nowNs;
+    m_fixedUntilNs = nowNs + static_cast<qint64>(qMax(0, durationMs)) * 1000000;
+}
+
+void CycleTimeProfiler::finishRun(bool completed, bool passed)
+{
+    m_active = false;
+    m_entry = -1;
+    m_run.completed = completed;
+    m_run.passed = passed;
+
+    if (completed) {
+        ++m_runs;
+        for (int c = 0; c < kCategoryCount; ++c) {
+            m_runTotals.ms[c] += m_run.total.ms[c];
+        }
+        for (const ActionTiming &timing : m_run.actions) {
+            ActionSummary &summary = m_summaries[actionKey(timing.stepIndex, timing.stepName, timing.actionIndex)];
+            summary.stepIndex = timing.stepIndex;
+            summary.actionIndex = timing.actionIndex;
+            summary.stepName = timing.stepName;
+            summary.actionName = timing.actionName;
+            const double total = timing.time.total();
+            summary.total.add(total);
+            summary.window.add(total);
+            for (int c = 0; c < kCategoryCount; ++c) {
+                summary.category[c].add(timing.time.ms[c]);
+            }
+        }
+    }
+
+    m_lastRun = m_run;
+    m_run = RunProfile();
+    emit runProfiled(m_lastRun);
+}
+
+QString CycleTimeProfiler::actionKey(int stepIndex, const QString &stepName, int actionIndex)
+{
+    return QString::number(stepIndex) + QLatin1Char('|') + stepName + QLatin1Char('#') + QString::number(actionIndex);
+}
@@ -0,0 +1,233 @@
+#ifndef CYCLETIMEPROFILER_H
+#define CYCLETIMEPROFILER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "app/TestSequenceRunner.h"
+#include "domain/MovingWindow.h"
+#include "domain/RangeStats.h"
+
+/**
+ * @brief 测试周期的耗时分解（每个步骤、每个子动作的时间花在哪里）
+ *
+ * 职责：
+ * - 订阅执行引擎的状态、步骤和子动作信号，把每次运行的墙钟时间分摊到当前子动作的各类耗时：
+ *   主机处理、等待设备 ACK、等待测量数据、固定延时（延时动作和动作间隔）、操作员确认、暂停
+ * - 每次运行结束发射 runProfiled（单次报告），并累计到跨运行汇总（全程均值 + 最近 kWindowSize 次均值）
+ * - 导出为 CSV 或折叠栈格式（flamegraph.pl / speedscope 可直接生成火焰图）
+ *
+ * 分类依据执行引擎状态：等待 ACK / 测量 / 用户确认 / 暂停各自计入对应类别；
+ * 运行状态下落在延时动作时长或动作间隔（按编译后的动作表）之内的部分计为固定延时，其余计为主机处理
+ * （包括定时器超出设定时长的部分）。并行组的时间计入组内最后启动的子动作。
+ * 子动作序号为 -1 的条目是步骤内不属于任何子动作的时间（如步骤间隔）。
+ *
+ * 跨运行汇总只统计完整执行的运行，每个子动作的内存固定（与运行次数无关）。
+ */
+class CycleTimeProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kWindowSize = 20;      ///< 滑动窗口大小（最近 N 次运行）
+
+    /**
+     * @brief 耗时类别
+     */
+    enum Category {
+        Host,               ///< 主机处理
+        DeviceAck,          ///< 等待设备 ACK
+        Measurement,        ///< 等待测量数据
+        FixedDelay,         ///< 固定延时（延时动作、动作间隔）
+        Operator,           ///< 操作员确认
+        Paused,             ///< 暂停
+        kCategoryCount
+    };
+
+    /**
+     * @brief 各类别的耗时（ms）
+     */
+    struct Breakdown {
+        double ms[kCategoryCount];
+
+        Breakdown() { clear(); }
+
+        void clear()
+        {
+            for (double &value : ms) {
+                value = 0.0;
+            }
+        }
+
+        double total() const
+        {
+            double sum = 0.0;
+            for (double value : ms) {
+                sum += value;
+            }
+            return sum;
+        }
+    };
+
+    /**
+     * @brief 单个子动作在一次运行中的耗时
+     */
+    struct ActionTiming {
+        int stepIndex;              ///< 步骤索引
+        int actionIndex;            ///< 子动作索引（-1 表示步骤内不属于子动作的时间）
+        QString stepName;           ///< 步骤名称
+        QString actionName;         ///< 子动作描述
+        Breakdown time;             ///< 耗时分解
+
+        ActionTiming() : stepIndex(-1), actionIndex(-1) {}
+    };
+
+    /**
+     * @brief 一次运行的报告
+     */
+    struct RunProfile {
+        qint64 runId;                       ///< 运行编号
+        bool completed;                     ///< 是否完整执行（中止为 false）
+        bool passed;                        ///< 是否全部步骤通过
+        Breakdown total;                    ///< 整次运行的耗时分解（含第一个步骤之前的时间）
+        QVector<ActionTiming> actions;      ///< 各子动作（按首次执行顺序）
+
+        RunProfile() : runId(0), completed(false), passed(false) {}
+    };
+
+    /**
+     * @brief 单个子动作的跨运行汇总
+     */
+    struct ActionSummary {
+        int stepIndex;              ///< 步骤索引
+        int actionIndex;            ///< 子动作索引
+        QString stepName;           ///< 步骤名称
+        QString actionName;         ///< 子动作描述
+        RangeStats total;           ///< 总耗时统计（ms）
+        RangeStats category[kCategoryCount];    ///< 各类别耗时统计（ms）
+        MovingWindow window;        ///< 最近 kWindowSize 次的总耗时
+
+        ActionSummary() : stepIndex(-1), actionIndex(-1), window(kWindowSize) {}
+    };
+
+    /**
+     * @brief 构造函数
+     * @param runner 执行引擎（不转移所有权）
+     * @param parent 父对象
+     */
+    explicit CycleTimeProfiler(TestSequenceRunner *runner, QObject *parent = nullptr);
+
+    /**
+     * @brief 清空跨运行汇总
+     */
+    void reset();
+
+    /**
+     * @brief 最近一次运行的报告
+     */
+    const RunProfile &lastRun() const { return m_lastRun; }
+
+    /**
+     * @brief 已汇总的完整运行次数
+     */
+    quint64 runCount() const { return m_runs; }
+
+    /**
+     * @brief 各子动作的跨运行汇总（按步骤、子动作索引排序）
+     */
+    QVector<const ActionSummary *> summaries() const;
+
+    /**
+     * @brief 类别的英文键（CSV 列名、折叠栈的叶子帧）
+     */
+    static QString categoryKey(int category);
+
+    /**
+     * @brief 类别的显示名称
+     */
+    static QString categoryName(int category);
+
+    /**
+     * @brief 耗时分解转为一行日志文本（按耗时从大到小）
+     */
+    static QString describe(const Breakdown &breakdown);
+
+    /**
+     * @brief CSV 表头（单次报告和跨运行汇总共用）
+     */
+    static QString csvHeader();
+
+    /**
+     * @brief 单次报告导出为 CSV 行（整次运行一行，每个子动作一行）
+     */
+    static QStringList runCsvLines(const RunProfile &profile);
+
+    /**
+     * @brief 单次报告导出为折叠栈（"步骤;子动作;类别 微秒"）
+     */
+    static QStringList runFoldedLines(const RunProfile &profile);
+
+    /**
+     * @brief 跨运行汇总导出为 CSV 行（各类别为全程均值）
+     */
+    QStringList toCsvLines() const;
+
+    /**
+     * @brief 跨运行汇总导出为折叠栈（各类别为全程均值，微秒）
+     */
+    QStringList toFoldedLines() const;
+
+signals:
+    /**
+     * @brief 一次运行结束（完整执行或中止）
+     */
+    void runProfiled(const CycleTimeProfiler::RunProfile &profile);
+
+private slots:
+    void onStateChanged(TestSequenceRunner::State state);
+    void onStepStarted(int stepIndex, const StepSpec &step);
+    void onActionStarted(int stepIndex, int actionIndex, const SubAction &action);
+    void onActionFinished(int stepIndex, int actionIndex, TestSequenceRunner::ActionResult result,
+                          const QString &message);
+    void onSequenceFinished(bool allPassed, int passedCount, int totalCount);
+
+private:
+    /**
+     * @brief 把上次事件到现在的时间计入当前条目
+     */
+    void advance(qint64 nowNs);
+
+    /**
+     * @brief 当前运行中 (步骤, 子动作) 对应的条目下标（不存在时追加）
+     */
+    int entryFor(int stepIndex, int actionIndex);
+
+    /**
+     * @brief 设置固定延时区间 [nowNs, nowNs + durationMs)
+     */
+    void setFixedWindow(qint64 nowNs, int durationMs);
+
+    /**
+     * @brief 结束当前运行，发射 runProfiled 并累计汇总
+     */
+    void finishRun(bool completed, bool passed);
+
+    static QString actionKey(int stepIndex, const QString &stepName, int actionIndex);
+
+    TestSequenceRunner *m_runner;                   ///< 执行引擎
+    TestSequenceRunner::State m_state;              ///< 执行引擎当前状态
+    bool m_active;                                  ///< 是否正在记录一次运行
+    qint64 m_lastNs;                                ///< 上次计时的时刻（MonotonicClock，纳秒）
+    qint64 m_fixedFromNs;                           ///< 固定延时区间起点
+    qint64 m_fixedUntilNs;                          ///< 固定延时区间终点
+    int m_entry;                                    ///< 当前条目下标（-1 表示只计入整次运行）
+    RunProfile m_run;                               ///< 正在记录的运行
+    RunProfile m_lastRun;                           ///< 最近一次结束的运行
+    quint64 m_runs;                                 ///< 已汇总的完整运行次数
+    Breakdown m_runTotals;                          ///< 完整运行的各类别累计耗时（ms）
+    QHash<QString, ActionSummary> m_summaries;      ///< 子动作键 → 跨运行汇总
+};
+
+#endif // CYCLETIMEPROFILER_H
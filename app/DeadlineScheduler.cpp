@@ -0,0 +1,169 @@
+#include "DeadlineScheduler.h"
+#include "domain/MonotonicClock.h"
+#include <algorithm>
+
+namespace {
+constexpr qint64 kNsPerMs = 1000000;
+}
+
+DeadlineScheduler::DeadlineScheduler(int keyCount, QObject *parent)
+    : QObject(parent)
+    , m_slots(keyCount)
+    , m_sequence(0)
+    , m_timer(new QTimer(this))
+{
+    m_heap.reserve(keyCount * 2);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &DeadlineScheduler::onTimer);
+}
+
+void DeadlineScheduler::start(int key, int delayMs)
+{
+    if (!isValidKey(key)) {
+        return;
+    }
+    push(key, MonotonicClock::nowNs() + qMax(0, delayMs) * kNsPerMs);
+    rearm();
+}
+
+void DeadlineScheduler::cancel(int key)
+{
+    if (!isValidKey(key) || m_slots[key].state == Slot::Idle) {
+        return;
+    }
+    Slot &slot = m_slots[key];
+    slot.state = Slot::Idle;
+    ++slot.generation;
+    rearm();
+}
+
+void DeadlineScheduler::cancelAll()
+{
+    for (Slot &slot : m_slots) {
+        slot.state = Slot::Idle;
+        ++slot.generation;
+    }
+    m_heap.clear();
+    m_timer->stop();
+}
+
+bool DeadlineScheduler::isActive(int key) const
+{
+    return isValidKey(key) && m_slots.at(key).state == Slot::Active;
+}
+
+bool DeadlineScheduler::isFrozen(int key) const
+{
+    return isValidKey(key) && m_slots.at(key).state == Slot::Frozen;
+}
+
+int DeadlineScheduler::remainingMs(int key) const
+{
+    if (!isValidKey(key)) {
+        return -1;
+    }
+    const Slot &slot = m_slots.at(key);
+    qint64 remainingNs;
+    switch (slot.state) {
+    case Slot::Active:
+        remainingNs = qMax<qint64>(0, slot.deadlineNs - MonotonicClock::nowNs());
+        break;
+    case Slot::Frozen:
+        remainingNs = slot.remainingNs;
+        break;
+    default:
+        return -1;
+    }
+    return static_cast<int>((remainingNs + kNsPerMs - 1) / kNsPerMs);
+}
+
+void DeadlineScheduler::freeze()
+{
+    const qint64 now = MonotonicClock::nowNs();
+    for (Slot &slot : m_slots) {
+        if (slot.state != Slot::Active) {
+            continue;
+        }
+        slot.state = Slot::Frozen;
+        slot.remainingNs = qMax<qint64>(0, slot.deadlineNs - now);
+        ++slot.generation;
+    }
+    rearm();
+}
+
+int DeadlineScheduler::thaw()
+{
+    const qint64 now = MonotonicClock::nowNs();
+    int thawed = 0;
+    for (int key = 0; key < m_slots.size(); ++key) {
+        if (m_slots.at(key).state == Slot::Frozen) {
+            push(key, now + m_slots.at(key).remainingNs);
+            ++thawed;
+        }
+    }
+    rearm();
+    return thawed;
+}
+
+void DeadlineScheduler::onTimer()
+{
+    // 接收方可能在 expired 中启动/取消截止时间，每次都从堆顶重新判断
+    for (;;) {
+        dropStale();
+        if (m_heap.isEmpty() || m_heap.first().deadlineNs > MonotonicClock::nowNs()) {
+            break;
+        }
+
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        const int key = m_heap.last().key;
+        m_heap.removeLast();
+        m_slots[key].state = Slot::Idle;
+        ++m_slots[key].generation;
+
+        emit expired(key);
+    }
+    rearm();
+}
+
+void DeadlineScheduler::push(int key, qint64 deadlineNs)
+{
+    Slot &slot = m_slots[key];
+    ++slot.generation;
+    slot.state = Slot::Active;
+    slot.deadlineNs = deadlineNs;
+
+    Entry entry;
+    entry.deadlineNs = deadlineNs;
+    entry.sequence = m_sequence++;
+    entry.key = key;
+    entry.generation = slot.generation;
+    m_heap.append(entry);
+    std::push_heap(m_heap.begin(), m_heap.end());
+}
+
+void DeadlineScheduler::dropStale()
+{
+    while (!m_heap.isEmpty()) {
+        const Entry &top = m_heap.first();
+        const Slot &slot = m_slots.at(top.key);
+        if (slot.state == Slot::Active && slot.generation == top.generation) {
+            return;
+        }
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        m_heap.removeLast();
+    }
+}
+
+void DeadlineScheduler::rearm()
+{
+    dropStale();
+    if (m_heap.isEmpty()) {
+        m_timer->stop();
+        return;
+    }
+
+    // 向上取整到毫秒，定时器不会早于截止时间触发
+    const qint64 remainingNs = qMax<qint64>(0, m_heap.first().deadlineNs - MonotonicClock::nowNs());
+    m_timer->start(static_cast<int>((remainingNs + kNsPerMs - 1) / kNsPerMs));
+}
@@ -0,0 +1,150 @@
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @brief 截止时间调度器（单个定时器 + 最小堆）
+ *
+ * 职责：
+ * - 以 MonotonicClock 的纳秒时间轴保存截止时间，所有截止时间共用一个 PreciseTimer，
+ *   定时器总是按堆顶（最早的截止时间）启动
+ * - 每个键同时只有一个截止时间，重新启动即替换（旧堆项按代号惰性失效，不做堆内删除）
+ * - 冻结/解冻：冻结时保存每个截止时间的纳秒级剩余时间，解冻后按剩余时间重新排队；
+ *   冻结期间新启动的截止时间照常运行（如暂停时等待停止检测的ACK）
+ *
+ * 键由调用方定义（通常为枚举值），取值范围 [0, keyCount)。
+ * 同一时刻到期的截止时间按启动先后依次发射 expired。
+ */
+class DeadlineScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param keyCount 键的数量
+     * @param parent 父对象
+     */
+    explicit DeadlineScheduler(int keyCount, QObject *parent = nullptr);
+
+    /**
+     * @brief 启动（或替换）一个截止时间
+     * @param key 键
+     * @param delayMs 距现在的毫秒数（0 表示在返回事件循环后立即到期）
+     */
+    void start(int key, int delayMs);
+
+    /**
+     * @brief 取消一个截止时间（包括已冻结的）
+     */
+    void cancel(int key);
+
+    /**
+     * @brief 取消全部截止时间
+     */
+    void cancelAll();
+
+    /**
+     * @brief 截止时间是否在运行（不含已冻结的）
+     */
+    bool isActive(int key) const;
+
+    /**
+     * @brief 截止时间是否已冻结
+     */
+    bool isFrozen(int key) const;
+
+    /**
+     * @brief 距截止时间的剩余毫秒数（向上取整；已冻结时为冻结时的剩余时间，未启动时为 -1）
+     */
+    int remainingMs(int key) const;
+
+    /**
+     * @brief 冻结当前运行中的全部截止时间
+     */
+    void freeze();
+
+    /**
+     * @brief 按冻结时的剩余时间恢复全部已冻结的截止时间
+     * @return 恢复的截止时间数
+     */
+    int thaw();
+
+signals:
+    /**
+     * @brief 截止时间到期
+     * @param key 键
+     */
+    void expired(int key);
+
+private slots:
+    /**
+     * @brief 定时器到期：依次发射所有已到期的截止时间，再按新的堆顶重新启动定时器
+     */
+    void onTimer();
+
+private:
+    /**
+     * @brief 每个键的状态
+     */
+    struct Slot {
+        enum State : quint8 {
+            Idle,       ///< 未启动
+            Active,     ///< 运行中（堆中有对应的有效项）
+            Frozen      ///< 已冻结（保存剩余时间）
+        };
+
+        State state;
+        quint32 generation;     ///< 每次启动/取消递增，堆项代号不符即失效
+        qint64 deadlineNs;      ///< 截止时间（Active）
+        qint64 remainingNs;     ///< 剩余时间（Frozen）
+
+        Slot() : state(Idle), generation(0), deadlineNs(0), remainingNs(0) {}
+    };
+
+    /**
+     * @brief 堆项
+     */
+    struct Entry {
+        qint64 deadlineNs;      ///< 截止时间
+        quint64 sequence;       ///< 启动序号（截止时间相同时先启动的先到期）
+        int key;                ///< 键
+        quint32 generation;     ///< 启动时的代号
+
+        /**
+         * @brief 最小堆比较（std::push_heap 默认构造最大堆，因此反向比较）
+         */
+        bool operator<(const Entry &other) const
+        {
+            return deadlineNs != other.deadlineNs ? deadlineNs > other.deadlineNs
+                                                  : sequence > other.sequence;
+        }
+    };
+
+    /**
+     * @brief 将截止时间放入堆
+     */
+    void push(int key, qint64 deadlineNs);
+
+    /**
+     * @brief 弹出堆顶的失效项
+     */
+    void dropStale();
+
+    /**
+     * @brief 按堆顶重新启动定时器（堆为空时停止）
+     */
+    void rearm();
+
+    bool isValidKey(int key) const { return key >= 0 && key < m_slots.size(); }
+
+    QVector<Slot> m_slots;      ///< 按键索引的状态
+    QVector<Entry> m_heap;      ///< 截止时间最小堆
+    quint64 m_sequence;         ///< 启动序号
+    QTimer *m_timer;            ///< 唯一的定时器
+};
+
+#endif // DEADLINESCHEDULER_H
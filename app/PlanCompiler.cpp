@@ -0,0 +1,605 @@
+#include "PlanCompiler.h"
+#include "DeviceProtocol.h"
+#include <QObject>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QLocale>
+#include <cmath>
+
+namespace {
+constexpr quint32 PLAN_CACHE_MAGIC = 0x50434250;   // "PCBP"
+
+constexpr Frame<1> kStartExternalMeterFrame = DeviceProtocol::externalMeterStartFrame();
+constexpr Frame<2> kStartExternalMeterAck = DeviceProtocol::externalMeterStartAckFrame();
+constexpr Frame<1> kStopExternalMeterFrame = DeviceProtocol::externalMeterStopFrame();
+constexpr Frame<2> kStopExternalMeterAck = DeviceProtocol::externalMeterStopAckFrame();
+
+bool isValidV123Channel(uint8_t channelId)
+{
+    return channelId == 0x01 || channelId == 0x02 || channelId == 0x03;
+}
+
+QString channelHex(uint8_t channelId)
+{
+    return QString("0x%1").arg(channelId, 2, 16, QChar('0'));
+}
+
+/**
+ * @brief 填充设备命令动作（echo 型命令的期望回应即命令帧本身）
+ */
+void setDeviceCommand(CompiledAction &compiled, Command command, const QByteArray &frame,
+                      const QByteArray &expectedResponse, const QString &logText,
+                      const QString &failureText, const QString &coalesceKey = QString())
+{
+    compiled.kind = CompiledAction::DeviceCommand;
+    compiled.command = command;
+    compiled.frame = frame;
+    compiled.expectedResponse = expectedResponse;
+    compiled.coalesceKey = coalesceKey;
+    compiled.timeoutMs = PlanCompiler::kDefaultAckTimeoutMs;
+    compiled.logText = QObject::tr("%1，DATA: %2").arg(logText, DeviceProtocol::toHex(frame));
+    compiled.failureText = failureText;
+}
+
+// ========== 二进制序列化 ==========
+
+void writeAction(QDataStream &stream, const SubAction &action)
+{
+    stream << static_cast<qint32>(action.type)
+           << action.v1Value << action.v2Value << static_cast<quint8>(action.v1Channel)
+           << static_cast<qint32>(action.key) << static_cast<qint32>(action.delayMs)
+           << action.currentThreshold << action.isUpperLimit << action.adaptiveSettle
+           << static_cast<qint32>(action.settleMaxWaitMs) << static_cast<qint32>(action.settleMinWaitMs)
+           << static_cast<qint32>(action.settleWindowSamples)
+           << action.confirmMessage
+           << static_cast<quint8>(action.openV1Channel) << static_cast<quint8>(action.openV4Channel)
+           << static_cast<qint32>(action.gapMs) << static_cast<qint32>(action.group);
+}
+
+void readAction(QDataStream &stream, SubAction &action)
+{
+    qint32 type = 0, key = 0, delayMs = 0, settleMaxWaitMs = 0, settleMinWaitMs = 0, settleWindowSamples = 0;
+    qint32 gapMs = -1, group = -1;
+    quint8 v1Channel = 0, openV1Channel = 0, openV4Channel = 0;
+    stream >> type
+           >> action.v1Value >> action.v2Value >> v1Channel
+           >> key >> delayMs
+           >> action.currentThreshold >> action.isUpperLimit >> action.adaptiveSettle
+           >> settleMaxWaitMs >> settleMinWaitMs >> settleWindowSamples
+           >> action.confirmMessage
+           >> openV1Channel >> openV4Channel
+           >> gapMs >> group;
+    action.type = static_cast<SubAction::Type>(type);
+    action.v1Channel = v1Channel;
+    action.key = static_cast<SubAction::KeyType>(key);
+    action.delayMs = delayMs;
+    action.settleMaxWaitMs = settleMaxWaitMs;
+    action.settleMinWaitMs = settleMinWaitMs;
+    action.settleWindowSamples = settleWindowSamples;
+    action.openV1Channel = openV1Channel;
+    action.openV4Channel = openV4Channel;
+    action.gapMs = gapMs;
+    action.group = group;
+}
+
+void writeCompiledAction(QDataStream &stream, const CompiledAction &action)
+{
+    stream << static_cast<quint8>(action.kind) << static_cast<qint32>(action.command)
+           << action.frame << action.expectedResponse << action.coalesceKey
+           << static_cast<qint8>(action.detection) << static_cast<qint32>(action.timeoutMs)
+           << action.logText << action.failureText << action.confirmMessage
+           << action.threshold << action.isUpperLimit << action.adaptive
+           << static_cast<qint32>(action.settleWindowSamples) << static_cast<qint32>(action.minWaitMs)
+           << static_cast<qint32>(action.gapMs) << static_cast<qint32>(action.groupEnd);
+}
+
+void readCompiledAction(QDataStream &stream, CompiledAction &action)
+{
+    quint8 kind = 0;
+    qint8 detection = 0;
+    qint32 command = 0, timeoutMs = 0, settleWindowSamples = 0, minWaitMs = 0, gapMs = 0, groupEnd = 0;
+    stream >> kind >> command
+           >> action.frame >> action.expectedResponse >> action.coalesceKey
+           >> detection >> timeoutMs
+           >> action.logText >> action.failureText >> action.confirmMessage
+           >> action.threshold >> action.isUpperLimit >> action.adaptive
+           >> settleWindowSamples >> minWaitMs >> gapMs >> groupEnd;
+    action.kind = static_cast<CompiledAction::Kind>(kind);
+    action.command = static_cast<Command>(command);
+    action.detection = static_cast<CompiledAction::DetectionEffect>(detection);
+    action.timeoutMs = timeoutMs;
+    action.settleWindowSamples = settleWindowSamples;
+    action.minWaitMs = minWaitMs;
+    action.gapMs = gapMs;
+    action.groupEnd = groupEnd;
+}
+
+} // namespace
+
+bool PlanCompiler::compile(const QVector<StepSpec> &steps, CompiledPlan &plan, QStringList *errors)
+{
+    plan.clear();
+    plan.steps = steps;
+    plan.stepTable.reserve(steps.size());
+
+    int actionTotal = 0;
+    for (const StepSpec &step : steps) {
+        actionTotal += step.actions.size();
+    }
+    plan.actions.reserve(actionTotal);
+
+    bool ok = true;
+    for (int stepIndex = 0; stepIndex < steps.size(); ++stepIndex) {
+        const StepSpec &step = steps.at(stepIndex);
+
+        CompiledStep compiledStep;
+        compiledStep.firstAction = plan.actions.size();
+        compiledStep.actionCount = step.actions.size();
+        compiledStep.stepTimeoutMs = step.stepTimeoutMs > 0 ? step.stepTimeoutMs : kDefaultStepTimeoutMs;
+        plan.stepTable.append(compiledStep);
+
+        for (int actionIndex = 0; actionIndex < step.actions.size(); ++actionIndex) {
+            CompiledAction compiled;
+            QString error;
+            if (!compileAction(step.actions.at(actionIndex), compiled, error)) {
+                ok = false;
+                if (errors) {
+                    errors->append(QObject::tr("第%1步第%2个动作：%3")
+                                   .arg(stepIndex + 1).arg(actionIndex + 1).arg(error));
+                }
+            }
+            compiled.groupEnd = actionIndex;
+            plan.actions.append(compiled);
+        }
+
+        // 相邻且组号相同的子动作组成并行组
+        for (int groupStart = 0; groupStart < step.actions.size(); ) {
+            const int group = step.actions.at(groupStart).group;
+            int groupEnd = groupStart;
+            while (group >= 0 && groupEnd + 1 < step.actions.size() &&
+                   step.actions.at(groupEnd + 1).group == group) {
+                ++groupEnd;
+            }
+            if (groupEnd > groupStart) {
+                CompiledAction *first = plan.actions.data() + compiledStep.firstAction + groupStart;
+                QString error;
+                if (validateGroup(first, groupEnd - groupStart + 1, error)) {
+                    for (int i = 0; i <= groupEnd - groupStart; ++i) {
+                        first[i].groupEnd = groupEnd;
+                    }
+                } else {
+                    ok = false;
+                    if (errors) {
+                        errors->append(QObject::tr("第%1步第%2~%3个动作（并行组 %4）：%5")
+                                       .arg(stepIndex + 1).arg(groupStart + 1).arg(groupEnd + 1)
+                                       .arg(group).arg(error));
+                    }
+                }
+            }
+            groupStart = groupEnd + 1;
+        }
+    }
+
+    return ok;
+}
+
+bool PlanCompiler::validateGroup(const CompiledAction *actions, int count, QString &error)
+{
+    int delays = 0, confirms = 0, checks = 0, detectionCommands = 0;
+    for (int i = 0; i < count; ++i) {
+        const CompiledAction &action = actions[i];
+        switch (action.kind) {
+        case CompiledAction::Delay:        ++delays; break;
+        case CompiledAction::UserConfirm:  ++confirms; break;
+        case CompiledAction::CheckCurrent: ++checks; break;
+        case CompiledAction::DeviceCommand:
+            if (action.detection != CompiledAction::DetectionUnchanged) {
+                ++detectionCommands;
+            }
+            // 并行命令按发送帧区分确认；合并键相同的命令会互相替换
+            for (int j = 0; j < i; ++j) {
+                if (actions[j].kind != CompiledAction::DeviceCommand) {
+                    continue;
+                }
+                if (actions[j].frame == action.frame) {
+                    error = QObject::tr("组内有相同的命令帧 %1").arg(DeviceProtocol::toHex(action.frame));
+                    return false;
+                }
+                if (!action.coalesceKey.isEmpty() && actions[j].coalesceKey == action.coalesceKey) {
+                    error = QObject::tr("组内有多个同类设置命令（%1），后发的会覆盖先发的").arg(action.coalesceKey);
+                    return false;
+                }
+            }
+            break;
+        }
+    }
+
+    if (delays > 1 || confirms > 1 || checks > 1) {
+        error = QObject::tr("组内延时、用户确认、电流检测各至多一个");
+        return false;
+    }
+    if (detectionCommands > 1 || (detectionCommands > 0 && checks > 0)) {
+        error = QObject::tr("开启/暂停检测不能与其他检测开关命令或电流检测并行");
+        return false;
+    }
+    return true;
+}
+
+bool PlanCompiler::compileAction(const SubAction &action, CompiledAction &compiled, QString &error)
+{
+    // 延时动作本身就是等待，默认不再追加间隔
+    compiled.gapMs = action.gapMs >= 0 ? action.gapMs
+                   : action.type == SubAction::Delay ? 0 : kDefaultActionGapMs;
+
+    switch (action.type) {
+    case SubAction::SetV1Voltage: {
+        if (!isValidV123Channel(action.v1Channel)) {
+            error = QObject::tr("无效的通道ID %1").arg(channelHex(action.v1Channel));
+            return false;
+        }
+        const double voltage = action.v1Value;
+        if (std::isnan(voltage) || (voltage != 0.0 && (voltage < 1.2 || voltage > 5.0))) {
+            error = QObject::tr("V123电压值无效或超出范围（0.0=关闭, 1.2~5.0V） 当前=%1V").arg(voltage, 0, 'f', 2);
+            return false;
+        }
+        const QByteArray frame = DeviceProtocol::v123VoltageControlFrame(action.v1Channel, voltage).toByteArray();
+        setDeviceCommand(compiled, Command::V123VoltageControl, frame, frame,
+                         QObject::tr("设置V1电压: %1V (通道%2)").arg(voltage, 0, 'f', 2).arg(channelHex(action.v1Channel)),
+                         QObject::tr("设置V1电压失败"),
+                         QString("V123Voltage:%1").arg(action.v1Channel));
+        return true;
+    }
+    case SubAction::SetV4Voltage: {
+        const double voltage = action.v2Value;
+        if (voltage != 0.0 && !(voltage >= 1.60 && voltage <= 10.80)) {
+            error = QObject::tr("V4电压值超出范围（0.0=关闭, 1.60~10.80V） 当前=%1V").arg(voltage, 0, 'f', 2);
+            return false;
+        }
+        const QByteArray frame = DeviceProtocol::v4VoltageControlFrame(voltage).toByteArray();
+        setDeviceCommand(compiled, Command::V4VoltageControl, frame, frame,
+                         QObject::tr("设置V4电压: %1V").arg(voltage, 0, 'f', 2),
+                         QObject::tr("设置V4电压失败"),
+                         QStringLiteral("V4Voltage"));
+        return true;
+    }
+    case SubAction::OpenV1Channel: {
+        if (!isValidV123Channel(action.v1Channel)) {
+            error = QObject::tr("无效的通道ID %1").arg(channelHex(action.v1Channel));
+            return false;
+        }
+        const QByteArray frame = DeviceProtocol::v123ChannelOpenFrame(action.v1Channel).toByteArray();
+        setDeviceCommand(compiled, Command::V123ChannelOpen, frame, frame,
+                         QObject::tr("打开V1通道: %1").arg(channelHex(action.v1Channel)),
+                         QObject::tr("打开V1通道失败"));
+        return true;
+    }
+    case SubAction::OpenV4Channel: {
+        const QByteArray frame = DeviceProtocol::v4ChannelOpenFrame().toByteArray();
+        setDeviceCommand(compiled, Command::V4ChannelOpen, frame, frame,
+                         QObject::tr("打开V4通道: 0x04"),
+                         QObject::tr("打开V4通道失败"));
+        return true;
+    }
+    case SubAction::OpenChannel: {
+        if (!isValidV123Channel(action.openV1Channel)) {
+            error = QObject::tr("无效的通道ID %1").arg(channelHex(action.openV1Channel));
+            return false;
+        }
+        if (action.openV4Channel != 0x04) {
+            error = QObject::tr("无效的V4通道ID %1").arg(channelHex(action.openV4Channel));
+            return false;
+        }
+        const QByteArray frame =
+            DeviceProtocol::voltageChannelOpenFrame(action.openV1Channel, action.openV4Channel).toByteArray();
+        setDeviceCommand(compiled, Command::VoltageChannelOpen, frame, frame,
+                         QObject::tr("开启通道: V1通道=%1, V4通道=%2")
+                             .arg(channelHex(action.openV1Channel), channelHex(action.openV4Channel)),
+                         QObject::tr("开启通道失败"));
+        return true;
+    }
+    case SubAction::StartDetection:
+        setDeviceCommand(compiled, Command::StartDetection,
+                         kStartExternalMeterFrame.toRawByteArray(), kStartExternalMeterAck.toRawByteArray(),
+                         QObject::tr("开启外部电流表连续检测"),
+                         QObject::tr("开启外部电流表检测失败"));
+        compiled.detection = CompiledAction::DetectionStarts;
+        return true;
+    case SubAction::PauseDetection:
+        setDeviceCommand(compiled, Command::StopExternalMeter,
+                         kStopExternalMeterFrame.toRawByteArray(), kStopExternalMeterAck.toRawByteArray(),
+                         QObject::tr("停止外部电流表连续检测"),
+                         QObject::tr("停止外部电流表检测失败"));
+        compiled.detection = CompiledAction::DetectionStops;
+        return true;
+    case SubAction::PressKey: {
+        Command command = Command::None;
+        QString keyName;
+        switch (action.key) {
+        case SubAction::KeyPowerConfirm: command = Command::RelayPowerConfirm; keyName = QObject::tr("开机/确认键"); break;
+        case SubAction::KeyRight:        command = Command::RelayRight;        keyName = QObject::tr("右键"); break;
+        case SubAction::KeySw3:          command = Command::RelaySw3;          keyName = QObject::tr("SW3"); break;
+        case SubAction::KeySw4:          command = Command::RelaySw4;          keyName = QObject::tr("SW4"); break;
+        case SubAction::KeySw5:          command = Command::RelaySw5;          keyName = QObject::tr("SW5"); break;
+        case SubAction::KeySw6:          command = Command::RelaySw6;          keyName = QObject::tr("SW6"); break;
+        default:
+            error = QObject::tr("未知按键 %1").arg(static_cast<int>(action.key));
+            return false;
+        }
+        // 按键码与继电器命令字节一致（KeyType 取值即 RelayKeyCode）
+        const QByteArray frame = DeviceProtocol::relayKeyFrame(
+            static_cast<DeviceProtocol::RelayKeyCode>(action.key)).toByteArray();
+        setDeviceCommand(compiled, command, frame, frame,
+                         QObject::tr("模拟按键: %1").arg(keyName),
+                         QObject::tr("按键模拟失败"));
+        return true;
+    }
+    case SubAction::Delay:
+        if (action.delayMs < 0) {
+            error = QObject::tr("延时时间不能为负数: %1 ms").arg(action.delayMs);
+            return false;
+        }
+        compiled.kind = CompiledAction::Delay;
+        compiled.timeoutMs = action.delayMs;
+        compiled.logText = QObject::tr("延时等待: %1 ms").arg(action.delayMs);
+        return true;
+    case SubAction::UserConfirm:
+        compiled.kind = CompiledAction::UserConfirm;
+        compiled.confirmMessage = action.confirmMessage;
+        compiled.logText = QObject::tr("等待用户确认: %1").arg(action.confirmMessage);
+        return true;
+    case SubAction::CheckCurrent: {
+        if (!std::isfinite(action.currentThreshold)) {
+            error = QObject::tr("电流阈值无效");
+            return false;
+        }
+        if (action.adaptiveSettle && action.settleWindowSamples < 3) {
+            error = QObject::tr("自适应判定窗口至少需要 3 个样本，当前=%1").arg(action.settleWindowSamples);
+            return false;
+        }
+        if (action.settleMinWaitMs < 0) {
+            error = QObject::tr("最短等待时间无效: %1 ms").arg(action.settleMinWaitMs);
+            return false;
+        }
+        if (action.adaptiveSettle && action.settleMaxWaitMs > 0 && action.settleMaxWaitMs <= action.settleMinWaitMs) {
+            error = QObject::tr("最长等待时间 %1 ms 必须大于最短等待时间 %2 ms")
+                        .arg(action.settleMaxWaitMs).arg(action.settleMinWaitMs);
+            return false;
+        }
+        compiled.kind = CompiledAction::CheckCurrent;
+        compiled.threshold = action.currentThreshold;
+        compiled.isUpperLimit = action.isUpperLimit;
+        compiled.adaptive = action.adaptiveSettle;
+        compiled.settleWindowSamples = action.settleWindowSamples;
+        compiled.minWaitMs = action.settleMinWaitMs;
+        compiled.logText = QObject::tr("开始电流检测, 阈值: %1 %2")
+                               .arg(action.isUpperLimit ? "<=" : ">=")
+                               .arg(action.currentThreshold, 0, 'f', 3);
+        // 非自适应检测在最短等待之后取第一个样本，与"延时 + 电流检测"相同
+        compiled.timeoutMs = action.settleMinWaitMs + kDefaultMeasurementTimeoutMs;
+        if (action.adaptiveSettle) {
+            if (action.settleMaxWaitMs > 0) {
+                compiled.timeoutMs = action.settleMaxWaitMs;
+            }
+            compiled.logText += QObject::tr("（自适应判定：读数稳定即判定，最长等待 %1ms）").arg(compiled.timeoutMs);
+        }
+        if (action.settleMinWaitMs > 0) {
+            compiled.logText += QObject::tr("（%1ms 内的读数不参与判定）").arg(action.settleMinWaitMs);
+        }
+        return true;
+    }
+    }
+
+    error = QObject::tr("未知的子动作类型: %1").arg(static_cast<int>(action.type));
+    return false;
+}
+
+bool PlanCompiler::loadFromJson(const QByteArray &json, CompiledPlan &plan, QStringList *errors)
+{
+    const QByteArray hash = hashJson(json);
+    if (loadCache(hash, plan)) {
+        return true;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        if (errors) {
+            errors->append(QObject::tr("JSON 解析失败: %1").arg(parseError.errorString()));
+        }
+        return false;
+    }
+
+    QVector<StepSpec> steps = StepSpec::stepsFromJson(doc);
+    if (steps.isEmpty()) {
+        if (errors) {
+            errors->append(QObject::tr("配置文件中没有有效的测试步骤"));
+        }
+        return false;
+    }
+
+    if (!compile(steps, plan, errors)) {
+        return false;
+    }
+
+    plan.sourceHash = hash;
+    saveCache(plan);
+    return true;
+}
+
+QByteArray PlanCompiler::hashJson(const QByteArray &json)
+{
+    return QCryptographicHash::hash(json, QCryptographicHash::Sha256);
+}
+
+QByteArray PlanCompiler::serialize(const CompiledPlan &plan)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << PLAN_CACHE_MAGIC << kFormatVersion << compilerFingerprint() << plan.sourceHash;
+
+    stream << static_cast<quint32>(plan.steps.size());
+    for (int i = 0; i < plan.steps.size(); ++i) {
+        const StepSpec &step = plan.steps.at(i);
+        const CompiledStep &compiledStep = plan.stepTable.at(i);
+        stream << static_cast<qint32>(step.id) << step.name << step.description
+               << static_cast<qint32>(step.stepTimeoutMs)
+               << static_cast<qint32>(compiledStep.firstAction)
+               << static_cast<qint32>(compiledStep.stepTimeoutMs)
+               << static_cast<quint32>(step.actions.size());
+        for (const SubAction &action : step.actions) {
+            writeAction(stream, action);
+        }
+    }
+
+    stream << static_cast<quint32>(plan.actions.size());
+    for (const CompiledAction &action : plan.actions) {
+        writeCompiledAction(stream, action);
+    }
+
+    return data;
+}
+
+bool PlanCompiler::deserialize(const QByteArray &data, CompiledPlan &plan)
+{
+    plan.clear();
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (magic != PLAN_CACHE_MAGIC || version != kFormatVersion) {
+        return false;
+    }
+    QByteArray fingerprint;
+    stream >> fingerprint;
+    if (fingerprint != compilerFingerprint()) {
+        return false;
+    }
+    stream >> plan.sourceHash;
+
+    // 数量上限防止损坏的文件导致巨量分配
+    const quint32 kMaxCount = 0xFFFF;
+
+    quint32 stepCount = 0;
+    stream >> stepCount;
+    if (stream.status() != QDataStream::Ok || stepCount > kMaxCount) {
+        return false;
+    }
+
+    plan.steps.resize(static_cast<int>(stepCount));
+    plan.stepTable.resize(static_cast<int>(stepCount));
+    for (int i = 0; i < plan.steps.size(); ++i) {
+        StepSpec &step = plan.steps[i];
+        CompiledStep &compiledStep = plan.stepTable[i];
+        qint32 id = 0, stepTimeoutMs = 0, firstAction = 0, compiledTimeoutMs = 0;
+        quint32 actionCount = 0;
+        stream >> id >> step.name >> step.description >> stepTimeoutMs
+               >> firstAction >> compiledTimeoutMs >> actionCount;
+        if (stream.status() != QDataStream::Ok || actionCount > kMaxCount) {
+            return false;
+        }
+        step.id = id;
+        step.stepTimeoutMs = stepTimeoutMs;
+        compiledStep.firstAction = firstAction;
+        compiledStep.actionCount = static_cast<int>(actionCount);
+        compiledStep.stepTimeoutMs = compiledTimeoutMs;
+
+        step.actions.resize(static_cast<int>(actionCount));
+        for (SubAction &action : step.actions) {
+            readAction(stream, action);
+        }
+    }
+
+    quint32 actionTotal = 0;
+    stream >> actionTotal;
+    if (stream.status() != QDataStream::Ok || actionTotal > kMaxCount) {
+        return false;
+    }
+    plan.actions.resize(static_cast<int>(actionTotal));
+    for (CompiledAction &action : plan.actions) {
+        readCompiledAction(stream, action);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // 步骤表必须落在动作表范围内，且与原始子动作一一对应
+    for (int i = 0; i < plan.stepTable.size(); ++i) {
+        const CompiledStep &compiledStep = plan.stepTable.at(i);
+        if (compiledStep.firstAction < 0 ||
+            compiledStep.firstAction + compiledStep.actionCount > plan.actions.size() ||
+            compiledStep.actionCount != plan.steps.at(i).actions.size()) {
+            return false;
+        }
+
+        // 执行引擎按种类分派、按 groupEnd 遍历并行组，越界值直接导致越界访问
+        for (int index = 0; index < compiledStep.actionCount; ++index) {
+            const CompiledAction &action = plan.actions.at(compiledStep.firstAction + index);
+            if (action.kind > CompiledAction::CheckCurrent ||
+                action.detection < CompiledAction::DetectionStops ||
+                action.detection > CompiledAction::DetectionStarts ||
+                action.groupEnd < index || action.groupEnd >= compiledStep.actionCount) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QByteArray PlanCompiler::compilerFingerprint()
+{
+    // 日志文本按界面语言生成并写入缓存，语言变化后需要重新编译
+    const QString text = QStringLiteral("%1|%2|%3|%4|%5|%6")
+                             .arg(kEncoderVersion)
+                             .arg(kDefaultAckTimeoutMs)
+                             .arg(kDefaultMeasurementTimeoutMs)
+                             .arg(kDefaultStepTimeoutMs)
+                             .arg(kDefaultActionGapMs)
+                             .arg(QLocale().name());
+    return QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha256);
+}
+
+QString PlanCompiler::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/plans";
+}
+
+QString PlanCompiler::cacheFilePath(const QByteArray &hash)
+{
+    return QString("%1/%2.plan").arg(cacheDirectory(), QString::fromLatin1(hash.toHex()));
+}
+
+bool PlanCompiler::loadCache(const QByteArray &hash, CompiledPlan &plan)
+{
+    QFile in(cacheFilePath(hash));
+    if (!in.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    if (!deserialize(in.readAll(), plan) || plan.sourceHash != hash) {
+        plan.clear();
+        return false;
+    }
+    return true;
+}
+
+void PlanCompiler::saveCache(const CompiledPlan &plan)
+{
+    QDir().mkpath(cacheDirectory());
+
+    QSaveFile out(cacheFilePath(plan.sourceHash));
+    if (!out.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    out.write(serialize(plan));
+    out.commit();
+}
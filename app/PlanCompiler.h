@@ -0,0 +1,99 @@
+#ifndef PLANCOMPILER_H
+#define PLANCOMPILER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "app/CompiledPlan.h"
+#include "domain/StepSpec.h"
+
+/**
+ * @brief 测试计划编译器
+ *
+ * 职责：
+ * - 将 QVector<StepSpec> 编译为扁平、已校验的动作表（命令帧、期望回应、超时、日志文本预先生成）
+ * - 参数校验规则与 DeviceController 的高层命令一致，非法计划在加载时即报错，而不是执行到该步骤才失败
+ * - 划分并行组（相邻且 group 相同的子动作），并校验组内动作可以同时执行
+ * - 从 JSON 导入时按文件内容的 SHA-256 缓存编译结果（二进制），同一配置再次导入时不再解析 JSON
+ *
+ * 缓存文件格式变化时递增 kFormatVersion，命令帧编码或动作表生成逻辑变化时递增 kEncoderVersion，旧缓存自动失效；
+ * 缓存头还记录编译器指纹（编码版本、默认参数、界面语言），默认值调整或切换语言后旧缓存同样失效。
+ * 缓存目录不可写时只是不缓存，行为不变。
+ */
+class PlanCompiler
+{
+public:
+    static constexpr int kDefaultAckTimeoutMs = 5000;           ///< 命令ACK超时
+    static constexpr int kDefaultMeasurementTimeoutMs = 5000;   ///< 测量超时（非自适应检测）
+    static constexpr int kDefaultStepTimeoutMs = 60000;         ///< 步骤超时（未配置时）
+    static constexpr int kDefaultActionGapMs = 100;             ///< 动作间隔（未配置时；延时动作默认为0）
+
+    /**
+     * @brief 编译步骤列表
+     * @param steps 步骤列表
+     * @param[out] plan 编译结果（失败时内容不确定）
+     * @param[out] errors 校验错误（可为空指针）
+     * @return true 编译成功（没有任何校验错误）
+     */
+    static bool compile(const QVector<StepSpec> &steps, CompiledPlan &plan, QStringList *errors = nullptr);
+
+    /**
+     * @brief 从 JSON 配置加载计划（命中缓存时跳过 JSON 解析和编译）
+     * @param json 配置文件内容
+     * @param[out] plan 编译结果
+     * @param[out] errors 解析或校验错误（可为空指针）
+     * @return true 成功
+     */
+    static bool loadFromJson(const QByteArray &json, CompiledPlan &plan, QStringList *errors = nullptr);
+
+    /**
+     * @brief 计算 JSON 配置的缓存键
+     */
+    static QByteArray hashJson(const QByteArray &json);
+
+    /**
+     * @brief 序列化编译结果
+     */
+    static QByteArray serialize(const CompiledPlan &plan);
+
+    /**
+     * @brief 反序列化编译结果
+     * @return true 格式、版本有效且数据完整（动作种类、并行组范围与步骤表一致）
+     */
+    static bool deserialize(const QByteArray &data, CompiledPlan &plan);
+
+    /**
+     * @brief 缓存目录
+     */
+    static QString cacheDirectory();
+
+private:
+    /**
+     * @brief 编译单个子动作
+     * @return true 参数有效
+     */
+    static bool compileAction(const SubAction &action, CompiledAction &compiled, QString &error);
+
+    /**
+     * @brief 校验并行组：同类等待动作（延时/用户确认/电流检测）各至多一个，
+     *        命令帧和合并键互不相同，至多一个检测开关命令且不与电流检测同组
+     * @param actions 组内已编译的子动作
+     * @return true 组内动作可以同时执行
+     */
+    static bool validateGroup(const CompiledAction *actions, int count, QString &error);
+
+    /**
+     * @brief 编译器指纹：编译结果依赖的编码逻辑版本、默认参数和界面语言
+     */
+    static QByteArray compilerFingerprint();
+
+    static QString cacheFilePath(const QByteArray &hash);
+    static bool loadCache(const QByteArray &hash, CompiledPlan &plan);
+    static void saveCache(const CompiledPlan &plan);
+
+    static constexpr quint16 kFormatVersion = 5;   ///< 缓存格式版本
+    static constexpr quint16 kEncoderVersion = 1;  ///< 编码版本（DeviceProtocol 命令帧编码或动作表生成逻辑变化时递增）
+};
+
+#endif // PLANCOMPILER_H
@@ -0,0 +1,250 @@
+#include "SoakController.h"
+#include "domain/MonotonicClock.h"
+#include <QTimer>
+#include <cstdio>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr qint64 kNsPerMs = 1000000;
+
+} // namespace
+
+SoakController::SoakController(TestSequenceRunner *runner, QObject *parent)
+    : QObject(parent)
+    , m_runner(runner)
+    , m_restTimer(new QTimer(this))
+    , m_reportTimer(new QTimer(this))
+    , m_running(false)
+    , m_startNs(0)
+    , m_iterationStartNs(0)
+    , m_cycleWindow(kWindowSize)
+    , m_passWindow(kWindowSize)
+{
+    m_restTimer->setSingleShot(true);
+    connect(m_restTimer, &QTimer::timeout, this, &SoakController::startIteration);
+    connect(m_reportTimer, &QTimer::timeout, this, &SoakController::onReportTimer);
+
+    connect(m_runner, &TestSequenceRunner::sequenceFinished,
+            this, &SoakController::onSequenceFinished);
+    connect(m_runner, &TestSequenceRunner::stepFinished,
+            this, &SoakController::onStepFinished);
+    connect(m_runner, &TestSequenceRunner::stateChanged,
+            this, &SoakController::onRunnerStateChanged);
+    connect(m_runner, &TestSequenceRunner::errorRecorded, this, [this](const ErrorRecord &) {
+        if (m_running) {
+            ++m_report.errorCount;
+        }
+    });
+}
+
+bool SoakController::start(const Config &config)
+{
+    if (m_running || m_runner->isRunning()) {
+        emit logMessage(tr("测试正在运行，无法开始循环测试"));
+        return false;
+    }
+
+    m_config = config;
+    m_report = Report();
+    m_cycleDigest.reset();
+    m_cycleWindow.clear();
+    m_passWindow.clear();
+    m_stepFailures.fill(0, m_runner->plan().stepCount());
+
+    m_running = true;
+    m_startNs = MonotonicClock::nowNs();
+    if (m_config.reportIntervalMs > 0) {
+        m_reportTimer->start(m_config.reportIntervalMs);
+    }
+
+    emit logMessage(tr("开始循环测试: 次数 %1，时长 %2")
+                    .arg(m_config.iterations > 0 ? QString::number(m_config.iterations) : tr("不限"))
+                    .arg(m_config.durationMs > 0 ? tr("%1 分钟").arg(m_config.durationMs / 60000.0, 0, 'f', 1)
+                                                 : tr("不限")));
+
+    startIteration();
+    return m_running;
+}
+
+void SoakController::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    // 先结束循环再中止执行引擎，中止引起的状态变化不再按"执行引擎中止"处理
+    finish(tr("用户停止"));
+    m_runner->stop();
+}
+
+SoakController::Report SoakController::report()
+{
+    if (m_running) {
+        m_report.elapsedMs = (MonotonicClock::nowNs() - m_startNs) / kNsPerMs;
+    }
+    m_report.residentBytes = residentMemoryBytes();
+    m_report.peakResidentBytes = qMax(m_report.peakResidentBytes, m_report.residentBytes);
+    m_report.windowCycleMs = m_cycleWindow.mean();
+    m_report.windowPassRate = m_passWindow.mean();
+    m_report.p50CycleMs = m_cycleDigest.quantile(0.5);
+    m_report.p99CycleMs = m_cycleDigest.quantile(0.99);
+    return m_report;
+}
+
+QString SoakController::describe(const Report &report)
+{
+    const auto megabytes = [](qint64 bytes) {
+        return bytes < 0 ? QStringLiteral("-") : QString::number(bytes / (1024.0 * 1024.0), 'f', 1);
+    };
+
+    return tr("循环 %1 次（通过 %2，失败 %3，错误 %4），已运行 %5 分钟；"
+              "周期 最近 %6 ms，近%7次均值 %8 ms，全程均值 %9 ms，P99 %10 ms，最大 %11 ms；"
+              "RSS %12 MB（首次 %13 MB，峰值 %14 MB）")
+            .arg(report.iterations).arg(report.passed).arg(report.failed).arg(report.errorCount)
+            .arg(report.elapsedMs / 60000.0, 0, 'f', 1)
+            .arg(report.lastCycleMs, 0, 'f', 0)
+            .arg(kWindowSize)
+            .arg(report.windowCycleMs, 0, 'f', 0)
+            .arg(report.cycleStats.mean, 0, 'f', 0)
+            .arg(report.p99CycleMs, 0, 'f', 0)
+            .arg(report.cycleStats.max, 0, 'f', 0)
+            .arg(megabytes(report.residentBytes))
+            .arg(megabytes(report.firstResidentBytes))
+            .arg(megabytes(report.peakResidentBytes));
+}
+
+qint64 SoakController::residentMemoryBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    // /proc/self/statm 第二列为常驻页数
+    FILE *file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return -1;
+    }
+    long long totalPages = 0;
+    long long residentPages = 0;
+    const int fields = std::fscanf(file, "%lld %lld", &totalPages, &residentPages);
+    std::fclose(file);
+    if (fields != 2) {
+        return -1;
+    }
+    return static_cast<qint64>(residentPages) * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+void SoakController::startIteration()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_iterationStartNs = MonotonicClock::nowNs();
+    emit iterationStarted(m_report.iterations + 1);
+    m_runner->start();
+
+    if (!m_runner->isRunning()) {
+        finish(tr("执行引擎无法开始测试"));
+    }
+}
+
+void SoakController::onSequenceFinished(bool allPassed, int passedCount, int totalCount)
+{
+    Q_UNUSED(passedCount)
+    Q_UNUSED(totalCount)
+
+    if (!m_running) {
+        return;
+    }
+
+    const double cycleMs = (MonotonicClock::nowNs() - m_iterationStartNs) / static_cast<double>(kNsPerMs);
+    ++m_report.iterations;
+    if (allPassed) {
+        ++m_report.passed;
+    } else {
+        ++m_report.failed;
+    }
+    m_report.lastCycleMs = cycleMs;
+    m_report.cycleStats.add(cycleMs);
+    m_cycleDigest.add(cycleMs);
+    m_cycleWindow.add(cycleMs);
+    m_passWindow.add(allPassed ? 1.0 : 0.0);
+    if (m_report.iterations == 1) {
+        // 第一次循环结束时各缓存已预热，作为判断内存增长的基线
+        m_report.firstResidentBytes = residentMemoryBytes();
+        m_report.peakResidentBytes = qMax(m_report.peakResidentBytes, m_report.firstResidentBytes);
+    }
+
+    emit iterationFinished(m_report.iterations, allPassed, cycleMs);
+
+    if (limitReached()) {
+        finish(QString());
+        return;
+    }
+
+    // 执行引擎仍在发射完成信号，下一次循环放到事件循环中启动
+    m_restTimer->start(qMax(0, m_config.restMs));
+}
+
+void SoakController::onStepFinished(int stepIndex, bool success, const QString &message)
+{
+    Q_UNUSED(message)
+
+    if (m_running && !success && stepIndex >= 0 && stepIndex < m_stepFailures.size()) {
+        ++m_stepFailures[stepIndex];
+    }
+}
+
+void SoakController::onRunnerStateChanged(TestSequenceRunner::State state)
+{
+    // 串口断开或在其他地方直接中止了执行引擎：循环随之结束
+    if (m_running && state == TestSequenceRunner::State::Aborted) {
+        finish(tr("执行引擎已中止"));
+    }
+}
+
+void SoakController::onReportTimer()
+{
+    emit reportReady(report());
+}
+
+bool SoakController::limitReached() const
+{
+    if (m_config.iterations > 0 && m_report.iterations >= m_config.iterations) {
+        return true;
+    }
+    return m_config.durationMs > 0 && MonotonicClock::nowNs() - m_startNs >= m_config.durationMs * kNsPerMs;
+}
+
+void SoakController::finish(const QString &abortReason)
+{
+    if (!m_running) {
+        return;
+    }
+
+    const Report current = report();
+    m_running = false;
+    m_restTimer->stop();
+    m_reportTimer->stop();
+
+    if (abortReason.isEmpty()) {
+        emit logMessage(tr("循环测试完成: %1").arg(describe(current)));
+    } else {
+        emit logMessage(tr("循环测试中止（%1）: %2").arg(abortReason, describe(current)));
+    }
+    emit finished(current, abortReason);
+}
@@ -0,0 +1,182 @@
+#ifndef SOAKCONTROLLER_H
+#define SOAKCONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "app/TestSequenceRunner.h"
+#include "domain/MovingWindow.h"
+#include "domain/RangeStats.h"
+#include "domain/TDigest.h"
+
+class QTimer;
+
+/**
+ * @brief 长时间循环（耐久/浸泡）测试控制器
+ *
+ * 职责：
+ * - 循环执行执行引擎中已加载的测试计划，直到达到次数上限、时间上限或被停止
+ * - 内存中只保留固定大小的汇总：全程周期统计（RangeStats + t-digest 分位数）、
+ *   最近 kWindowSize 次的周期和通过率滑动窗口、各步骤失败次数
+ * - 定期报告进程常驻内存（RSS）和单次循环周期，用于确认多日无人值守运行时内存保持平稳
+ *
+ * 细节不在这里累积：错误记录由使用方按 TestSequenceRunner::errorRecorded 写入错误记录库，
+ * 每次循环的结果通过 iterationFinished 交给使用方落盘（如无界面执行的汇总文件）。
+ * 执行引擎每次 start() 时清空本次运行的错误记录和步骤结果，单次运行的内存与循环次数无关。
+ */
+class SoakController : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kWindowSize = 100;                     ///< 滑动窗口大小（最近 N 次循环）
+    static constexpr int kDefaultReportIntervalMs = 60 * 1000;  ///< 默认报告间隔
+
+    /**
+     * @brief 循环参数
+     */
+    struct Config {
+        qint64 iterations;      ///< 循环次数上限（0 表示不限）
+        qint64 durationMs;      ///< 运行时间上限（0 表示不限，到达后等当前一次结束再停止）
+        int reportIntervalMs;   ///< 资源与周期报告间隔（0 表示只在结束时报告）
+        int restMs;             ///< 两次循环之间的间隔
+
+        Config() : iterations(0), durationMs(0), reportIntervalMs(kDefaultReportIntervalMs), restMs(0) {}
+    };
+
+    /**
+     * @brief 运行报告（只含汇总值）
+     */
+    struct Report {
+        qint64 iterations;          ///< 已完成的循环次数
+        qint64 passed;              ///< 全部步骤通过的次数
+        qint64 failed;              ///< 有步骤失败的次数
+        qint64 errorCount;          ///< 错误记录总数
+        qint64 elapsedMs;           ///< 已运行时间
+        qint64 residentBytes;       ///< 当前常驻内存（字节，-1 表示无法获取）
+        qint64 peakResidentBytes;   ///< 报告采样到的最大常驻内存（字节）
+        qint64 firstResidentBytes;  ///< 第一次完成循环后的常驻内存（字节，用于比较增长）
+        double lastCycleMs;         ///< 最近一次循环的周期
+        double windowCycleMs;       ///< 最近 kWindowSize 次的平均周期
+        double windowPassRate;      ///< 最近 kWindowSize 次的通过率
+        RangeStats cycleStats;      ///< 全程周期统计（ms）
+        double p50CycleMs;          ///< 周期中位数
+        double p99CycleMs;          ///< 周期 99 分位
+
+        Report()
+            : iterations(0), passed(0), failed(0), errorCount(0), elapsedMs(0)
+            , residentBytes(-1), peakResidentBytes(-1), firstResidentBytes(-1)
+            , lastCycleMs(0.0), windowCycleMs(0.0), windowPassRate(0.0)
+            , p50CycleMs(0.0), p99CycleMs(0.0) {}
+    };
+
+    /**
+     * @brief 构造函数
+     * @param runner 执行引擎（应已加载测试计划，不转移所有权）
+     * @param parent 父对象
+     */
+    explicit SoakController(TestSequenceRunner *runner, QObject *parent = nullptr);
+
+    /**
+     * @brief 开始循环测试（清空上一次的汇总）
+     * @return true 第一次循环已开始；计划无效或执行引擎正忙时返回 false
+     */
+    bool start(const Config &config);
+
+    /**
+     * @brief 停止循环（中止正在进行的一次，发射 finished）
+     */
+    void stop();
+
+    /**
+     * @brief 是否正在循环
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief 当前汇总（同时采样一次常驻内存；循环结束后运行时间保持不变）
+     */
+    Report report();
+
+    /**
+     * @brief 各步骤的失败次数（按步骤索引）
+     */
+    const QVector<qint64> &stepFailures() const { return m_stepFailures; }
+
+    /**
+     * @brief 报告转为一行日志文本
+     */
+    static QString describe(const Report &report);
+
+    /**
+     * @brief 当前进程的常驻内存（字节）
+     * @return 无法获取时返回 -1
+     */
+    static qint64 residentMemoryBytes();
+
+signals:
+    /**
+     * @brief 一次循环开始
+     * @param iteration 循环序号（从1开始）
+     */
+    void iterationStarted(qint64 iteration);
+
+    /**
+     * @brief 一次循环结束
+     * @param iteration 循环序号
+     * @param passed 是否全部步骤通过
+     * @param cycleMs 本次周期（ms）
+     */
+    void iterationFinished(qint64 iteration, bool passed, double cycleMs);
+
+    /**
+     * @brief 定期报告（按 reportIntervalMs，使用方可用 describe 输出到日志）
+     */
+    void reportReady(const SoakController::Report &report);
+
+    /**
+     * @brief 日志消息
+     */
+    void logMessage(const QString &message);
+
+    /**
+     * @brief 循环结束（达到上限、被停止或执行引擎中止）
+     * @param report 最终汇总
+     * @param abortReason 中止原因（正常达到次数或时长上限时为空）
+     */
+    void finished(const SoakController::Report &report, const QString &abortReason);
+
+private slots:
+    void startIteration();
+    void onSequenceFinished(bool allPassed, int passedCount, int totalCount);
+    void onStepFinished(int stepIndex, bool success, const QString &message);
+    void onRunnerStateChanged(TestSequenceRunner::State state);
+    void onReportTimer();
+
+private:
+    /**
+     * @brief 是否已达到次数或时间上限
+     */
+    bool limitReached() const;
+
+    /**
+     * @brief 结束循环并发射 finished
+     * @param abortReason 中止原因（正常结束为空）
+     */
+    void finish(const QString &abortReason);
+
+    TestSequenceRunner *m_runner;       ///< 执行引擎
+    QTimer *m_restTimer;                ///< 循环间隔定时器
+    QTimer *m_reportTimer;              ///< 报告定时器
+    Config m_config;                    ///< 当前参数
+    bool m_running;                     ///< 是否正在循环
+    qint64 m_startNs;                   ///< 开始循环的时刻（MonotonicClock，纳秒）
+    qint64 m_iterationStartNs;          ///< 本次循环开始的时刻
+    Report m_report;                    ///< 汇总
+    TDigest m_cycleDigest;              ///< 周期分布（ms）
+    MovingWindow m_cycleWindow;         ///< 最近 kWindowSize 次的周期
+    MovingWindow m_passWindow;          ///< 最近 kWindowSize 次的通过情况（1/0）
+    QVector<qint64> m_stepFailures;     ///< 各步骤的失败次数
+};
+
+#endif // SOAKCONTROLLER_H
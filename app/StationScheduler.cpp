@@ -0,0 +1,371 @@
+#include "StationScheduler.h"
+#include "SerialPortService.h"
+#include "DeviceController.h"
+#include "app/PlanCompiler.h"
+#include "storage/ErrorRecordStore.h"
+#include "app/YieldAggregator.h"
+
+StationScheduler::StationScheduler(QObject *parent)
+    : QObject(parent)
+    , m_confirmationPresented(false)
+{
+}
+
+StationScheduler::~StationScheduler()
+{
+    clearFixtures();
+}
+
+int StationScheduler::setupFixtures(const QStringList &portNames, int baudRate, bool pipelining)
+{
+    clearFixtures();
+
+    for (const QString &portName : portNames) {
+        Fixture fixture;
+        fixture.portName = portName;
+        fixture.service = new SerialPortService(this);
+        fixture.controller = new DeviceController(fixture.service, this);
+        fixture.controller->setPipeliningEnabled(pipelining);
+        fixture.runner = new TestSequenceRunner(fixture.controller, this);
+        fixture.runner->setFixtureName(portName);
+        fixture.finished = false;
+        fixture.allPassed = false;
+        fixture.passedCount = 0;
+        fixture.totalCount = 0;
+
+        if (!fixture.controller->connectToDevice(portName, baudRate)) {
+            // 连接失败的治具不保留
+            delete fixture.runner;
+            delete fixture.controller;
+            delete fixture.service;
+            continue;
+        }
+
+        m_fixtures.append(fixture);
+        connectFixture(m_fixtures.size() - 1);
+    }
+
+    return m_fixtures.size();
+}
+
+void StationScheduler::clearFixtures()
+{
+    // 先断开信号，避免停止和销毁过程中回调到调度器
+    for (Fixture &fixture : m_fixtures) {
+        fixture.runner->disconnect(this);
+        fixture.controller->disconnect(this);
+    }
+
+    stopAll();
+
+    m_confirmations.clear();
+    m_confirmationPresented = false;
+
+    for (Fixture &fixture : m_fixtures) {
+        delete fixture.runner;
+        fixture.controller->disconnectDevice();
+        delete fixture.controller;
+        delete fixture.service;
+    }
+    m_fixtures.clear();
+}
+
+void StationScheduler::connectFixture(int index)
+{
+    const Fixture &fixture = m_fixtures.at(index);
+
+    // 设备控制器日志
+    connect(fixture.controller, &DeviceController::logMessage,
+            this, [this, index](const QString &message) {
+        emit fixtureLogMessage(index, message);
+    });
+
+    // 执行引擎日志与进度
+    connect(fixture.runner, &TestSequenceRunner::logMessage,
+            this, [this, index](const QString &message) {
+        emit fixtureLogMessage(index, message);
+    });
+    connect(fixture.runner, &TestSequenceRunner::stateChanged,
+            this, [this, index](TestSequenceRunner::State newState) {
+        // 治具中止时撤销其未处理的确认请求，并按未通过计入完成
+        // （stop() 不会发射 sequenceFinished）
+        if (newState == TestSequenceRunner::State::Aborted && !m_fixtures.at(index).finished) {
+            Fixture &abortedFixture = m_fixtures[index];
+            abortedFixture.finished = true;
+            abortedFixture.allPassed = false;
+            abortedFixture.totalCount = abortedFixture.runner->steps().size();
+
+            dropConfirmations(index);
+            emit fixtureUpdated(index);
+            emit fixtureFinished(index, false, abortedFixture.passedCount, abortedFixture.totalCount);
+            checkAllFinished();
+            return;
+        }
+        emit fixtureUpdated(index);
+    });
+    connect(fixture.runner, &TestSequenceRunner::stepStarted,
+            this, [this, index](int, const StepSpec &) {
+        emit fixtureUpdated(index);
+    });
+    // 通过步数随步骤结果累计，中止时上报已通过的步数
+    connect(fixture.runner, &TestSequenceRunner::stepFinished,
+            this, [this, index](int, bool success, const QString &) {
+        if (success) {
+            ++m_fixtures[index].passedCount;
+            emit fixtureUpdated(index);
+        }
+    });
+
+    // 错误记录写入错误记录库
+    if (m_errorRecordStore) {
+        connect(fixture.runner, &TestSequenceRunner::errorRecorded,
+                m_errorRecordStore.data(), &ErrorRecordStore::append);
+    }
+
+    // 步骤和电流检测结果汇总到良率统计
+    if (m_yieldAggregator) {
+        m_yieldAggregator->attachRunner(fixture.runner);
+    }
+
+    // 用户确认请求：进入统一队列
+    connect(fixture.runner, &TestSequenceRunner::userConfirmRequired,
+            this, [this, index](const QString &message) {
+        enqueueConfirmation(index, message);
+    });
+    // 确认请求作废（并行组内其他动作失败等）：移出队列，不再等待操作员应答
+    connect(fixture.runner, &TestSequenceRunner::userConfirmCancelled,
+            this, [this, index](quint64) {
+        dropConfirmations(index);
+    });
+
+    // 执行完成
+    connect(fixture.runner, &TestSequenceRunner::sequenceFinished,
+            this, [this, index](bool allPassed, int passedCount, int totalCount) {
+        Fixture &finishedFixture = m_fixtures[index];
+        bool alreadyFinished = finishedFixture.finished;
+        finishedFixture.finished = true;
+        finishedFixture.allPassed = allPassed;
+        finishedFixture.passedCount = passedCount;
+        finishedFixture.totalCount = totalCount;
+
+        dropConfirmations(index);
+        emit fixtureUpdated(index);
+        if (!alreadyFinished) {
+            emit fixtureFinished(index, allPassed, passedCount, totalCount);
+            checkAllFinished();
+        }
+    });
+}
+
+void StationScheduler::loadSteps(const QVector<StepSpec> &steps)
+{
+    // 所有治具执行同一计划：只编译一次，各执行引擎共享编译结果（隐式共享，不复制动作表）
+    CompiledPlan plan;
+    if (!PlanCompiler::compile(steps, plan)) {
+        // 校验失败时由各执行引擎记录校验错误并拒绝启动
+        for (Fixture &fixture : m_fixtures) {
+            fixture.runner->loadSteps(steps);
+        }
+        return;
+    }
+
+    for (Fixture &fixture : m_fixtures) {
+        fixture.runner->loadPlan(plan);
+    }
+}
+
+QString StationScheduler::fixturePortName(int index) const
+{
+    if (index < 0 || index >= m_fixtures.size()) {
+        return QString();
+    }
+    return m_fixtures.at(index).portName;
+}
+
+TestSequenceRunner *StationScheduler::fixtureRunner(int index) const
+{
+    if (index < 0 || index >= m_fixtures.size()) {
+        return nullptr;
+    }
+    return m_fixtures.at(index).runner;
+}
+
+DeviceController *StationScheduler::fixtureController(int index) const
+{
+    if (index < 0 || index >= m_fixtures.size()) {
+        return nullptr;
+    }
+    return m_fixtures.at(index).controller;
+}
+
+QVector<ErrorRecord> StationScheduler::fixtureErrorRecords(int index) const
+{
+    if (index < 0 || index >= m_fixtures.size()) {
+        return QVector<ErrorRecord>();
+    }
+    return m_fixtures.at(index).runner->getErrorRecords();
+}
+
+QVector<StationScheduler::FixtureSummary> StationScheduler::summary() const
+{
+    QVector<FixtureSummary> result;
+    result.reserve(m_fixtures.size());
+
+    for (int i = 0; i < m_fixtures.size(); ++i) {
+        const Fixture &fixture = m_fixtures.at(i);
+
+        FixtureSummary item;
+        item.index = i;
+        item.portName = fixture.portName;
+        item.state = fixture.runner->state();
+        item.currentStep = fixture.runner->currentStepIndex();
+        item.finished = fixture.finished;
+        item.allPassed = fixture.allPassed;
+        item.passedCount = fixture.passedCount;
+        item.totalCount = fixture.finished ? fixture.totalCount : fixture.runner->steps().size();
+        item.errorCount = fixture.runner->getErrorRecords().size();
+        result.append(item);
+    }
+
+    return result;
+}
+
+bool StationScheduler::isRunning() const
+{
+    for (const Fixture &fixture : m_fixtures) {
+        if (fixture.runner->isRunning() || fixture.runner->state() == TestSequenceRunner::State::Paused) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StationScheduler::startAll()
+{
+    m_confirmations.clear();
+    m_confirmationPresented = false;
+    emit confirmationQueueChanged(0);
+
+    for (int i = 0; i < m_fixtures.size(); ++i) {
+        Fixture &fixture = m_fixtures[i];
+        fixture.finished = false;
+        fixture.allPassed = false;
+        fixture.passedCount = 0;
+        fixture.totalCount = 0;
+        fixture.runner->clearErrorRecords();
+        fixture.runner->start();
+    }
+}
+
+void StationScheduler::pauseAll()
+{
+    for (Fixture &fixture : m_fixtures) {
+        if (fixture.runner->isRunning() &&
+            fixture.runner->state() != TestSequenceRunner::State::WaitingForUser) {
+            fixture.runner->pause();
+        }
+    }
+}
+
+void StationScheduler::resumeAll()
+{
+    for (Fixture &fixture : m_fixtures) {
+        if (fixture.runner->state() == TestSequenceRunner::State::Paused) {
+            fixture.runner->resume();
+        }
+    }
+}
+
+void StationScheduler::stopAll()
+{
+    for (Fixture &fixture : m_fixtures) {
+        if (fixture.runner->isRunning() || fixture.runner->state() == TestSequenceRunner::State::Paused) {
+            fixture.runner->stop();
+        }
+    }
+}
+
+void StationScheduler::answerConfirmation(bool confirmed)
+{
+    if (m_confirmations.isEmpty()) {
+        return;
+    }
+
+    ConfirmationRequest request = m_confirmations.dequeue();
+    m_confirmationPresented = false;
+
+    emit fixtureLogMessage(request.fixtureIndex,
+                           tr("用户确认: %1").arg(confirmed ? tr("是") : tr("否")));
+
+    TestSequenceRunner *runner = fixtureRunner(request.fixtureIndex);
+    if (runner && runner->state() == TestSequenceRunner::State::WaitingForUser) {
+        runner->userConfirm(confirmed, request.token);
+    }
+
+    emit confirmationQueueChanged(m_confirmations.size());
+    presentNextConfirmation();
+}
+
+void StationScheduler::enqueueConfirmation(int index, const QString &message)
+{
+    ConfirmationRequest request;
+    request.fixtureIndex = index;
+    request.message = message;
+    request.token = m_fixtures.at(index).runner->confirmToken();
+    m_confirmations.enqueue(request);
+
+    emit confirmationQueueChanged(m_confirmations.size());
+    presentNextConfirmation();
+}
+
+void StationScheduler::dropConfirmations(int index)
+{
+    bool headRemoved = !m_confirmations.isEmpty() && m_confirmations.head().fixtureIndex == index;
+
+    QQueue<ConfirmationRequest> remaining;
+    for (const ConfirmationRequest &request : m_confirmations) {
+        if (request.fixtureIndex != index) {
+            remaining.enqueue(request);
+        }
+    }
+
+    if (remaining.size() == m_confirmations.size()) {
+        return;
+    }
+
+    m_confirmations.swap(remaining);
+    if (headRemoved) {
+        m_confirmationPresented = false;
+    }
+
+    emit confirmationQueueChanged(m_confirmations.size());
+    presentNextConfirmation();
+}
+
+void StationScheduler::presentNextConfirmation()
+{
+    if (m_confirmationPresented || m_confirmations.isEmpty()) {
+        return;
+    }
+
+    const ConfirmationRequest &request = m_confirmations.head();
+    m_confirmationPresented = true;
+    emit confirmationRequested(request.fixtureIndex,
+                               fixturePortName(request.fixtureIndex),
+                               request.message);
+}
+
+void StationScheduler::checkAllFinished()
+{
+    int passedFixtures = 0;
+    for (const Fixture &fixture : m_fixtures) {
+        if (!fixture.finished) {
+            return;
+        }
+        if (fixture.allPassed) {
+            ++passedFixtures;
+        }
+    }
+
+    emit allFinished(passedFixtures, m_fixtures.size());
+}
@@ -0,0 +1,260 @@
+#ifndef STATIONSCHEDULER_H
+#define STATIONSCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+#include <QQueue>
+#include <QPointer>
+#include <QStringList>
+#include "app/TestSequenceRunner.h"
+#include "domain/StepSpec.h"
+#include "domain/ErrorRecord.h"
+
+class SerialPortService;
+class DeviceController;
+class ErrorRecordStore;
+class YieldAggregator;
+
+/**
+ * @brief 多工位测试调度器
+ *
+ * 职责：
+ * - 为每个治具串口创建独立的设备栈（SerialPortService + DeviceController + TestSequenceRunner）
+ * - 在所有治具上同时执行同一套测试步骤，各治具状态和错误记录互相独立
+ * - 将各治具的用户确认请求合并到一个队列，按先后顺序逐个交给操作员处理
+ * - 汇总每个治具的测试结果
+ *
+ * 所有设备栈都运行在调用线程（GUI线程）的事件循环中，
+ * 串口读写由各自 SerialPortService 的I/O线程完成，不会互相阻塞。
+ */
+class StationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 单个治具的结果汇总
+     */
+    struct FixtureSummary {
+        int index;                          ///< 治具序号
+        QString portName;                   ///< 串口名称
+        TestSequenceRunner::State state;    ///< 当前执行状态
+        int currentStep;                    ///< 当前步骤索引（-1表示未开始）
+        bool finished;                      ///< 是否已执行完成
+        bool allPassed;                     ///< 是否全部通过
+        int passedCount;                    ///< 通过的步骤数
+        int totalCount;                     ///< 总步骤数
+        int errorCount;                     ///< 错误记录数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象
+     */
+    explicit StationScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数（停止所有治具并关闭串口）
+     */
+    ~StationScheduler() override;
+
+    /**
+     * @brief 为每个串口创建设备栈并连接
+     * @param portNames 治具串口列表
+     * @param baudRate 波特率，默认9600
+     * @param pipelining 是否启用命令流水线发送，默认不启用
+     * @return 成功连接的治具数量（连接失败的串口不会保留）
+     */
+    int setupFixtures(const QStringList &portNames, int baudRate = 9600, bool pipelining = false);
+
+    /**
+     * @brief 停止并释放所有治具设备栈
+     */
+    void clearFixtures();
+
+    /**
+     * @brief 为所有治具加载测试步骤
+     * @param steps 测试步骤列表
+     */
+    void loadSteps(const QVector<StepSpec> &steps);
+
+    /**
+     * @brief 设置错误记录库（各治具的错误记录写入同一记录库，治具名为串口名称）
+     * @param store 错误记录库，之后创建的治具生效
+     */
+    void setErrorRecordStore(ErrorRecordStore *store) { m_errorRecordStore = store; }
+
+    /**
+     * @brief 设置良率统计（各治具的结果汇总到同一统计）
+     * @param aggregator 良率统计，之后创建的治具生效
+     */
+    void setYieldAggregator(YieldAggregator *aggregator) { m_yieldAggregator = aggregator; }
+
+    /**
+     * @brief 治具数量
+     */
+    int fixtureCount() const { return m_fixtures.size(); }
+
+    /**
+     * @brief 获取治具串口名称
+     */
+    QString fixturePortName(int index) const;
+
+    /**
+     * @brief 获取治具的执行引擎（用于查看步骤或状态）
+     */
+    TestSequenceRunner *fixtureRunner(int index) const;
+
+    /**
+     * @brief 获取治具的设备控制器（用于查看命令延迟统计）
+     */
+    DeviceController *fixtureController(int index) const;
+
+    /**
+     * @brief 获取治具的错误记录
+     */
+    QVector<ErrorRecord> fixtureErrorRecords(int index) const;
+
+    /**
+     * @brief 获取所有治具的结果汇总
+     */
+    QVector<FixtureSummary> summary() const;
+
+    /**
+     * @brief 是否有治具正在运行
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 等待操作员处理的确认请求数（包括当前正在显示的请求）
+     */
+    int pendingConfirmationCount() const { return m_confirmations.size(); }
+
+public slots:
+    /**
+     * @brief 所有治具同时开始执行
+     */
+    void startAll();
+
+    /**
+     * @brief 暂停所有正在运行的治具
+     */
+    void pauseAll();
+
+    /**
+     * @brief 恢复所有已暂停的治具
+     */
+    void resumeAll();
+
+    /**
+     * @brief 停止所有治具
+     */
+    void stopAll();
+
+    /**
+     * @brief 操作员回答当前确认请求
+     * @param confirmed true表示确认通过，false表示标记失败
+     */
+    void answerConfirmation(bool confirmed);
+
+signals:
+    /**
+     * @brief 治具日志消息
+     * @param index 治具序号
+     * @param message 日志内容
+     */
+    void fixtureLogMessage(int index, const QString &message);
+
+    /**
+     * @brief 治具状态或进度发生变化（用于刷新汇总表）
+     * @param index 治具序号
+     */
+    void fixtureUpdated(int index);
+
+    /**
+     * @brief 治具测试序列执行完成
+     * @param index 治具序号
+     * @param allPassed 是否全部通过
+     * @param passedCount 通过的步骤数
+     * @param totalCount 总步骤数
+     */
+    void fixtureFinished(int index, bool allPassed, int passedCount, int totalCount);
+
+    /**
+     * @brief 所有治具均已执行完成
+     * @param passedFixtures 全部通过的治具数
+     * @param totalFixtures 治具总数
+     */
+    void allFinished(int passedFixtures, int totalFixtures);
+
+    /**
+     * @brief 需要操作员确认（队列头部的请求）
+     * @param index 治具序号
+     * @param portName 串口名称
+     * @param message 确认消息
+     */
+    void confirmationRequested(int index, const QString &portName, const QString &message);
+
+    /**
+     * @brief 确认队列长度变化
+     * @param pendingCount 等待处理的确认请求数
+     */
+    void confirmationQueueChanged(int pendingCount);
+
+private:
+    /**
+     * @brief 单个治具的设备栈
+     */
+    struct Fixture {
+        QString portName;                   ///< 串口名称
+        SerialPortService *service;         ///< 串口服务
+        DeviceController *controller;       ///< 设备控制器
+        TestSequenceRunner *runner;         ///< 测试序列执行引擎
+        bool finished;                      ///< 是否已执行完成
+        bool allPassed;                     ///< 是否全部通过
+        int passedCount;                    ///< 通过的步骤数
+        int totalCount;                     ///< 总步骤数
+    };
+
+    /**
+     * @brief 用户确认请求
+     */
+    struct ConfirmationRequest {
+        int fixtureIndex;                   ///< 治具序号
+        QString message;                    ///< 确认消息
+        quint64 token;                      ///< 执行引擎的确认请求编号
+    };
+
+    /**
+     * @brief 连接治具设备栈的信号
+     */
+    void connectFixture(int index);
+
+    /**
+     * @brief 将确认请求加入队列
+     */
+    void enqueueConfirmation(int index, const QString &message);
+
+    /**
+     * @brief 移除指定治具的全部确认请求（治具停止或完成时）
+     */
+    void dropConfirmations(int index);
+
+    /**
+     * @brief 队列头部请求发生变化时通知界面
+     */
+    void presentNextConfirmation();
+
+    /**
+     * @brief 检查是否全部治具完成
+     */
+    void checkAllFinished();
+
+    QVector<Fixture> m_fixtures;                    ///< 治具设备栈列表
+    QQueue<ConfirmationRequest> m_confirmations;    ///< 用户确认队列（头部为正在显示的请求）
+    bool m_confirmationPresented;                   ///< 队列头部请求是否已通知界面
+    QPointer<ErrorRecordStore> m_errorRecordStore;  ///< 错误记录库（可为空）
+    QPointer<YieldAggregator> m_yieldAggregator;    ///< 良率统计（可为空）
+};
+
+#endif // STATIONSCHEDULER_H
@@ -1,24 +1,14 @@
 #include "TestSequenceRunner.h"
 #include "DeviceController.h"
+#include "DeadlineScheduler.h"
+#include "domain/MonotonicClock.h"
 #include <QDebug>
 
 TestSequenceRunner::TestSequenceRunner(DeviceController *deviceController, QObject *parent)
-    : QObject(parent), m_deviceController(deviceController), m_state(State::Idle), m_currentStepIndex(-1), m_currentActionIndex(-1), m_delayTimer(new QTimer(this)), m_measurementTimer(new QTimer(this)), m_stepTimer(new QTimer(this)), m_ackTimer(new QTimer(this)), m_pendingCurrentThreshold(0.0), m_pendingIsUpperLimit(true), m_waitingForMeasurement(false), m_isDetectionActive(false), m_remainingStepTime(0), m_remainingDelayTime(0), m_remainingMeasurementTime(0), m_remainingAckTime(0), m_prePauseState(State::Idle)
+    : QObject(parent), m_deviceController(deviceController), m_planValid(false), m_runId(0), m_state(State::Idle), m_currentStepIndex(-1), m_currentActionIndex(-1), m_deadlines(new DeadlineScheduler(DeadlineCount, this)), m_pendingCurrentThreshold(0.0), m_pendingIsUpperLimit(true), m_pendingAdaptive(false), m_checkStartNs(0), m_sampleCutoffNs(0), m_minWaitEndNs(0), m_waitingForMeasurement(false), m_isDetectionActive(false), m_groupEnd(-1), m_groupDelayAction(-1), m_groupConfirmAction(-1), m_groupMeasurementAction(-1), m_prePauseState(State::Idle), m_confirmToken(0), m_confirmPending(false)
 {
-    // 定时器配置为单次触发
-    m_delayTimer->setSingleShot(true);
-    m_measurementTimer->setSingleShot(true);
-    m_stepTimer->setSingleShot(true);
-    m_ackTimer->setSingleShot(true);
-
-    // 连接定时器信号
-
-    // 当延时操作完成且当前状态为 Running 时，再调度执行下一个动作。
-    connect(m_delayTimer, &QTimer::timeout, this, &TestSequenceRunner::onDelayFinished);
-
-    connect(m_measurementTimer, &QTimer::timeout, this, &TestSequenceRunner::onMeasurementTimeout);
-    connect(m_stepTimer, &QTimer::timeout, this, &TestSequenceRunner::onStepTimeout);
-    connect(m_ackTimer, &QTimer::timeout, this, &TestSequenceRunner::onAckTimeout);
+    // 动作间隔、延时和各类超时共用一个截止时间队列
+    connect(m_deadlines, &DeadlineScheduler::expired, this, &TestSequenceRunner::onDeadlineExpired);
 
     // 连接DeviceController的信号
     if (m_deviceController)
@@ -28,52 +18,8 @@ TestSequenceRunner::TestSequenceRunner(DeviceController *deviceController, QObje
                 this, &TestSequenceRunner::onCommandConfirmed);
         
         // 连接外部电流表测量数据信号，用于 CheckCurrent 动作
-        connect(m_deviceController, &DeviceController::externalMeasurementReceived,
-                this, [this](float valueMa) {
-            // 外部电流表直接返回 mA 值，无需转换
-            if (!m_waitingForMeasurement || m_state != State::WaitingForMeasurement) {
-                return;
-            }
-
-            m_measurementTimer->stop();
-            m_waitingForMeasurement = false;
-
-            double value = valueMa;  // 直接使用 mA 值
-            QString unit = "mA";
-
-            bool passed = m_pendingIsUpperLimit ? (value <= m_pendingCurrentThreshold)
-                                                : (value >= m_pendingCurrentThreshold);
-
-            QString resultStr = passed ? tr("PASS") : tr("FAIL");
-            QString compareOp = m_pendingIsUpperLimit ? "<=" : ">=";
-
-            log(tr("电流测量: %1 %2, 阈值: %3 %4 %5 - %6")
-                    .arg(value, 0, 'f', 3)
-                    .arg(unit)
-                    .arg(compareOp)
-                    .arg(m_pendingCurrentThreshold, 0, 'f', 3)
-                    .arg(unit)
-                    .arg(resultStr));
-
-            emit currentCheckResult(m_currentStepIndex, value, m_pendingCurrentThreshold, passed);
-
-            ActionResult result = passed ? ActionResult::Success : ActionResult::Failed;
-            emit actionFinished(m_currentStepIndex, m_currentActionIndex, result,
-                                tr("测量值: %1 %2").arg(value, 0, 'f', 3).arg(unit));
-
-            if (passed) {
-                setState(State::Running);
-                QTimer::singleShot(kActionDelayMs, this, &TestSequenceRunner::executeNextAction);
-            } else {
-                QString compareOp2 = m_pendingIsUpperLimit ? ">" : "<";
-                QString detail = tr("测量值 %1 mA %2 阈值 %3 mA")
-                    .arg(value, 0, 'f', 3)
-                    .arg(compareOp2)
-                    .arg(m_pendingCurrentThreshold, 0, 'f', 3);
-                recordError(tr("电流检测"), tr("电流超限"), detail, value, m_pendingCurrentThreshold);
-                finishCurrentStep(false, tr("电流检测未通过"));
-            }
-        });
+        connect(m_deviceController, &DeviceController::externalMeasurementsReceived,
+                this, &TestSequenceRunner::onExternalMeasurementsReceived);
     }
 }
 
@@ -82,27 +28,54 @@ TestSequenceRunner::~TestSequenceRunner()
     stop();
 }
 
-void TestSequenceRunner::loadSteps(const QVector<StepSpec> &steps)
+bool TestSequenceRunner::loadSteps(const QVector<StepSpec> &steps)
+{
+    if (isRunning())
+    {
+        log(tr("无法在运行时加载步骤"));
+        return false;
+    }
+
+    CompiledPlan plan;
+    QStringList errors;
+    bool compiled = PlanCompiler::compile(steps, plan, &errors);
+    for (const QString &error : errors)
+    {
+        log(tr("测试计划校验失败: %1").arg(error));
+    }
+    loadPlan(plan);
+    m_planValid = compiled;
+    return compiled;
+}
+
+void TestSequenceRunner::loadPlan(const CompiledPlan &plan)
 {
     if (isRunning())
     {
         log(tr("无法在运行时加载步骤"));
         return;
     }
-    m_steps = steps;
+    m_plan = plan;
+    m_planValid = true;
     m_stepResults.clear();
-    m_stepResults.resize(steps.size());
-    log(tr("已加载 %1 个测试步骤").arg(steps.size()));
+    m_stepResults.resize(plan.stepCount());
+    log(tr("已加载 %1 个测试步骤").arg(plan.stepCount()));
 }
 
 void TestSequenceRunner::start()
 {
-    if (m_steps.isEmpty())
+    if (m_plan.isEmpty())
     {
         log(tr("没有可执行的测试步骤"));
         return;
     }
 
+    if (!m_planValid)
+    {
+        log(tr("测试计划未通过校验，无法执行"));
+        return;
+    }
+
     if (isRunning())
     {
         log(tr("测试已在运行中"));
@@ -114,24 +87,27 @@ void TestSequenceRunner::start()
     m_currentActionIndex = -1;
     m_stepResults.fill(false);
     m_errorRecords.clear();       // 清空错误记录
+    m_runId = qMax(QDateTime::currentMSecsSinceEpoch(), m_runId + 1);  // 运行编号单调递增
     m_isDetectionActive = false;  // 重置检测激活标志
+    m_confirmPending = false;
+    clearGroup();
 
     setState(State::Running);
 
     // 启动第一个步骤
-    if (m_currentStepIndex < m_steps.size())
+    if (m_currentStepIndex < m_plan.stepCount())
     {
-        const StepSpec &step = m_steps[m_currentStepIndex];
+        const StepSpec &step = m_plan.steps[m_currentStepIndex];
 
         // 触发TaskListWidget::onStepStarted，在文本上显示执行中
         emit stepStarted(m_currentStepIndex, step);
         log(tr("步骤 %1: %2").arg(step.id).arg(step.name));
 
-        // 启动步骤超时定时器
-        m_stepTimer->start(step.stepTimeoutMs > 0 ? step.stepTimeoutMs : kDefaultStepTimeoutMs);
+        // 启动步骤超时
+        m_deadlines->start(StepDeadline, m_plan.stepTable[m_currentStepIndex].stepTimeoutMs);
 
         // 开始执行第一个子动作
-        QTimer::singleShot(0, this, &TestSequenceRunner::executeNextAction);
+        m_deadlines->start(NextActionDeadline, 0);
     }
 }
 
@@ -148,46 +124,8 @@ void TestSequenceRunner::pause()
     // 1. 保存当前状态（用于恢复）
     m_prePauseState = m_state;
 
-    // 2. 保存各定时器剩余时间并停止定时器
-    if (m_stepTimer->isActive())
-    {
-        m_remainingStepTime = m_stepTimer->remainingTime();
-        m_stepTimer->stop();
-    }
-    else
-    {
-        m_remainingStepTime = 0;
-    }
-
-    if (m_delayTimer->isActive())
-    {
-        m_remainingDelayTime = m_delayTimer->remainingTime();
-        m_delayTimer->stop();
-    }
-    else
-    {
-        m_remainingDelayTime = 0;
-    }
-
-    if (m_measurementTimer->isActive())
-    {
-        m_remainingMeasurementTime = m_measurementTimer->remainingTime();
-        m_measurementTimer->stop();
-    }
-    else
-    {
-        m_remainingMeasurementTime = 0;
-    }
-
-    if (m_ackTimer->isActive())
-    {
-        m_remainingAckTime = m_ackTimer->remainingTime();
-        m_ackTimer->stop();
-    }
-    else
-    {
-        m_remainingAckTime = 0;
-    }
+    // 2. 冻结全部截止时间（包括动作间隔），恢复时按剩余时间继续
+    m_deadlines->freeze();
 
     // 3. 根据检测激活状态决定是否发送停止检测指令
     //    只要检测处于激活状态（无论当前是 WaitingForMeasurement 还是 WaitingForAck），都必须发送停止指令
@@ -205,7 +143,7 @@ void TestSequenceRunner::pause()
             {
                 // 进入等待暂停ACK状态
                 setState(State::WaitingForPauseAck);
-                m_ackTimer->start(kDefaultAckTimeoutMs);
+                m_deadlines->start(PauseAckDeadline, kDefaultAckTimeoutMs);
             }
             else
             {
@@ -247,8 +185,13 @@ void TestSequenceRunner::resume()
         log(tr("恢复前重新开启外部电流表检测"));
         m_deviceController->startExternalMeterDetection();
         // 如果暂停前是在等待测量数据，恢复标志位
-        if (m_prePauseState == State::WaitingForMeasurement) {
+        if (m_prePauseState == State::WaitingForMeasurement || m_groupMeasurementAction >= 0) {
             m_waitingForMeasurement = true;
+            m_sampleCutoffNs = qMax(MonotonicClock::nowNs(), m_minWaitEndNs);
+            // 重新开启检测后读数会再次经历过渡过程，暂停前的窗口不再有效
+            if (m_pendingAdaptive) {
+                m_settleDetector.reset();
+            }
         }
     }
 
@@ -256,43 +199,17 @@ void TestSequenceRunner::resume()
     setState(m_prePauseState);
     log(tr("测试已恢复"));
 
-    bool specificTimerResumed = false;
-
-    // 3. 恢复步骤超时定时器
-    if (m_remainingStepTime > 0)
-    {
-        m_stepTimer->start(m_remainingStepTime);
-        m_remainingStepTime = 0;
-    }
-
-    // 4. 恢复延时定时器
-    if (m_remainingDelayTime > 0)
-    {
-        m_delayTimer->start(m_remainingDelayTime);
-        m_remainingDelayTime = 0;
-        specificTimerResumed = true;
-    }
-
-    // 5. 恢复测量超时定时器
-    if (m_remainingMeasurementTime > 0)
-    {
-        m_measurementTimer->start(m_remainingMeasurementTime);
-        m_remainingMeasurementTime = 0;
-        specificTimerResumed = true;
-    }
-
-    // 6. 恢复ACK超时定时器
-    if (m_remainingAckTime > 0)
-    {
-        m_ackTimer->start(m_remainingAckTime);
-        m_remainingAckTime = 0;
-        specificTimerResumed = true;
-    }
+    // 3. 按冻结时的剩余时间恢复全部截止时间（动作间隔、延时、测量/ACK/步骤超时）
+    const bool actionPending = m_deadlines->isFrozen(NextActionDeadline) ||
+                               m_deadlines->isFrozen(DelayDeadline) ||
+                               m_deadlines->isFrozen(MeasurementDeadline) ||
+                               m_deadlines->isFrozen(AckDeadline);
+    m_deadlines->thaw();
 
-    // 如果没有恢复特定的子动作定时器（说明暂停发生在动作间隙），且之前是运行状态，则继续执行
-    if (!specificTimerResumed && m_prePauseState == State::Running)
+    // 没有待继续的子动作截止时间且之前是运行状态，则立即继续执行
+    if (!actionPending && m_prePauseState == State::Running)
     {
-        QTimer::singleShot(0, this, &TestSequenceRunner::executeNextAction);
+        m_deadlines->start(NextActionDeadline, 0);
     }
 }
 
@@ -305,11 +222,8 @@ void TestSequenceRunner::stop()
 
     log(tr("测试中止中..."));
 
-    // 停止所有定时器
-    m_delayTimer->stop();
-    m_measurementTimer->stop();
-    m_stepTimer->stop();
-    m_ackTimer->stop();
+    // 取消所有截止时间（包括冻结的）
+    m_deadlines->cancelAll();
 
     // 如果检测处于激活状态，发送停止检测指令到硬件
     if (m_isDetectionActive && m_deviceController)
@@ -320,32 +234,48 @@ void TestSequenceRunner::stop()
 
     m_waitingForMeasurement = false;
     m_isDetectionActive = false;  // 重置检测激活标志
+    cancelConfirmation();
+    clearGroup();
     setState(State::Aborted);
     log(tr("测试已中止"));
 }
 
-void TestSequenceRunner::userConfirm(bool confirmed)
+void TestSequenceRunner::userConfirm(bool confirmed, quint64 token)
 {
-    if (m_state != State::WaitingForUser)
+    // 过期应答（对应的请求已作废，如并行组内其他动作失败后步骤已结束）不能落到新的确认请求上
+    if (m_state != State::WaitingForUser || !m_confirmPending || (token != 0 && token != m_confirmToken))
     {
         return;
     }
+    m_confirmPending = false;
+
+    if (m_groupConfirmAction >= 0)
+    {
+        m_currentActionIndex = m_groupConfirmAction;
+    }
 
     if (confirmed)
     {
         log(tr("用户确认通过"));
+        if (m_groupConfirmAction >= 0)
+        {
+            m_groupConfirmAction = -1;
+            emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::Success, tr("用户确认通过"));
+            completeGroupAction();
+            return;
+        }
         setState(State::Running);
         // 继续执行下一个动作
-        QTimer::singleShot(kActionDelayMs, this, &TestSequenceRunner::executeNextAction);
+        scheduleNextAction();
     }
     else
     {
         log(tr("用户标记失败"));
         // 获取当前用户确认动作的描述
         QString confirmMsg;
-        if (m_currentStepIndex >= 0 && m_currentStepIndex < m_steps.size() &&
-            m_currentActionIndex >= 0 && m_currentActionIndex < m_steps[m_currentStepIndex].actions.size()) {
-            confirmMsg = m_steps[m_currentStepIndex].actions[m_currentActionIndex].confirmMessage;
+        if (m_currentStepIndex >= 0 && m_currentStepIndex < m_plan.stepCount() &&
+            m_currentActionIndex >= 0 && m_currentActionIndex < m_plan.stepTable[m_currentStepIndex].actionCount) {
+            confirmMsg = m_plan.action(m_currentStepIndex, m_currentActionIndex).confirmMessage;
         }
         recordError(tr("用户确认: %1").arg(confirmMsg), tr("用户取消"), tr("用户在确认弹窗中点击了否"));
         emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::UserRejected, tr("用户标记失败"));
@@ -355,10 +285,98 @@ void TestSequenceRunner::userConfirm(bool confirmed)
 
 void TestSequenceRunner::onMeasurementReceived(const Measurement &measurement)
 {
-    // 此方法已废弃，电流测量逻辑已移至 lambda 中直接处理
+    // 此方法已废弃，电流测量逻辑在 onExternalMeasurementsReceived 中处理
     Q_UNUSED(measurement)
 }
 
+void TestSequenceRunner::onExternalMeasurementsReceived(const QVector<Measurement> &measurements)
+{
+    // 外部电流表直接返回 mA 值，无需转换
+    // 并行组内同时等待用户确认时状态为 WaitingForUser，测量照常判定
+    const bool groupWaiting = m_groupMeasurementAction >= 0 && m_state == State::WaitingForUser;
+    if (!m_waitingForMeasurement || (m_state != State::WaitingForMeasurement && !groupWaiting)) {
+        return;
+    }
+    // 样本按读取边界处的到达时刻判断先后：同一批中检测开始前采集的读数（如继电器动作前）跳过
+    int first = 0;
+    while (first < measurements.size() && measurements.at(first).monotonicNs < m_sampleCutoffNs) {
+        ++first;
+    }
+    if (first == measurements.size()) {
+        return;
+    }
+
+    if (!m_pendingAdaptive) {
+        // 取本批第一个有效样本作为判定值（与逐个接收时的行为一致）
+        const Measurement &measurement = measurements.at(first);
+        double value = measurement.rawValue;
+        bool passed = m_pendingIsUpperLimit ? (value <= m_pendingCurrentThreshold)
+                                            : (value >= m_pendingCurrentThreshold);
+        completeCurrentCheck(value, passed, tr("样本时刻 +%1ms").arg(elapsedMs(measurement.monotonicNs), 0, 'f', 1));
+        return;
+    }
+
+    // 自适应模式：逐个样本送入判定器，一旦稳定且置信即判定，本批剩余样本不再处理
+    for (int i = first; i < measurements.size(); ++i) {
+        const Measurement &measurement = measurements.at(i);
+        SettleDetector::Decision decision = m_settleDetector.addSample(measurement.rawValue);
+        if (decision != SettleDetector::Decision::Pending) {
+            completeCurrentCheck(m_settleDetector.mean(), decision == SettleDetector::Decision::Pass,
+                                 tr("%1ms 内稳定，%2 个样本，σ=%3")
+                                     .arg(elapsedMs(measurement.monotonicNs), 0, 'f', 1)
+                                     .arg(m_settleDetector.totalSamples())
+                                     .arg(m_settleDetector.residualStdDev(), 0, 'g', 3));
+            return;
+        }
+    }
+}
+
+void TestSequenceRunner::completeCurrentCheck(double value, bool passed, const QString &note)
+{
+    m_deadlines->cancel(MeasurementDeadline);
+    m_waitingForMeasurement = false;
+    const bool inGroup = m_groupMeasurementAction >= 0;
+    if (inGroup) {
+        m_currentActionIndex = m_groupMeasurementAction;
+        m_groupMeasurementAction = -1;
+    }
+
+    QString unit = "mA";
+    QString resultStr = passed ? tr("PASS") : tr("FAIL");
+    QString compareOp = m_pendingIsUpperLimit ? "<=" : ">=";
+    QString noteStr = note.isEmpty() ? QString() : tr("（%1）").arg(note);
+
+    log(tr("电流测量: %1 %2, 阈值: %3 %4 %5 - %6%7")
+            .arg(value, 0, 'f', 3)
+            .arg(unit)
+            .arg(compareOp)
+            .arg(m_pendingCurrentThreshold, 0, 'f', 3)
+            .arg(unit)
+            .arg(resultStr)
+            .arg(noteStr));
+
+    emit currentCheckResult(m_currentStepIndex, value, m_pendingCurrentThreshold, passed);
+
+    ActionResult result = passed ? ActionResult::Success : ActionResult::Failed;
+    emit actionFinished(m_currentStepIndex, m_currentActionIndex, result,
+                        tr("测量值: %1 %2").arg(value, 0, 'f', 3).arg(unit));
+
+    if (passed && inGroup) {
+        completeGroupAction();
+    } else if (passed) {
+        setState(State::Running);
+        scheduleNextAction();
+    } else {
+        QString compareOp2 = m_pendingIsUpperLimit ? ">" : "<";
+        QString detail = tr("测量值 %1 mA %2 阈值 %3 mA")
+            .arg(value, 0, 'f', 3)
+            .arg(compareOp2)
+            .arg(m_pendingCurrentThreshold, 0, 'f', 3);
+        recordError(tr("电流检测"), tr("电流超限"), detail, value, m_pendingCurrentThreshold);
+        finishCurrentStep(false, tr("电流检测未通过"));
+    }
+}
+
 void TestSequenceRunner::executeNextAction()
 {
     if (m_state != State::Running)
@@ -370,40 +388,92 @@ void TestSequenceRunner::executeNextAction()
     m_currentActionIndex++;
 
     // 检查是否还有子动作
-    if (m_currentStepIndex >= m_steps.size())
+    if (m_currentStepIndex >= m_plan.stepCount())
     {
         finishSequence();
         return;
     }
 
-    const StepSpec &currentStep = m_steps[m_currentStepIndex];
-
-    if (m_currentActionIndex >= currentStep.actions.size())
+    if (m_currentActionIndex >= m_plan.stepTable[m_currentStepIndex].actionCount)
     {
         // 当前步骤的所有子动作已完成
         finishCurrentStep(true, tr("步骤完成"));
         return;
     }
 
-    // 执行当前子动作
-    const SubAction &action = currentStep.actions[m_currentActionIndex];
+    // 并行组：组内动作同时启动
+    if (m_plan.action(m_currentStepIndex, m_currentActionIndex).groupEnd > m_currentActionIndex)
+    {
+        startGroup();
+        return;
+    }
 
-    // 触发TaskListWidget::onActionStarted槽函数
-    emit actionStarted(m_currentStepIndex, m_currentActionIndex, action);
+    // 触发TaskListWidget::onActionStarted槽函数（界面仍使用原始子动作规格）
+    emit actionStarted(m_currentStepIndex, m_currentActionIndex,
+                       m_plan.steps[m_currentStepIndex].actions[m_currentActionIndex]);
 
-    bool immediateComplete = executeAction(action);
+    // 执行当前子动作（按编译后的动作表）
+    bool immediateComplete = executeAction(m_plan.action(m_currentStepIndex, m_currentActionIndex));
 
     if (immediateComplete)
     {
         // 动作立即完成，继续下一个
         emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::Success, QString());
-        QTimer::singleShot(kActionDelayMs, this, &TestSequenceRunner::executeNextAction);
+        scheduleNextAction();
     }
     // 否则等待异步回调（延时、用户确认、测量数据等）
 }
 
+void TestSequenceRunner::onDeadlineExpired(int deadline)
+{
+    switch (deadline)
+    {
+    case NextActionDeadline:
+        executeNextAction();
+        break;
+    case DelayDeadline:
+        onDelayFinished();
+        break;
+    case MeasurementDeadline:
+        onMeasurementTimeout();
+        break;
+    case StepDeadline:
+        onStepTimeout();
+        break;
+    case AckDeadline:
+    case PauseAckDeadline:
+        onAckTimeout();
+        break;
+    }
+}
+
+void TestSequenceRunner::scheduleNextAction()
+{
+    m_deadlines->start(NextActionDeadline, currentActionGapMs());
+}
+
+int TestSequenceRunner::currentActionGapMs() const
+{
+    if (m_currentStepIndex < 0 || m_currentStepIndex >= m_plan.stepCount() ||
+        m_currentActionIndex < 0 || m_currentActionIndex >= m_plan.stepTable[m_currentStepIndex].actionCount)
+    {
+        return PlanCompiler::kDefaultActionGapMs;
+    }
+    return m_plan.action(m_currentStepIndex, m_currentActionIndex).gapMs;
+}
+
 void TestSequenceRunner::onDelayFinished()
 {
+    if (m_groupDelayAction >= 0)
+    {
+        m_currentActionIndex = m_groupDelayAction;
+        m_groupDelayAction = -1;
+        log(tr("延时完成"));
+        emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::Success, tr("延时完成"));
+        completeGroupAction();
+        return;
+    }
+
     if (m_state != State::Running)
     {
         return;
@@ -412,8 +482,8 @@ void TestSequenceRunner::onDelayFinished()
     log(tr("延时完成"));
     emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::Success, tr("延时完成"));
 
-    // singleShot静态函数会在指定的时间间隔后调用一个槽函数，0表示当队列中的事件处理完后立即调用后续函数
-    QTimer::singleShot(0, this, &TestSequenceRunner::executeNextAction);
+    // 延时动作默认间隔为0：返回事件循环后立即执行下一个动作
+    scheduleNextAction();
 }
 
 void TestSequenceRunner::onMeasurementTimeout()
@@ -423,6 +493,21 @@ void TestSequenceRunner::onMeasurementTimeout()
         return;
     }
 
+    if (m_groupMeasurementAction >= 0)
+    {
+        m_currentActionIndex = m_groupMeasurementAction;
+    }
+
+    // 自适应模式到达最长等待时间：读数未稳定，按窗口均值兜底判定
+    SettleDetector::Decision fallback = m_settleDetector.fallbackDecision();
+    if (m_pendingAdaptive && fallback != SettleDetector::Decision::Pending) {
+        completeCurrentCheck(m_settleDetector.mean(), fallback == SettleDetector::Decision::Pass,
+                             tr("达到最长等待时间 %1ms 仍未稳定，按最近 %2 个样本均值判定")
+                                 .arg(elapsedMs(MonotonicClock::nowNs()), 0, 'f', 0)
+                                 .arg(m_settleDetector.windowCount()));
+        return;
+    }
+
     m_waitingForMeasurement = false;
     log(tr("测量超时"));
     recordError(tr("电流检测"), tr("测量超时"), tr("等待电流测量数据超时"));
@@ -453,8 +538,13 @@ void TestSequenceRunner::onAckTimeout()
         return;
     }
 
+    // 并行组：任一命令未确认即按第一条未确认的命令记为超时
+    if (!m_groupAckActions.isEmpty())
+    {
+        m_currentActionIndex = m_groupAckActions.first();
+    }
     // 处理普通指令ACK超时
-    if (m_state != State::WaitingForAck)
+    else if (m_state != State::WaitingForAck)
     {
         return;
     }
@@ -473,7 +563,7 @@ void TestSequenceRunner::onCommandConfirmed(Command command, bool success, const
     // 处理停止检测指令的ACK确认（用户点击暂停按钮触发）
     if (m_state == State::WaitingForPauseAck)
     {
-        m_ackTimer->stop();
+        m_deadlines->cancel(PauseAckDeadline);
         if (success && command == Command::StopExternalMeter)
         {
             log(tr("停止检测指令已确认，进入暂停状态"));
@@ -490,20 +580,55 @@ void TestSequenceRunner::onCommandConfirmed(Command command, bool success, const
         return;
     }
 
+    // 并行组：按发送帧找到对应的组内命令（暂停期间与顺序执行一样不处理）
+    if (!m_groupAckActions.isEmpty())
+    {
+        if (!isRunning())
+        {
+            return;
+        }
+        int position = 0;
+        while (position < m_groupAckActions.size() &&
+               m_plan.action(m_currentStepIndex, m_groupAckActions.at(position)).frame != sentData)
+        {
+            ++position;
+        }
+        if (position == m_groupAckActions.size())
+        {
+            return; // 不是本组发出的命令
+        }
+        m_currentActionIndex = m_groupAckActions.takeAt(position);
+        if (m_groupAckActions.isEmpty())
+        {
+            m_deadlines->cancel(AckDeadline);
+        }
+        else
+        {
+            restartGroupAckDeadline();
+        }
+        if (success)
+        {
+            log(tr("指令确认成功"));
+            emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::Success, tr("指令已确认"));
+            completeGroupAction();
+            return;
+        }
+        // 失败处理与顺序执行相同
+    }
     // 只在等待ACK状态下处理
-    if (m_state != State::WaitingForAck)
+    else if (m_state != State::WaitingForAck)
     {
         return;
     }
 
-    m_ackTimer->stop();
+    m_deadlines->cancel(AckDeadline);
 
     if (success)
     {
         log(tr("指令确认成功"));
         emit actionFinished(m_currentStepIndex, m_currentActionIndex, ActionResult::Success, tr("指令已确认"));
         setState(State::Running);
-        QTimer::singleShot(kActionDelayMs, this, &TestSequenceRunner::executeNextAction);
+        scheduleNextAction();
     }
     else
     {
@@ -529,264 +654,247 @@ void TestSequenceRunner::setState(State newState)
     }
 }
 
-bool TestSequenceRunner::executeAction(const SubAction &action)
+bool TestSequenceRunner::executeAction(const CompiledAction &action)
 {
-    switch (action.type)
+    switch (action.kind)
     {
-    case SubAction::SetV1Voltage:
-        return executeSetV1Voltage(action);
-    case SubAction::SetV4Voltage:
-        return executeSetV4Voltage(action);
-    case SubAction::OpenV1Channel:
-        return executeOpenV1Channel(action);
-    case SubAction::OpenV4Channel:
-        return executeOpenV4Channel();
-    case SubAction::StartDetection:
-        return executeStartDetection();
-    case SubAction::PauseDetection:
-        return executePauseDetection();
-    case SubAction::CheckCurrent:
+    case CompiledAction::DeviceCommand:
+        return executeDeviceCommand(action);
+    case CompiledAction::Delay:
+        log(action.logText);
+        m_deadlines->start(DelayDeadline, action.timeoutMs);
+        return false; // 需要等待定时器回调
+    case CompiledAction::UserConfirm:
+        log(action.logText);
+        setState(State::WaitingForUser);
+        requestConfirmation(action.confirmMessage);
+        return false; // 需要等待用户响应
+    case CompiledAction::CheckCurrent:
         return executeCheckCurrent(action);
-    case SubAction::PressKey:
-        return executePressKey(action);
-    case SubAction::Delay:
-        return executeDelay(action);
-    case SubAction::UserConfirm:
-        return executeUserConfirm(action);
-    case SubAction::OpenChannel:
-        return executeOpenChannel(action);
-    default:
-        log(tr("未知的子动作类型: %1").arg(static_cast<int>(action.type)));
-        return true;
     }
+    return true;
 }
 
-bool TestSequenceRunner::executeSetV1Voltage(const SubAction &action)
+bool TestSequenceRunner::executeDeviceCommand(const CompiledAction &action)
 {
-    log(tr("设置V1电压: %1V (通道0x%2)")
-            .arg(action.v1Value, 0, 'f', 2)
-            .arg(action.v1Channel, 2, 16, QChar('0')));
-
-    // 发送V1电压控制命令：0x02 + 通道ID + 电压BCD
-    bool success = m_deviceController->setV123VoltageControl(action.v1Channel, action.v1Value);
+    log(action.logText);
 
+    // 帧、期望回应和合并键已在编译时生成，这里只负责提交
+    bool success = m_deviceController->submitPrecompiledCommand(
+        action.command, action.frame, action.expectedResponse, action.coalesceKey);
     if (!success)
     {
-        log(tr("设置V1电压失败"));
-        return true; // 发送失败，立即完成（会被标记为失败）
+        log(action.failureText);
+        return true; // 发送失败，立即完成
     }
 
+    applyDetectionEffect(action);
+
     // 进入等待ACK状态
     setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
+    m_deadlines->start(AckDeadline, action.timeoutMs);
     return false; // 需要等待ACK
 }
 
-bool TestSequenceRunner::executeSetV4Voltage(const SubAction &action)
+bool TestSequenceRunner::executeCheckCurrent(const CompiledAction &action)
 {
-    log(tr("设置V4电压: %1V")
-            .arg(action.v2Value, 0, 'f', 2));
-
-    // 发送V4电压控制命令：0x02 + 0x04 + 电压码
-    bool success = m_deviceController->setV4VoltageControl(action.v2Value);
+    beginCurrentCheck(action);
+    setState(State::WaitingForMeasurement);
+    return false; // 需要等待测量数据
+}
 
-    if (!success)
+void TestSequenceRunner::applyDetectionEffect(const CompiledAction &action)
+{
+    if (action.detection == CompiledAction::DetectionStarts)
     {
-        log(tr("设置V4电压失败"));
-        return true;
+        // 预先标记检测已激活（ACK失败时在 onCommandConfirmed 中回滚）
+        m_isDetectionActive = true;
+        log(tr("检测状态已标记为：激活"));
+    }
+    else if (action.detection == CompiledAction::DetectionStops)
+    {
+        m_isDetectionActive = false;
+        log(tr("检测状态已标记为：停止"));
     }
-
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
 }
 
-bool TestSequenceRunner::executeOpenV1Channel(const SubAction &action)
+void TestSequenceRunner::beginCurrentCheck(const CompiledAction &action)
 {
-    log(tr("打开V1通道: 0x%1")
-            .arg(action.v1Channel, 2, 16, QChar('0')));
+    log(action.logText);
 
-    // 发送V1通道开启命令：0x12 + 通道ID
-    bool success = m_deviceController->openV123Channel(action.v1Channel);
+    m_pendingCurrentThreshold = action.threshold;
+    m_pendingIsUpperLimit = action.isUpperLimit;
+    m_pendingAdaptive = action.adaptive;
+    m_waitingForMeasurement = true;
+    m_checkStartNs = MonotonicClock::nowNs();
+    // 最短等待（业务延时）内的读数不参与判定，避免负载接通前稳定的低读数提前判定通过
+    m_minWaitEndNs = m_checkStartNs + static_cast<qint64>(action.minWaitMs) * 1000000;
+    m_sampleCutoffNs = m_minWaitEndNs;
 
-    if (!success)
-    {
-        log(tr("打开V1通道失败"));
-        return true;
+    if (m_pendingAdaptive) {
+        SettleDetector::Config config;
+        config.windowSize = action.settleWindowSamples;
+        m_settleDetector.start(action.threshold, action.isUpperLimit, config);
     }
 
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
+    m_deadlines->start(MeasurementDeadline, action.timeoutMs);
 }
 
-bool TestSequenceRunner::executeOpenV4Channel()
+void TestSequenceRunner::startGroup()
 {
-    log(tr("打开V4通道: 0x04"));
+    const int first = m_currentActionIndex;
+    m_groupEnd = m_plan.action(m_currentStepIndex, first).groupEnd;
+    log(tr("并行执行第 %1~%2 个子动作").arg(first + 1).arg(m_groupEnd + 1));
 
-    // 发送V4通道开启命令：0x12 + 0x04
-    bool success = m_deviceController->openV4Channel();
-
-    if (!success)
+    QString confirmMessage;
+    for (int i = first; i <= m_groupEnd; ++i)
     {
-        log(tr("打开V4通道失败"));
-        return true;
-    }
+        m_currentActionIndex = i;
+        const CompiledAction &action = m_plan.action(m_currentStepIndex, i);
+        emit actionStarted(m_currentStepIndex, i, m_plan.steps[m_currentStepIndex].actions[i]);
 
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
-}
+        switch (action.kind)
+        {
+        case CompiledAction::DeviceCommand:
+            log(action.logText);
+            // 组内命令背靠背提交，由 DeviceController 排队发送（启用流水线时回应可区分的命令并发发送）
+            if (!m_deviceController->submitPrecompiledCommand(
+                    action.command, action.frame, action.expectedResponse, action.coalesceKey))
+            {
+                log(action.failureText);
+                emit actionFinished(m_currentStepIndex, i, ActionResult::Success, QString()); // 与顺序执行一致
+                break;
+            }
+            applyDetectionEffect(action);
+            m_groupAckActions.append(i);
+            break;
+        case CompiledAction::Delay:
+            log(action.logText);
+            m_groupDelayAction = i;
+            m_deadlines->start(DelayDeadline, action.timeoutMs);
+            break;
+        case CompiledAction::UserConfirm:
+            log(action.logText);
+            m_groupConfirmAction = i;
+            confirmMessage = action.confirmMessage;
+            break;
+        case CompiledAction::CheckCurrent:
+            beginCurrentCheck(action);
+            m_groupMeasurementAction = i;
+            break;
+        }
+    }
 
-bool TestSequenceRunner::executeStartDetection()
-{
-    log(tr("开启外部电流表连续检测"));
-    
-    bool success = m_deviceController->startExternalMeterDetection();
-    if (!success)
+    if (!m_groupAckActions.isEmpty())
     {
-        log(tr("开启外部电流表检测失败"));
-        return true;  // 发送失败，立即完成
+        restartGroupAckDeadline();
     }
 
-    // 预先标记检测已激活
-    m_isDetectionActive = true;
-    log(tr("检测状态已标记为：激活"));
+    if (!groupHasPending())
+    {
+        completeGroupAction();
+        return;
+    }
 
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
+    updateGroupState();
+    if (m_groupConfirmAction >= 0)
+    {
+        requestConfirmation(confirmMessage);
+    }
 }
 
-bool TestSequenceRunner::executePauseDetection()
+void TestSequenceRunner::completeGroupAction()
 {
-    log(tr("停止外部电流表连续检测"));
-    bool success = m_deviceController->stopExternalMeterDetection();
-    if (!success)
+    if (groupHasPending())
     {
-        log(tr("停止外部电流表检测失败"));
-        return true;
+        updateGroupState();
+        return;
     }
 
-    // 标记检测已停止（预先设置）
-    m_isDetectionActive = false;
-    log(tr("检测状态已标记为：停止"));
-
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
+    // 组内全部完成：从组内最后一个动作之后继续
+    m_currentActionIndex = m_groupEnd;
+    clearGroup();
+    setState(State::Running);
+    scheduleNextAction();
 }
 
-bool TestSequenceRunner::executePressKey(const SubAction &action)
+void TestSequenceRunner::updateGroupState()
 {
-    QString keyName;
-    bool success = false;
-
-    switch (action.key)
+    if (m_groupConfirmAction >= 0)
     {
-    case SubAction::KeyPowerConfirm:
-        keyName = tr("开机/确认键");
-        success = m_deviceController->pressPowerConfirmKey();
-        break;
-    case SubAction::KeyRight:
-        keyName = tr("右键");
-        success = m_deviceController->pressRightKey();
-        break;
-    case SubAction::KeySw3:
-        keyName = tr("SW3");
-        success = m_deviceController->pressSw3Key();
-        break;
-    case SubAction::KeySw4:
-        keyName = tr("SW4");
-        success = m_deviceController->pressSw4Key();
-        break;
-    case SubAction::KeySw5:
-        keyName = tr("SW5");
-        success = m_deviceController->pressSw5Key();
-        break;
-    case SubAction::KeySw6:
-        keyName = tr("SW6");
-        success = m_deviceController->pressSw6Key();
-        break;
-    default:
-        keyName = tr("未知按键");
-        break;
+        setState(State::WaitingForUser);
     }
-
-    log(tr("模拟按键: %1").arg(keyName));
-    if (!success)
+    else if (m_groupMeasurementAction >= 0)
     {
-        log(tr("按键模拟失败"));
-        return true;
+        setState(State::WaitingForMeasurement);
+    }
+    else if (!m_groupAckActions.isEmpty())
+    {
+        setState(State::WaitingForAck);
+    }
+    else
+    {
+        setState(State::Running);
     }
-
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
 }
 
-bool TestSequenceRunner::executeDelay(const SubAction &action)
+bool TestSequenceRunner::groupHasPending() const
 {
-    log(tr("延时等待: %1 ms").arg(action.delayMs));
-    m_delayTimer->start(action.delayMs);
-    return false; // 需要等待定时器回调
+    return !m_groupAckActions.isEmpty() || m_groupDelayAction >= 0 ||
+           m_groupConfirmAction >= 0 || m_groupMeasurementAction >= 0;
 }
 
-bool TestSequenceRunner::executeUserConfirm(const SubAction &action)
+void TestSequenceRunner::requestConfirmation(const QString &message)
 {
-    log(tr("等待用户确认: %1").arg(action.confirmMessage));
-    setState(State::WaitingForUser);
-    emit userConfirmRequired(action.confirmMessage);
-    return false; // 需要等待用户响应
+    ++m_confirmToken;
+    m_confirmPending = true;
+    emit userConfirmRequired(message);
 }
 
-bool TestSequenceRunner::executeCheckCurrent(const SubAction &action)
+void TestSequenceRunner::cancelConfirmation()
 {
-    QString compareOp = action.isUpperLimit ? "<=" : ">=";
-    log(tr("开始电流检测, 阈值: %1 %2").arg(compareOp).arg(action.currentThreshold, 0, 'f', 3));
-
-    m_pendingCurrentThreshold = action.currentThreshold;
-    m_pendingIsUpperLimit = action.isUpperLimit;
-    m_waitingForMeasurement = true;
-
-    setState(State::WaitingForMeasurement);
-    m_measurementTimer->start(kDefaultMeasurementTimeoutMs);
-
-    return false; // 需要等待测量数据
+    if (!m_confirmPending)
+    {
+        return;
+    }
+    m_confirmPending = false;
+    log(tr("用户确认请求已作废"));
+    emit userConfirmCancelled(m_confirmToken);
 }
 
-bool TestSequenceRunner::executeOpenChannel(const SubAction &action)
+void TestSequenceRunner::restartGroupAckDeadline()
 {
-    log(tr("开启通道: V1通道=0x%1, V4通道=0x%2")
-            .arg(action.openV1Channel, 2, 16, QChar('0'))
-            .arg(action.openV4Channel, 2, 16, QChar('0')));
-
-    bool success = m_deviceController->openVoltageChannel(action.openV1Channel, action.openV4Channel);
-    if (!success)
+    // 组内命令可能逐条确认（未启用流水线或回应不可区分），截止时间从最近一次确认开始、
+    // 按剩余命令中最长的超时计时，每条命令都有与顺序执行相同的超时
+    int ackTimeoutMs = 0;
+    for (int index : m_groupAckActions)
     {
-        log(tr("开启通道失败"));
-        return true;
+        ackTimeoutMs = qMax(ackTimeoutMs, m_plan.action(m_currentStepIndex, index).timeoutMs);
     }
+    m_deadlines->start(AckDeadline, ackTimeoutMs);
+}
 
-    // 进入等待ACK状态
-    setState(State::WaitingForAck);
-    m_ackTimer->start(kDefaultAckTimeoutMs);
-    return false;
+void TestSequenceRunner::clearGroup()
+{
+    m_groupEnd = -1;
+    m_groupAckActions.clear();
+    m_groupDelayAction = -1;
+    m_groupConfirmAction = -1;
+    m_groupMeasurementAction = -1;
 }
 
 void TestSequenceRunner::advanceToNextStep()
 {
-    m_stepTimer->stop();
+    // 步骤正常走完时最后一个动作的间隔已经等过；提前结束（失败/超时）时按当前动作的间隔
+    const bool allActionsDone = m_currentStepIndex >= 0 && m_currentStepIndex < m_plan.stepCount() &&
+                                m_currentActionIndex >= m_plan.stepTable[m_currentStepIndex].actionCount;
+    const int gapMs = allActionsDone ? 0 : currentActionGapMs();
+
+    m_deadlines->cancel(StepDeadline);
     m_currentStepIndex++;
     m_currentActionIndex = -1;
 
-    if (m_currentStepIndex >= m_steps.size())
+    if (m_currentStepIndex >= m_plan.stepCount())
     {
         finishSequence();
         return;
@@ -795,20 +903,26 @@ void TestSequenceRunner::advanceToNextStep()
     // 恢复运行状态（确保从失败/等待状态切换后能继续执行）
     setState(State::Running);
 
-    const StepSpec &step = m_steps[m_currentStepIndex];
+    const StepSpec &step = m_plan.steps[m_currentStepIndex];
     emit stepStarted(m_currentStepIndex, step);
     log(tr("步骤 %1: %2").arg(step.id).arg(step.name));
 
-    // 启动新步骤的超时定时器
-    m_stepTimer->start(step.stepTimeoutMs > 0 ? step.stepTimeoutMs : kDefaultStepTimeoutMs);
+    // 启动新步骤的超时
+    m_deadlines->start(StepDeadline, m_plan.stepTable[m_currentStepIndex].stepTimeoutMs);
 
     // 开始执行第一个子动作
-    QTimer::singleShot(kActionDelayMs, this, &TestSequenceRunner::executeNextAction);
+    m_deadlines->start(NextActionDeadline, gapMs);
 }
 
 void TestSequenceRunner::finishCurrentStep(bool success, const QString &message)
 {
-    m_stepTimer->stop();
+    // 当前步骤的截止时间全部作废，避免过期的延时/超时落到下一个步骤
+    m_deadlines->cancel(StepDeadline);
+    m_deadlines->cancel(DelayDeadline);
+    m_deadlines->cancel(MeasurementDeadline);
+    m_deadlines->cancel(AckDeadline);
+    cancelConfirmation();
+    clearGroup();
 
     if (m_currentStepIndex >= 0 && m_currentStepIndex < m_stepResults.size())
     {
@@ -826,13 +940,10 @@ void TestSequenceRunner::finishCurrentStep(bool success, const QString &message)
 
 void TestSequenceRunner::finishSequence()
 {
-    m_delayTimer->stop();
-    m_measurementTimer->stop();
-    m_stepTimer->stop();
-    m_ackTimer->stop();
+    m_deadlines->cancelAll();
 
     int passedCount = m_stepResults.count(true);
-    int totalCount = m_steps.size();
+    int totalCount = m_plan.stepCount();
     bool allPassed = (passedCount == totalCount);
 
     log(tr("========== 测试序列完成 =========="));
@@ -853,8 +964,8 @@ void TestSequenceRunner::recordError(const QString &actionDesc, const QString &e
                                       double measuredValue, double thresholdValue)
 {
     QString stepName;
-    if (m_currentStepIndex >= 0 && m_currentStepIndex < m_steps.size()) {
-        stepName = m_steps[m_currentStepIndex].name;
+    if (m_currentStepIndex >= 0 && m_currentStepIndex < m_plan.stepCount()) {
+        stepName = m_plan.steps[m_currentStepIndex].name;
     } else {
         stepName = tr("未知步骤");
     }
@@ -862,7 +973,11 @@ void TestSequenceRunner::recordError(const QString &actionDesc, const QString &e
     ErrorRecord record(m_currentStepIndex, stepName, m_currentActionIndex,
                        actionDesc, errorType, errorDetail,
                        measuredValue, thresholdValue);
+    record.boardSerial = m_boardSerial;
+    record.fixture = m_fixtureName;
+    record.runId = m_runId;
     m_errorRecords.append(record);
+    emit errorRecorded(record);
 
     log(tr("[错误记录] 步骤%1 - %2: %3").arg(m_currentStepIndex + 1).arg(errorType).arg(errorDetail));
 }
@@ -3,21 +3,27 @@
 
 #include <QObject>
 #include <QVector>
-#include <QTimer>
 #include "domain/StepSpec.h"
 #include "domain/Measurement.h"
 #include "domain/Command.h"
 #include "domain/ErrorRecord.h"
+#include "domain/SettleDetector.h"
+#include "app/CompiledPlan.h"
+#include "app/PlanCompiler.h"
 
 class DeviceController;
+class DeadlineScheduler;
 
 /**
  * @brief 测试序列执行引擎
  * 
  * 职责：
- * - 按顺序执行测试步骤列表（StepSpec）
+ * - 按顺序执行测试步骤列表（StepSpec），执行前由 PlanCompiler 编译为扁平动作表
  * - 维护执行状态机（Idle/Running/Paused/WaitingForUser）
  * - 异步调度：发送指令后等待响应，通过信号槽驱动下一步
+ * - 动作间隔、延时、测量/步骤/ACK超时统一由 DeadlineScheduler 按单调时钟调度，暂停时精确冻结剩余时间
+ * - 并行组（SubAction::group）内的动作同时启动：命令背靠背提交（启用流水线时并发在途），
+ *   延时、用户确认、电流检测与命令重叠等待，全部完成后再执行下一个动作
  * - 自动判定电流测量结果（Pass/Fail）
  * - 通过信号向UI层报告执行进度和结果
  */
@@ -66,15 +72,27 @@ public:
     ~TestSequenceRunner() override;
 
     /**
-     * @brief 加载测试步骤序列
+     * @brief 加载测试步骤序列（编译并校验）
      * @param steps 测试步骤列表
+     * @return true 编译成功；失败时记录校验错误日志，计划不可执行
      */
-    void loadSteps(const QVector<StepSpec> &steps);
+    bool loadSteps(const QVector<StepSpec> &steps);
+
+    /**
+     * @brief 加载已编译的测试计划（多工位共享同一编译结果）
+     * @param plan 编译后的测试计划
+     */
+    void loadPlan(const CompiledPlan &plan);
 
     /**
      * @brief 获取当前加载的步骤列表
      */
-    const QVector<StepSpec>& steps() const { return m_steps; }
+    const QVector<StepSpec>& steps() const { return m_plan.steps; }
+
+    /**
+     * @brief 获取当前加载的编译计划
+     */
+    const CompiledPlan& plan() const { return m_plan; }
 
     /**
      * @brief 获取当前执行状态
@@ -102,6 +120,26 @@ public:
      */
     void clearErrorRecords() { m_errorRecords.clear(); }
 
+    /**
+     * @brief 设置治具名称（写入之后的错误记录，通常为串口名称）
+     */
+    void setFixtureName(const QString &fixture) { m_fixtureName = fixture; }
+
+    /**
+     * @brief 设置被测板序列号（写入之后的错误记录，为空表示未录入）
+     */
+    void setBoardSerial(const QString &serial) { m_boardSerial = serial; }
+
+    /**
+     * @brief 获取当前运行编号（每次 start() 时生成，未运行过时为0）
+     */
+    qint64 runId() const { return m_runId; }
+
+    /**
+     * @brief 最近一次用户确认请求的编号（userConfirmRequired 发射时已更新，应答时原样传回）
+     */
+    quint64 confirmToken() const { return m_confirmToken; }
+
     /**
      * @brief 检查是否正在运行
      */
@@ -135,8 +173,9 @@ public slots:
     /**
      * @brief 用户确认交互（继续执行）
      * @param confirmed true表示用户确认通过，false表示用户标记失败
+     * @param token 确认请求编号（confirmToken()），与当前请求不符的过期应答被忽略；0 表示应答当前请求
      */
-    void userConfirm(bool confirmed);
+    void userConfirm(bool confirmed, quint64 token = 0);
 
     /**
      * @brief 接收测量数据（由外部连接DeviceController的信号）
@@ -198,6 +237,12 @@ signals:
      */
     void userConfirmRequired(const QString &message);
 
+    /**
+     * @brief 用户确认请求已作废（所在步骤已结束或测试中止），应关闭对应的确认弹窗
+     * @param token 作废的确认请求编号
+     */
+    void userConfirmCancelled(quint64 token);
+
     /**
      * @brief 日志消息
      * @param message 日志内容
@@ -221,17 +266,35 @@ signals:
      */
     void currentCheckResult(int stepIndex, double value, double threshold, bool passed);
 
+    /**
+     * @brief 记录了一条错误（已带板号、治具和运行编号，可直接写入错误记录库）
+     * @param record 错误记录
+     */
+    void errorRecorded(const ErrorRecord &record);
+
 private slots:
     /**
      * @brief 执行下一个子动作
      */
     void executeNextAction();
 
+    /**
+     * @brief 截止时间到期分派
+     * @param deadline 到期的截止时间（Deadline）
+     */
+    void onDeadlineExpired(int deadline);
+
     /**
      * @brief 延时完成回调
      */
     void onDelayFinished();
 
+    /**
+     * @brief 外部电流表测量数据回调（CheckCurrent 判定）
+     * @param measurements 本次读取解码出的测量批次
+     */
+    void onExternalMeasurementsReceived(const QVector<Measurement> &measurements);
+
     /**
      * @brief 测量超时回调
      */
@@ -248,73 +311,100 @@ private slots:
     void onAckTimeout();
 
 private:
+    /**
+     * @brief 截止时间种类（DeadlineScheduler 的键）
+     */
+    enum Deadline {
+        NextActionDeadline,     ///< 动作间隔结束，执行下一个子动作
+        DelayDeadline,          ///< 延时动作结束
+        MeasurementDeadline,    ///< 测量超时
+        StepDeadline,           ///< 步骤超时
+        AckDeadline,            ///< 指令ACK超时
+        PauseAckDeadline,       ///< 暂停指令ACK超时（其他截止时间冻结期间运行）
+        DeadlineCount
+    };
+
     /**
      * @brief 设置执行状态
      */
     void setState(State newState);
 
     /**
-     * @brief 执行单个子动作
-     * @param action 子动作
+     * @brief 执行单个编译后的子动作
+     * @param action 动作表中的子动作
      * @return 是否立即完成（false表示需要等待异步响应）
-     * 👌
      */
-    bool executeAction(const SubAction &action);
+    bool executeAction(const CompiledAction &action);
 
     /**
-     * @brief 执行设置V1电压动作（0x02 + 通道 + 电压）
+     * @brief 发送预编码的设备命令并进入等待ACK状态
      */
-    bool executeSetV1Voltage(const SubAction &action);
+    bool executeDeviceCommand(const CompiledAction &action);
 
     /**
-     * @brief 执行设置V4电压动作（0x02 + 0x04 + 电压）
+     * @brief 执行电流检测动作
      */
-    bool executeSetV4Voltage(const SubAction &action);
+    bool executeCheckCurrent(const CompiledAction &action);
 
     /**
-     * @brief 执行打开V1通道动作（0x12 + 通道）
+     * @brief 按命令对检测状态的影响更新 m_isDetectionActive
      */
-    bool executeOpenV1Channel(const SubAction &action);
+    void applyDetectionEffect(const CompiledAction &action);
 
     /**
-     * @brief 执行打开V4通道动作（0x12 + 0x04）
+     * @brief 记录电流检测参数并启动测量超时（不改变执行状态）
      */
-    bool executeOpenV4Channel();
+    void beginCurrentCheck(const CompiledAction &action);
 
     /**
-     * @brief 执行开启检测动作
+     * @brief 某一时刻相对本次电流检测开始的毫秒数
      */
-    bool executeStartDetection();
+    double elapsedMs(qint64 monotonicNs) const { return (monotonicNs - m_checkStartNs) / 1.0e6; }
 
     /**
-     * @brief 执行暂停检测动作
+     * @brief 同时启动当前并行组内的全部子动作
      */
-    bool executePauseDetection();
+    void startGroup();
 
     /**
-     * @brief 执行按键模拟动作
+     * @brief 并行组内一个子动作完成（调用方已清除其等待标记并发射 actionFinished）
+     *
+     * 组内全部完成时按组内最后一个动作的间隔调度下一个动作，否则按剩余等待项更新状态。
      */
-    bool executePressKey(const SubAction &action);
+    void completeGroupAction();
 
     /**
-     * @brief 执行延时动作
+     * @brief 按并行组剩余的等待项设置状态（用户确认 > 测量 > ACK > 运行）
      */
-    bool executeDelay(const SubAction &action);
+    void updateGroupState();
 
     /**
-     * @brief 执行用户确认动作
+     * @brief 并行组是否还有未完成的子动作
      */
-    bool executeUserConfirm(const SubAction &action);
+    bool groupHasPending() const;
 
     /**
-     * @brief 执行电流检测动作
+     * @brief 清除并行组状态
      */
-    bool executeCheckCurrent(const SubAction &action);
+    void clearGroup();
 
     /**
-     * @brief 执行通道开启动作
+     * @brief 结束电流检测：记录结果并继续执行或结束当前步骤
+     * @param value 判定用的测量值（mA）
+     * @param passed 是否通过
+     * @param note 附加说明（自适应判定的稳定信息，可为空）
      */
-    bool executeOpenChannel(const SubAction &action);
+    void completeCurrentCheck(double value, bool passed, const QString &note);
+
+    /**
+     * @brief 当前子动作完成后，按其间隔调度下一个子动作
+     */
+    void scheduleNextAction();
+
+    /**
+     * @brief 当前子动作配置的间隔（没有当前子动作时为默认间隔）
+     */
+    int currentActionGapMs() const;
 
     /**
      * @brief 前进到下一个步骤
@@ -326,6 +416,21 @@ private:
      */
     void finishCurrentStep(bool success, const QString &message);
 
+    /**
+     * @brief 按组内尚未确认的命令重新启动 ACK 截止时间（从最近一次确认开始计时）
+     */
+    void restartGroupAckDeadline();
+
+    /**
+     * @brief 发出新的用户确认请求（更新请求编号）
+     */
+    void requestConfirmation(const QString &message);
+
+    /**
+     * @brief 作废尚未应答的用户确认请求并发射 userConfirmCancelled
+     */
+    void cancelConfirmation();
+
     /**
      * @brief 完成整个序列
      */
@@ -353,39 +458,49 @@ private:
     DeviceController *m_deviceController;
 
     // 测试数据
-    QVector<StepSpec> m_steps;              ///< 测试步骤列表
+    CompiledPlan m_plan;                    ///< 编译后的测试计划（含原始步骤列表）
+    bool m_planValid;                       ///< 计划是否通过编译校验
     QVector<bool> m_stepResults;            ///< 每个步骤的执行结果
-    QVector<ErrorRecord> m_errorRecords;    ///< 错误记录列表
+    QVector<ErrorRecord> m_errorRecords;    ///< 错误记录列表（仅本次运行）
+    QString m_fixtureName;                  ///< 治具名称
+    QString m_boardSerial;                  ///< 被测板序列号
+    qint64 m_runId;                         ///< 当前运行编号
 
     // 执行状态
     State m_state;                          ///< 当前状态
     int m_currentStepIndex;                 ///< 当前步骤索引
     int m_currentActionIndex;               ///< 当前子动作索引
 
-    // 定时器
-    QTimer *m_delayTimer;                   ///< 延时定时器
-    QTimer *m_measurementTimer;             ///< 测量超时定时器
-    QTimer *m_stepTimer;                    ///< 步骤超时定时器
-    QTimer *m_ackTimer;                     ///< ACK超时定时器（子动作超时定时器）
+    // 调度
+    DeadlineScheduler *m_deadlines;         ///< 全部截止时间（按 Deadline 索引）
 
     // 电流检测相关
     double m_pendingCurrentThreshold;       ///< 待检测的电流阈值
     bool m_pendingIsUpperLimit;             ///< 待检测的阈值类型
+    bool m_pendingAdaptive;                 ///< 待检测是否使用自适应稳定判定
+    SettleDetector m_settleDetector;        ///< 自适应稳定判定器
+    qint64 m_checkStartNs;                  ///< 本次电流检测开始的时刻（MonotonicClock，纳秒；日志显示用时）
+    qint64 m_sampleCutoffNs;                ///< 早于该时刻到达的样本不参与判定（检测开始/恢复前采集的旧读数）
+    qint64 m_minWaitEndNs;                  ///< 最短等待结束的时刻，此前到达的样本不参与判定
     bool m_waitingForMeasurement;           ///< 是否正在等待测量数据
     bool m_isDetectionActive;               ///< 下位机检测是否已激活（用于判断暂停时是否需要发送暂停指令）
 
-    // 暂停恢复相关
-    int m_remainingStepTime;                ///< 暂停时保存步骤超时剩余时间
-    int m_remainingDelayTime;               ///< 暂停时保存延时剩余时间
-    int m_remainingMeasurementTime;         ///< 暂停时保存测量超时剩余时间
-    int m_remainingAckTime;                 ///< 暂停时保存ACK超时剩余时间
+    // 并行组相关（m_groupEnd < 0 表示当前不在并行组中）
+    int m_groupEnd;                         ///< 当前并行组最后一个动作的下标
+    QVector<int> m_groupAckActions;         ///< 等待ACK的组内命令动作下标
+    int m_groupDelayAction;                 ///< 等待中的组内延时动作下标（-1 表示无）
+    int m_groupConfirmAction;               ///< 等待中的组内用户确认动作下标（-1 表示无）
+    int m_groupMeasurementAction;           ///< 等待中的组内电流检测动作下标（-1 表示无）
+
+    // 暂停恢复相关（剩余时间由 DeadlineScheduler 冻结保存）
     State m_prePauseState;                  ///< 暂停前的状态
 
+    // 用户确认相关
+    quint64 m_confirmToken;                 ///< 最近一次用户确认请求的编号
+    bool m_confirmPending;                  ///< 最近一次用户确认请求是否尚未应答
+
     // 配置常量
-    static constexpr int kDefaultMeasurementTimeoutMs = 5000;   ///< 默认测量超时
-    static constexpr int kDefaultStepTimeoutMs = 60000;         ///< 默认步骤超时
-    static constexpr int kDefaultAckTimeoutMs = 5000;           ///< 默认ACK超时
-    static constexpr int kActionDelayMs = 100;                  ///< 动作间延时（毫秒）
+    static constexpr int kDefaultAckTimeoutMs = PlanCompiler::kDefaultAckTimeoutMs;  ///< 默认ACK超时（暂停指令）
 };
 
 #endif // TESTSEQUENCERUNNER_H
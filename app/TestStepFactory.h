@@ -76,40 +76,35 @@ inline StepSpec TestStepFactory::createStep1_StaticCurrentAndPowerOn()
     // 5. 开启检测
     step.addAction(SubAction::createStartDetection());
 
-    // 6. 延时等待测量稳定
-    step.addAction(SubAction::createDelay(8000));
+    // 6. 检测关机电流 ≤ 5uA (0.005mA)，读数稳定即判定，最长等待8秒
+    step.addAction(SubAction::createAdaptiveCheckCurrent(0.005, true, 8000)); // <=0.005mA
 
-    // 7. 检测关机电流 ≤ 5uA (0.005mA)
-    step.addAction(SubAction::createCheckCurrent(0.005, true)); // <=0.005mA
-
-    // 8. 暂停检测（停止外部电流表）
+    // 7. 暂停检测（停止外部电流表）
     step.addAction(SubAction::createPauseDetection());
 
-    // 9. 短按【开机/确认键】开机
+    // 8. 短按【开机/确认键】开机
     step.addAction(SubAction::createPressKey(SubAction::KeyPowerConfirm));
 
-    // 10. 延时等待开机（业务延时，等待设备启动）
+    // 9. 延时等待开机（业务延时，等待设备启动）
     step.addAction(SubAction::createDelay(5000));
 
-    // 11. 短按【右键】进入语言选择界面
+    // 10. 短按【右键】进入语言选择界面
     step.addAction(SubAction::createPressKey(SubAction::KeyRight));
 
-    // 12. 延时等待界面切换（业务延时）
+    // 11. 延时等待界面切换（业务延时）
     step.addAction(SubAction::createDelay(1000));
 
-    // 13. 用户确认：是否显示4格电量
+    // 12. 用户确认：是否显示4格电量
     step.addAction(SubAction::createUserConfirm(QObject::tr("请确认电池是否显示4格电量？")));
 
-    // 14. 重新开启检测（使用外部电流表）
+    // 13. 重新开启检测（使用外部电流表）
     step.addAction(SubAction::createStartDetection());
 
-    // 15. 延时等待测量稳定（业务延时）
-    step.addAction(SubAction::createDelay(8000));
-
-    // 16. 检测工作电流 ≤ 160mA（蜂鸣器响时）
-    step.addAction(SubAction::createCheckCurrent(160.0, true)); // <=160mA
+    // 14. 检测工作电流 ≤ 160mA（蜂鸣器响时）：先等待8秒（业务延时，必须保留，等待负载接通），
+    //     之后读数稳定即判定，最长再等待5秒
+    step.addAction(SubAction::createAdaptiveCheckCurrent(160.0, true, 13000, 8000)); // <=160mA
 
-    // 17. 暂停检测（停止外部电流表）
+    // 15. 暂停检测（停止外部电流表）
     step.addAction(SubAction::createPauseDetection());
 
     step.stepTimeoutMs = 120000; // 2分钟超时
@@ -172,13 +167,11 @@ inline StepSpec TestStepFactory::createStep3_NormalVoltageTest()
     // 8. 开启检测
     step.addAction(SubAction::createStartDetection());
 
-    // 9. 延时等待测量稳定（业务延时，必须保留）
-    step.addAction(SubAction::createDelay(8000));
+    // 9. 检测工作电流 ≤ 120mA：先等待8秒（业务延时，必须保留，等待负载接通），
+    //    之后读数稳定即判定，最长再等待5秒
+    step.addAction(SubAction::createAdaptiveCheckCurrent(120.0, true, 13000, 8000)); // <=120mA
 
-    // 10. 检测工作电流 ≤ 120mA
-    step.addAction(SubAction::createCheckCurrent(120.0, true)); // <=120mA
-
-    // 11. 暂停检测
+    // 10. 暂停检测
     step.addAction(SubAction::createPauseDetection());
 
     step.stepTimeoutMs = 120000; // 2分钟超时
@@ -199,13 +192,10 @@ inline StepSpec TestStepFactory::createStep4_LowBatteryShutdown()
     // 3. 开启检测（使用外部电流表）
     step.addAction(SubAction::createStartDetection());
 
-    // 4. 延时等待测量稳定（业务延时，必须保留）
-    step.addAction(SubAction::createDelay(8000));
-
-    // 5. 检测关机电流 ≤ 5uA (0.005mA)
-    step.addAction(SubAction::createCheckCurrent(0.005, true)); // <=0.005mA
+    // 4. 检测关机电流 ≤ 5uA (0.005mA)，读数稳定即判定，最长等待8秒
+    step.addAction(SubAction::createAdaptiveCheckCurrent(0.005, true, 8000)); // <=0.005mA
 
-    // 6. 暂停检测（停止外部电流表）
+    // 5. 暂停检测（停止外部电流表）
     step.addAction(SubAction::createPauseDetection());
 
     step.stepTimeoutMs = 120000; // 2分钟超时
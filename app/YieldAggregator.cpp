@@ -0,0 +1,236 @@
+#include "YieldAggregator.h"
+#include "app/TestSequenceRunner.h"
+#include <QJsonArray>
+#include <algorithm>
+
+namespace {
+
+QString formatRate(double rate)
+{
+    return QString::number(rate * 100.0, 'f', 2);
+}
+
+QString formatMa(double value)
+{
+    return QString::number(value, 'f', 3);
+}
+
+QStringList passFields(const QString &kind, const YieldAggregator::PassStats &stats)
+{
+    QStringList fields;
+    fields << kind << QString::number(stats.stepIndex) << stats.name << QString()
+           << QString::number(stats.runs) << QString::number(stats.passes)
+           << formatRate(stats.passRate()) << formatRate(stats.windowPassRate());
+    for (int i = 0; i < 11; ++i) {
+        fields << QString();   // 电流分布列留空
+    }
+    return fields;
+}
+
+QJsonObject passToJson(const YieldAggregator::PassStats &stats)
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("step_index"), stats.stepIndex);
+    object.insert(QStringLiteral("name"), stats.name);
+    object.insert(QStringLiteral("runs"), static_cast<double>(stats.runs));
+    object.insert(QStringLiteral("passes"), static_cast<double>(stats.passes));
+    object.insert(QStringLiteral("pass_rate"), stats.passRate());
+    object.insert(QStringLiteral("window_pass_rate"), stats.windowPassRate());
+    object.insert(QStringLiteral("window_runs"), stats.window.size());
+    return object;
+}
+
+} // namespace
+
+YieldAggregator::YieldAggregator(QObject *parent)
+    : QObject(parent)
+{
+    m_overall.name = tr("整体");
+}
+
+void YieldAggregator::attachRunner(TestSequenceRunner *runner)
+{
+    if (!runner) {
+        return;
+    }
+
+    // 以本对象为接收者：任一方销毁时连接自动断开
+    connect(runner, &TestSequenceRunner::stepFinished,
+            this, [this, runner](int stepIndex, bool success, const QString &) {
+        recordStep(runner, stepIndex, success);
+    });
+    connect(runner, &TestSequenceRunner::currentCheckResult,
+            this, [this, runner](int stepIndex, double value, double threshold, bool passed) {
+        recordCurrent(runner, stepIndex, value, threshold, passed);
+    });
+    connect(runner, &TestSequenceRunner::sequenceFinished,
+            this, [this](bool allPassed, int, int) {
+        recordSequence(allPassed);
+    });
+}
+
+void YieldAggregator::reset()
+{
+    m_overall.runs = 0;
+    m_overall.passes = 0;
+    m_overall.window.clear();
+    m_steps.clear();
+    m_currents.clear();
+}
+
+QVector<const YieldAggregator::PassStats *> YieldAggregator::steps() const
+{
+    QVector<const PassStats *> result;
+    result.reserve(m_steps.size());
+    for (auto it = m_steps.constBegin(); it != m_steps.constEnd(); ++it) {
+        result.append(&it.value());
+    }
+    std::sort(result.begin(), result.end(), [](const PassStats *a, const PassStats *b) {
+        return a->stepIndex != b->stepIndex ? a->stepIndex < b->stepIndex : a->name < b->name;
+    });
+    return result;
+}
+
+QVector<const YieldAggregator::CurrentStats *> YieldAggregator::currentChecks() const
+{
+    QVector<const CurrentStats *> result;
+    result.reserve(m_currents.size());
+    for (auto it = m_currents.constBegin(); it != m_currents.constEnd(); ++it) {
+        result.append(&it.value());
+    }
+    std::sort(result.begin(), result.end(), [](const CurrentStats *a, const CurrentStats *b) {
+        if (a->stepIndex != b->stepIndex) {
+            return a->stepIndex < b->stepIndex;
+        }
+        if (a->actionIndex != b->actionIndex) {
+            return a->actionIndex < b->actionIndex;
+        }
+        return a->stepName < b->stepName;
+    });
+    return result;
+}
+
+QString YieldAggregator::csvHeader()
+{
+    return QStringLiteral("kind,step_index,step_name,action_index,runs,passes,pass_rate_pct,window_pass_rate_pct,"
+                          "threshold_ma,limit,min_ma,p01_ma,p10_ma,p50_ma,p90_ma,p99_ma,max_ma,mean_ma,window_mean_ma");
+}
+
+QStringList YieldAggregator::toCsvLines() const
+{
+    QStringList lines;
+    lines << passFields(QStringLiteral("run"), m_overall).join(QLatin1Char(','));
+    for (const PassStats *stats : steps()) {
+        lines << passFields(QStringLiteral("step"), *stats).join(QLatin1Char(','));
+    }
+
+    for (const CurrentStats *stats : currentChecks()) {
+        const TDigest &d = stats->digest;
+        const quint64 runs = d.count();
+        QStringList fields;
+        fields << QStringLiteral("current") << QString::number(stats->stepIndex) << stats->stepName
+               << QString::number(stats->actionIndex)
+               << QString::number(runs) << QString::number(runs - stats->failures)
+               << formatRate(runs > 0 ? static_cast<double>(runs - stats->failures) / runs : 0.0) << QString()
+               << formatMa(stats->threshold) << (stats->isUpperLimit ? QStringLiteral("upper") : QStringLiteral("lower"))
+               << formatMa(d.minValue()) << formatMa(d.quantile(0.01)) << formatMa(d.quantile(0.10))
+               << formatMa(d.quantile(0.50)) << formatMa(d.quantile(0.90)) << formatMa(d.quantile(0.99))
+               << formatMa(d.maxValue()) << formatMa(d.mean()) << formatMa(stats->window.mean());
+        lines << fields.join(QLatin1Char(','));
+    }
+    return lines;
+}
+
+QJsonObject YieldAggregator::toJson() const
+{
+    QJsonArray stepArray;
+    for (const PassStats *stats : steps()) {
+        stepArray.append(passToJson(*stats));
+    }
+
+    QJsonArray currentArray;
+    for (const CurrentStats *stats : currentChecks()) {
+        const TDigest &d = stats->digest;
+        QJsonObject object;
+        object.insert(QStringLiteral("step_index"), stats->stepIndex);
+        object.insert(QStringLiteral("action_index"), stats->actionIndex);
+        object.insert(QStringLiteral("step_name"), stats->stepName);
+        object.insert(QStringLiteral("threshold_ma"), stats->threshold);
+        object.insert(QStringLiteral("upper_limit"), stats->isUpperLimit);
+        object.insert(QStringLiteral("samples"), static_cast<double>(d.count()));
+        object.insert(QStringLiteral("failures"), static_cast<double>(stats->failures));
+        object.insert(QStringLiteral("min_ma"), d.minValue());
+        object.insert(QStringLiteral("p01_ma"), d.quantile(0.01));
+        object.insert(QStringLiteral("p10_ma"), d.quantile(0.10));
+        object.insert(QStringLiteral("p50_ma"), d.quantile(0.50));
+        object.insert(QStringLiteral("p90_ma"), d.quantile(0.90));
+        object.insert(QStringLiteral("p99_ma"), d.quantile(0.99));
+        object.insert(QStringLiteral("max_ma"), d.maxValue());
+        object.insert(QStringLiteral("mean_ma"), d.mean());
+        object.insert(QStringLiteral("window_mean_ma"), stats->window.mean());
+        object.insert(QStringLiteral("window_samples"), stats->window.size());
+        currentArray.append(object);
+    }
+
+    QJsonObject result;
+    result.insert(QStringLiteral("window_size"), kWindowSize);
+    result.insert(QStringLiteral("overall"), passToJson(m_overall));
+    result.insert(QStringLiteral("steps"), stepArray);
+    result.insert(QStringLiteral("current_checks"), currentArray);
+    return result;
+}
+
+void YieldAggregator::recordStep(TestSequenceRunner *runner, int stepIndex, bool success)
+{
+    if (stepIndex < 0 || stepIndex >= runner->steps().size()) {
+        return;
+    }
+
+    const QString &name = runner->steps().at(stepIndex).name;
+    PassStats &stats = m_steps[stepKey(stepIndex, name)];
+    stats.stepIndex = stepIndex;
+    stats.name = name;
+    ++stats.runs;
+    if (success) {
+        ++stats.passes;
+    }
+    stats.window.add(success ? 1.0 : 0.0);
+}
+
+void YieldAggregator::recordCurrent(TestSequenceRunner *runner, int stepIndex, double value,
+                                    double threshold, bool passed)
+{
+    const CompiledPlan &plan = runner->plan();
+    const int actionIndex = runner->currentActionIndex();
+    if (stepIndex < 0 || stepIndex >= plan.stepCount() ||
+        actionIndex < 0 || actionIndex >= plan.stepTable.at(stepIndex).actionCount) {
+        return;
+    }
+
+    const QString &name = plan.steps.at(stepIndex).name;
+    CurrentStats &stats = m_currents[stepKey(stepIndex, name) + QLatin1Char('#') + QString::number(actionIndex)];
+    stats.stepIndex = stepIndex;
+    stats.actionIndex = actionIndex;
+    stats.stepName = name;
+    stats.threshold = threshold;
+    stats.isUpperLimit = plan.action(stepIndex, actionIndex).isUpperLimit;
+    if (!passed) {
+        ++stats.failures;
+    }
+    stats.digest.add(value);
+    stats.window.add(value);
+}
+
+void YieldAggregator::recordSequence(bool allPassed)
+{
+    ++m_overall.runs;
+    if (allPassed) {
+        ++m_overall.passes;
+    }
+    m_overall.window.add(allPassed ? 1.0 : 0.0);
+}
+
+QString YieldAggregator::stepKey(int stepIndex, const QString &name)
+{
+    return QString::number(stepIndex) + QLatin1Char('|') + name;
+}
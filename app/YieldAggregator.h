@@ -0,0 +1,121 @@
+#ifndef YIELDAGGREGATOR_H
+#define YIELDAGGREGATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QJsonObject>
+#include "domain/TDigest.h"
+#include "domain/MovingWindow.h"
+
+class TestSequenceRunner;
+
+/**
+ * @brief 跨运行的良率与电流分布统计
+ *
+ * 职责：
+ * - 订阅各执行引擎（单工位和多工位治具）的步骤结果、电流检测结果和序列完成信号
+ * - 增量维护整体良率、各步骤通过率和各电流检测动作的分布（t-digest 分位数）
+ * - 同时维护最近 kWindowSize 次的滑动窗口通过率和电流均值，便于发现产线上待机/工作电流的漂移
+ *
+ * 每个步骤、每个电流检测动作的内存固定（与运行次数无关）。
+ * 统计按"步骤序号 + 步骤名称"区分步骤，更换测试计划后不同的步骤分别统计。
+ */
+class YieldAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kWindowSize = 100;     ///< 滑动窗口大小（最近 N 次）
+
+    /**
+     * @brief 通过率统计（整体或单个步骤）
+     */
+    struct PassStats {
+        int stepIndex;              ///< 步骤索引（整体统计为 -1）
+        QString name;               ///< 名称
+        quint64 runs;               ///< 执行次数
+        quint64 passes;             ///< 通过次数
+        MovingWindow window;        ///< 最近 kWindowSize 次的通过情况（1/0）
+
+        PassStats() : stepIndex(-1), runs(0), passes(0), window(kWindowSize) {}
+
+        double passRate() const { return runs > 0 ? static_cast<double>(passes) / runs : 0.0; }
+        double windowPassRate() const { return window.mean(); }
+    };
+
+    /**
+     * @brief 单个电流检测动作的分布统计
+     */
+    struct CurrentStats {
+        int stepIndex;              ///< 步骤索引
+        int actionIndex;            ///< 子动作索引
+        QString stepName;           ///< 步骤名称
+        double threshold;           ///< 最近一次的阈值（mA）
+        bool isUpperLimit;          ///< 阈值类型
+        quint64 failures;           ///< 超限次数
+        TDigest digest;             ///< 测量值分布（mA）
+        MovingWindow window;        ///< 最近 kWindowSize 次的测量值
+
+        CurrentStats()
+            : stepIndex(-1), actionIndex(-1), threshold(0.0), isUpperLimit(true)
+            , failures(0), window(kWindowSize) {}
+    };
+
+    explicit YieldAggregator(QObject *parent = nullptr);
+
+    /**
+     * @brief 订阅执行引擎的结果信号（执行引擎销毁时自动断开）
+     */
+    void attachRunner(TestSequenceRunner *runner);
+
+    /**
+     * @brief 清空全部统计
+     */
+    void reset();
+
+    /**
+     * @brief 整体良率（每次完整执行的序列计一次，中途停止不计入）
+     */
+    const PassStats &overall() const { return m_overall; }
+
+    /**
+     * @brief 各步骤通过率（按步骤索引排序）
+     */
+    QVector<const PassStats *> steps() const;
+
+    /**
+     * @brief 各电流检测动作的分布（按步骤、子动作索引排序）
+     */
+    QVector<const CurrentStats *> currentChecks() const;
+
+    /**
+     * @brief CSV 表头（与 toCsvLines 的列一一对应）
+     */
+    static QString csvHeader();
+
+    /**
+     * @brief 导出为 CSV 行（整体一行，每个步骤一行，每个电流检测动作一行）
+     */
+    QStringList toCsvLines() const;
+
+    /**
+     * @brief 导出为 JSON
+     */
+    QJsonObject toJson() const;
+
+private:
+    void recordStep(TestSequenceRunner *runner, int stepIndex, bool success);
+    void recordCurrent(TestSequenceRunner *runner, int stepIndex, double value, double threshold, bool passed);
+    void recordSequence(bool allPassed);
+
+    static QString stepKey(int stepIndex, const QString &name);
+
+    PassStats m_overall;                        ///< 整体良率
+    QHash<QString, PassStats> m_steps;          ///< 步骤键 → 步骤通过率
+    QHash<QString, CurrentStats> m_currents;    ///< 动作键 → 电流分布
+};
+
+#endif // YIELDAGGREGATOR_H
@@ -0,0 +1,26 @@
+# 协议解析、CRC和帧构造热点路径的微基准测试
+# 构建：qmake bench/bench.pro && make && ./pcba_bench
+# 输出每次调用耗时（QBENCHMARK）以及 ns/op、MB/s 汇总
+
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = pcba_bench
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    bench_hotpaths.cpp
+
+HEADERS += \
+    ../DeviceProtocol.h \
+    ../OtaProtocol.h \
+    ../protocol/ProtocolParser.h \
+    ../protocol/MeasurementFrameDecoder.h \
+    ../protocol/ResponseMatcher.h \
+    ../protocol/BaudRate.h
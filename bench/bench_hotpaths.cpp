@@ -0,0 +1,643 @@
+#include <QtTest>
+#include <QByteArray>
+#include <QVector>
+#include <QElapsedTimer>
+#include <cstring>
+#include <random>
+#include "DeviceProtocol.h"
+#include "OtaProtocol.h"
+#include "protocol/ProtocolParser.h"
+#include "protocol/MeasurementFrameDecoder.h"
+#include "protocol/ResponseMatcher.h"
+
+namespace {
+
+volatile uint32_t g_sink = 0;   ///< 保存计算结果，避免被编译器优化掉
+
+/**
+ * @brief 统计 QBENCHMARK 循环的总调用次数和耗时，输出 ns/op 和 MB/s
+ *
+ * QBENCHMARK 只报告每次迭代的毫秒数；这里按实际调用次数和处理字节数换算，
+ * 便于直接和产线串口速率（9600 波特约 0.87 KB/s）对比。
+ */
+class RateMeter
+{
+public:
+    explicit RateMeter(qint64 bytesPerIteration = 0, int opsPerIteration = 1)
+        : m_bytesPerIteration(bytesPerIteration)
+        , m_opsPerIteration(opsPerIteration)
+        , m_iterations(0)
+    {
+        m_timer.start();
+    }
+
+    void tick() { ++m_iterations; }
+
+    void report() const
+    {
+        const qint64 elapsedNs = m_timer.nsecsElapsed();
+        if (m_iterations == 0 || elapsedNs <= 0) {
+            return;
+        }
+
+        const double nsPerOp = static_cast<double>(elapsedNs) / (m_iterations * m_opsPerIteration);
+        QString line = QString("%1 ns/op").arg(nsPerOp, 0, 'f', 1);
+        if (m_bytesPerIteration > 0) {
+            const double mbPerSec = (static_cast<double>(m_bytesPerIteration) * m_iterations)
+                                    / (elapsedNs / 1e9) / (1024.0 * 1024.0);
+            line += QString(", %1 MB/s").arg(mbPerSec, 0, 'f', 1);
+        }
+        qInfo("%s[%s]: %s", QTest::currentTestFunction(),
+              QTest::currentDataTag() ? QTest::currentDataTag() : "",
+              qPrintable(line));
+    }
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_bytesPerIteration;
+    int m_opsPerIteration;
+    qint64 m_iterations;
+};
+
+/**
+ * @brief 测量帧：0x50 + 4字节float（小端）
+ */
+QByteArray measurementFrame(float value)
+{
+    QByteArray frame(5, Qt::Uninitialized);
+    frame[0] = static_cast<char>(0x50);
+    std::memcpy(frame.data() + 1, &value, sizeof(float));
+    return frame;
+}
+
+/**
+ * @brief 连续测量帧流
+ */
+QByteArray measurementStream(int frameCount, std::mt19937 &random)
+{
+    std::uniform_real_distribution<float> values(0.0f, 5.0f);
+    QByteArray stream;
+    stream.reserve(frameCount * 5);
+    for (int i = 0; i < frameCount; ++i) {
+        stream.append(measurementFrame(values(random)));
+    }
+    return stream;
+}
+
+/**
+ * @brief 打包测量帧流（0x52，每帧 kPackedMaxSamples 个样本）
+ */
+QByteArray packedMeasurementStream(int sampleCount, std::mt19937 &random)
+{
+    std::uniform_int_distribution<int> values(-20000, 20000);
+    int16_t samples[ProtocolParser::kPackedMaxSamples];
+    QByteArray stream;
+    for (int sent = 0; sent < sampleCount; sent += ProtocolParser::kPackedMaxSamples) {
+        for (int16_t &sample : samples) {
+            sample = static_cast<int16_t>(values(random));
+        }
+        stream.append(ProtocolParser::encodePackedFrame(ProtocolParser::kPackedInt16Header, 1.0f, 1e-4f,
+                                                        samples, ProtocolParser::kPackedMaxSamples));
+    }
+    return stream;
+}
+
+/**
+ * @brief 多通道扫描帧流（0x54，每帧四个通道）
+ */
+QByteArray scanMeasurementStream(int scanCount, std::mt19937 &random)
+{
+    std::uniform_real_distribution<float> values(0.0f, 10.0f);
+    float samples[ProtocolParser::kScanMaxChannels];
+    QByteArray stream;
+    stream.reserve(scanCount * ProtocolParser::scanFrameSize(ProtocolParser::kScanAllChannels));
+    for (int i = 0; i < scanCount; ++i) {
+        for (float &sample : samples) {
+            sample = values(random);
+        }
+        stream.append(ProtocolParser::encodeScanFrame(ProtocolParser::kScanAllChannels, samples));
+    }
+    return stream;
+}
+
+/**
+ * @brief 按 [1, maxChunk] 的随机长度切分字节流（maxChunk <= 0 表示不切分）
+ */
+QVector<QByteArray> randomChunks(const QByteArray &stream, int maxChunk, std::mt19937 &random)
+{
+    QVector<QByteArray> chunks;
+    if (maxChunk <= 0) {
+        chunks.append(stream);
+        return chunks;
+    }
+
+    std::uniform_int_distribution<int> sizes(1, maxChunk);
+    for (int pos = 0; pos < stream.size();) {
+        const int size = qMin(sizes(random), stream.size() - pos);
+        chunks.append(stream.mid(pos, size));
+        pos += size;
+    }
+    return chunks;
+}
+
+/**
+ * @brief 伪随机固件镜像
+ */
+QByteArray firmwareImage(int size)
+{
+    std::mt19937 random(size);
+    QByteArray image(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        image[i] = static_cast<char>(random() & 0xFF);
+    }
+    return image;
+}
+
+QByteArray bytes(std::initializer_list<uint8_t> values)
+{
+    QByteArray data;
+    for (uint8_t value : values) {
+        data.append(static_cast<char>(value));
+    }
+    return data;
+}
+
+} // namespace
+
+/**
+ * @brief 协议解析、CRC和帧构造热点路径的微基准测试
+ *
+ * 数据均由固定种子生成，多次运行结果可比较。
+ */
+class BenchHotPaths : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void checkResponseMatch_data();
+    void checkResponseMatch();
+
+    void parseExternalMeasurementWithHeader_data();
+    void parseExternalMeasurementWithHeader();
+
+    void decoderFeed_data();
+    void decoderFeed();
+
+    void decoderFeedPacked_data();
+    void decoderFeedPacked();
+
+    void decoderFeedScan_data();
+    void decoderFeedScan();
+
+    void mixedStream_data();
+    void mixedStream();
+
+    void mixedStreamMatcher_data();
+    void mixedStreamMatcher();
+
+    void encodeVoltage();
+    void encodeV4Voltage();
+
+    void crc16_data();
+    void crc16();
+
+    void crc32_data();
+    void crc32();
+
+    void buildDeviceFrames();
+    void buildDeviceFramesFixed();
+
+    void buildOtaDataFrame_data();
+    void buildOtaDataFrame();
+};
+
+void BenchHotPaths::checkResponseMatch_data()
+{
+    QTest::addColumn<QByteArray>("buffer");
+    QTest::addColumn<QByteArray>("expected");
+
+    std::mt19937 random(1);
+    const QByteArray stream = measurementStream(200, random);
+
+    QTest::newRow("echo_at_head") << (bytes({0x01, 0x01}) + stream.left(100)) << bytes({0x01, 0x01});
+    QTest::newRow("pause_ack_after_stream") << (stream + bytes({0xAA, 0x55})) << bytes({0xAA, 0x55});
+    QTest::newRow("single_byte_after_stream") << (stream + bytes({0x05})) << bytes({0x05});
+    QTest::newRow("miss_multi_byte") << stream << bytes({0x02, 0x01, 0x33});
+}
+
+void BenchHotPaths::checkResponseMatch()
+{
+    QFETCH(QByteArray, buffer);
+    QFETCH(QByteArray, expected);
+
+    RateMeter meter(buffer.size());
+    QBENCHMARK {
+        g_sink += ProtocolParser::checkResponseMatch(buffer, expected) ? 1u : 0u;
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::parseExternalMeasurementWithHeader_data()
+{
+    QTest::addColumn<int>("frameCount");
+
+    QTest::newRow("64_frames") << 64;
+    QTest::newRow("1024_frames") << 1024;
+}
+
+void BenchHotPaths::parseExternalMeasurementWithHeader()
+{
+    QFETCH(int, frameCount);
+
+    std::mt19937 random(2);
+    const QByteArray stream = measurementStream(frameCount, random);
+
+    RateMeter meter(stream.size(), frameCount);
+    QBENCHMARK {
+        QByteArray buffer = stream;
+        float value = 0.0f;
+        while (buffer.size() >= 5) {
+            if (ProtocolParser::parseExternalMeasurementWithHeader(buffer, value)) {
+                g_sink += static_cast<uint32_t>(value);
+            }
+        }
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::decoderFeed_data()
+{
+    QTest::addColumn<int>("maxChunk");
+
+    QTest::newRow("split_1") << 1;
+    QTest::newRow("random_1_16") << 16;
+    QTest::newRow("random_1_256") << 256;
+    QTest::newRow("whole") << 0;
+}
+
+void BenchHotPaths::decoderFeed()
+{
+    QFETCH(int, maxChunk);
+
+    std::mt19937 random(3);
+    const QByteArray stream = measurementStream(4096, random);
+    const QVector<QByteArray> chunks = randomChunks(stream, maxChunk, random);
+
+    MeasurementFrameDecoder decoder;
+    QVector<float> values;
+    values.reserve(4096);
+
+    RateMeter meter(stream.size(), 4096);
+    QBENCHMARK {
+        decoder.clear();
+        values.clear();
+        for (const QByteArray &chunk : chunks) {
+            decoder.feed(chunk, values);
+        }
+        g_sink += static_cast<uint32_t>(values.size());
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::decoderFeedPacked_data()
+{
+    decoderFeed_data();
+}
+
+void BenchHotPaths::decoderFeedPacked()
+{
+    QFETCH(int, maxChunk);
+
+    std::mt19937 random(3);
+    const QByteArray stream = packedMeasurementStream(4096, random);
+    const QVector<QByteArray> chunks = randomChunks(stream, maxChunk, random);
+
+    MeasurementFrameDecoder decoder;
+    decoder.setPackedFramesEnabled(true);
+    QVector<float> values;
+    values.reserve(4096);
+
+    RateMeter meter(stream.size(), 4096);
+    QBENCHMARK {
+        decoder.clear();
+        values.clear();
+        for (const QByteArray &chunk : chunks) {
+            decoder.feed(chunk, values);
+        }
+        g_sink += static_cast<uint32_t>(values.size());
+        meter.tick();
+    }
+    QCOMPARE(values.size(), 4096);
+    meter.report();
+}
+
+void BenchHotPaths::decoderFeedScan_data()
+{
+    decoderFeed_data();
+}
+
+void BenchHotPaths::decoderFeedScan()
+{
+    QFETCH(int, maxChunk);
+
+    std::mt19937 random(4);
+    const QByteArray stream = scanMeasurementStream(1024, random);
+    const QVector<QByteArray> chunks = randomChunks(stream, maxChunk, random);
+
+    MeasurementFrameDecoder decoder;
+    decoder.setScanFramesEnabled(true);
+    QVector<float> values;
+    QVector<uint8_t> channels;
+    values.reserve(4096);
+    channels.reserve(4096);
+
+    RateMeter meter(stream.size(), 4096);
+    QBENCHMARK {
+        decoder.clear();
+        values.clear();
+        channels.clear();
+        for (const QByteArray &chunk : chunks) {
+            decoder.feed(chunk, values, &channels);
+        }
+        g_sink += static_cast<uint32_t>(values.size());
+        meter.tick();
+    }
+    QCOMPARE(values.size(), 4096);
+    QCOMPARE(channels.size(), 4096);
+    meter.report();
+}
+
+void BenchHotPaths::mixedStream_data()
+{
+    QTest::addColumn<int>("maxChunk");
+
+    QTest::newRow("random_1_8") << 8;
+    QTest::newRow("random_1_64") << 64;
+}
+
+void BenchHotPaths::mixedStream()
+{
+    QFETCH(int, maxChunk);
+
+    // 检测过程中穿插控制命令：每个确认帧之后跟50个测量帧
+    const QVector<QByteArray> acks = {
+        bytes({0x01, 0x01}), bytes({0x02, 0x01, 0x33}), bytes({0x12, 0x04}), bytes({0x06, 0x04, 0x01})
+    };
+    std::mt19937 random(4);
+    QByteArray stream;
+    QVector<int> ackOffsets;
+    for (int i = 0; i < 40; ++i) {
+        ackOffsets.append(stream.size());
+        stream.append(acks.at(i % acks.size()));
+        stream.append(measurementStream(50, random));
+    }
+    const QVector<QByteArray> chunks = randomChunks(stream, maxChunk, random);
+
+    MeasurementFrameDecoder decoder;
+    QVector<float> values;
+
+    // 与 DeviceController::onSerialDataReceived 相同的处理方式：
+    // 等待确认期间累积缓冲并匹配，匹配成功后剩余数据交给测量帧解码器；
+    // 假定每条命令都恰好在其确认帧到达前发出
+    RateMeter meter(stream.size());
+    QBENCHMARK {
+        QByteArray pending;
+        bool waiting = false;
+        int next = 0;
+        int pos = 0;
+        decoder.clear();
+        values.clear();
+        for (const QByteArray &chunk : chunks) {
+            const int start = pos;
+            pos += chunk.size();
+
+            if (waiting) {
+                pending.append(chunk);
+            } else if (next < ackOffsets.size() && ackOffsets.at(next) < pos) {
+                const int split = ackOffsets.at(next) - start;
+                decoder.feed(chunk.left(split), values);
+                pending = chunk.mid(split);
+                waiting = true;
+            } else {
+                decoder.feed(chunk, values);
+                continue;
+            }
+
+            const QByteArray &expected = acks.at(next % acks.size());
+            if (!ProtocolParser::checkResponseMatch(pending, expected)) {
+                continue;
+            }
+            const int matchPos = ProtocolParser::findResponse(pending, expected);
+            decoder.feed(pending.mid(matchPos + expected.size()), values);
+            pending.clear();
+            waiting = false;
+            ++next;
+        }
+        g_sink += static_cast<uint32_t>(values.size() + next);
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::mixedStreamMatcher_data()
+{
+    mixedStream_data();
+}
+
+void BenchHotPaths::mixedStreamMatcher()
+{
+    QFETCH(int, maxChunk);
+
+    // 与 mixedStream 相同的数据流，改用 ResponseMatcher 一次遍历识别确认帧和测量帧
+    const QVector<QByteArray> acks = {
+        bytes({0x01, 0x01}), bytes({0x02, 0x01, 0x33}), bytes({0x12, 0x04}), bytes({0x06, 0x04, 0x01})
+    };
+    std::mt19937 random(4);
+    QByteArray stream;
+    for (int i = 0; i < 40; ++i) {
+        stream.append(acks.at(i % acks.size()));
+        stream.append(measurementStream(50, random));
+    }
+    const QVector<QByteArray> chunks = randomChunks(stream, maxChunk, random);
+
+    ResponseMatcher matcher;
+    QVector<float> values;
+
+    // 假定每条命令都在上一条确认后立即发出，始终有一条在途命令
+    RateMeter meter(stream.size());
+    QBENCHMARK {
+        int next = 0;
+        matcher.reset();
+        values.clear();
+        ResponseMatcher::Event event;
+        for (const QByteArray &chunk : chunks) {
+            matcher.feed(chunk);
+            const QByteArray *expected = &acks.at(next % acks.size());
+            while (matcher.next(expected, 1, event)) {
+                if (event.type == ResponseMatcher::Event::Measurement) {
+                    values.append(event.value);
+                } else {
+                    ++next;
+                    expected = &acks.at(next % acks.size());
+                }
+            }
+        }
+        g_sink += static_cast<uint32_t>(values.size() + next);
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::encodeVoltage()
+{
+    QVector<double> voltages;
+    for (int i = 0; i <= 99; ++i) {
+        voltages.append(i / 10.0);
+    }
+
+    RateMeter meter(0, voltages.size());
+    QBENCHMARK {
+        for (double voltage : voltages) {
+            g_sink += DeviceProtocol::encodeVoltage(voltage);
+        }
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::encodeV4Voltage()
+{
+    // 特殊指令码电压 + BCD 编码电压
+    const QVector<double> voltages = {
+        2.90, 3.20, 3.45, 3.65, 3.85, 3.90, 4.05, 4.70, 5.50, 0.00,
+        1.20, 2.50, 3.30, 5.00, 6.80, 9.90
+    };
+
+    RateMeter meter(0, voltages.size());
+    QBENCHMARK {
+        for (double voltage : voltages) {
+            g_sink += DeviceProtocol::encodeV4Voltage(voltage);
+        }
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::crc16_data()
+{
+    QTest::addColumn<int>("size");
+
+    // 帧头到数据区结束的长度：空帧、常用数据包大小
+    QTest::newRow("frame_empty") << 7;
+    QTest::newRow("frame_256") << 7 + 256;
+    QTest::newRow("frame_1024") << 7 + 1024;
+}
+
+void BenchHotPaths::crc16()
+{
+    QFETCH(int, size);
+
+    const QByteArray data = firmwareImage(size);
+    const uint8_t *ptr = reinterpret_cast<const uint8_t*>(data.constData());
+
+    RateMeter meter(size);
+    QBENCHMARK {
+        g_sink += OtaProtocol::calculateCRC16(ptr, static_cast<uint16_t>(size));
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::crc32_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("image_64K") << 64 * 1024;
+    QTest::newRow("image_256K") << 256 * 1024;
+    QTest::newRow("image_1M") << 1024 * 1024;
+}
+
+void BenchHotPaths::crc32()
+{
+    QFETCH(int, size);
+
+    const QByteArray image = firmwareImage(size);
+    const uint8_t *ptr = reinterpret_cast<const uint8_t*>(image.constData());
+
+    RateMeter meter(size);
+    QBENCHMARK {
+        g_sink += OtaProtocol::calculateCRC32(ptr, static_cast<uint32_t>(size));
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::buildDeviceFrames()
+{
+    // 一次测试步骤中最常用的几种控制帧
+    RateMeter meter(0, 6);
+    QBENCHMARK {
+        g_sink += static_cast<uint32_t>(DeviceProtocol::buildPowerOn().size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::buildV123VoltageControl(0x01, 3.3).size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::buildV4VoltageControl(3.85).size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::buildDetection(0x01, 0x11).size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::buildRelayKey(DeviceProtocol::RelayKeyCode::PowerConfirm).size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::buildPauseDetection().size());
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::buildDeviceFramesFixed()
+{
+    // 与 buildDeviceFrames 相同的帧：参数帧在栈上编码后一次分配，固定帧为静态常量零拷贝包装
+    static constexpr Frame<2> kPowerOn = DeviceProtocol::powerOnFrame();
+    static constexpr Frame<2> kRelayPowerConfirm = DeviceProtocol::relayKeyFrame(DeviceProtocol::RelayKeyCode::PowerConfirm);
+    static constexpr Frame<1> kPauseDetection = DeviceProtocol::pauseDetectionFrame();
+    volatile double v123Voltage = 3.3;  // 运行时参数，避免整帧被编译期折叠
+    volatile double v4Voltage = 3.85;
+
+    RateMeter meter(0, 6);
+    QBENCHMARK {
+        g_sink += static_cast<uint32_t>(kPowerOn.toRawByteArray().size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::v123VoltageControlFrame(0x01, v123Voltage).toByteArray().size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::v4VoltageControlFrame(v4Voltage).toByteArray().size());
+        g_sink += static_cast<uint32_t>(DeviceProtocol::detectionFrame(0x01, 0x11).toByteArray().size());
+        g_sink += static_cast<uint32_t>(kRelayPowerConfirm.toRawByteArray().size());
+        g_sink += static_cast<uint32_t>(kPauseDetection.toRawByteArray().size());
+        meter.tick();
+    }
+    meter.report();
+}
+
+void BenchHotPaths::buildOtaDataFrame_data()
+{
+    QTest::addColumn<int>("packetSize");
+
+    QTest::newRow("packet_128") << 128;
+    QTest::newRow("packet_256") << 256;
+    QTest::newRow("packet_1024") << 1024;
+}
+
+void BenchHotPaths::buildOtaDataFrame()
+{
+    QFETCH(int, packetSize);
+
+    const QByteArray payload = firmwareImage(packetSize);
+    const uint8_t *ptr = reinterpret_cast<const uint8_t*>(payload.constData());
+
+    RateMeter meter(packetSize);
+    uint16_t seq = 0;
+    QBENCHMARK {
+        g_sink += static_cast<uint32_t>(OtaProtocol::buildDataFrame(seq++, ptr, static_cast<uint16_t>(packetSize)).size());
+        meter.tick();
+    }
+    meter.report();
+}
+
+QTEST_APPLESS_MAIN(BenchHotPaths)
+
+#include "bench_hotpaths.moc"
@@ -0,0 +1,75 @@
+# 不依赖 QtWidgets/QtCharts 的核心模块：设备通信、协议、执行引擎、记录存储
+# 图形界面（test.pro）与无界面批处理（headless/headless.pro）共用
+# 只依赖 QtCore 和 QtSerialPort，新增的非界面源文件应加在这里
+
+QT += core serialport
+
+INCLUDEPATH += $$PWD
+
+# SoakController 读取进程常驻内存（GetProcessMemoryInfo）
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    $$PWD/SerialPortService.cpp \
+    $$PWD/SerialPortWorker.cpp \
+    $$PWD/SimulatedDeviceTransport.cpp \
+    $$PWD/DeviceController.cpp \
+    $$PWD/app/TestSequenceRunner.cpp \
+    $$PWD/app/DeadlineScheduler.cpp \
+    $$PWD/app/StationScheduler.cpp \
+    $$PWD/app/PlanCompiler.cpp \
+    $$PWD/app/YieldAggregator.cpp \
+    $$PWD/app/SoakController.cpp \
+    $$PWD/app/CycleTimeProfiler.cpp \
+    $$PWD/storage/MeasurementRecorder.cpp \
+    $$PWD/storage/MeasurementRecordingReader.cpp \
+    $$PWD/storage/ErrorRecordReader.cpp \
+    $$PWD/storage/ErrorRecordWriter.cpp \
+    $$PWD/storage/ErrorRecordStore.cpp \
+    $$PWD/log/LogFileSink.cpp \
+    $$PWD/log/LogFileWriter.cpp
+
+HEADERS += \
+    $$PWD/DeviceProtocol.h \
+    $$PWD/SerialPortService.h \
+    $$PWD/SerialPortWorker.h \
+    $$PWD/DeviceTransport.h \
+    $$PWD/SimulatedDeviceTransport.h \
+    $$PWD/DeviceController.h \
+    $$PWD/domain/Command.h \
+    $$PWD/domain/Measurement.h \
+    $$PWD/domain/StepSpec.h \
+    $$PWD/domain/ErrorRecord.h \
+    $$PWD/domain/SampleHistory.h \
+    $$PWD/domain/RangeStats.h \
+    $$PWD/domain/MultiChannelHistory.h \
+    $$PWD/domain/MonotonicClock.h \
+    $$PWD/domain/LatencyHistogram.h \
+    $$PWD/domain/CommandLatencyStats.h \
+    $$PWD/domain/SettleDetector.h \
+    $$PWD/domain/TDigest.h \
+    $$PWD/domain/MovingWindow.h \
+    $$PWD/protocol/ProtocolParser.h \
+    $$PWD/protocol/MeasurementFrameDecoder.h \
+    $$PWD/protocol/ResponseMatcher.h \
+    $$PWD/protocol/Frame.h \
+    $$PWD/protocol/BaudRate.h \
+    $$PWD/app/TestSequenceRunner.h \
+    $$PWD/app/DeadlineScheduler.h \
+    $$PWD/app/TestStepFactory.h \
+    $$PWD/app/StationScheduler.h \
+    $$PWD/app/CompiledPlan.h \
+    $$PWD/app/PlanCompiler.h \
+    $$PWD/app/YieldAggregator.h \
+    $$PWD/app/SoakController.h \
+    $$PWD/app/CycleTimeProfiler.h \
+    $$PWD/storage/MeasurementRecord.h \
+    $$PWD/storage/MeasurementRecorder.h \
+    $$PWD/storage/MeasurementRecordingReader.h \
+    $$PWD/storage/ErrorRecordFormat.h \
+    $$PWD/storage/ErrorRecordReader.h \
+    $$PWD/storage/ErrorRecordWriter.h \
+    $$PWD/storage/ErrorRecordStore.h \
+    $$PWD/log/LogEntry.h \
+    $$PWD/log/LogFileSink.h \
+    $$PWD/log/LogFileWriter.h
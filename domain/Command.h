@@ -31,7 +31,9 @@ enum class Command {
     RelaySw4,           ///< 继电器-SW4按键
     RelaySw5,           ///< 继电器-SW5按键
     RelaySw6,           ///< 继电器-SW6按键
-    StopExternalMeter   ///< 停止外部电流表连续检测
+    StopExternalMeter,  ///< 停止外部电流表连续检测
+    SetMeasurementFormat,   ///< 选择连续检测的测量帧格式
+    LinkKeepalive           ///< 链路保活探测帧（DeviceController 内部使用，不发射确认信号）
 };
 
 /**
@@ -59,6 +61,8 @@ inline QString commandToString(Command cmd) {
     case Command::RelayPowerConfirm: return QObject::tr("继电器-确认键");
     case Command::RelayRight:       return QObject::tr("继电器-右键");
     case Command::StopExternalMeter: return QObject::tr("停止外部电流表检测");
+    case Command::SetMeasurementFormat: return QObject::tr("测量帧格式选择");
+    case Command::LinkKeepalive:    return QObject::tr("链路保活");
     default:                        return QObject::tr("未知操作");
     }
 }
@@ -0,0 +1,172 @@
+#ifndef COMMANDLATENCYSTATS_H
+#define COMMANDLATENCYSTATS_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "domain/Command.h"
+#include "domain/LatencyHistogram.h"
+
+/**
+ * @brief 单个命令类型的往返统计
+ */
+struct CommandLatencyRecord {
+    LatencyHistogram ackLatency;    ///< 发送到确认匹配的延迟（从最近一次发送起算，微秒）
+    quint64 sent;                   ///< 发送次数（不含重试）
+    quint64 acked;                  ///< 确认成功次数
+    quint64 timeouts;               ///< 确认超时次数（每次超时都计数）
+    quint64 retries;                ///< 重试次数
+    quint64 failures;               ///< 最终失败次数（超过最大重试、写入失败等）
+
+    CommandLatencyRecord() : sent(0), acked(0), timeouts(0), retries(0), failures(0) {}
+
+    void merge(const CommandLatencyRecord &other)
+    {
+        ackLatency.merge(other.ackLatency);
+        sent += other.sent;
+        acked += other.acked;
+        timeouts += other.timeouts;
+        retries += other.retries;
+        failures += other.failures;
+    }
+};
+
+/**
+ * @brief 按命令类型汇总的命令往返统计
+ *
+ * 职责：
+ * - 记录每种命令的发送、确认、超时、重试和失败次数，以及确认延迟直方图
+ * - 导出为 CSV 行或 JSON，便于按治具比较 p50/p99 延迟
+ */
+class CommandLatencyStats
+{
+public:
+    void recordSent(Command command) { ++m_records[command].sent; }
+    void recordAck(Command command, qint64 latencyUs)
+    {
+        CommandLatencyRecord &record = m_records[command];
+        ++record.acked;
+        record.ackLatency.record(latencyUs);
+    }
+    void recordTimeout(Command command) { ++m_records[command].timeouts; }
+    void recordRetry(Command command) { ++m_records[command].retries; }
+    void recordFailure(Command command) { ++m_records[command].failures; }
+
+    void reset() { m_records.clear(); }
+    bool isEmpty() const { return m_records.isEmpty(); }
+
+    /**
+     * @brief 有统计数据的命令类型
+     */
+    QList<Command> commands() const { return m_records.keys(); }
+
+    /**
+     * @brief 指定命令的统计（没有数据时返回空记录）
+     */
+    CommandLatencyRecord record(Command command) const { return m_records.value(command); }
+
+    /**
+     * @brief 所有命令合计
+     */
+    CommandLatencyRecord total() const
+    {
+        CommandLatencyRecord sum;
+        for (const CommandLatencyRecord &record : m_records) {
+            sum.merge(record);
+        }
+        return sum;
+    }
+
+    /**
+     * @brief CSV 表头（与 toCsvLines 的列一一对应）
+     */
+    static QString csvHeader()
+    {
+        return QStringLiteral("fixture,command_id,command,sent,acked,timeouts,retries,failures,"
+                              "min_ms,p50_ms,p90_ms,p99_ms,max_ms,mean_ms");
+    }
+
+    /**
+     * @brief 导出为 CSV 行（每种命令一行，最后一行为合计）
+     * @param fixture 治具名称（串口名）
+     */
+    QStringList toCsvLines(const QString &fixture) const
+    {
+        QStringList lines;
+        for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+            lines << csvLine(fixture, QString::number(static_cast<int>(it.key())),
+                             commandToString(it.key()), it.value());
+        }
+        lines << csvLine(fixture, QString(), QStringLiteral("total"), total());
+        return lines;
+    }
+
+    /**
+     * @brief 导出为 JSON（含各命令的非空直方图桶，桶下界单位为微秒）
+     */
+    QJsonObject toJson() const
+    {
+        QJsonArray commands;
+        for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+            QJsonObject object = recordToJson(it.value());
+            object.insert(QStringLiteral("command_id"), static_cast<int>(it.key()));
+            object.insert(QStringLiteral("command"), commandToString(it.key()));
+            commands.append(object);
+        }
+
+        QJsonObject result;
+        result.insert(QStringLiteral("commands"), commands);
+        result.insert(QStringLiteral("total"), recordToJson(total()));
+        return result;
+    }
+
+private:
+    static QString formatMs(qint64 us) { return QString::number(us / 1000.0, 'f', 3); }
+
+    static QString csvLine(const QString &fixture, const QString &commandId,
+                           const QString &commandName, const CommandLatencyRecord &record)
+    {
+        const LatencyHistogram &h = record.ackLatency;
+        QStringList fields;
+        fields << fixture << commandId << commandName
+               << QString::number(record.sent) << QString::number(record.acked)
+               << QString::number(record.timeouts) << QString::number(record.retries)
+               << QString::number(record.failures)
+               << formatMs(h.minValue()) << formatMs(h.valueAtPercentile(50))
+               << formatMs(h.valueAtPercentile(90)) << formatMs(h.valueAtPercentile(99))
+               << formatMs(h.maxValue()) << QString::number(h.mean() / 1000.0, 'f', 3);
+        return fields.join(QLatin1Char(','));
+    }
+
+    static QJsonObject recordToJson(const CommandLatencyRecord &record)
+    {
+        const LatencyHistogram &h = record.ackLatency;
+
+        QJsonArray buckets;
+        for (const auto &bucket : h.nonEmptyBuckets()) {
+            buckets.append(QJsonArray{static_cast<double>(bucket.first), static_cast<double>(bucket.second)});
+        }
+
+        QJsonObject object;
+        object.insert(QStringLiteral("sent"), static_cast<double>(record.sent));
+        object.insert(QStringLiteral("acked"), static_cast<double>(record.acked));
+        object.insert(QStringLiteral("timeouts"), static_cast<double>(record.timeouts));
+        object.insert(QStringLiteral("retries"), static_cast<double>(record.retries));
+        object.insert(QStringLiteral("failures"), static_cast<double>(record.failures));
+        object.insert(QStringLiteral("min_us"), static_cast<double>(h.minValue()));
+        object.insert(QStringLiteral("p50_us"), static_cast<double>(h.valueAtPercentile(50)));
+        object.insert(QStringLiteral("p90_us"), static_cast<double>(h.valueAtPercentile(90)));
+        object.insert(QStringLiteral("p99_us"), static_cast<double>(h.valueAtPercentile(99)));
+        object.insert(QStringLiteral("max_us"), static_cast<double>(h.maxValue()));
+        object.insert(QStringLiteral("mean_us"), h.mean());
+        object.insert(QStringLiteral("buckets"), buckets);
+        return object;
+    }
+
+    QMap<Command, CommandLatencyRecord> m_records;  ///< 各命令的统计
+};
+
+#endif // COMMANDLATENCYSTATS_H
@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QDateTime>
+#include <QMetaType>
 
 /**
  * @brief 测试错误记录结构
@@ -21,6 +22,11 @@ struct ErrorRecord {
     // 测量数据（用于电流检测失败，无效时为-1）
     double measuredValue;       ///< 实际测量值（mA）
     double thresholdValue;      ///< 阈值（mA）
+
+    // 追溯信息（写入错误记录库）
+    QString boardSerial;        ///< 被测板序列号（未录入时为空）
+    QString fixture;            ///< 治具（串口名称）
+    qint64 runId;               ///< 运行编号（每次开始测试时生成，同一次运行的记录相同）
     
     /**
      * @brief 默认构造函数
@@ -31,6 +37,7 @@ struct ErrorRecord {
         , timestamp(QDateTime::currentDateTime())
         , measuredValue(-1.0)
         , thresholdValue(-1.0)
+        , runId(0)
     {}
     
     /**
@@ -48,6 +55,7 @@ struct ErrorRecord {
         , timestamp(QDateTime::currentDateTime())
         , measuredValue(-1.0)
         , thresholdValue(-1.0)
+        , runId(0)
     {}
     
     /**
@@ -65,6 +73,7 @@ struct ErrorRecord {
         , timestamp(QDateTime::currentDateTime())
         , measuredValue(measured)
         , thresholdValue(threshold)
+        , runId(0)
     {}
     
     /**
@@ -95,4 +104,6 @@ struct ErrorRecord {
     }
 };
 
+Q_DECLARE_METATYPE(ErrorRecord)
+
 #endif // ERRORRECORD_H
@@ -0,0 +1,179 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief 延迟直方图（HDR 风格的对数-线性分桶，单位微秒）
+ *
+ * 职责：
+ * - 固定内存记录任意数量的延迟样本，记录为 O(1)
+ * - 0~63us 每微秒一个桶；更大的值按 2 的幂分段，每段 32 个线性子桶，相对误差不超过 1/32（约3%）
+ * - 按百分位查询（p50/p99 等），可合并多个直方图
+ *
+ * 覆盖范围约 0~19 小时，超出范围的样本计入最后一个桶（max 仍记录真实值）。
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int kLinearBuckets = 64;       ///< 线性区桶数（0~63us）
+    static constexpr int kSubBuckets = 32;          ///< 每个 2 的幂分段的子桶数
+    static constexpr int kSubBucketBits = 5;        ///< log2(kSubBuckets)
+    static constexpr int kMaxExponent = 30;         ///< 最大分段数（上限 2^36 us）
+    static constexpr int kBucketCount = kLinearBuckets + kMaxExponent * kSubBuckets;
+
+    LatencyHistogram()
+        : m_counts(kBucketCount, 0)
+        , m_totalCount(0)
+        , m_sum(0)
+        , m_min(std::numeric_limits<qint64>::max())
+        , m_max(0)
+    {}
+
+    /**
+     * @brief 记录一个样本
+     * @param valueUs 延迟（微秒，负值按0处理）
+     */
+    void record(qint64 valueUs)
+    {
+        if (valueUs < 0) {
+            valueUs = 0;
+        }
+        ++m_counts[bucketIndex(valueUs)];
+        ++m_totalCount;
+        m_sum += valueUs;
+        m_min = qMin(m_min, valueUs);
+        m_max = qMax(m_max, valueUs);
+    }
+
+    /**
+     * @brief 合并另一个直方图
+     */
+    void merge(const LatencyHistogram &other)
+    {
+        for (int i = 0; i < kBucketCount; ++i) {
+            m_counts[i] += other.m_counts.at(i);
+        }
+        m_totalCount += other.m_totalCount;
+        m_sum += other.m_sum;
+        m_min = qMin(m_min, other.m_min);
+        m_max = qMax(m_max, other.m_max);
+    }
+
+    /**
+     * @brief 清空所有样本
+     */
+    void reset()
+    {
+        m_counts.fill(0);
+        m_totalCount = 0;
+        m_sum = 0;
+        m_min = std::numeric_limits<qint64>::max();
+        m_max = 0;
+    }
+
+    quint64 count() const { return m_totalCount; }
+    qint64 minValue() const { return m_totalCount > 0 ? m_min : 0; }
+    qint64 maxValue() const { return m_max; }
+    double mean() const { return m_totalCount > 0 ? static_cast<double>(m_sum) / m_totalCount : 0.0; }
+
+    /**
+     * @brief 百分位对应的延迟（微秒）
+     * @param percentile 百分位（0~100）
+     * @return 样本所在桶的中点，结果限制在 [min, max] 内；无样本时返回0
+     */
+    qint64 valueAtPercentile(double percentile) const
+    {
+        if (m_totalCount == 0) {
+            return 0;
+        }
+
+        percentile = qBound(0.0, percentile, 100.0);
+        quint64 target = static_cast<quint64>(percentile / 100.0 * m_totalCount + 0.5);
+        target = qBound<quint64>(1, target, m_totalCount);
+
+        quint64 accumulated = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            accumulated += m_counts.at(i);
+            if (accumulated >= target) {
+                const qint64 low = bucketLowerBound(i);
+                const qint64 mid = low + (bucketWidth(i) - 1) / 2;
+                return qBound(minValue(), mid, m_max);
+            }
+        }
+        return m_max;
+    }
+
+    /**
+     * @brief 非空桶（下界, 计数），用于导出
+     */
+    QVector<QPair<qint64, quint64>> nonEmptyBuckets() const
+    {
+        QVector<QPair<qint64, quint64>> buckets;
+        for (int i = 0; i < kBucketCount; ++i) {
+            if (m_counts.at(i) > 0) {
+                buckets.append(qMakePair(bucketLowerBound(i), static_cast<quint64>(m_counts.at(i))));
+            }
+        }
+        return buckets;
+    }
+
+private:
+    /**
+     * @brief 值所在的桶
+     */
+    static int bucketIndex(qint64 value)
+    {
+        if (value < kLinearBuckets) {
+            return static_cast<int>(value);
+        }
+
+        // 最高有效位 msb >= 6；分段 e = msb - 5，子桶 = value >> e，落在 [32, 63]
+        int msb = 63;
+        while (!(static_cast<quint64>(value) & (Q_UINT64_C(1) << msb))) {
+            --msb;
+        }
+        const int exponent = msb - kSubBucketBits;
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const int sub = static_cast<int>(value >> exponent) - kSubBuckets;
+        return kLinearBuckets + (exponent - 1) * kSubBuckets + sub;
+    }
+
+    /**
+     * @brief 桶的下界
+     */
+    static qint64 bucketLowerBound(int index)
+    {
+        if (index < kLinearBuckets) {
+            return index;
+        }
+        const int exponent = (index - kLinearBuckets) / kSubBuckets + 1;
+        const int sub = (index - kLinearBuckets) % kSubBuckets + kSubBuckets;
+        return static_cast<qint64>(sub) << exponent;
+    }
+
+    /**
+     * @brief 桶的宽度
+     */
+    static qint64 bucketWidth(int index)
+    {
+        if (index < kLinearBuckets) {
+            return 1;
+        }
+        const int exponent = (index - kLinearBuckets) / kSubBuckets + 1;
+        return Q_INT64_C(1) << exponent;
+    }
+
+    QVector<quint32> m_counts;  ///< 各桶计数
+    quint64 m_totalCount;       ///< 样本总数
+    qint64 m_sum;               ///< 样本总和（计算平均值）
+    qint64 m_min;               ///< 最小值
+    qint64 m_max;               ///< 最大值
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -3,6 +3,8 @@
 
 #include <QString>
 #include <QDateTime>
+#include <QMetaType>
+#include <QVector>
 
 /**
  * @brief 电流测量值数据结构
@@ -26,7 +28,8 @@ struct Measurement {
     float rawValue;         ///< 原始测量值（mA）
     Range range;            ///< 当前档位
     Channel channel;        ///< 测量通道
-    QDateTime timestamp;    ///< 测量时间戳
+    QDateTime timestamp;    ///< 测量时间戳（墙钟，同一次读取的样本相同，用于显示）
+    qint64 monotonicNs;     ///< 样本到达时刻（MonotonicClock 时间轴，纳秒，由读取时刻和帧在数据中的位置推算）
     
     /**
      * @brief 获取显示值（根据档位自动转换单位）
@@ -80,5 +83,7 @@ struct Measurement {
     }
 };
 
+Q_DECLARE_METATYPE(Measurement)
+
 #endif // MEASUREMENT_H
 
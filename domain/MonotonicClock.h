@@ -0,0 +1,53 @@
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QtGlobal>
+
+/**
+ * @brief 进程级单调时钟
+ *
+ * 以进程内第一次使用时为零点，返回纳秒级单调递增的时间戳，
+ * 不受系统时间调整影响，适合作为测量记录的时间轴。
+ * 同时保存零点对应的墙钟时间，用于换算回绝对时间显示。
+ */
+class MonotonicClock
+{
+public:
+    /**
+     * @brief 当前单调时间（纳秒，从时钟零点起）
+     */
+    static qint64 nowNs() { return anchor().timer.nsecsElapsed(); }
+
+    /**
+     * @brief 时钟零点对应的墙钟时间（自 1970-01-01 UTC 起的毫秒数）
+     */
+    static qint64 epochWallMs() { return anchor().wallMs; }
+
+    /**
+     * @brief 单调时间换算为墙钟时间
+     * @param monotonicNs 单调时间（纳秒）
+     * @param epochWallMs 对应时钟零点的墙钟时间（毫秒），读取历史记录时使用记录中保存的值
+     */
+    static QDateTime toDateTime(qint64 monotonicNs, qint64 epochWallMs)
+    {
+        return QDateTime::fromMSecsSinceEpoch(epochWallMs + monotonicNs / 1000000);
+    }
+
+private:
+    struct Anchor {
+        QElapsedTimer timer;
+        qint64 wallMs;
+
+        Anchor() : wallMs(QDateTime::currentMSecsSinceEpoch()) { timer.start(); }
+    };
+
+    static const Anchor &anchor()
+    {
+        static const Anchor instance;   // C++11 局部静态变量初始化线程安全
+        return instance;
+    }
+};
+
+#endif // MONOTONICCLOCK_H
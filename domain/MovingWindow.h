@@ -0,0 +1,69 @@
+#ifndef MOVINGWINDOW_H
+#define MOVINGWINDOW_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief 定长滑动窗口（最近 N 个样本的均值）
+ *
+ * 容量固定，构造时一次性分配，写满后覆盖最旧的样本；均值按累计和 O(1) 计算。
+ * 每写满一圈重新求和一次，避免长时间运行后浮点累计误差漂移。
+ * 通过/失败按 1/0 写入时，均值即为最近 N 次的通过率。
+ */
+class MovingWindow
+{
+public:
+    explicit MovingWindow(int capacity = 100)
+        : m_values(qMax(1, capacity), 0.0)
+        , m_count(0)
+        , m_next(0)
+        , m_sum(0.0)
+    {}
+
+    /**
+     * @brief 追加一个样本
+     */
+    void add(double value)
+    {
+        if (m_count == m_values.size()) {
+            m_sum -= m_values.at(m_next);
+        } else {
+            ++m_count;
+        }
+        m_values[m_next] = value;
+        m_sum += value;
+
+        if (++m_next == m_values.size()) {
+            m_next = 0;
+            double sum = 0.0;
+            for (int i = 0; i < m_count; ++i) {
+                sum += m_values.at(i);
+            }
+            m_sum = sum;
+        }
+    }
+
+    /**
+     * @brief 清空所有样本（保留已分配内存）
+     */
+    void clear()
+    {
+        m_count = 0;
+        m_next = 0;
+        m_sum = 0.0;
+    }
+
+    int capacity() const { return m_values.size(); }
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    double mean() const { return m_count > 0 ? m_sum / m_count : 0.0; }
+
+private:
+    QVector<double> m_values;   ///< 环形存储
+    int m_count;                ///< 当前样本数
+    int m_next;                 ///< 下一个写入位置
+    double m_sum;               ///< 窗口内样本和
+};
+
+#endif // MOVINGWINDOW_H
@@ -0,0 +1,147 @@
+#ifndef MULTICHANNELHISTORY_H
+#define MULTICHANNELHISTORY_H
+
+#include <QScopedPointer>
+#include <QtGlobal>
+#include "domain/Measurement.h"
+#include "domain/SampleHistory.h"
+
+/**
+ * @brief 多通道测量样本历史（每个通道一个 SampleHistory，共用扫描时间基准）
+ *
+ * 职责：
+ * - 按通道分别保存测量值（结构数组：每个通道一段连续的 float 存储），通道首次出现时才分配
+ * - 以扫描序号作为共同的时间基准：多通道扫描帧中的样本按通道号递增排列，
+ *   通道码不大于上一个样本时即开始新的一次扫描
+ * - 记录每个通道首次出现时的扫描序号（偏移），通道第 k 个样本的 X 坐标为 偏移 + k + 1，
+ *   各通道曲线在同一 X 轴上对齐
+ *
+ * 清空后第一个出现的通道为主通道（偏移为 0），图表的标定、悬停和平均值以主通道为准。
+ */
+class MultiChannelHistory
+{
+public:
+    static constexpr int kChannelCount = 4;     ///< 通道数（CH1~CH4）
+
+    /**
+     * @brief 构造函数
+     * @param capacityPerChannel 每个通道的最大保存样本数（通道首次出现时分配）
+     */
+    explicit MultiChannelHistory(int capacityPerChannel)
+        : m_capacity(capacityPerChannel)
+    {
+        clear();
+    }
+
+    /**
+     * @brief 通道对应的槽位
+     * @return 0~3 对应 CH1~CH4，未区分通道时返回 -1
+     */
+    static int slotOf(Measurement::Channel channel)
+    {
+        switch (channel) {
+        case Measurement::Channel::CH1: return 0;
+        case Measurement::Channel::CH2: return 1;
+        case Measurement::Channel::CH3: return 2;
+        case Measurement::Channel::CH4: return 3;
+        default: return -1;
+        }
+    }
+
+    /**
+     * @brief 清空所有通道（保留已分配内存）
+     */
+    void clear()
+    {
+        for (int slot = 0; slot < kChannelCount; ++slot) {
+            if (m_channels[slot]) {
+                m_channels[slot]->clear();
+            }
+            m_present[slot] = false;
+            m_offsets[slot] = 0;
+            m_lastValues[slot] = 0.0;
+        }
+        m_scanCount = 0;
+        m_lastSlot = kChannelCount;
+        m_primarySlot = -1;
+    }
+
+    /**
+     * @brief 追加一个样本
+     * @param slot 通道槽位（0~3）
+     * @param value 测量值
+     */
+    void append(int slot, double value)
+    {
+        if (slot < 0 || slot >= kChannelCount) {
+            return;
+        }
+
+        // 通道码不递增：上一次扫描已结束
+        if (slot <= m_lastSlot) {
+            ++m_scanCount;
+        }
+        m_lastSlot = slot;
+
+        if (!m_present[slot]) {
+            if (!m_channels[slot]) {
+                m_channels[slot].reset(new SampleHistory(m_capacity));
+            }
+            m_present[slot] = true;
+            m_offsets[slot] = m_scanCount - 1;
+            if (m_primarySlot < 0) {
+                m_primarySlot = slot;
+            }
+        }
+
+        m_channels[slot]->append(value);
+        m_lastValues[slot] = value;
+    }
+
+    /**
+     * @brief 是否没有任何通道的样本
+     */
+    bool isEmpty() const { return m_primarySlot < 0; }
+
+    /**
+     * @brief 通道是否有样本
+     */
+    bool hasChannel(int slot) const { return slot >= 0 && slot < kChannelCount && m_present[slot]; }
+
+    /**
+     * @brief 通道的样本历史（调用方保证 hasChannel(slot)）
+     */
+    const SampleHistory &channel(int slot) const { return *m_channels[slot]; }
+
+    /**
+     * @brief 通道首次出现时的扫描序号（X 坐标偏移）
+     */
+    qint64 offset(int slot) const { return m_offsets[slot]; }
+
+    /**
+     * @brief 通道最新的测量值
+     */
+    double lastValue(int slot) const { return m_lastValues[slot]; }
+
+    /**
+     * @brief 主通道槽位（清空后第一个出现的通道，没有样本时为 -1）
+     */
+    int primarySlot() const { return m_primarySlot; }
+
+    /**
+     * @brief 累计扫描次数
+     */
+    qint64 scanCount() const { return m_scanCount; }
+
+private:
+    int m_capacity;                                         ///< 每个通道的容量
+    QScopedPointer<SampleHistory> m_channels[kChannelCount]; ///< 各通道的样本历史（首次出现时分配）
+    bool m_present[kChannelCount];                          ///< 清空后通道是否出现过
+    qint64 m_offsets[kChannelCount];                        ///< 各通道首次出现时的扫描序号
+    double m_lastValues[kChannelCount];                     ///< 各通道最新的测量值
+    qint64 m_scanCount;                                     ///< 累计扫描次数
+    int m_lastSlot;                                         ///< 上一个样本的槽位（判定扫描边界）
+    int m_primarySlot;                                      ///< 主通道槽位
+};
+
+#endif // MULTICHANNELHISTORY_H
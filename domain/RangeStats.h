@@ -0,0 +1,68 @@
+#ifndef RANGESTATS_H
+#define RANGESTATS_H
+
+#include <QtGlobal>
+#include <cmath>
+
+/**
+ * @brief 区间统计（样本数、均值、标准差、最小值、最大值）
+ *
+ * 以 (count, mean, M2) 保存，合并使用 Chan 的并行公式：
+ * 不依赖大数前缀和相减，长时间采集中睡眠电流这类小量级区间的方差也不会被抵消掉。
+ */
+struct RangeStats {
+    qint64 count;       ///< 样本数
+    double mean;        ///< 均值
+    double m2;          ///< 离差平方和 Σ(x-mean)²
+    double min;         ///< 最小值
+    double max;         ///< 最大值
+
+    RangeStats() : count(0), mean(0.0), m2(0.0), min(0.0), max(0.0) {}
+
+    bool isEmpty() const { return count == 0; }
+
+    /**
+     * @brief 总体标准差（样本数不足2时为0）
+     */
+    double stdDev() const { return count > 1 ? std::sqrt(m2 / count) : 0.0; }
+
+    /**
+     * @brief 追加一个样本（Welford）
+     */
+    void add(double value)
+    {
+        if (count == 0) {
+            min = max = value;
+        } else {
+            min = qMin(min, value);
+            max = qMax(max, value);
+        }
+        ++count;
+        const double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    /**
+     * @brief 合并另一段的统计
+     */
+    void merge(const RangeStats &other)
+    {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        const qint64 total = count + other.count;
+        const double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+        min = qMin(min, other.min);
+        max = qMax(max, other.max);
+        count = total;
+    }
+};
+
+#endif // RANGESTATS_H
@@ -0,0 +1,278 @@
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include <QVector>
+#include <QPointF>
+#include <QtGlobal>
+#include "domain/RangeStats.h"
+
+/**
+ * @brief 测量样本历史（预分配的环形存储）
+ *
+ * 职责：
+ * - 按到达顺序保存测量值，容量固定，写满后覆盖最旧的样本
+ * - 样本使用全局序号访问（从0开始单调递增，不受覆盖影响）
+ * - 提供按绘图宽度的 min/max 抽稀，供图表一次性 replace() 刷新
+ * - 提供任意区间的均值/标准差/最小值/最大值/样本数（区间统计索引）
+ *
+ * 与直接使用 QLineSeries 保存数据相比，追加样本不会触发曲线重绘，
+ * 也不需要 removePoints(0, n) 的整体搬移。
+ *
+ * 区间统计索引：存储按 kBlockSize 个样本分块，每写满一块计算一次块统计，
+ * 放入按块槽位建立的线段树（容量 2M 样本时约 2.6MB）。查询只扫描两端不完整的块（≤2*kBlockSize 个样本），
+ * 中间的整块走线段树合并，耗时与区间长度无关。块统计以均值/离差平方和合并（见 RangeStats），
+ * 不使用前缀和相减，长时间采集中的小电流区间同样精确。
+ */
+class SampleHistory
+{
+public:
+    static constexpr int kBlockSize = 64;  ///< 区间统计的分块大小（样本数）
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最大保存样本数（构造时一次性分配，向上取整为 kBlockSize 的倍数）
+     */
+    explicit SampleHistory(int capacity)
+        : m_values(alignedCapacity(capacity))
+        , m_capacity(alignedCapacity(capacity))
+        , m_total(0)
+        , m_blockCount(m_capacity / kBlockSize)
+        , m_treeBase(treeBaseFor(m_blockCount))
+        , m_tree(2 * m_treeBase)
+    {}
+
+    /**
+     * @brief 清空所有样本（保留已分配内存）
+     */
+    void clear()
+    {
+        m_total = 0;
+        m_tree.fill(RangeStats());
+    }
+
+    /**
+     * @brief 追加一个样本
+     */
+    void append(double value)
+    {
+        const int slot = static_cast<int>(m_total % m_capacity);
+        if (slot % kBlockSize == 0 && m_total >= m_capacity) {
+            // 开始覆盖最旧的块：该块不再完整，改为查询时直接扫描
+            setBlockStats(slot / kBlockSize, RangeStats());
+        }
+
+        m_values[slot] = static_cast<float>(value);
+        ++m_total;
+
+        if (m_total % kBlockSize == 0) {
+            const int blockStart = slot + 1 - kBlockSize;
+            RangeStats stats;
+            for (int i = blockStart; i <= slot; ++i) {
+                stats.add(m_values[i]);
+            }
+            setBlockStats(slot / kBlockSize, stats);
+        }
+    }
+
+    /**
+     * @brief 累计追加过的样本总数（包含已被覆盖的样本）
+     */
+    qint64 totalCount() const { return m_total; }
+
+    /**
+     * @brief 当前仍保存的最旧样本序号
+     */
+    qint64 firstIndex() const { return qMax<qint64>(0, m_total - m_capacity); }
+
+    /**
+     * @brief 当前保存的样本数
+     */
+    int size() const { return static_cast<int>(m_total - firstIndex()); }
+
+    /**
+     * @brief 样本容量
+     */
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief 指定序号的样本是否仍在存储中
+     */
+    bool contains(qint64 index) const
+    {
+        return index >= firstIndex() && index < m_total;
+    }
+
+    /**
+     * @brief 读取指定序号的样本（调用方保证 contains(index)）
+     */
+    double at(qint64 index) const
+    {
+        return m_values[static_cast<int>(index % m_capacity)];
+    }
+
+    /**
+     * @brief 按桶做 min/max 抽稀，生成绘图点
+     * @param first 起始样本序号（含）
+     * @param last 结束样本序号（含）
+     * @param buckets 桶数（通常等于绘图区宽度像素数）
+     * @param[out] out 输出点集，X 为"测量次数"（序号+1+xOffset），Y 为测量值
+     * @param xOffset X 坐标偏移（多通道曲线按通道首次出现的扫描序号对齐）
+     *
+     * 样本数不超过 2*buckets 时原样输出；否则每个桶输出最小值和最大值两个点，
+     * 并按出现顺序排列，保证尖峰不会因抽稀而丢失。
+     */
+    void decimateMinMax(qint64 first, qint64 last, int buckets, QVector<QPointF> &out, qint64 xOffset = 0) const
+    {
+        out.clear();
+
+        first = qMax(first, firstIndex());
+        last = qMin(last, m_total - 1);
+        if (last < first || buckets <= 0) {
+            return;
+        }
+
+        const qint64 count = last - first + 1;
+        if (count <= 2 * static_cast<qint64>(buckets)) {
+            out.reserve(static_cast<int>(count));
+            for (qint64 i = first; i <= last; ++i) {
+                out.append(QPointF(static_cast<double>(i + 1 + xOffset), at(i)));
+            }
+            return;
+        }
+
+        out.reserve(2 * buckets);
+        for (int b = 0; b < buckets; ++b) {
+            const qint64 begin = first + count * b / buckets;
+            const qint64 end = first + count * (b + 1) / buckets;   // 不含
+            if (end <= begin) {
+                continue;
+            }
+
+            qint64 minIndex = begin;
+            qint64 maxIndex = begin;
+            double minValue = at(begin);
+            double maxValue = minValue;
+            for (qint64 i = begin + 1; i < end; ++i) {
+                const double v = at(i);
+                if (v < minValue) {
+                    minValue = v;
+                    minIndex = i;
+                } else if (v > maxValue) {
+                    maxValue = v;
+                    maxIndex = i;
+                }
+            }
+
+            if (minIndex <= maxIndex) {
+                out.append(QPointF(static_cast<double>(minIndex + 1 + xOffset), minValue));
+                if (maxIndex != minIndex) {
+                    out.append(QPointF(static_cast<double>(maxIndex + 1 + xOffset), maxValue));
+                }
+            } else {
+                out.append(QPointF(static_cast<double>(maxIndex + 1 + xOffset), maxValue));
+                out.append(QPointF(static_cast<double>(minIndex + 1 + xOffset), minValue));
+            }
+        }
+    }
+
+    /**
+     * @brief 区间统计
+     * @param first 起始样本序号（含）
+     * @param last 结束样本序号（含）
+     * @return 区间内仍在存储中的样本的统计（没有样本时 isEmpty()）
+     */
+    RangeStats rangeStats(qint64 first, qint64 last) const
+    {
+        RangeStats stats;
+        first = qMax(first, firstIndex());
+        last = qMin(last, m_total - 1);
+        if (last < first) {
+            return stats;
+        }
+
+        const qint64 firstBlock = first / kBlockSize;
+        const qint64 lastBlock = last / kBlockSize;
+        if (firstBlock == lastBlock) {
+            scan(first, last, stats);
+            return stats;
+        }
+
+        // 两端不完整的块直接扫描，中间的整块（均已写满且未被覆盖）查线段树
+        scan(first, (firstBlock + 1) * kBlockSize - 1, stats);
+        scan(lastBlock * kBlockSize, last, stats);
+        if (lastBlock - firstBlock > 1) {
+            const int firstSlot = static_cast<int>((firstBlock + 1) % m_blockCount);
+            const int lastSlot = static_cast<int>((lastBlock - 1) % m_blockCount);
+            if (firstSlot <= lastSlot) {
+                queryBlocks(firstSlot, lastSlot, stats);
+            } else {
+                queryBlocks(firstSlot, m_blockCount - 1, stats);
+                queryBlocks(0, lastSlot, stats);
+            }
+        }
+        return stats;
+    }
+
+private:
+    static int alignedCapacity(int capacity)
+    {
+        return (qMax(1, capacity) + kBlockSize - 1) / kBlockSize * kBlockSize;
+    }
+
+    static int treeBaseFor(int blockCount)
+    {
+        int base = 1;
+        while (base < blockCount) {
+            base <<= 1;
+        }
+        return base;
+    }
+
+    /**
+     * @brief 更新一个块槽位的统计并向上重算父节点
+     */
+    void setBlockStats(int block, const RangeStats &stats)
+    {
+        int node = m_treeBase + block;
+        m_tree[node] = stats;
+        for (node >>= 1; node >= 1; node >>= 1) {
+            m_tree[node] = m_tree[2 * node];
+            m_tree[node].merge(m_tree[2 * node + 1]);
+        }
+    }
+
+    /**
+     * @brief 合并块槽位 [firstSlot, lastSlot] 的统计
+     */
+    void queryBlocks(int firstSlot, int lastSlot, RangeStats &stats) const
+    {
+        int left = m_treeBase + firstSlot;
+        int right = m_treeBase + lastSlot + 1;
+        while (left < right) {
+            if (left & 1) {
+                stats.merge(m_tree[left++]);
+            }
+            if (right & 1) {
+                stats.merge(m_tree[--right]);
+            }
+            left >>= 1;
+            right >>= 1;
+        }
+    }
+
+    void scan(qint64 first, qint64 last, RangeStats &stats) const
+    {
+        for (qint64 i = first; i <= last; ++i) {
+            stats.add(at(i));
+        }
+    }
+
+    QVector<float> m_values;    ///< 环形存储区
+    int m_capacity;             ///< 容量（kBlockSize 的倍数）
+    qint64 m_total;             ///< 累计样本数
+    int m_blockCount;           ///< 块槽位数
+    int m_treeBase;             ///< 线段树叶子起始下标（≥块槽位数的2的幂）
+    QVector<RangeStats> m_tree; ///< 块统计线段树（1为根，叶子按块槽位排列）
+};
+
+#endif // SAMPLEHISTORY_H
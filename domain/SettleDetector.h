@@ -0,0 +1,249 @@
+#ifndef SETTLEDETECTOR_H
+#define SETTLEDETECTOR_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <cmath>
+
+/**
+ * @brief 电流稳定判定器（自适应 CheckCurrent 使用）
+ *
+ * 职责：
+ * - 在最近 N 个样本的滑动窗口上维护均值、残差方差和线性斜率（每个样本 O(1) 更新）
+ * - 读数已稳定（窗口内漂移小于容差）且置信地落在阈值内/外时立即给出判定
+ * - 读数仍在向通过方向变化（如关机电流衰减）且已置信地通过时，不必等到完全稳定
+ * - 达到最长等待时间仍未判定时，由调用方用 fallbackDecision() 按窗口均值判定
+ *
+ * 时间轴使用样本序号：下位机以固定频率采样，按序号计算斜率不受批量到达的时间戳影响。
+ */
+class SettleDetector
+{
+public:
+    /**
+     * @brief 判定结果
+     */
+    enum class Decision {
+        Pending,    ///< 尚不能判定，继续采样
+        Pass,       ///< 通过
+        Fail        ///< 未通过
+    };
+
+    /**
+     * @brief 判定参数
+     */
+    struct Config {
+        int windowSize;             ///< 滑动窗口样本数（窗口未满时不判定）
+        double confidenceSigma;     ///< 置信系数（均值距阈值超过 k 倍标准误差才判定）
+        double settleTolerance;     ///< 稳定容差（窗口内漂移不超过 |阈值| 的比例）
+
+        Config() : windowSize(20), confidenceSigma(3.0), settleTolerance(0.02) {}
+    };
+
+    SettleDetector() : m_threshold(0.0), m_isUpperLimit(true) { reset(); }
+
+    /**
+     * @brief 开始一次新的判定
+     * @param threshold 电流阈值
+     * @param isUpperLimit true: <=阈值为Pass; false: >=阈值为Pass
+     * @param config 判定参数
+     */
+    void start(double threshold, bool isUpperLimit, const Config &config = Config())
+    {
+        m_threshold = threshold;
+        m_isUpperLimit = isUpperLimit;
+        m_config = config;
+        m_config.windowSize = qMax(3, m_config.windowSize);
+        reset();
+    }
+
+    /**
+     * @brief 清空样本（保留阈值和参数，如暂停恢复后重新采样）
+     */
+    void reset()
+    {
+        m_window.fill(0.0, m_config.windowSize);
+        m_head = 0;
+        m_count = 0;
+        m_totalSamples = 0;
+        m_sumY = 0.0;
+        m_sumYY = 0.0;
+        m_sumXY = 0.0;
+    }
+
+    /**
+     * @brief 加入一个样本并尝试判定
+     * @param value 测量值（与阈值同单位）
+     */
+    Decision addSample(double value)
+    {
+        const int n = m_config.windowSize;
+
+        if (m_count == n) {
+            // 移除最旧样本（x=0），其余样本 x 减 1：Σxy -= Σy
+            const double oldest = m_window.at(m_head);
+            m_sumY -= oldest;
+            m_sumYY -= oldest * oldest;
+            m_sumXY -= m_sumY;
+            --m_count;
+        }
+
+        m_window[m_head] = value;
+        m_sumXY += m_count * value;
+        m_sumY += value;
+        m_sumYY += value * value;
+        ++m_count;
+        ++m_totalSamples;
+        m_head = (m_head + 1) % n;
+
+        // 窗口每转一圈重新精确求和，避免增量更新的舍入误差累积
+        if (m_head == 0 && m_count == n) {
+            recomputeSums();
+        }
+
+        return evaluate();
+    }
+
+    /**
+     * @brief 按当前窗口重新判定（不加入新样本）
+     */
+    Decision evaluate() const
+    {
+        if (m_count < m_config.windowSize) {
+            return Decision::Pending;
+        }
+
+        // 统一为"偏差 <= 0 为通过"：上限时为 均值-阈值，下限时为 阈值-均值
+        const double sign = m_isUpperLimit ? 1.0 : -1.0;
+        const double deviation = sign * (mean() - m_threshold);
+        const double margin = m_config.confidenceSigma * standardError();
+        const bool settled = isSettled();
+        const bool towardsPass = sign * slope() <= 0.0;
+
+        if (deviation + margin <= 0.0 && (settled || towardsPass)) {
+            return Decision::Pass;
+        }
+        if (deviation - margin > 0.0 && settled) {
+            return Decision::Fail;
+        }
+        return Decision::Pending;
+    }
+
+    /**
+     * @brief 达到最长等待时间时的兜底判定（窗口均值直接与阈值比较）
+     * @return 没有样本时返回 Pending
+     */
+    Decision fallbackDecision() const
+    {
+        if (m_count == 0) {
+            return Decision::Pending;
+        }
+        const bool passed = m_isUpperLimit ? (mean() <= m_threshold) : (mean() >= m_threshold);
+        return passed ? Decision::Pass : Decision::Fail;
+    }
+
+    /**
+     * @brief 窗口内漂移是否小于容差
+     */
+    bool isSettled() const
+    {
+        if (m_count < 2) {
+            return false;
+        }
+        const double drift = std::fabs(slope()) * (m_count - 1);
+        return drift <= tolerance();
+    }
+
+    int windowCount() const { return m_count; }
+    int totalSamples() const { return m_totalSamples; }
+    double threshold() const { return m_threshold; }
+
+    /**
+     * @brief 窗口均值
+     */
+    double mean() const { return m_count > 0 ? m_sumY / m_count : 0.0; }
+
+    /**
+     * @brief 窗口内线性拟合斜率（每个样本的变化量）
+     */
+    double slope() const
+    {
+        const double sxx = centeredSumXX();
+        if (sxx <= 0.0) {
+            return 0.0;
+        }
+        return centeredSumXY() / sxx;
+    }
+
+    /**
+     * @brief 去除线性趋势后的残差标准差
+     */
+    double residualStdDev() const
+    {
+        if (m_count < 3) {
+            return 0.0;
+        }
+        const double syy = m_sumYY - m_sumY * m_sumY / m_count;
+        const double sxx = centeredSumXX();
+        const double sxy = centeredSumXY();
+        const double residual = sxx > 0.0 ? syy - sxy * sxy / sxx : syy;
+        return std::sqrt(qMax(0.0, residual / (m_count - 2)));
+    }
+
+    /**
+     * @brief 均值的标准误差
+     */
+    double standardError() const
+    {
+        return m_count > 0 ? residualStdDev() / std::sqrt(static_cast<double>(m_count)) : 0.0;
+    }
+
+private:
+    double tolerance() const
+    {
+        const double minTolerance = 1e-6;   // 阈值为0时的最小稳定容差
+        return qMax(std::fabs(m_threshold) * m_config.settleTolerance, minTolerance);
+    }
+
+    // 窗口内 x = 0..count-1：Σx = n(n-1)/2，Σx² = (n-1)n(2n-1)/6
+    double centeredSumXX() const
+    {
+        const double n = m_count;
+        const double sumX = n * (n - 1) / 2.0;
+        const double sumXX = (n - 1) * n * (2 * n - 1) / 6.0;
+        return n > 0 ? sumXX - sumX * sumX / n : 0.0;
+    }
+
+    double centeredSumXY() const
+    {
+        const double n = m_count;
+        const double sumX = n * (n - 1) / 2.0;
+        return n > 0 ? m_sumXY - sumX * m_sumY / n : 0.0;
+    }
+
+    void recomputeSums()
+    {
+        m_sumY = 0.0;
+        m_sumYY = 0.0;
+        m_sumXY = 0.0;
+        // m_head 指向最旧样本
+        for (int x = 0; x < m_count; ++x) {
+            const double y = m_window.at((m_head + x) % m_config.windowSize);
+            m_sumY += y;
+            m_sumYY += y * y;
+            m_sumXY += x * y;
+        }
+    }
+
+    Config m_config;            ///< 判定参数
+    double m_threshold;         ///< 阈值
+    bool m_isUpperLimit;        ///< 阈值类型
+    QVector<double> m_window;   ///< 滑动窗口（环形缓冲区）
+    int m_head;                 ///< 下一个写入位置（窗口满时即最旧样本）
+    int m_count;                ///< 窗口内样本数
+    int m_totalSamples;         ///< 本次判定收到的样本总数
+    double m_sumY;              ///< Σy
+    double m_sumYY;             ///< Σy²
+    double m_sumXY;             ///< Σxy（x 为窗口内序号，最旧样本为0）
+};
+
+#endif // SETTLEDETECTOR_H
@@ -68,6 +68,10 @@ struct SubAction {
     // 电流检测参数（CheckCurrent用）
     double currentThreshold;    ///< 电流阈值（单位：默认mA）
     bool isUpperLimit;          ///< true: <=阈值为Pass; false: >=阈值为Pass
+    bool adaptiveSettle;        ///< true: 读数稳定即判定（自适应）；false: 取第一个样本判定
+    int settleMaxWaitMs;        ///< 自适应判定的最长等待时间（毫秒），到时按窗口均值判定
+    int settleMinWaitMs;        ///< 判定前的最短等待时间（毫秒），此前的样本不参与判定（如等待负载接通）
+    int settleWindowSamples;    ///< 自适应判定的滑动窗口样本数
     
     // 用户交互参数（UserConfirm用）
     QString confirmMessage;     ///< 弹窗提示信息
@@ -76,6 +80,10 @@ struct SubAction {
     uint8_t openV1Channel;      ///< 要开启的V1通道
     uint8_t openV4Channel;      ///< 要开启的V4通道（0x04）
     
+    // 调度参数（所有类型）
+    int gapMs;                  ///< 本动作完成后到下一动作开始的间隔（毫秒），-1 表示使用默认值
+    int group;                  ///< 并行组号：相邻且组号相同（>=0）的动作同时执行，全部完成后再继续；-1 表示顺序执行
+    
     /**
      * @brief 默认构造函数
      */
@@ -88,8 +96,14 @@ struct SubAction {
         , delayMs(0)
         , currentThreshold(0.0)
         , isUpperLimit(true)
+        , adaptiveSettle(false)
+        , settleMaxWaitMs(8000)
+        , settleMinWaitMs(0)
+        , settleWindowSamples(20)
         , openV1Channel(0x01)
         , openV4Channel(0x04)
+        , gapMs(-1)
+        , group(-1)
     {}
     
     // ========== 静态工厂方法构造子动作 ==========
@@ -123,6 +137,21 @@ struct SubAction {
         action.isUpperLimit = upperLimit;
         return action;
     }
+
+    /**
+     * @brief 创建自适应电流检测子动作（替代"固定延时 + 电流检测"）
+     * @param threshold 电流阈值
+     * @param upperLimit true表示 <=threshold 为Pass
+     * @param maxWaitMs 最长等待时间，读数提前稳定时提前判定
+     * @param minWaitMs 最短等待时间（业务延时），此前即使读数稳定也不判定
+     */
+    static SubAction createAdaptiveCheckCurrent(double threshold, bool upperLimit, int maxWaitMs, int minWaitMs = 0) {
+        SubAction action = createCheckCurrent(threshold, upperLimit);
+        action.adaptiveSettle = true;
+        action.settleMaxWaitMs = maxWaitMs;
+        action.settleMinWaitMs = minWaitMs;
+        return action;
+    }
     
     /**
      * @brief 创建按键模拟子动作
@@ -213,9 +242,19 @@ struct SubAction {
         obj["delayMs"] = delayMs;
         obj["currentThreshold"] = currentThreshold;
         obj["isUpperLimit"] = isUpperLimit;
+        obj["adaptiveSettle"] = adaptiveSettle;
+        obj["settleMaxWaitMs"] = settleMaxWaitMs;
+        obj["settleMinWaitMs"] = settleMinWaitMs;
+        obj["settleWindowSamples"] = settleWindowSamples;
         obj["confirmMessage"] = confirmMessage;
         obj["openV1Channel"] = openV1Channel;
         obj["openV4Channel"] = openV4Channel;
+        if (gapMs >= 0) {
+            obj["gapMs"] = gapMs;
+        }
+        if (group >= 0) {
+            obj["group"] = group;
+        }
         return obj;
     }
     
@@ -232,9 +271,15 @@ struct SubAction {
         action.delayMs = obj["delayMs"].toInt();
         action.currentThreshold = obj["currentThreshold"].toDouble();
         action.isUpperLimit = obj["isUpperLimit"].toBool(true);
+        action.adaptiveSettle = obj["adaptiveSettle"].toBool(false);
+        action.settleMaxWaitMs = obj["settleMaxWaitMs"].toInt(8000);
+        action.settleMinWaitMs = obj["settleMinWaitMs"].toInt(0);
+        action.settleWindowSamples = obj["settleWindowSamples"].toInt(20);
         action.confirmMessage = obj["confirmMessage"].toString();
         action.openV1Channel = static_cast<uint8_t>(obj["openV1Channel"].toInt());
         action.openV4Channel = static_cast<uint8_t>(obj["openV4Channel"].toInt());
+        action.gapMs = obj["gapMs"].toInt(-1);
+        action.group = obj["group"].toInt(-1);
         return action;
     }
 };
@@ -0,0 +1,202 @@
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief 流式分位数估计（合并式 t-digest）
+ *
+ * 职责：
+ * - 固定内存汇总任意数量的样本：质心数不超过约 compression 个，另有 5×compression 个样本的缓冲
+ * - 按分位数查询（p1/p50/p99 等），两端尾部精度最高（k1 尺度函数，质心在 q≈0/1 附近最小）
+ * - 添加为均摊 O(1)，缓冲满时排序合并一次
+ *
+ * 查询时会先合并缓冲，缓冲和质心表因此声明为 mutable，对外行为仍是只读的。
+ */
+class TDigest
+{
+public:
+    static constexpr int kDefaultCompression = 100;     ///< 默认压缩参数（质心数上限约等于该值）
+
+    explicit TDigest(int compression = kDefaultCompression)
+        : m_compression(qMax(20, compression))
+        , m_totalWeight(0.0)
+        , m_sum(0.0)
+        , m_min(std::numeric_limits<double>::infinity())
+        , m_max(-std::numeric_limits<double>::infinity())
+    {
+        m_buffer.reserve(bufferCapacity());
+    }
+
+    /**
+     * @brief 添加一个样本（非有限值忽略）
+     */
+    void add(double value)
+    {
+        if (!std::isfinite(value)) {
+            return;
+        }
+        m_buffer.append(value);
+        m_totalWeight += 1.0;
+        m_sum += value;
+        m_min = qMin(m_min, value);
+        m_max = qMax(m_max, value);
+
+        if (m_buffer.size() >= bufferCapacity()) {
+            compress();
+        }
+    }
+
+    /**
+     * @brief 清空所有样本
+     */
+    void reset()
+    {
+        m_centroids.clear();
+        m_buffer.clear();
+        m_totalWeight = 0.0;
+        m_sum = 0.0;
+        m_min = std::numeric_limits<double>::infinity();
+        m_max = -std::numeric_limits<double>::infinity();
+    }
+
+    quint64 count() const { return static_cast<quint64>(m_totalWeight); }
+    double minValue() const { return m_totalWeight > 0 ? m_min : 0.0; }
+    double maxValue() const { return m_totalWeight > 0 ? m_max : 0.0; }
+    double mean() const { return m_totalWeight > 0 ? m_sum / m_totalWeight : 0.0; }
+
+    /**
+     * @brief 当前质心数（诊断用）
+     */
+    int centroidCount() const
+    {
+        compress();
+        return m_centroids.size();
+    }
+
+    /**
+     * @brief 分位数对应的值
+     * @param q 分位数（0~1）
+     * @return 估计值，限制在 [min, max] 内；无样本时返回0
+     */
+    double quantile(double q) const
+    {
+        compress();
+        if (m_centroids.isEmpty()) {
+            return 0.0;
+        }
+        if (m_centroids.size() == 1) {
+            return m_centroids.first().mean;
+        }
+
+        q = qBound(0.0, q, 1.0);
+        const double index = q * m_totalWeight;
+
+        // 第一个质心中心以左：在 min 与质心均值之间插值
+        const Centroid &first = m_centroids.first();
+        if (index < first.weight / 2.0) {
+            return m_min + (first.mean - m_min) * (index / (first.weight / 2.0));
+        }
+
+        // 相邻质心中心之间线性插值
+        double weightSoFar = first.weight / 2.0;
+        for (int i = 0; i + 1 < m_centroids.size(); ++i) {
+            const Centroid &left = m_centroids.at(i);
+            const Centroid &right = m_centroids.at(i + 1);
+            const double span = (left.weight + right.weight) / 2.0;
+            if (weightSoFar + span > index) {
+                const double t = (index - weightSoFar) / span;
+                return left.mean + t * (right.mean - left.mean);
+            }
+            weightSoFar += span;
+        }
+
+        // 最后一个质心中心以右：在质心均值与 max 之间插值
+        const Centroid &last = m_centroids.last();
+        const double tail = (index - weightSoFar) / (last.weight / 2.0);
+        return last.mean + (m_max - last.mean) * qMin(1.0, tail);
+    }
+
+private:
+    /**
+     * @brief 质心（均值 + 权重）
+     */
+    struct Centroid {
+        double mean;
+        double weight;
+
+        bool operator<(const Centroid &other) const { return mean < other.mean; }
+    };
+
+    int bufferCapacity() const { return m_compression * 5; }
+
+    /**
+     * @brief k1 尺度函数：k(q) = δ/(2π)·asin(2q−1)
+     */
+    double scale(double q) const
+    {
+        return m_compression / (2.0 * 3.14159265358979323846) * std::asin(2.0 * q - 1.0);
+    }
+
+    /**
+     * @brief 将缓冲的样本并入质心表
+     *
+     * 质心和新样本按均值排序后顺序合并：只要合并后质心覆盖的 k 值跨度不超过 1 就继续合并，
+     * 因此质心数受 compression 限制，与样本总数无关。
+     */
+    void compress() const
+    {
+        if (m_buffer.isEmpty()) {
+            return;
+        }
+
+        QVector<Centroid> all;
+        all.reserve(m_centroids.size() + m_buffer.size());
+        all += m_centroids;
+        for (double value : m_buffer) {
+            Centroid c;
+            c.mean = value;
+            c.weight = 1.0;
+            all.append(c);
+        }
+        m_buffer.clear();
+        std::sort(all.begin(), all.end());
+
+        QVector<Centroid> merged;
+        merged.reserve(m_compression * 2);
+
+        Centroid current = all.first();
+        double weightSoFar = 0.0;
+        double kLeft = scale(0.0);
+        for (int i = 1; i < all.size(); ++i) {
+            const Centroid &next = all.at(i);
+            const double qRight = (weightSoFar + current.weight + next.weight) / m_totalWeight;
+            if (scale(qMin(1.0, qRight)) - kLeft <= 1.0) {
+                const double weight = current.weight + next.weight;
+                current.mean += (next.mean - current.mean) * next.weight / weight;
+                current.weight = weight;
+            } else {
+                merged.append(current);
+                weightSoFar += current.weight;
+                kLeft = scale(qMin(1.0, weightSoFar / m_totalWeight));
+                current = next;
+            }
+        }
+        merged.append(current);
+        m_centroids.swap(merged);
+    }
+
+    int m_compression;                      ///< 压缩参数 δ
+    mutable QVector<Centroid> m_centroids;  ///< 质心表（按均值升序）
+    mutable QVector<double> m_buffer;       ///< 尚未合并的样本
+    double m_totalWeight;                   ///< 样本总数（含缓冲）
+    double m_sum;                           ///< 样本和
+    double m_min;                           ///< 最小值
+    double m_max;                           ///< 最大值
+};
+
+#endif // TDIGEST_H
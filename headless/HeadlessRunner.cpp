@@ -0,0 +1,454 @@
+#include "HeadlessRunner.h"
+#include "SerialPortService.h"
+#include "DeviceController.h"
+#include "app/TestSequenceRunner.h"
+#include "app/PlanCompiler.h"
+#include "app/CycleTimeProfiler.h"
+#include "storage/ErrorRecordStore.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTextStream>
+#include <QTimer>
+#include <cstdio>
+
+namespace {
+
+QJsonObject errorToJson(const ErrorRecord &record)
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("time"), record.timestamp.toString(Qt::ISODateWithMs));
+    object.insert(QStringLiteral("step_index"), record.stepIndex);
+    object.insert(QStringLiteral("step_name"), record.stepName);
+    object.insert(QStringLiteral("action_index"), record.actionIndex);
+    object.insert(QStringLiteral("action"), record.actionDescription);
+    object.insert(QStringLiteral("error_type"), record.errorType);
+    object.insert(QStringLiteral("detail"), record.errorDetail);
+    object.insert(QStringLiteral("measured"), record.measuredValue);
+    object.insert(QStringLiteral("threshold"), record.thresholdValue);
+    return object;
+}
+
+/**
+ * @brief 文本行追加到文件（文件为空时先写表头）
+ */
+bool appendLines(const QString &path, const QString &header, const QStringList &lines, QString *errorString)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        *errorString = file.errorString();
+        return false;
+    }
+    QByteArray text;
+    if (file.size() == 0 && !header.isEmpty()) {
+        text += header.toUtf8() + '\n';
+    }
+    for (const QString &line : lines) {
+        text += line.toUtf8() + '\n';
+    }
+    file.write(text);
+    return true;
+}
+
+bool isAffirmative(const QString &answer)
+{
+    const QString text = answer.trimmed().toLower();
+    return text == QLatin1String("y") || text == QLatin1String("yes") ||
+           text == QLatin1String("1") || text == QLatin1String("pass") ||
+           text == QLatin1String("ok");
+}
+
+} // namespace
+
+HeadlessRunner::HeadlessRunner(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_serialPortService(new SerialPortService())
+    , m_deviceController(new DeviceController(m_serialPortService.data()))
+    , m_runner(new TestSequenceRunner(m_deviceController.data()))
+    , m_iteration(0)
+    , m_completed(false)
+{
+    if (m_options.fixtureName.isEmpty()) {
+        m_options.fixtureName = m_options.portName;
+    }
+    if (!m_options.resultPath.isEmpty()) {
+        m_errorRecordStore.reset(new ErrorRecordStore(m_options.resultPath));
+        connect(m_errorRecordStore.data(), &ErrorRecordStore::errorOccurred,
+                this, &HeadlessRunner::onLogMessage);
+    }
+
+    connect(m_deviceController.data(), &DeviceController::logMessage,
+            this, &HeadlessRunner::onLogMessage);
+    connect(m_deviceController.data(), &DeviceController::connectionStatusChanged,
+            this, &HeadlessRunner::onConnectionStatusChanged);
+    connect(m_runner.data(), &TestSequenceRunner::logMessage,
+            this, &HeadlessRunner::onLogMessage);
+    connect(m_runner.data(), &TestSequenceRunner::userConfirmRequired,
+            this, &HeadlessRunner::onUserConfirmRequired);
+    connect(m_runner.data(), &TestSequenceRunner::sequenceFinished,
+            this, &HeadlessRunner::onSequenceFinished);
+    connect(m_runner.data(), &TestSequenceRunner::errorRecorded,
+            this, [this](const ErrorRecord &record) {
+        m_errors.append(record);
+        if (m_errorRecordStore) {
+            m_errorRecordStore->append(record);
+        }
+    });
+
+    if (!m_options.profilePath.isEmpty() || !m_options.flamePath.isEmpty()) {
+        // 在循环控制器之前创建：最后一次运行的分解先于循环汇总写出
+        m_profiler.reset(new CycleTimeProfiler(m_runner.data()));
+        connect(m_profiler.data(), &CycleTimeProfiler::runProfiled,
+                this, [this](const CycleTimeProfiler::RunProfile &profile) {
+            onLogMessage(tr("耗时分解: %1").arg(CycleTimeProfiler::describe(profile.total)));
+            writeProfile(CycleTimeProfiler::runCsvLines(profile), CycleTimeProfiler::runFoldedLines(profile));
+        });
+    }
+
+    if (m_options.isSoak()) {
+        // 在上面的连接之后创建：每次循环先由 onSequenceFinished 输出该次汇总，再由循环控制器计数
+        m_soak.reset(new SoakController(m_runner.data()));
+        connect(m_soak.data(), &SoakController::logMessage, this, &HeadlessRunner::onLogMessage);
+        connect(m_soak.data(), &SoakController::reportReady, this, &HeadlessRunner::onSoakReport);
+        connect(m_soak.data(), &SoakController::finished, this, &HeadlessRunner::onSoakFinished);
+        connect(m_soak.data(), &SoakController::iterationStarted, this, [this](qint64 iteration) {
+            m_iteration = iteration;
+            m_errors.clear();
+            m_elapsed.start();
+        });
+    }
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    // 析构时中止执行引擎不再输出循环汇总和耗时分解
+    if (m_soak) {
+        m_soak->disconnect(this);
+    }
+    if (m_profiler) {
+        m_profiler->disconnect(this);
+    }
+    m_runner->stop();
+    m_deviceController->disconnectDevice();
+}
+
+bool HeadlessRunner::start(QString *errorString)
+{
+    QFile file(m_options.planPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = tr("无法打开测试配置 %1: %2").arg(m_options.planPath, file.errorString());
+        }
+        return false;
+    }
+
+    CompiledPlan plan;
+    QStringList errors;
+    if (!PlanCompiler::loadFromJson(file.readAll(), plan, &errors)) {
+        if (errorString) {
+            *errorString = tr("测试配置无效:\n%1").arg(errors.join(QLatin1Char('\n')));
+        }
+        return false;
+    }
+    if (plan.stepCount() == 0) {
+        if (errorString) {
+            *errorString = tr("测试配置中没有测试步骤");
+        }
+        return false;
+    }
+
+    m_deviceController->setMaxBaudRate(m_options.maxBaudRate);
+    m_deviceController->setPreferredMeasurementFormat(m_options.measurementFormat);
+    m_deviceController->setPipeliningEnabled(m_options.pipelining);
+    if (!m_deviceController->connectToDevice(m_options.portName, m_options.baudRate)) {
+        if (errorString) {
+            *errorString = tr("无法连接串口 %1").arg(m_options.portName);
+        }
+        return false;
+    }
+
+    m_runner->loadPlan(plan);
+    m_runner->setFixtureName(m_options.fixtureName);
+    m_runner->setBoardSerial(m_options.boardSerial);
+    m_errors.clear();
+    m_elapsed.start();
+    onLogMessage(tr("开始测试: %1 个步骤，串口 %2，序列号 %3")
+                 .arg(plan.stepCount()).arg(m_options.portName, m_options.boardSerial));
+
+    if (m_soak) {
+        SoakController::Config config;
+        config.iterations = m_options.loopCount;
+        config.durationMs = m_options.loopDurationMs;
+        config.reportIntervalMs = m_options.reportIntervalMs;
+        if (!m_soak->start(config)) {
+            if (errorString) {
+                *errorString = tr("无法开始循环测试");
+            }
+            return false;
+        }
+        return true;
+    }
+
+    m_runner->start();
+    return true;
+}
+
+void HeadlessRunner::onUserConfirmRequired(const QString &message)
+{
+    // 确认信号在执行引擎的动作处理中同步发出，应答放到下一轮事件循环再提交
+    const bool confirmed = resolveConfirm(message);
+    onLogMessage(tr("用户确认 \"%1\": %2").arg(message, confirmed ? tr("是") : tr("否")));
+    const quint64 token = m_runner->confirmToken();
+    QTimer::singleShot(0, m_runner.data(), [this, confirmed, token]() {
+        m_runner->userConfirm(confirmed, token);
+    });
+}
+
+void HeadlessRunner::onSequenceFinished(bool allPassed, int passedCount, int totalCount)
+{
+    if (m_soak) {
+        // 本次循环的明细落盘后即释放，内存中只保留循环控制器的汇总
+        if (m_soak->isRunning()) {
+            writeSummary(runSummary(allPassed, passedCount, totalCount, QString()));
+            m_errors.clear();
+        }
+        return;
+    }
+    complete(allPassed, passedCount, totalCount, QString());
+}
+
+void HeadlessRunner::onConnectionStatusChanged(bool isConnected, const QString &portName)
+{
+    if (isConnected || m_completed) {
+        return;
+    }
+
+    const QString reason = tr("串口 %1 已断开").arg(portName);
+    if (m_soak) {
+        if (!m_soak->isRunning()) {
+            return;
+        }
+        // 循环过程中串口断开：输出中断的这一次，结束循环并输出循环汇总
+        m_abortReason = reason;
+        if (m_runner->isRunning()) {
+            writeSummary(runSummary(false, 0, m_runner->plan().stepCount(), reason));
+            m_errors.clear();
+        }
+        m_soak->stop();
+        return;
+    }
+
+    if (!m_runner->isRunning()) {
+        return;
+    }
+
+    // 测试过程中串口断开：中止并按失败输出汇总
+    m_runner->stop();
+    complete(false, 0, m_runner->plan().stepCount(), reason);
+}
+
+void HeadlessRunner::onLogMessage(const QString &message)
+{
+    if (m_options.quiet) {
+        return;
+    }
+    QTextStream err(stderr);
+    err << message << endl;
+}
+
+void HeadlessRunner::onSoakReport(const SoakController::Report &report)
+{
+    // 长时间运行时用于确认内存是否平稳，--quiet 时也输出
+    QTextStream err(stderr);
+    err << SoakController::describe(report) << endl;
+}
+
+void HeadlessRunner::onSoakFinished(const SoakController::Report &report, const QString &abortReason)
+{
+    if (m_completed) {
+        return;
+    }
+    m_completed = true;
+
+    if (m_errorRecordStore) {
+        m_errorRecordStore->sync();
+    }
+
+    // 串口断开时循环控制器只看到执行引擎被停止，以断开原因为准
+    const QString reason = m_abortReason.isEmpty() ? abortReason : m_abortReason;
+    const bool allPassed = reason.isEmpty() && report.iterations > 0 && report.failed == 0;
+
+    QJsonObject cycle;
+    cycle.insert(QStringLiteral("last"), report.lastCycleMs);
+    cycle.insert(QStringLiteral("window_mean"), report.windowCycleMs);
+    cycle.insert(QStringLiteral("mean"), report.cycleStats.mean);
+    cycle.insert(QStringLiteral("p50"), report.p50CycleMs);
+    cycle.insert(QStringLiteral("p99"), report.p99CycleMs);
+    cycle.insert(QStringLiteral("max"), report.cycleStats.max);
+
+    QJsonArray stepFailures;
+    for (qint64 count : m_soak->stepFailures()) {
+        stepFailures.append(static_cast<double>(count));
+    }
+
+    QJsonObject summary;
+    summary.insert(QStringLiteral("serial"), m_options.boardSerial);
+    summary.insert(QStringLiteral("fixture"), m_options.fixtureName);
+    summary.insert(QStringLiteral("port"), m_options.portName);
+    summary.insert(QStringLiteral("soak"), true);
+    summary.insert(QStringLiteral("passed"), allPassed);
+    summary.insert(QStringLiteral("iterations"), static_cast<double>(report.iterations));
+    summary.insert(QStringLiteral("passed_iterations"), static_cast<double>(report.passed));
+    summary.insert(QStringLiteral("failed_iterations"), static_cast<double>(report.failed));
+    summary.insert(QStringLiteral("error_count"), static_cast<double>(report.errorCount));
+    summary.insert(QStringLiteral("elapsed_ms"), static_cast<double>(report.elapsedMs));
+    summary.insert(QStringLiteral("cycle_ms"), cycle);
+    summary.insert(QStringLiteral("rss_bytes"), static_cast<double>(report.residentBytes));
+    summary.insert(QStringLiteral("first_rss_bytes"), static_cast<double>(report.firstResidentBytes));
+    summary.insert(QStringLiteral("peak_rss_bytes"), static_cast<double>(report.peakResidentBytes));
+    summary.insert(QStringLiteral("step_failures"), stepFailures);
+    if (!reason.isEmpty()) {
+        summary.insert(QStringLiteral("aborted"), reason);
+    }
+    writeSummary(summary);
+
+    if (m_profiler) {
+        writeProfile(m_profiler->toCsvLines(), m_profiler->toFoldedLines());
+    }
+
+    emit finished(allPassed ? ExitPassed : ExitFailed);
+}
+
+bool HeadlessRunner::resolveConfirm(const QString &message)
+{
+    switch (m_options.confirmMode) {
+    case ConfirmMode::Stdin:
+        return answerFromStdin(message);
+    case ConfirmMode::Command:
+        return answerFromCommand(message);
+    case ConfirmMode::Auto:
+        break;
+    }
+    return answerFromRules(message);
+}
+
+bool HeadlessRunner::answerFromRules(const QString &message) const
+{
+    for (const QPair<QString, bool> &rule : m_options.answers) {
+        if (message.contains(rule.first, Qt::CaseInsensitive)) {
+            return rule.second;
+        }
+    }
+    return m_options.defaultAnswer;
+}
+
+bool HeadlessRunner::answerFromStdin(const QString &message)
+{
+    // 串口收发在 SerialPortWorker 线程中进行，这里阻塞等待输入不会丢失设备数据
+    QTextStream err(stderr);
+    err << tr("[确认] %1 (y/n): ").arg(message) << flush;
+
+    QTextStream in(stdin);
+    const QString line = in.readLine();
+    if (line.isNull()) {
+        // 标准输入已关闭：退回到预设应答
+        return answerFromRules(message);
+    }
+    return isAffirmative(line);
+}
+
+bool HeadlessRunner::answerFromCommand(const QString &message)
+{
+    if (m_options.confirmCommand.isEmpty()) {
+        return answerFromRules(message);
+    }
+    const QString &program = m_options.confirmCommand;
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(program, QStringList() << message);
+    if (!process.waitForStarted()) {
+        onLogMessage(tr("无法启动确认命令 %1: %2").arg(program, process.errorString()));
+        return false;
+    }
+    if (!process.waitForFinished(m_options.confirmTimeoutMs)) {
+        process.kill();
+        process.waitForFinished();
+        onLogMessage(tr("确认命令超时（%1 ms），按否处理").arg(m_options.confirmTimeoutMs));
+        return false;
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+void HeadlessRunner::complete(bool allPassed, int passedCount, int totalCount, const QString &abortReason)
+{
+    if (m_completed) {
+        return;
+    }
+    m_completed = true;
+
+    writeSummary(runSummary(allPassed, passedCount, totalCount, abortReason));
+    emit finished(allPassed ? ExitPassed : ExitFailed);
+}
+
+QJsonObject HeadlessRunner::runSummary(bool allPassed, int passedCount, int totalCount, const QString &abortReason)
+{
+    if (m_errorRecordStore) {
+        m_errorRecordStore->sync();
+    }
+
+    QJsonArray errors;
+    for (const ErrorRecord &record : m_errors) {
+        errors.append(errorToJson(record));
+    }
+
+    QJsonObject summary;
+    summary.insert(QStringLiteral("serial"), m_options.boardSerial);
+    summary.insert(QStringLiteral("fixture"), m_options.fixtureName);
+    summary.insert(QStringLiteral("port"), m_options.portName);
+    summary.insert(QStringLiteral("run_id"), static_cast<double>(m_runner->runId()));
+    if (m_soak) {
+        summary.insert(QStringLiteral("iteration"), static_cast<double>(m_iteration));
+    }
+    summary.insert(QStringLiteral("passed"), allPassed);
+    summary.insert(QStringLiteral("passed_steps"), passedCount);
+    summary.insert(QStringLiteral("total_steps"), totalCount);
+    summary.insert(QStringLiteral("elapsed_ms"), static_cast<double>(m_elapsed.elapsed()));
+    if (!abortReason.isEmpty()) {
+        summary.insert(QStringLiteral("aborted"), abortReason);
+    }
+    summary.insert(QStringLiteral("errors"), errors);
+    return summary;
+}
+
+void HeadlessRunner::writeSummary(const QJsonObject &summary)
+{
+    const QByteArray line = QJsonDocument(summary).toJson(QJsonDocument::Compact) + '\n';
+    if (m_options.summaryPath.isEmpty()) {
+        std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+        std::fflush(stdout);
+    } else {
+        QFile file(m_options.summaryPath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            file.write(line);
+        } else {
+            onLogMessage(tr("无法写入汇总文件 %1: %2").arg(m_options.summaryPath, file.errorString()));
+        }
+    }
+}
+
+void HeadlessRunner::writeProfile(const QStringList &csvLines, const QStringList &foldedLines)
+{
+    QString error;
+    if (!m_options.profilePath.isEmpty() &&
+        !appendLines(m_options.profilePath, CycleTimeProfiler::csvHeader(), csvLines, &error)) {
+        onLogMessage(tr("无法写入耗时分解 %1: %2").arg(m_options.profilePath, error));
+    }
+    if (!m_options.flamePath.isEmpty() &&
+        !appendLines(m_options.flamePath, QString(), foldedLines, &error)) {
+        onLogMessage(tr("无法写入耗时分解 %1: %2").arg(m_options.flamePath, error));
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "domain/ErrorRecord.h"
+#include "app/SoakController.h"
+#include "DeviceProtocol.h"
+
+class SerialPortService;
+class DeviceController;
+class TestSequenceRunner;
+class ErrorRecordStore;
+class CycleTimeProfiler;
+class QJsonObject;
+
+/**
+ * @brief 无界面批处理执行器
+ *
+ * 职责：
+ * - 不创建任何窗口，直接组装 SerialPortService → DeviceController → TestSequenceRunner
+ * - 加载 TaskListWidget 导出的测试配置 JSON，连接串口后执行一次完整序列
+ * - 按配置自动应答用户确认动作（固定答案 / 标准输入 / 外部命令，如读取治具 GPIO 的脚本）
+ * - 错误记录写入与界面相同格式的错误记录库，结束时输出一行 JSON 汇总供 MES 或脚本解析
+ * - 循环模式（loopCount 不为1或设置了 loopDurationMs）：由 SoakController 反复执行序列，
+ *   每次循环结束即输出该次的汇总并释放其错误记录，最后再输出一行循环汇总；
+ *   定期的周期与常驻内存报告始终输出到标准错误（不受 quiet 影响）
+ * - 指定 profilePath / flamePath 时由 CycleTimeProfiler 记录每次运行的耗时分解，
+ *   每次运行追加 CSV 行和折叠栈行，循环模式结束时再追加跨运行汇总
+ *
+ * 日志输出到标准错误，标准输出只保留汇总结果。
+ */
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 进程退出码
+     */
+    enum ExitCode {
+        ExitPassed = 0,         ///< 全部步骤通过
+        ExitFailed = 1,         ///< 有步骤失败或测试被中止
+        ExitSetupError = 2      ///< 配置、串口等准备工作失败
+    };
+
+    /**
+     * @brief 用户确认的应答方式
+     */
+    enum class ConfirmMode {
+        Auto,       ///< 按 answers 匹配确认提示，未匹配时使用 defaultAnswer
+        Stdin,      ///< 在标准输入读取一行（y/yes/1/pass 视为确认）
+        Command     ///< 执行外部命令，退出码0视为确认
+    };
+
+    /**
+     * @brief 执行选项
+     */
+    struct Options {
+        QString portName;                           ///< 串口名（SIM 或 SIM:参数 使用模拟设备）
+        int baudRate;                               ///< 波特率
+        int maxBaudRate;                            ///< 连接后协商的最高波特率（不高于 baudRate 时不协商）
+        DeviceProtocol::MeasurementFormat measurementFormat;    ///< 连接后选择的测量帧格式
+        bool pipelining;                            ///< 是否启用命令流水线发送
+        QString planPath;                           ///< 测试配置 JSON 路径
+        QString resultPath;                         ///< 错误记录库路径（空则不记录）
+        QString summaryPath;                        ///< 汇总输出文件（空则输出到标准输出）
+        QString boardSerial;                        ///< 板卡序列号
+        QString fixtureName;                        ///< 治具名称（空则使用串口名）
+        ConfirmMode confirmMode;                    ///< 用户确认应答方式
+        bool defaultAnswer;                         ///< 未匹配时的默认应答
+        QVector<QPair<QString, bool>> answers;      ///< 确认提示关键字 → 应答（按顺序匹配第一个）
+        QString confirmCommand;                     ///< 外部确认程序路径（提示文本作为唯一参数）
+        int confirmTimeoutMs;                       ///< 外部确认程序的等待上限
+        bool quiet;                                 ///< 不输出过程日志
+        qint64 loopCount;                           ///< 循环次数（1 为单次执行，0 表示不限）
+        qint64 loopDurationMs;                      ///< 循环时长上限（0 表示不限）
+        int reportIntervalMs;                       ///< 循环模式的报告间隔
+        QString profilePath;                        ///< 耗时分解 CSV 追加到的文件（空则不输出）
+        QString flamePath;                          ///< 耗时分解折叠栈追加到的文件（空则不输出）
+
+        Options()
+            : baudRate(9600), maxBaudRate(9600), measurementFormat(DeviceProtocol::MeasurementFormat::Float), pipelining(false), confirmMode(ConfirmMode::Auto), defaultAnswer(true)
+            , confirmTimeoutMs(30000), quiet(false), loopCount(1), loopDurationMs(0)
+            , reportIntervalMs(SoakController::kDefaultReportIntervalMs) {}
+
+        /**
+         * @brief 是否为循环模式
+         */
+        bool isSoak() const { return loopCount != 1 || loopDurationMs > 0; }
+    };
+
+    explicit HeadlessRunner(const Options &options, QObject *parent = nullptr);
+    ~HeadlessRunner() override;
+
+    /**
+     * @brief 加载测试配置、连接串口并开始执行
+     * @param errorString 失败原因输出
+     * @return 是否成功开始（失败时不会发射 finished）
+     */
+    bool start(QString *errorString);
+
+signals:
+    /**
+     * @brief 执行结束（汇总已输出），参数为进程退出码
+     */
+    void finished(int exitCode);
+
+private slots:
+    void onUserConfirmRequired(const QString &message);
+    void onSequenceFinished(bool allPassed, int passedCount, int totalCount);
+    void onConnectionStatusChanged(bool isConnected, const QString &portName);
+    void onLogMessage(const QString &message);
+    void onSoakReport(const SoakController::Report &report);
+    void onSoakFinished(const SoakController::Report &report, const QString &abortReason);
+
+private:
+    /**
+     * @brief 根据应答方式得出确认结果（可能阻塞等待标准输入或外部命令）
+     */
+    bool resolveConfirm(const QString &message);
+    bool answerFromRules(const QString &message) const;
+    bool answerFromStdin(const QString &message);
+    bool answerFromCommand(const QString &message);
+
+    /**
+     * @brief 输出汇总并发射 finished
+     */
+    void complete(bool allPassed, int passedCount, int totalCount, const QString &abortReason);
+
+    /**
+     * @brief 单次运行的汇总（同步错误记录库，循环模式下带循环序号）
+     */
+    QJsonObject runSummary(bool allPassed, int passedCount, int totalCount, const QString &abortReason);
+
+    /**
+     * @brief 汇总写入标准输出或汇总文件（一行 JSON）
+     */
+    void writeSummary(const QJsonObject &summary);
+
+    /**
+     * @brief 耗时分解追加到 CSV / 折叠栈文件
+     */
+    void writeProfile(const QStringList &csvLines, const QStringList &foldedLines);
+
+    Options m_options;
+    QScopedPointer<SerialPortService> m_serialPortService;  ///< 串口服务（声明顺序即析构逆序）
+    QScopedPointer<DeviceController> m_deviceController;    ///< 设备控制器
+    QScopedPointer<TestSequenceRunner> m_runner;            ///< 执行引擎
+    QScopedPointer<CycleTimeProfiler> m_profiler;           ///< 耗时分解（仅指定输出文件时）
+    QScopedPointer<SoakController> m_soak;                  ///< 循环控制器（仅循环模式）
+    QScopedPointer<ErrorRecordStore> m_errorRecordStore;    ///< 错误记录库（可为空）
+    QVector<ErrorRecord> m_errors;                          ///< 本次运行的错误记录
+    QElapsedTimer m_elapsed;                                ///< 执行计时（循环模式下为本次循环）
+    qint64 m_iteration;                                     ///< 当前循环序号（循环模式）
+    QString m_abortReason;                                  ///< 循环模式下串口断开等中止原因
+    bool m_completed;                                       ///< 是否已输出汇总
+};
+
+#endif // HEADLESSRUNNER_H
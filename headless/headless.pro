@@ -0,0 +1,25 @@
+# 无界面批处理执行程序：不依赖 QtWidgets/QtCharts，可在产线工控机或 CI 中运行
+# 构建：qmake headless/headless.pro && make
+# 用法：./pcba_headless --port COM3 --plan plan.json --serial SN001 --answer "LED=yes"
+#       模拟设备：--port SIM 或 --port SIM:rate=2000,level=1.5
+#       长时间循环：--loop 0 --loop-minutes 4320 --report-interval 300
+#       耗时分解：--profile cycle.csv --flame cycle.folded（flamegraph.pl cycle.folded > cycle.svg）
+# 标准输出为一行 JSON 汇总，退出码 0 通过、1 失败、2 准备失败
+
+QT       = core serialport
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = pcba_headless
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../core.pri)
+
+SOURCES += \
+    main.cpp \
+    HeadlessRunner.cpp
+
+HEADERS += \
+    HeadlessRunner.h
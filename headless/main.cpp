@@ -0,0 +1,226 @@
+#include "HeadlessRunner.h"
+#include "storage/ErrorRecordStore.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QTimer>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief 解析 "关键字=yes|no" 形式的确认应答
+ */
+bool parseAnswer(const QString &text, QPair<QString, bool> &answer)
+{
+    const int separator = text.lastIndexOf(QLatin1Char('='));
+    if (separator <= 0) {
+        return false;
+    }
+    const QString value = text.mid(separator + 1).trimmed().toLower();
+    if (value == QLatin1String("yes") || value == QLatin1String("y") || value == QLatin1String("1")) {
+        answer = qMakePair(text.left(separator), true);
+        return true;
+    }
+    if (value == QLatin1String("no") || value == QLatin1String("n") || value == QLatin1String("0")) {
+        answer = qMakePair(text.left(separator), false);
+        return true;
+    }
+    return false;
+}
+
+int failSetup(const QString &message)
+{
+    QTextStream(stderr) << message << endl;
+    return HeadlessRunner::ExitSetupError;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 只创建 QCoreApplication：不加载任何界面模块，可在无显示环境的产线工控机上运行
+    QCoreApplication app(argc, argv);
+    // 与界面程序使用同一应用名，默认的错误记录库两边共用
+    QCoreApplication::setApplicationName(QStringLiteral("test"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QCoreApplication::translate("main",
+        "PCBA 测试无界面执行：加载导出的测试配置，执行测试序列（可循环执行）并输出 JSON 汇总"));
+    parser.addHelpOption();
+
+    const QCommandLineOption portOption(QStringLiteral("port"),
+        QCoreApplication::translate("main", "串口名（SIM 或 SIM:rate=...,level=... 使用模拟设备）"), QStringLiteral("name"));
+    const QCommandLineOption baudOption(QStringLiteral("baud"),
+        QCoreApplication::translate("main", "波特率"), QStringLiteral("rate"), QStringLiteral("9600"));
+    const QCommandLineOption maxBaudOption(QStringLiteral("max-baud"),
+        QCoreApplication::translate("main", "连接后协商的最高波特率（默认不协商；旧版固件不支持协商）"),
+        QStringLiteral("rate"));
+    const QCommandLineOption formatOption(QStringLiteral("format"),
+        QCoreApplication::translate("main", "测量帧格式：float、int16、delta 或 multi（四通道同时扫描；设备不支持时保持 float）"),
+        QStringLiteral("format"), QStringLiteral("float"));
+    const QCommandLineOption pipelineOption(QStringLiteral("pipeline"),
+        QCoreApplication::translate("main", "启用命令流水线发送（回应可区分的命令不等前一条确认即背靠背发送）"));
+    const QCommandLineOption planOption(QStringLiteral("plan"),
+        QCoreApplication::translate("main", "测试配置 JSON（界面中导出的配置文件）"), QStringLiteral("file"));
+    const QCommandLineOption resultsOption(QStringLiteral("results"),
+        QCoreApplication::translate("main", "错误记录库路径，\"-\" 表示不记录"), QStringLiteral("file"),
+        ErrorRecordStore::defaultFilePath());
+    const QCommandLineOption summaryOption(QStringLiteral("summary"),
+        QCoreApplication::translate("main", "汇总结果追加到文件（默认输出到标准输出）"), QStringLiteral("file"));
+    const QCommandLineOption serialOption(QStringLiteral("serial"),
+        QCoreApplication::translate("main", "板卡序列号"), QStringLiteral("sn"));
+    const QCommandLineOption fixtureOption(QStringLiteral("fixture"),
+        QCoreApplication::translate("main", "治具名称（默认使用串口名）"), QStringLiteral("name"));
+    const QCommandLineOption confirmOption(QStringLiteral("confirm"),
+        QCoreApplication::translate("main", "用户确认应答方式：auto、stdin 或 command"),
+        QStringLiteral("mode"), QStringLiteral("auto"));
+    const QCommandLineOption answerOption(QStringLiteral("answer"),
+        QCoreApplication::translate("main", "确认提示包含关键字时的应答，可重复，如 \"LED=yes\""),
+        QStringLiteral("text=yes|no"));
+    const QCommandLineOption defaultAnswerOption(QStringLiteral("default-answer"),
+        QCoreApplication::translate("main", "未匹配关键字时的应答"), QStringLiteral("yes|no"),
+        QStringLiteral("yes"));
+    const QCommandLineOption confirmCommandOption(QStringLiteral("confirm-command"),
+        QCoreApplication::translate("main", "确认程序路径（提示文本作为唯一参数，退出码0为确认）"),
+        QStringLiteral("command"));
+    const QCommandLineOption confirmTimeoutOption(QStringLiteral("confirm-timeout"),
+        QCoreApplication::translate("main", "确认命令的超时（毫秒），超时按否处理"),
+        QStringLiteral("ms"), QStringLiteral("30000"));
+    const QCommandLineOption quietOption(QStringLiteral("quiet"),
+        QCoreApplication::translate("main", "不输出过程日志"));
+    const QCommandLineOption loopOption(QStringLiteral("loop"),
+        QCoreApplication::translate("main", "循环执行次数，0 表示不限（每次输出一行汇总，最后输出循环汇总）"),
+        QStringLiteral("count"), QStringLiteral("1"));
+    const QCommandLineOption loopMinutesOption(QStringLiteral("loop-minutes"),
+        QCoreApplication::translate("main", "循环执行的时长上限（分钟），到达后等当前一次结束再停止"),
+        QStringLiteral("minutes"));
+    const QCommandLineOption reportIntervalOption(QStringLiteral("report-interval"),
+        QCoreApplication::translate("main", "循环模式下周期与常驻内存报告的间隔（秒），0 表示只在结束时报告"),
+        QStringLiteral("seconds"), QString::number(SoakController::kDefaultReportIntervalMs / 1000));
+    const QCommandLineOption profileOption(QStringLiteral("profile"),
+        QCoreApplication::translate("main", "每次运行的耗时分解（主机处理/等待ACK/等待测量/固定延时/操作员确认）追加到 CSV 文件"),
+        QStringLiteral("file"));
+    const QCommandLineOption flameOption(QStringLiteral("flame"),
+        QCoreApplication::translate("main", "耗时分解以折叠栈格式追加到文件（微秒，可用 flamegraph.pl 或 speedscope 生成火焰图）"),
+        QStringLiteral("file"));
+
+    parser.addOptions({portOption, baudOption, maxBaudOption, formatOption, pipelineOption, planOption, resultsOption, summaryOption,
+                       serialOption, fixtureOption, confirmOption, answerOption,
+                       defaultAnswerOption, confirmCommandOption, confirmTimeoutOption, quietOption,
+                       loopOption, loopMinutesOption, reportIntervalOption, profileOption, flameOption});
+    parser.process(app);
+
+    HeadlessRunner::Options options;
+    options.portName = parser.value(portOption);
+    options.planPath = parser.value(planOption);
+    if (options.portName.isEmpty() || options.planPath.isEmpty()) {
+        return failSetup(QCoreApplication::translate("main", "必须指定 --port 和 --plan"));
+    }
+
+    bool ok = false;
+    options.baudRate = parser.value(baudOption).toInt(&ok);
+    if (!ok || options.baudRate <= 0) {
+        return failSetup(QCoreApplication::translate("main", "无效的波特率: %1").arg(parser.value(baudOption)));
+    }
+    options.maxBaudRate = options.baudRate;
+    if (parser.isSet(maxBaudOption)) {
+        options.maxBaudRate = parser.value(maxBaudOption).toInt(&ok);
+        if (!ok || BaudRate::codeOf(options.maxBaudRate) < 0) {
+            return failSetup(QCoreApplication::translate("main", "无效的最高波特率: %1").arg(parser.value(maxBaudOption)));
+        }
+    }
+    options.pipelining = parser.isSet(pipelineOption);
+    const QString format = parser.value(formatOption).toLower();
+    if (format == QLatin1String("float")) {
+        options.measurementFormat = DeviceProtocol::MeasurementFormat::Float;
+    } else if (format == QLatin1String("int16")) {
+        options.measurementFormat = DeviceProtocol::MeasurementFormat::PackedInt16;
+    } else if (format == QLatin1String("delta")) {
+        options.measurementFormat = DeviceProtocol::MeasurementFormat::PackedDelta;
+    } else if (format == QLatin1String("multi")) {
+        options.measurementFormat = DeviceProtocol::MeasurementFormat::MultiChannel;
+    } else {
+        return failSetup(QCoreApplication::translate("main", "未知的测量帧格式: %1").arg(format));
+    }
+    options.confirmTimeoutMs = parser.value(confirmTimeoutOption).toInt(&ok);
+    if (!ok || options.confirmTimeoutMs <= 0) {
+        return failSetup(QCoreApplication::translate("main", "无效的确认超时: %1")
+                         .arg(parser.value(confirmTimeoutOption)));
+    }
+
+    options.loopCount = parser.value(loopOption).toLongLong(&ok);
+    if (!ok || options.loopCount < 0) {
+        return failSetup(QCoreApplication::translate("main", "无效的循环次数: %1").arg(parser.value(loopOption)));
+    }
+    if (parser.isSet(loopMinutesOption)) {
+        const double minutes = parser.value(loopMinutesOption).toDouble(&ok);
+        if (!ok || minutes <= 0.0) {
+            return failSetup(QCoreApplication::translate("main", "无效的循环时长: %1")
+                             .arg(parser.value(loopMinutesOption)));
+        }
+        options.loopDurationMs = static_cast<qint64>(minutes * 60000.0);
+        if (!parser.isSet(loopOption)) {
+            // 只给出时长时不限次数
+            options.loopCount = 0;
+        }
+    }
+    const int reportSeconds = parser.value(reportIntervalOption).toInt(&ok);
+    if (!ok || reportSeconds < 0) {
+        return failSetup(QCoreApplication::translate("main", "无效的报告间隔: %1")
+                         .arg(parser.value(reportIntervalOption)));
+    }
+    options.reportIntervalMs = reportSeconds * 1000;
+
+    const QString results = parser.value(resultsOption);
+    options.resultPath = (results == QLatin1String("-")) ? QString() : results;
+    options.summaryPath = parser.value(summaryOption);
+    options.profilePath = parser.value(profileOption);
+    options.flamePath = parser.value(flameOption);
+    options.boardSerial = parser.value(serialOption);
+    options.fixtureName = parser.value(fixtureOption);
+    options.quiet = parser.isSet(quietOption);
+
+    const QString mode = parser.value(confirmOption).toLower();
+    if (mode == QLatin1String("auto")) {
+        options.confirmMode = HeadlessRunner::ConfirmMode::Auto;
+    } else if (mode == QLatin1String("stdin")) {
+        options.confirmMode = HeadlessRunner::ConfirmMode::Stdin;
+    } else if (mode == QLatin1String("command")) {
+        options.confirmMode = HeadlessRunner::ConfirmMode::Command;
+        options.confirmCommand = parser.value(confirmCommandOption);
+        if (options.confirmCommand.isEmpty()) {
+            return failSetup(QCoreApplication::translate("main", "--confirm command 需要指定 --confirm-command"));
+        }
+    } else {
+        return failSetup(QCoreApplication::translate("main", "未知的确认方式: %1").arg(mode));
+    }
+
+    QPair<QString, bool> defaultAnswer;
+    if (!parseAnswer(QStringLiteral("*=") + parser.value(defaultAnswerOption), defaultAnswer)) {
+        return failSetup(QCoreApplication::translate("main", "无效的默认应答: %1")
+                         .arg(parser.value(defaultAnswerOption)));
+    }
+    options.defaultAnswer = defaultAnswer.second;
+
+    for (const QString &text : parser.values(answerOption)) {
+        QPair<QString, bool> answer;
+        if (!parseAnswer(text, answer)) {
+            return failSetup(QCoreApplication::translate("main", "无效的确认应答: %1").arg(text));
+        }
+        options.answers.append(answer);
+    }
+
+    HeadlessRunner runner(options);
+    QObject::connect(&runner, &HeadlessRunner::finished, &app, [](int exitCode) {
+        // 等当前事件处理完再退出，确保执行引擎的信号已全部分发
+        QTimer::singleShot(0, [exitCode]() { QCoreApplication::exit(exitCode); });
+    });
+
+    QString errorString;
+    if (!runner.start(&errorString)) {
+        return failSetup(errorString);
+    }
+    return app.exec();
+}
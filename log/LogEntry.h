@@ -0,0 +1,69 @@
+#ifndef LOGENTRY_H
+#define LOGENTRY_H
+
+#include <QString>
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * @brief 日志级别
+ */
+enum class LogSeverity {
+    Debug = 0,      ///< 调试（原始收发数据等高频信息）
+    Info = 1,       ///< 一般信息
+    Warning = 2,    ///< 警告
+    Error = 3       ///< 错误
+};
+
+/**
+ * @brief 单条日志
+ */
+struct LogEntry {
+    qint64 timestampMs;     ///< 墙钟时间（毫秒，自1970年起）
+    LogSeverity severity;   ///< 日志级别
+    QString source;         ///< 来源（主界面/自动测试/多工位等）
+    QString message;        ///< 日志内容
+
+    LogEntry() : timestampMs(0), severity(LogSeverity::Info) {}
+};
+
+Q_DECLARE_METATYPE(LogEntry)
+
+/**
+ * @brief 日志级别名称（写入日志文件）
+ */
+inline const char *logSeverityName(LogSeverity severity)
+{
+    switch (severity) {
+    case LogSeverity::Debug:   return "DEBUG";
+    case LogSeverity::Info:    return "INFO";
+    case LogSeverity::Warning: return "WARN";
+    case LogSeverity::Error:   return "ERROR";
+    }
+    return "INFO";
+}
+
+/**
+ * @brief 按日志内容推断级别
+ *
+ * 各模块的 logMessage 信号只携带文本，这里按约定的关键字归类：
+ * "错误"/"失败"/"超时"/"异常" 为错误，"警告"/"取消"/"重试"/"重发" 为警告，
+ * 原始收发数据为调试，其余为一般信息。
+ */
+inline LogSeverity classifyLogMessage(const QString &message)
+{
+    if (message.contains(QStringLiteral("错误")) || message.contains(QStringLiteral("失败")) ||
+        message.contains(QStringLiteral("超时")) || message.contains(QStringLiteral("异常"))) {
+        return LogSeverity::Error;
+    }
+    if (message.contains(QStringLiteral("警告")) || message.contains(QStringLiteral("取消")) ||
+        message.contains(QStringLiteral("重试")) || message.contains(QStringLiteral("重发"))) {
+        return LogSeverity::Warning;
+    }
+    if (message.startsWith(QStringLiteral("收到从机回传"))) {
+        return LogSeverity::Debug;
+    }
+    return LogSeverity::Info;
+}
+
+#endif // LOGENTRY_H
@@ -0,0 +1,49 @@
+#include "LogFileSink.h"
+#include "LogFileWriter.h"
+#include <QStandardPaths>
+
+LogFileSink::LogFileSink(const QString &filePath, qint64 maxFileBytes, int maxBackupFiles, QObject *parent)
+    : QObject(parent)
+    , m_writer(new LogFileWriter())
+    , m_filePath(filePath)
+{
+    qRegisterMetaType<QVector<LogEntry>>("QVector<LogEntry>");
+
+    // 写入对象移入后台线程，线程结束时在该线程内销毁（析构时关闭文件）
+    m_thread.setObjectName(QStringLiteral("LogFileSink"));
+    m_writer->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished,
+            m_writer, &QObject::deleteLater);
+    connect(m_writer, &LogFileWriter::errorOccurred,
+            this, &LogFileSink::errorOccurred);
+    m_thread.start(QThread::LowPriority);
+
+    QMetaObject::invokeMethod(m_writer, "open", Qt::QueuedConnection,
+                              Q_ARG(QString, filePath),
+                              Q_ARG(qint64, maxFileBytes),
+                              Q_ARG(int, maxBackupFiles));
+}
+
+LogFileSink::~LogFileSink()
+{
+    // 阻塞等待：队列按顺序执行，返回时之前排队的写入都已完成
+    QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QString LogFileSink::defaultFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/logs/pcba.log";
+}
+
+void LogFileSink::write(const QVector<LogEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_writer, "writeEntries", Qt::QueuedConnection,
+                              Q_ARG(QVector<LogEntry>, entries));
+}
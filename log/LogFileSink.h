@@ -0,0 +1,71 @@
+#ifndef LOGFILESINK_H
+#define LOGFILESINK_H
+
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <QVector>
+#include "log/LogEntry.h"
+
+class LogFileWriter;
+
+/**
+ * @brief 日志文件输出服务
+ *
+ * 职责：
+ * - 在独立的后台线程中运行LogFileWriter，格式化和磁盘写入不占用界面线程
+ * - 接收各日志视图合并后的日志批次，按大小轮转日志文件
+ *
+ * write() 只负责排队，立即返回；析构时等待后台线程写完所有已排队的日志。
+ */
+class LogFileSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 kDefaultMaxFileBytes = 8 * 1024 * 1024;    ///< 单个文件默认最大 8MB
+    static constexpr int kDefaultMaxBackupFiles = 5;                    ///< 默认保留 5 个轮转文件
+
+    /**
+     * @brief 构造函数
+     * @param filePath 日志文件路径
+     * @param maxFileBytes 单个文件最大字节数
+     * @param maxBackupFiles 保留的轮转文件数
+     * @param parent 父对象指针
+     */
+    explicit LogFileSink(const QString &filePath,
+                         qint64 maxFileBytes = kDefaultMaxFileBytes,
+                         int maxBackupFiles = kDefaultMaxBackupFiles,
+                         QObject *parent = nullptr);
+    ~LogFileSink() override;
+
+    /**
+     * @brief 日志文件路径
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief 默认日志文件路径
+     */
+    static QString defaultFilePath();
+
+public slots:
+    /**
+     * @brief 排队写入一批日志
+     */
+    void write(const QVector<LogEntry> &entries);
+
+signals:
+    /**
+     * @brief 文件写入错误时发射
+     * @param errorString 错误描述
+     */
+    void errorOccurred(const QString &errorString);
+
+private:
+    QThread m_thread;           ///< 日志写入线程
+    LogFileWriter *m_writer;    ///< 写入对象（属于写入线程）
+    QString m_filePath;         ///< 日志文件路径
+};
+
+#endif // LOGFILESINK_H
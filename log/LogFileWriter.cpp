@@ -0,0 +1,99 @@
+#include "LogFileWriter.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+LogFileWriter::LogFileWriter(QObject *parent)
+    : QObject(parent)
+    , m_maxFileBytes(0)
+    , m_maxBackupFiles(0)
+    , m_failed(false)
+{
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    close();
+}
+
+void LogFileWriter::open(const QString &filePath, qint64 maxFileBytes, int maxBackupFiles)
+{
+    close();
+
+    m_maxFileBytes = maxFileBytes;
+    m_maxBackupFiles = maxBackupFiles;
+    m_failed = false;
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        m_failed = true;
+        emit errorOccurred(tr("无法打开日志文件 %1: %2").arg(filePath, m_file.errorString()));
+    }
+}
+
+void LogFileWriter::writeEntries(const QVector<LogEntry> &entries)
+{
+    if (!m_file.isOpen() || entries.isEmpty()) {
+        return;
+    }
+
+    QByteArray batch;
+    batch.reserve(entries.size() * 96);
+    for (const LogEntry &entry : entries) {
+        batch += QDateTime::fromMSecsSinceEpoch(entry.timestampMs)
+                     .toString(QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")).toLatin1();
+        batch += " [";
+        batch += logSeverityName(entry.severity);
+        batch += "] ";
+        if (!entry.source.isEmpty()) {
+            batch += '[';
+            batch += entry.source.toUtf8();
+            batch += "] ";
+        }
+        batch += entry.message.toUtf8();
+        batch += '\n';
+    }
+
+    if (m_file.write(batch) != batch.size()) {
+        if (!m_failed) {
+            m_failed = true;
+            emit errorOccurred(tr("写入日志文件失败: %1").arg(m_file.errorString()));
+        }
+        return;
+    }
+    m_file.flush();
+
+    if (m_maxFileBytes > 0 && m_file.size() >= m_maxFileBytes) {
+        rotate();
+    }
+}
+
+void LogFileWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+void LogFileWriter::rotate()
+{
+    const QString path = m_file.fileName();
+    m_file.close();
+
+    // 从最旧的开始依次后移，pcba.log.N 被删除
+    QFile::remove(QString("%1.%2").arg(path).arg(m_maxBackupFiles));
+    for (int i = m_maxBackupFiles - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(path).arg(i), QString("%1.%2").arg(path).arg(i + 1));
+    }
+    if (m_maxBackupFiles > 0) {
+        QFile::rename(path, path + ".1");
+    } else {
+        QFile::remove(path);
+    }
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        m_failed = true;
+        emit errorOccurred(tr("无法打开日志文件 %1: %2").arg(path, m_file.errorString()));
+    }
+}
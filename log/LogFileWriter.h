@@ -0,0 +1,65 @@
+#ifndef LOGFILEWRITER_H
+#define LOGFILEWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include "log/LogEntry.h"
+
+/**
+ * @brief 日志文件写入对象（运行在LogFileSink的后台线程中）
+ *
+ * 职责：
+ * - 将日志逐行写入文件，每批写完后刷新
+ * - 文件超过设定大小时轮转：pcba.log → pcba.log.1 → … → pcba.log.N，最旧的删除
+ *
+ * 该类只应由 LogFileSink 创建和调用（通过队列连接跨线程调用槽函数）。
+ */
+class LogFileWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogFileWriter(QObject *parent = nullptr);
+    ~LogFileWriter() override;
+
+public slots:
+    /**
+     * @brief 打开日志文件（追加写入）
+     * @param filePath 文件路径
+     * @param maxFileBytes 单个文件最大字节数
+     * @param maxBackupFiles 保留的轮转文件数
+     */
+    void open(const QString &filePath, qint64 maxFileBytes, int maxBackupFiles);
+
+    /**
+     * @brief 写入一批日志
+     */
+    void writeEntries(const QVector<LogEntry> &entries);
+
+    /**
+     * @brief 关闭日志文件
+     */
+    void close();
+
+signals:
+    /**
+     * @brief 文件写入错误时发射
+     * @param errorString 错误描述
+     */
+    void errorOccurred(const QString &errorString);
+
+private:
+    /**
+     * @brief 轮转日志文件并重新打开
+     */
+    void rotate();
+
+    QFile m_file;               ///< 当前日志文件
+    qint64 m_maxFileBytes;      ///< 单个文件最大字节数
+    int m_maxBackupFiles;       ///< 保留的轮转文件数
+    bool m_failed;              ///< 已报告过写入错误（避免重复报告）
+};
+
+#endif // LOGFILEWRITER_H
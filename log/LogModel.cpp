@@ -0,0 +1,124 @@
+#include "LogModel.h"
+#include <QDateTime>
+#include <QColor>
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_capacity(qMax(1, capacity))
+    , m_head(0)
+    , m_count(0)
+    , m_timestampFormat(QStringLiteral("hh:mm:ss.zzz"))
+{
+    m_ring.resize(m_capacity);
+}
+
+void LogModel::setTimestampFormat(const QString &format)
+{
+    m_timestampFormat = format;
+    if (m_count > 0) {
+        emit dataChanged(index(0), index(m_count - 1), {Qt::DisplayRole});
+    }
+}
+
+void LogModel::appendEntries(const QVector<LogEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    // 单批超过容量：只保留最新的 capacity 条，整体重置
+    if (entries.size() >= m_capacity) {
+        beginResetModel();
+        const int offset = entries.size() - m_capacity;
+        for (int i = 0; i < m_capacity; ++i) {
+            m_ring[i] = entries.at(offset + i);
+        }
+        m_head = 0;
+        m_count = m_capacity;
+        endResetModel();
+        return;
+    }
+
+    // 先移除会被覆盖的最旧日志
+    const int overflow = m_count + entries.size() - m_capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        for (int i = 0; i < overflow; ++i) {
+            m_ring[(m_head + i) % m_capacity] = LogEntry();
+        }
+        m_head = (m_head + overflow) % m_capacity;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + entries.size() - 1);
+    for (const LogEntry &entry : entries) {
+        m_ring[(m_head + m_count) % m_capacity] = entry;
+        ++m_count;
+    }
+    endInsertRows();
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    m_ring.fill(LogEntry());
+    m_head = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const LogEntry &entry = entryAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return QDateTime::fromMSecsSinceEpoch(entry.timestampMs).toString(m_timestampFormat)
+               + QLatin1Char(' ') + entry.message;
+    case Qt::ForegroundRole:
+        switch (entry.severity) {
+        case LogSeverity::Error:   return QColor("#e74c3c");
+        case LogSeverity::Warning: return QColor("#e67e22");
+        case LogSeverity::Debug:   return QColor("#7f8c8d");
+        default:                   return QVariant();
+        }
+    case SeverityRole:
+        return static_cast<int>(entry.severity);
+    case TimestampRole:
+        return entry.timestampMs;
+    case MessageRole:
+        return entry.message;
+    default:
+        return QVariant();
+    }
+}
+
+LogSeverityFilter::LogSeverityFilter(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_minimumSeverity(LogSeverity::Debug)
+{
+}
+
+void LogSeverityFilter::setMinimumSeverity(LogSeverity severity)
+{
+    if (m_minimumSeverity == severity) {
+        return;
+    }
+    m_minimumSeverity = severity;
+    invalidateFilter();
+}
+
+bool LogSeverityFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    return sourceModel()->data(index, LogModel::SeverityRole).toInt() >= static_cast<int>(m_minimumSeverity);
+}
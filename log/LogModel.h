@@ -0,0 +1,91 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include "log/LogEntry.h"
+
+/**
+ * @brief 定长环形缓冲区日志模型
+ *
+ * 职责：
+ * - 最多保留 capacity 条日志，满后丢弃最旧的日志，内存占用不随运行时间增长
+ * - 按批追加（一次 beginInsertRows），配合 QListView 只绘制可见行
+ * - 显示文本在绘制时按需格式化，不预先生成富文本
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Role {
+        SeverityRole = Qt::UserRole + 1,    ///< 日志级别（int）
+        TimestampRole,                      ///< 时间戳（qint64 毫秒）
+        MessageRole                         ///< 日志内容（不含时间戳）
+    };
+
+    static constexpr int kDefaultCapacity = 20000;  ///< 默认保留条数
+
+    explicit LogModel(int capacity = kDefaultCapacity, QObject *parent = nullptr);
+
+    /**
+     * @brief 最多保留的日志条数
+     */
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief 设置显示的时间戳格式（QDateTime 格式字符串）
+     */
+    void setTimestampFormat(const QString &format);
+
+    /**
+     * @brief 按批追加日志（超出容量时先移除最旧的日志）
+     */
+    void appendEntries(const QVector<LogEntry> &entries);
+
+    /**
+     * @brief 清空所有日志
+     */
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    const LogEntry &entryAt(int row) const { return m_ring[(m_head + row) % m_capacity]; }
+
+    QVector<LogEntry> m_ring;   ///< 环形缓冲区（预分配 capacity 个槽位）
+    int m_capacity;             ///< 容量
+    int m_head;                 ///< 最旧日志所在的槽位
+    int m_count;                ///< 当前日志条数
+    QString m_timestampFormat;  ///< 时间戳格式
+};
+
+/**
+ * @brief 按最低级别过滤日志
+ */
+class LogSeverityFilter : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit LogSeverityFilter(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置显示的最低级别
+     */
+    void setMinimumSeverity(LogSeverity severity);
+    LogSeverity minimumSeverity() const { return m_minimumSeverity; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    LogSeverity m_minimumSeverity;  ///< 最低级别
+};
+
+#endif // LOGMODEL_H
@@ -0,0 +1,125 @@
+#include "LogView.h"
+#include "LogModel.h"
+#include "LogFileSink.h"
+#include <QListView>
+#include <QComboBox>
+#include <QLabel>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QScrollBar>
+#include <QDateTime>
+
+LogView::LogView(QWidget *parent)
+    : QWidget(parent)
+    , m_listView(new QListView(this))
+    , m_filterCombo(new QComboBox(this))
+    , m_model(new LogModel(LogModel::kDefaultCapacity, this))
+    , m_filter(new LogSeverityFilter(this))
+    , m_flushTimer(new QTimer(this))
+{
+    m_filter->setSourceModel(m_model);
+
+    // 所有行等高：QListView 不必逐行测量，滚动和插入只处理可见区域
+    m_listView->setModel(m_filter);
+    m_listView->setUniformItemSizes(true);
+    m_listView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_listView->setWordWrap(false);
+    m_listView->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+
+    m_filterCombo->addItem(tr("全部"), static_cast<int>(LogSeverity::Debug));
+    m_filterCombo->addItem(tr("信息"), static_cast<int>(LogSeverity::Info));
+    m_filterCombo->addItem(tr("警告"), static_cast<int>(LogSeverity::Warning));
+    m_filterCombo->addItem(tr("错误"), static_cast<int>(LogSeverity::Error));
+    connect(m_filterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &LogView::onFilterChanged);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->setContentsMargins(0, 0, 0, 0);
+    filterLayout->addWidget(new QLabel(tr("级别:"), this));
+    filterLayout->addWidget(m_filterCombo);
+    filterLayout->addStretch();
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(2);
+    layout->addLayout(filterLayout);
+    layout->addWidget(m_listView, 1);
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &LogView::flush);
+}
+
+LogView::~LogView()
+{
+    // 未刷新的日志仍需写入文件
+    if (m_fileSink && !m_pending.isEmpty()) {
+        m_fileSink->write(m_pending);
+    }
+}
+
+void LogView::setFileSink(LogFileSink *sink, const QString &source)
+{
+    m_fileSink = sink;
+    m_source = source;
+}
+
+void LogView::setTimestampFormat(const QString &format)
+{
+    m_model->setTimestampFormat(format);
+}
+
+void LogView::appendMessage(const QString &message)
+{
+    appendEntry(message, classifyLogMessage(message));
+}
+
+void LogView::appendEntry(const QString &message, LogSeverity severity)
+{
+    LogEntry entry;
+    entry.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    entry.severity = severity;
+    entry.source = m_source;
+    entry.message = message;
+    m_pending.append(entry);
+
+    // 第一条待显示日志启动定时器，之后的日志合并到同一次刷新
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void LogView::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QScrollBar *scrollBar = m_listView->verticalScrollBar();
+    bool wasAtBottom = (scrollBar->value() >= scrollBar->maximum() - 2);
+
+    m_model->appendEntries(m_pending);
+    if (m_fileSink) {
+        m_fileSink->write(m_pending);
+    }
+    m_pending.clear();
+
+    // 之前停在底部时跟随最新日志，否则保持用户的浏览位置
+    if (wasAtBottom) {
+        m_listView->scrollToBottom();
+    }
+}
+
+void LogView::clear()
+{
+    flush();
+    m_model->clear();
+}
+
+void LogView::onFilterChanged(int index)
+{
+    m_filter->setMinimumSeverity(static_cast<LogSeverity>(m_filterCombo->itemData(index).toInt()));
+    m_listView->scrollToBottom();
+}
@@ -0,0 +1,90 @@
+#ifndef LOGVIEW_H
+#define LOGVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QTimer>
+#include <QPointer>
+#include "log/LogEntry.h"
+
+class QListView;
+class QComboBox;
+class LogModel;
+class LogSeverityFilter;
+class LogFileSink;
+
+/**
+ * @brief 日志显示控件（替代只增不减的 QTextEdit 日志框）
+ *
+ * 职责：
+ * - 日志先进入待显示队列，由帧定时器合并后一次性追加到模型，高频日志不逐条刷新界面
+ * - 模型为定长环形缓冲区，QListView 只绘制可见行，长时间运行内存和刷新耗时都保持恒定
+ * - 按级别过滤显示；视图停在底部时自动跟随最新日志
+ * - 可选地将每批日志转发给后台线程的 LogFileSink 写入文件
+ */
+class LogView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kFlushIntervalMs = 50;     ///< 合并刷新间隔（约20帧/秒）
+
+    explicit LogView(QWidget *parent = nullptr);
+    ~LogView() override;
+
+    /**
+     * @brief 设置文件输出
+     * @param sink 文件输出服务（为空时不写文件；由调用方管理生命周期，先于本控件销毁也安全）
+     * @param source 写入文件时标注的来源
+     */
+    void setFileSink(LogFileSink *sink, const QString &source = QString());
+
+    /**
+     * @brief 设置显示的时间戳格式（QDateTime 格式字符串）
+     */
+    void setTimestampFormat(const QString &format);
+
+    /**
+     * @brief 列表控件（用于设置样式）
+     */
+    QListView *listView() const { return m_listView; }
+
+public slots:
+    /**
+     * @brief 追加日志（按内容推断级别）
+     */
+    void appendMessage(const QString &message);
+
+    /**
+     * @brief 追加指定级别的日志
+     */
+    void appendEntry(const QString &message, LogSeverity severity);
+
+    /**
+     * @brief 立即显示所有待显示的日志
+     */
+    void flush();
+
+    /**
+     * @brief 清空显示（不影响已写入文件的日志）
+     */
+    void clear();
+
+private slots:
+    /**
+     * @brief 级别过滤下拉框变化
+     */
+    void onFilterChanged(int index);
+
+private:
+    QListView *m_listView;              ///< 日志列表
+    QComboBox *m_filterCombo;           ///< 级别过滤
+    LogModel *m_model;                  ///< 环形缓冲区模型
+    LogSeverityFilter *m_filter;        ///< 级别过滤代理
+    QTimer *m_flushTimer;               ///< 合并刷新定时器
+    QVector<LogEntry> m_pending;        ///< 待显示的日志
+    QPointer<LogFileSink> m_fileSink;   ///< 文件输出（可为空）
+    QString m_source;                   ///< 文件中标注的来源
+};
+
+#endif // LOGVIEW_H
@@ -0,0 +1,81 @@
+#ifndef BAUDRATE_H
+#define BAUDRATE_H
+
+#include <cstdint>
+
+/**
+ * @brief 波特率协商公共定义（业务协议与 OTA 协议共用）
+ *
+ * 速率码 0~7 对应 kRates 中的波特率，能力位图的第 n 位表示支持速率码 n。
+ * 9600（速率码0）始终支持，是上电、复位和协商失败后的默认速率。
+ *
+ * 切换约定（下位机与 Bootloader 相同）：
+ * - 设备以原速率确认切换请求后立即切换到新速率
+ * - 切换后 kRevertMs 内未收到新速率下的有效帧（探测帧/握手帧）则自行退回 9600
+ * - 设备空闲（未收到有效帧）超过 kIdleRevertMs 或复位后同样回到 9600，上位机每次连接都重新协商
+ * - 上位机在更高速率下空闲 kKeepaliveMs 后发送探测帧保活；探测帧无回应说明设备已退回，
+ *   上位机同步退回 9600 后重新协商
+ *
+ * 旧版固件不认识 0x60 命令，上位机默认不协商（最高速率为 kDefault），由调用方显式开启。
+ */
+namespace BaudRate {
+
+constexpr int kDefault = 9600;                  ///< 默认速率
+constexpr int kRates[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+constexpr int kRateCount = sizeof(kRates) / sizeof(kRates[0]);
+constexpr int kDefaultMax = 115200;             ///< 上位机默认允许的最高速率（USB 转串口普遍稳定）
+
+constexpr int kQueryTimeoutMs = 300;            ///< 能力查询/切换确认的等待时间
+constexpr int kSettleMs = 20;                   ///< 切换后发送探测帧前的等待时间（双方完成切换）
+constexpr int kRevertMs = 1000;                 ///< 设备未收到探测帧时退回默认速率的时间
+constexpr int kIdleRevertMs = 3000;             ///< 设备空闲退回默认速率的时间
+constexpr int kKeepaliveMs = 1000;              ///< 上位机空闲保活间隔（留出探测帧重试的余量）
+constexpr int kBitsPerByte = 11;                ///< 9位模式每字节的线路位数：起始位 + 8数据位 + Mark/Space校验位 + 停止位
+
+static_assert(kRateCount <= 8, "baud capability mask is one byte");
+static_assert(kKeepaliveMs + 3 * kQueryTimeoutMs < kIdleRevertMs, "keepalive must beat the idle revert");
+
+/**
+ * @brief 波特率对应的速率码
+ * @return 速率码；不在速率表中时返回 -1
+ */
+constexpr int codeOf(int baudRate, int index = 0) {
+    return index >= kRateCount ? -1
+         : kRates[index] == baudRate ? index
+         : codeOf(baudRate, index + 1);
+}
+
+/**
+ * @brief 速率码对应的波特率（无效速率码返回默认速率）
+ */
+constexpr int rateOf(int code) {
+    return (code >= 0 && code < kRateCount) ? kRates[code] : kDefault;
+}
+
+/**
+ * @brief 速率上限以内、设备能力位图中最高的速率
+ * @param capabilityMask 设备支持的速率码位图
+ * @param maxBaudRate 上位机允许的最高速率
+ * @return 双方都支持的最高速率（至少为默认速率）
+ */
+constexpr int highestCommon(uint8_t capabilityMask, int maxBaudRate, int code = kRateCount - 1) {
+    return code <= 0 ? kDefault
+         : ((capabilityMask >> code) & 0x01) && kRates[code] <= maxBaudRate ? kRates[code]
+         : highestCommon(capabilityMask, maxBaudRate, code - 1);
+}
+
+/**
+ * @brief 单个字节在线路上的传输时间（纳秒）
+ */
+constexpr int64_t byteTimeNs(int baudRate) {
+    return baudRate > 0 ? int64_t(kBitsPerByte) * 1000000000 / baudRate : 0;
+}
+
+static_assert(codeOf(9600) == 0 && codeOf(115200) == 4 && codeOf(12345) == -1, "baud code table mismatch");
+static_assert(highestCommon(0x1F, 115200) == 115200 && highestCommon(0xFF, 57600) == 57600 &&
+              highestCommon(0x00, 921600) == kDefault, "baud negotiation mismatch");
+static_assert(byteTimeNs(9600) == 1145833 && byteTimeNs(115200) == 95486, "byte time mismatch");
+
+} // namespace BaudRate
+
+#endif // BAUDRATE_H
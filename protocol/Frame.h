@@ -0,0 +1,65 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <cstdint>
+
+/**
+ * @brief 定长协议帧（编译期可构造）
+ *
+ * 职责：
+ * - 以内联字节数组保存 N 字节的帧，构造和复制都不分配堆内存
+ * - 参数为常量时（如固定命令、工厂中的固定电压）整帧在编译期编码
+ * - 需要交给串口层时再转换为 QByteArray：静态帧常量零拷贝、零分配，运行时帧仅一次分配
+ *
+ * C++11 constexpr 限制：构造函数体必须为空，成员函数只能是单条 return 语句。
+ */
+template <int N>
+struct Frame
+{
+    static_assert(N > 0, "Frame must contain at least one byte");
+
+    uint8_t bytes[N];   ///< 帧数据
+
+    /**
+     * @brief 按字节构造（字节数必须等于 N）
+     */
+    template <typename... Bytes>
+    constexpr explicit Frame(Bytes... values)
+        : bytes{static_cast<uint8_t>(values)...}
+    {
+        static_assert(sizeof...(Bytes) == N, "Frame byte count mismatch");
+    }
+
+    static constexpr int size() { return N; }
+    constexpr uint8_t operator[](int index) const { return bytes[index]; }
+
+    /**
+     * @brief 复制为 QByteArray（一次分配）
+     */
+    QByteArray toByteArray() const
+    {
+        return QByteArray(reinterpret_cast<const char *>(bytes), N);
+    }
+
+    /**
+     * @brief 不复制地包装为 QByteArray
+     * @note 仅用于静态存储期的帧常量（如 constexpr 全局帧），返回值不得比帧本身存活更久
+     */
+    QByteArray toRawByteArray() const
+    {
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(bytes), N);
+    }
+};
+
+/**
+ * @brief 两帧内容是否相同（编译期可比较）
+ */
+template <int N>
+constexpr bool frameEquals(const Frame<N> &a, const Frame<N> &b, int index = 0)
+{
+    return index >= N ? true : (a.bytes[index] == b.bytes[index] && frameEquals(a, b, index + 1));
+}
+
+#endif // FRAME_H
@@ -0,0 +1,290 @@
+#ifndef MEASUREMENTFRAMEDECODER_H
+#define MEASUREMENTFRAMEDECODER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <cstdint>
+#include <cstring>
+#include "ProtocolParser.h"
+
+/**
+ * @brief 外部电流表测量帧流式解码器（固定容量环形缓冲区）
+ *
+ * 职责：
+ * - 缓存串口分片到达的字节流，不做任何 memmove
+ * - 通过读写游标完成帧头重同步（逐字节前移读游标，而非 remove(0, 1)）
+ * - 单次遍历解码当前缓冲区内所有完整帧，输出到连续的 float 数组
+ *
+ * 帧格式：[0x50] + [4字节float little-endian]
+ * 启用打包帧后同时解码 0x52/0x53 打包测量帧（格式见 ProtocolParser），CRC 错误的帧计数后重同步
+ * 启用扫描帧后同时解码 0x54 多通道扫描帧，可选地按样本输出通道码（未带通道的帧为 0）
+ * 可选地按样本输出帧尾之后本次送入的剩余字节数，调用方据此和波特率推算每个样本的到达时刻
+ *
+ * 与 ProtocolParser::parseExternalMeasurementWithHeader 的区别：
+ * 后者每解析一帧都要 QByteArray::remove(0, 5)，大块数据到达时为 O(n²)；
+ * 本解码器对每个字节只访问一次，整体为 O(n)。
+ */
+class MeasurementFrameDecoder
+{
+public:
+    static constexpr int kCapacity = 4096;          ///< 环形缓冲区容量（必须为2的幂）
+    static constexpr int kFrameSize = 5;            ///< 帧长度：1字节帧头 + 4字节float
+    static constexpr uint8_t kFrameHeader = 0x50;   ///< 帧头
+
+    MeasurementFrameDecoder()
+        : m_readPos(0)
+        , m_writePos(0)
+        , m_packedEnabled(false)
+        , m_scanEnabled(false)
+        , m_crcErrors(0)
+        , m_floatRun(0)
+    {}
+
+    /**
+     * @brief 设置是否解码打包测量帧（设备确认切换测量帧格式后启用）
+     *
+     * 未启用时 0x52/0x53 按普通字节跳过，避免在原始 float 流中等待不存在的打包帧。
+     */
+    void setPackedFramesEnabled(bool enabled) { m_packedEnabled = enabled; m_floatRun = 0; }
+    bool packedFramesEnabled() const { return m_packedEnabled; }
+
+    /**
+     * @brief 设置是否解码多通道扫描帧（设备确认切换为 MultiChannel 格式后启用）
+     */
+    void setScanFramesEnabled(bool enabled) { m_scanEnabled = enabled; m_floatRun = 0; }
+    bool scanFramesEnabled() const { return m_scanEnabled; }
+
+    /**
+     * @brief CRC 校验失败的打包帧/扫描帧数（诊断用）
+     */
+    qint64 crcErrors() const { return m_crcErrors; }
+
+    /**
+     * @brief 最近连续解码的 float 帧数（解码出打包帧/扫描帧时清零）
+     *
+     * 启用打包帧或扫描帧后仍连续收到 float 帧，说明设备已复位或空闲退回 Float 格式。
+     */
+    int floatFrameRun() const { return m_floatRun; }
+
+    /**
+     * @brief 清空缓冲区（丢弃所有未解码字节）
+     */
+    void clear()
+    {
+        m_readPos = 0;
+        m_writePos = 0;
+        m_floatRun = 0;
+    }
+
+    /**
+     * @brief 当前缓存的未解码字节数
+     */
+    int size() const
+    {
+        return static_cast<int>(m_writePos - m_readPos);
+    }
+
+    /**
+     * @brief 追加一段字节流并解码其中所有完整帧
+     * @param chunk 本次串口读到的数据
+     * @param[out] outValues 解码结果追加到末尾（调用方可复用该数组避免重复分配）
+     * @param[out] outChannels 可选，与 outValues 逐项对应的通道码（未带通道的帧为 0）
+     * @param[out] outTrailingBytes 可选，与 outValues 逐项对应：样本所在帧的帧尾之后本次 chunk 中还剩余的字节数
+     * @return 本次解码出的样本数
+     *
+     * 大于缓冲区容量的数据块会分段写入，每写满一段就解码一次，
+     * 因为解码后最多残留一个不完整帧（不超过 ProtocolParser::kPackedMaxFrameSize 字节），缓冲区永远不会溢出。
+     */
+    int feed(const QByteArray &chunk, QVector<float> &outValues, QVector<uint8_t> *outChannels = nullptr,
+             QVector<int> *outTrailingBytes = nullptr)
+    {
+        const char *src = chunk.constData();
+        int remaining = chunk.size();
+        int decoded = 0;
+        const int trailingBase = outTrailingBytes ? outTrailingBytes->size() : 0;
+
+        while (remaining > 0) {
+            int writable = qMin(remaining, kCapacity - size());
+            append(src, writable);
+            src += writable;
+            remaining -= writable;
+
+            // 按最大可能帧数预留输出空间，解码时直接写入连续内存
+            // （打包帧每个样本至少占 1 字节，按字节数预留即可；扫描帧每个样本占用不少于 kFrameSize 字节）
+            int base = outValues.size();
+            const int reserve = m_packedEnabled ? size() : size() / kFrameSize;
+            outValues.resize(base + reserve);
+            uint8_t *channels = nullptr;
+            if (outChannels) {
+                outChannels->resize(base + reserve);
+                channels = outChannels->data() + base;
+            }
+            uint32_t *frameEnds = nullptr;
+            if (outTrailingBytes) {
+                const int endsBase = outTrailingBytes->size();
+                outTrailingBytes->resize(endsBase + reserve);
+                frameEnds = reinterpret_cast<uint32_t *>(outTrailingBytes->data() + endsBase);
+            }
+            int count = decode(outValues.data() + base, channels, frameEnds);
+            outValues.resize(base + count);
+            if (outChannels) {
+                outChannels->resize(base + count);
+            }
+            if (outTrailingBytes) {
+                outTrailingBytes->resize(outTrailingBytes->size() - reserve + count);
+            }
+            decoded += count;
+        }
+
+        // 解码时记录的是帧尾的写游标位置，全部写入后换算为帧尾之后的字节数
+        if (outTrailingBytes) {
+            int *trailing = outTrailingBytes->data();
+            for (int i = trailingBase; i < outTrailingBytes->size(); ++i) {
+                trailing[i] = static_cast<int>(m_writePos - static_cast<uint32_t>(trailing[i]));
+            }
+        }
+
+        return decoded;
+    }
+
+private:
+    static constexpr uint32_t kMask = kCapacity - 1;
+
+    /**
+     * @brief 写入字节（调用方保证不超过剩余容量）
+     */
+    void append(const char *data, int length)
+    {
+        // 最多分两段拷贝：写游标到缓冲区末尾 + 缓冲区开头
+        uint32_t start = m_writePos & kMask;
+        int firstPart = qMin(length, static_cast<int>(kCapacity - start));
+        memcpy(m_buffer + start, data, firstPart);
+        if (length > firstPart) {
+            memcpy(m_buffer, data + firstPart, length - firstPart);
+        }
+        m_writePos += static_cast<uint32_t>(length);
+    }
+
+    /**
+     * @brief 单次遍历解码所有完整帧
+     * @param out 输出数组，容量至少为 size() / kFrameSize（启用打包帧时为 size()）
+     * @param channels 可选的通道码输出数组，容量与 out 相同
+     * @param frameEnds 可选的帧尾位置输出数组（写游标坐标），容量与 out 相同
+     * @return 解码出的样本数
+     */
+    int decode(float *out, uint8_t *channels, uint32_t *frameEnds)
+    {
+        int count = 0;
+
+        while (m_writePos - m_readPos >= static_cast<uint32_t>(kFrameSize)) {
+            const uint8_t header = m_buffer[m_readPos & kMask];
+
+            if (m_packedEnabled && ProtocolParser::isPackedHeader(header)) {
+                const int frameSize = ProtocolParser::packedFrameSize(header, m_buffer[(m_readPos + 1) & kMask]);
+                if (frameSize < 0) {
+                    ++m_readPos;
+                    continue;
+                }
+                if (m_writePos - m_readPos < static_cast<uint32_t>(frameSize)) {
+                    break;  // 等待帧的剩余部分
+                }
+
+                // 打包帧可能跨越缓冲区末尾，复制到连续内存后解码
+                uint8_t frame[ProtocolParser::kPackedMaxFrameSize];
+                for (int i = 0; i < frameSize; ++i) {
+                    frame[i] = m_buffer[(m_readPos + i) & kMask];
+                }
+                const int decoded = ProtocolParser::decodePackedFrame(frame, frameSize, out + count);
+                if (decoded < 0) {
+                    ++m_crcErrors;
+                    ++m_readPos;
+                    continue;
+                }
+                if (channels) {
+                    memset(channels + count, 0, static_cast<size_t>(decoded));
+                }
+                m_floatRun = 0;
+                m_readPos += static_cast<uint32_t>(frameSize);
+                markFrameEnd(frameEnds, count, decoded);
+                count += decoded;
+                continue;
+            }
+
+            if (m_scanEnabled && header == ProtocolParser::kScanHeader) {
+                const int frameSize = ProtocolParser::scanFrameSize(m_buffer[(m_readPos + 1) & kMask]);
+                if (frameSize < 0) {
+                    ++m_readPos;
+                    continue;
+                }
+                if (m_writePos - m_readPos < static_cast<uint32_t>(frameSize)) {
+                    break;  // 等待帧的剩余部分
+                }
+
+                uint8_t frame[ProtocolParser::kScanMaxFrameSize];
+                for (int i = 0; i < frameSize; ++i) {
+                    frame[i] = m_buffer[(m_readPos + i) & kMask];
+                }
+                uint8_t codes[ProtocolParser::kScanMaxChannels];
+                const int decoded = ProtocolParser::decodeScanFrame(frame, frameSize, out + count, codes);
+                if (decoded < 0) {
+                    ++m_crcErrors;
+                    ++m_readPos;
+                    continue;
+                }
+                if (channels) {
+                    memcpy(channels + count, codes, static_cast<size_t>(decoded));
+                }
+                m_floatRun = 0;
+                m_readPos += static_cast<uint32_t>(frameSize);
+                markFrameEnd(frameEnds, count, decoded);
+                count += decoded;
+                continue;
+            }
+
+            // 帧头不匹配：仅前移读游标完成重同步
+            if (header != kFrameHeader) {
+                ++m_readPos;
+                continue;
+            }
+
+            // 提取4字节float（小端序），可能跨越缓冲区末尾
+            uint8_t bytes[4];
+            for (int i = 0; i < 4; ++i) {
+                bytes[i] = m_buffer[(m_readPos + 1 + i) & kMask];
+            }
+            memcpy(&out[count], bytes, sizeof(float));
+            if (channels) {
+                channels[count] = 0;
+            }
+
+            m_readPos += kFrameSize;
+            markFrameEnd(frameEnds, count, 1);
+            ++count;
+            ++m_floatRun;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief 为刚解码的一帧中的样本记录帧尾位置（同一帧的样本共用帧尾）
+     */
+    void markFrameEnd(uint32_t *frameEnds, int first, int count) const
+    {
+        if (frameEnds) {
+            for (int i = 0; i < count; ++i) {
+                frameEnds[first + i] = m_readPos;
+            }
+        }
+    }
+
+    uint8_t m_buffer[kCapacity];    ///< 环形缓冲区
+    uint32_t m_readPos;             ///< 读游标（单调递增，取模得到下标）
+    uint32_t m_writePos;            ///< 写游标（单调递增，取模得到下标）
+    bool m_packedEnabled;           ///< 是否解码打包测量帧
+    bool m_scanEnabled;             ///< 是否解码多通道扫描帧
+    qint64 m_crcErrors;             ///< CRC 校验失败的打包帧/扫描帧数
+    int m_floatRun;                 ///< 最近连续解码的 float 帧数
+};
+
+#endif // MEASUREMENTFRAMEDECODER_H
@@ -4,6 +4,8 @@
 #include <QByteArray>
 #include <QVector>
 #include <QDateTime>
+#include <cstdint>
+#include <cstring>
 #include "../domain/Measurement.h"
 
 #include <QDebug>
@@ -20,10 +22,231 @@
  * - 测量帧：[0x13] + [4字节float little-endian]
  * - 开始检测确认帧：[0x05]（单字节，与测量帧分离）
  * - 暂停检测确认帧：[0xAA] + [0x55]（双字节特征码）
+ * - 打包测量帧（设备支持时由上位机选择，见 DeviceProtocol::MeasurementFormat）：
+ *   [0x52|0x53] + [样本数N] + [base float] + [scale float] + [样本] + [CRC16 little-endian]
+ *   0x52：N 个 int16 样本；0x53：首个 int16 样本 + (N-1) 个 int8 差值
+ *   第 i 个测量值 = base + scale * q[i]，CRC16/MODBUS 覆盖帧头到最后一个样本
+ * - 多通道扫描帧（MeasurementFormat::MultiChannel）：
+ *   [0x54] + [通道位图] + [每个通道一个 float] + [CRC16 little-endian]
+ *   位图 bit0~bit3 对应 CH1~CH4，float 按通道号从小到大排列；同一帧的样本属于同一次扫描（共用时间基准）
  */
 class ProtocolParser
 {
 public:
+    static constexpr uint8_t kPackedInt16Header = 0x52;     ///< 打包测量帧帧头（int16 样本）
+    static constexpr uint8_t kPackedDeltaHeader = 0x53;     ///< 打包测量帧帧头（int8 差值样本）
+    static constexpr int kPackedMaxSamples = 64;            ///< 单帧最多样本数
+    static constexpr int kPackedPrefixSize = 10;            ///< 帧头(1) + 样本数(1) + base(4) + scale(4)
+    static constexpr int kPackedCrcSize = 2;                ///< CRC16
+    static constexpr int kPackedMaxFrameSize = kPackedPrefixSize + kPackedMaxSamples * 2 + kPackedCrcSize;
+
+    static constexpr uint8_t kScanHeader = 0x54;            ///< 多通道扫描帧帧头
+    static constexpr int kScanMaxChannels = 4;              ///< 通道数（CH1~CH4）
+    static constexpr uint8_t kScanAllChannels = 0x0F;       ///< 全部通道的位图
+    static constexpr int kScanMaxFrameSize = 2 + kScanMaxChannels * 4 + kPackedCrcSize;
+
+    /**
+     * @brief 通道位图中的通道数
+     */
+    static constexpr int scanChannelCount(uint8_t mask)
+    {
+        return mask == 0 ? 0 : (mask & 0x01) + scanChannelCount(static_cast<uint8_t>(mask >> 1));
+    }
+
+    /**
+     * @brief 根据通道位图计算扫描帧长度
+     * @return 帧长度；位图为空或含 CH4 以外的位时返回 -1
+     */
+    static constexpr int scanFrameSize(uint8_t mask)
+    {
+        return (mask == 0 || (mask & ~kScanAllChannels) != 0) ? -1
+             : 2 + scanChannelCount(mask) * 4 + kPackedCrcSize;
+    }
+
+    /**
+     * @brief 位图第 bit 位对应的通道码（与 Measurement::Channel / DeviceProtocol::ChannelCode 相同）
+     */
+    static constexpr uint8_t scanChannelCode(int bit)
+    {
+        return static_cast<uint8_t>(0x11 + 0x10 * bit);
+    }
+
+    /**
+     * @brief 是否为打包测量帧帧头
+     */
+    static constexpr bool isPackedHeader(uint8_t header)
+    {
+        return header == kPackedInt16Header || header == kPackedDeltaHeader;
+    }
+
+    /**
+     * @brief 根据帧头和样本数计算打包测量帧长度
+     * @return 帧长度；帧头或样本数无效时返回 -1
+     */
+    static constexpr int packedFrameSize(uint8_t header, uint8_t count)
+    {
+        return (count == 0 || count > kPackedMaxSamples) ? -1
+             : header == kPackedInt16Header ? kPackedPrefixSize + count * 2 + kPackedCrcSize
+             : header == kPackedDeltaHeader ? kPackedPrefixSize + 2 + (count - 1) + kPackedCrcSize
+             : -1;
+    }
+
+    /**
+     * @brief CRC16/MODBUS（多项式 0x8005 反射，初值 0xFFFF，与 OtaProtocol::calculateCRC16 相同）
+     */
+    static uint16_t crc16(const uint8_t *data, int length)
+    {
+        uint16_t crc = 0xFFFF;
+        for (int i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief 解码一个完整的打包测量帧
+     * @param frame 帧数据（从帧头开始，长度为 packedFrameSize）
+     * @param length 帧长度
+     * @param[out] out 输出数组，容量至少为 kPackedMaxSamples
+     * @return 解码出的样本数；长度不符或 CRC 错误时返回 -1
+     */
+    static int decodePackedFrame(const uint8_t *frame, int length, float *out)
+    {
+        const int expected = packedFrameSize(frame[0], length > 1 ? frame[1] : 0);
+        if (expected < 0 || length != expected) {
+            return -1;
+        }
+
+        const uint16_t crc = static_cast<uint16_t>(frame[length - 2] | (frame[length - 1] << 8));
+        if (crc16(frame, length - kPackedCrcSize) != crc) {
+            return -1;
+        }
+
+        const int count = frame[1];
+        float base;
+        float scale;
+        memcpy(&base, frame + 2, sizeof(float));
+        memcpy(&scale, frame + 6, sizeof(float));
+
+        const uint8_t *samples = frame + kPackedPrefixSize;
+        int16_t q = static_cast<int16_t>(samples[0] | (samples[1] << 8));
+        out[0] = base + scale * q;
+        for (int i = 1; i < count; ++i) {
+            if (frame[0] == kPackedInt16Header) {
+                q = static_cast<int16_t>(samples[i * 2] | (samples[i * 2 + 1] << 8));
+            } else {
+                q = static_cast<int16_t>(q + static_cast<int8_t>(samples[1 + i]));
+            }
+            out[i] = base + scale * q;
+        }
+        return count;
+    }
+
+    /**
+     * @brief 编码打包测量帧（模拟设备和测试数据使用）
+     * @param header kPackedInt16Header 或 kPackedDeltaHeader
+     * @param base 基准值
+     * @param scale 量化步长
+     * @param samples 量化后的样本，个数为 1~kPackedMaxSamples
+     * @param count 样本数
+     * @return 帧数据；差值超出 int8 范围时无法用 0x53 编码，返回空
+     */
+    static QByteArray encodePackedFrame(uint8_t header, float base, float scale,
+                                        const int16_t *samples, int count)
+    {
+        const int size = packedFrameSize(header, static_cast<uint8_t>(qBound(0, count, 255)));
+        if (size < 0) {
+            return QByteArray();
+        }
+
+        QByteArray frame(size, Qt::Uninitialized);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(frame.data());
+        dst[0] = header;
+        dst[1] = static_cast<uint8_t>(count);
+        memcpy(dst + 2, &base, sizeof(float));
+        memcpy(dst + 6, &scale, sizeof(float));
+
+        uint8_t *out = dst + kPackedPrefixSize;
+        *out++ = static_cast<uint8_t>(samples[0] & 0xFF);
+        *out++ = static_cast<uint8_t>((samples[0] >> 8) & 0xFF);
+        for (int i = 1; i < count; ++i) {
+            if (header == kPackedInt16Header) {
+                *out++ = static_cast<uint8_t>(samples[i] & 0xFF);
+                *out++ = static_cast<uint8_t>((samples[i] >> 8) & 0xFF);
+            } else {
+                const int delta = samples[i] - samples[i - 1];
+                if (delta < -128 || delta > 127) {
+                    return QByteArray();
+                }
+                *out++ = static_cast<uint8_t>(static_cast<int8_t>(delta));
+            }
+        }
+
+        const uint16_t crc = crc16(dst, size - kPackedCrcSize);
+        *out++ = static_cast<uint8_t>(crc & 0xFF);
+        *out = static_cast<uint8_t>((crc >> 8) & 0xFF);
+        return frame;
+    }
+
+    /**
+     * @brief 解码一个完整的多通道扫描帧
+     * @param frame 帧数据（从帧头开始，长度为 scanFrameSize）
+     * @param length 帧长度
+     * @param[out] out 输出数组，容量至少为 kScanMaxChannels
+     * @param[out] channels 每个样本的通道码，容量至少为 kScanMaxChannels
+     * @return 解码出的样本数；长度不符或 CRC 错误时返回 -1
+     */
+    static int decodeScanFrame(const uint8_t *frame, int length, float *out, uint8_t *channels)
+    {
+        const int expected = length > 1 ? scanFrameSize(frame[1]) : -1;
+        if (expected < 0 || length != expected) {
+            return -1;
+        }
+
+        const uint16_t crc = static_cast<uint16_t>(frame[length - 2] | (frame[length - 1] << 8));
+        if (crc16(frame, length - kPackedCrcSize) != crc) {
+            return -1;
+        }
+
+        int count = 0;
+        for (int bit = 0; bit < kScanMaxChannels; ++bit) {
+            if (frame[1] & (1u << bit)) {
+                memcpy(&out[count], frame + 2 + count * 4, sizeof(float));
+                channels[count] = scanChannelCode(bit);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief 编码多通道扫描帧（模拟设备和测试数据使用）
+     * @param mask 通道位图
+     * @param values 各通道的测量值，按通道号从小到大排列，个数为 scanChannelCount(mask)
+     * @return 帧数据；位图无效时返回空
+     */
+    static QByteArray encodeScanFrame(uint8_t mask, const float *values)
+    {
+        const int size = scanFrameSize(mask);
+        if (size < 0) {
+            return QByteArray();
+        }
+
+        QByteArray frame(size, Qt::Uninitialized);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(frame.data());
+        dst[0] = kScanHeader;
+        dst[1] = mask;
+        memcpy(dst + 2, values, static_cast<size_t>(scanChannelCount(mask)) * sizeof(float));
+
+        const uint16_t crc = crc16(dst, size - kPackedCrcSize);
+        dst[size - 2] = static_cast<uint8_t>(crc & 0xFF);
+        dst[size - 1] = static_cast<uint8_t>((crc >> 8) & 0xFF);
+        return frame;
+    }
+
     /**
      * @brief 解析外部电流表测量帧（带帧头：0x50 + 4字节float）
      * @param buffer 输入/输出缓冲区，解析后会移除已处理的帧
@@ -32,6 +255,8 @@ public:
      * 
      * 帧格式：[0x50] + [4字节float little-endian]
      * 数据来自外部RS485电流表，由MCU转发
+     *
+     * @note 每帧都会移动缓冲区数据，仅适合少量数据；连续数据流请使用 MeasurementFrameDecoder
      */
     static bool parseExternalMeasurementWithHeader(QByteArray &buffer, float &outValue)
     {        
@@ -198,6 +423,38 @@ public:
         // 判断receivedData是否以expectedResponse开头
         return receivedData.startsWith(expectedResponse);
     }
+
+    /**
+     * @brief 查找期望回应在接收数据中的位置
+     * @param receivedData 接收到的数据
+     * @param expectedResponse 期望的回应
+     * @return 首次出现的位置，未找到返回-1
+     *
+     * 使用逐字节 uint8_t 比较查找匹配位置，
+     * QByteArray::indexOf 对 0xAA 等高字节值存在符号问题
+     */
+    static int findResponse(const QByteArray &receivedData,
+                            const QByteArray &expectedResponse)
+    {
+        if (expectedResponse.isEmpty()) {
+            return -1;
+        }
+
+        for (int i = 0; i <= receivedData.size() - expectedResponse.size(); i++) {
+            bool match = true;
+            for (int j = 0; j < expectedResponse.size(); j++) {
+                if (static_cast<uint8_t>(receivedData[i + j]) !=
+                    static_cast<uint8_t>(expectedResponse[j])) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                return i;
+            }
+        }
+        return -1;
+    }
 };
 
 #endif // PROTOCOLPARSER_H
@@ -0,0 +1,263 @@
+#ifndef RESPONSEMATCHER_H
+#define RESPONSEMATCHER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <cstdint>
+#include <cstring>
+#include "ProtocolParser.h"
+
+/**
+ * @brief 确认帧/测量帧增量匹配器（可跨读取恢复的状态机）
+ *
+ * 职责：
+ * - 逐字节识别期望的确认帧和外部电流表测量帧（0x50 + 4字节float），每个字节只前进一次
+ * - 未完成的帧保存在内部帧缓冲中，下一块数据到达时从断点继续，与操作系统如何拆分读取无关
+ * - 匹配成功时直接给出帧在字节流中的偏移，不再二次搜索
+ *
+ * 帧定界状态：
+ * - 空闲：当前帧缓冲为空，等待帧首字节
+ * - 帧内：帧缓冲是某个期望回应或测量帧的前缀，继续接收
+ * - 完成：帧缓冲等于某个期望回应（确认帧）或构成完整测量帧，输出事件并回到空闲
+ * - 失配：帧缓冲不是任何候选的前缀，丢弃首字节后用剩余字节重新定界（最多回看一个最长帧的长度）
+ *
+ * 确认帧优先于测量帧：启动检测确认 [0x50, 0xAA] 与测量帧帧头相同时按确认帧处理。
+ * 启用打包帧后同样识别 0x52/0x53 打包测量帧（CRC 错误按失配重新定界），整帧样本作为一个事件输出。
+ * 启用扫描帧后识别 0x54 多通道扫描帧，整帧样本连同各自的通道码作为一个事件输出。
+ * 测量帧内部出现的字节不会被误认为确认帧，取代了原先"向前查找 0x13"的启发式判断。
+ *
+ * 期望回应由调用方在每次 next() 时传入（通常为在途命令的回应），
+ * 因此命令在两次读取之间超时、重试或新发出时无需通知匹配器。
+ */
+class ResponseMatcher
+{
+public:
+    static constexpr int kMaxFrameSize = 8;                 ///< 可识别的最长确认帧（期望回应不得超过该长度）
+    static constexpr int kMeasurementFrameSize = 5;         ///< 测量帧长度：1字节帧头 + 4字节float
+    static constexpr uint8_t kMeasurementHeader = 0x50;     ///< 测量帧帧头
+
+    /**
+     * @brief 匹配事件
+     */
+    struct Event {
+        enum Type {
+            Ack,                ///< 确认帧
+            Measurement,        ///< 测量帧
+            MeasurementBatch    ///< 打包测量帧/多通道扫描帧
+        };
+
+        Type type;              ///< 事件类型
+        int expectationIndex;   ///< 匹配的期望回应下标（Ack）
+        qint64 offset;          ///< 帧首字节在字节流中的偏移（自 reset() 起）
+        float value;            ///< 测量值（Measurement）
+        const float *values;    ///< 打包帧的测量值（MeasurementBatch，下次 next() 前有效）
+        int valueCount;         ///< 打包帧的样本数（MeasurementBatch）
+        const uint8_t *channels;    ///< 扫描帧各样本的通道码（其他帧为 nullptr）
+    };
+
+    ResponseMatcher() : m_packedEnabled(false), m_scanEnabled(false) { reset(); }
+
+    /**
+     * @brief 设置是否识别打包测量帧（与 MeasurementFrameDecoder 保持一致）
+     */
+    void setPackedFramesEnabled(bool enabled) { m_packedEnabled = enabled; }
+
+    /**
+     * @brief 设置是否识别多通道扫描帧（与 MeasurementFrameDecoder 保持一致）
+     */
+    void setScanFramesEnabled(bool enabled) { m_scanEnabled = enabled; }
+
+    /**
+     * @brief 清空状态（丢弃未完成的帧和未处理的数据）
+     */
+    void reset()
+    {
+        m_chunk.clear();
+        m_chunkPos = 0;
+        m_frameLength = 0;
+        m_streamOffset = 0;
+        m_discardedBytes = 0;
+    }
+
+    /**
+     * @brief 送入新读取的数据块（此前的数据块应已通过 next() 处理完）
+     */
+    void feed(const QByteArray &chunk)
+    {
+        m_chunk = chunk;
+        m_chunkPos = 0;
+    }
+
+    /**
+     * @brief 继续匹配，直到识别出一个完整帧或数据块耗尽
+     * @param expected 期望回应数组（按优先级排列，通常为在途命令顺序）
+     * @param count 期望回应数量
+     * @param[out] event 识别出的帧
+     * @return true 识别出一帧；false 数据块已耗尽（未完成的帧保留到下次 feed）
+     */
+    bool next(const QByteArray *expected, int count, Event &event)
+    {
+        while (m_chunkPos < m_chunk.size()) {
+            m_frame[m_frameLength++] = static_cast<uint8_t>(m_chunk.at(m_chunkPos++));
+            ++m_streamOffset;
+
+            // 失配时逐字节丢弃帧首并重新定界，直到剩余字节仍是某个候选的前缀
+            while (m_frameLength > 0) {
+                const Match match = evaluate(expected, count, event);
+                if (match == Complete) {
+                    return true;
+                }
+                if (match == Partial) {
+                    break;
+                }
+                std::memmove(m_frame, m_frame + 1, static_cast<size_t>(m_frameLength - 1));
+                --m_frameLength;
+                ++m_discardedBytes;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 取出尚未识别的字节（未完成的帧 + 数据块剩余部分），并清空
+     *
+     * 所有命令已确认、改由测量帧解码器处理后续数据时使用，保证字节流不断档。
+     */
+    QByteArray takeRemaining()
+    {
+        QByteArray rest(reinterpret_cast<const char *>(m_frame), m_frameLength);
+        rest.append(m_chunk.constData() + m_chunkPos, m_chunk.size() - m_chunkPos);
+        m_streamOffset += m_chunk.size() - m_chunkPos;
+        m_chunk.clear();
+        m_chunkPos = 0;
+        m_frameLength = 0;
+        return rest;
+    }
+
+    /**
+     * @brief 是否有尚未识别的字节
+     */
+    bool hasPendingBytes() const { return m_frameLength > 0 || m_chunkPos < m_chunk.size(); }
+
+    /**
+     * @brief 当前数据块中尚未扫描的字节数
+     *
+     * 在 next() 返回事件后调用，即该帧帧尾之后本块剩余的字节数，用于按波特率推算帧的到达时刻。
+     */
+    int unscannedBytes() const { return m_chunk.size() - m_chunkPos; }
+
+    /**
+     * @brief 重新定界时丢弃的字节数（诊断用）
+     */
+    qint64 discardedBytes() const { return m_discardedBytes; }
+
+private:
+    enum Match {
+        NoMatch,    ///< 帧缓冲不是任何候选的前缀
+        Partial,    ///< 帧缓冲是某个候选的前缀
+        Complete    ///< 帧缓冲构成完整帧（已输出事件并清空帧缓冲）
+    };
+
+    /**
+     * @brief 判定当前帧缓冲（每个字节最多比较 count+1 个候选，与缓冲区历史长度无关）
+     */
+    Match evaluate(const QByteArray *expected, int count, Event &event)
+    {
+        bool partial = false;
+
+        for (int i = 0; i < count; ++i) {
+            const int size = expected[i].size();
+            if (size == 0 || size > kMaxFrameSize || m_frameLength > size ||
+                std::memcmp(m_frame, expected[i].constData(), static_cast<size_t>(m_frameLength)) != 0) {
+                continue;
+            }
+            if (m_frameLength == size) {
+                event.type = Event::Ack;
+                event.expectationIndex = i;
+                event.offset = m_streamOffset - size;
+                event.value = 0.0f;
+                event.values = nullptr;
+                event.valueCount = 0;
+                event.channels = nullptr;
+                m_frameLength = 0;
+                return Complete;
+            }
+            partial = true;
+        }
+
+        if (m_packedEnabled && ProtocolParser::isPackedHeader(m_frame[0])) {
+            const int frameSize = m_frameLength < 2 ? 0 : ProtocolParser::packedFrameSize(m_frame[0], m_frame[1]);
+            if (frameSize == 0 || (frameSize > 0 && m_frameLength < frameSize)) {
+                partial = true;
+            } else if (frameSize > 0 && !partial) {
+                const int decoded = ProtocolParser::decodePackedFrame(m_frame, frameSize, m_packedValues);
+                if (decoded > 0) {
+                    event.type = Event::MeasurementBatch;
+                    event.expectationIndex = -1;
+                    event.offset = m_streamOffset - frameSize;
+                    event.value = m_packedValues[0];
+                    event.values = m_packedValues;
+                    event.valueCount = decoded;
+                    event.channels = nullptr;
+                    m_frameLength = 0;
+                    return Complete;
+                }
+            }
+        }
+
+        if (m_scanEnabled && m_frame[0] == ProtocolParser::kScanHeader) {
+            const int frameSize = m_frameLength < 2 ? 0 : ProtocolParser::scanFrameSize(m_frame[1]);
+            if (frameSize == 0 || (frameSize > 0 && m_frameLength < frameSize)) {
+                partial = true;
+            } else if (frameSize > 0 && !partial) {
+                const int decoded = ProtocolParser::decodeScanFrame(m_frame, frameSize, m_packedValues, m_scanChannels);
+                if (decoded > 0) {
+                    event.type = Event::MeasurementBatch;
+                    event.expectationIndex = -1;
+                    event.offset = m_streamOffset - frameSize;
+                    event.value = m_packedValues[0];
+                    event.values = m_packedValues;
+                    event.valueCount = decoded;
+                    event.channels = m_scanChannels;
+                    m_frameLength = 0;
+                    return Complete;
+                }
+            }
+        }
+
+        if (m_frame[0] == kMeasurementHeader) {
+            if (m_frameLength == kMeasurementFrameSize && !partial) {
+                event.type = Event::Measurement;
+                event.expectationIndex = -1;
+                event.offset = m_streamOffset - kMeasurementFrameSize;
+                std::memcpy(&event.value, m_frame + 1, sizeof(float));   // 小端序
+                event.values = nullptr;
+                event.valueCount = 1;
+                event.channels = nullptr;
+                m_frameLength = 0;
+                return Complete;
+            }
+            if (m_frameLength < kMeasurementFrameSize) {
+                partial = true;
+            }
+        }
+
+        return partial ? Partial : NoMatch;
+    }
+
+    QByteArray m_chunk;                 ///< 当前数据块（隐式共享，不拷贝）
+    int m_chunkPos;                     ///< 数据块内的扫描位置
+    static constexpr int kFrameBufferSize = ProtocolParser::kPackedMaxFrameSize > ProtocolParser::kScanMaxFrameSize
+                                            ? ProtocolParser::kPackedMaxFrameSize : ProtocolParser::kScanMaxFrameSize;
+
+    uint8_t m_frame[kFrameBufferSize];  ///< 当前帧缓冲（未完成的帧跨数据块保留）
+    int m_frameLength;                  ///< 当前帧已接收字节数
+    qint64 m_streamOffset;              ///< 已扫描的字节总数
+    qint64 m_discardedBytes;            ///< 重新定界丢弃的字节数
+    bool m_packedEnabled;               ///< 是否识别打包测量帧
+    bool m_scanEnabled;                 ///< 是否识别多通道扫描帧
+    float m_packedValues[ProtocolParser::kPackedMaxSamples];   ///< 最近一个打包帧/扫描帧的测量值
+    uint8_t m_scanChannels[ProtocolParser::kScanMaxChannels];  ///< 最近一个扫描帧的通道码
+};
+
+#endif // RESPONSEMATCHER_H
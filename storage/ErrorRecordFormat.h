@@ -0,0 +1,67 @@
+#ifndef ERRORRECORDFORMAT_H
+#define ERRORRECORDFORMAT_H
+
+#include <QtGlobal>
+
+/**
+ * @brief 错误记录库文件格式（按批列式存储，只追加写入）
+ *
+ * 文件 = 文件头(32字节) + 数据块 × N。每个数据块保存一批记录：
+ *   块头(56字节)
+ *   新增字符串：stringCount × (quint32 字节数 + UTF-8)，编号从 firstStringId 起依次递增
+ *   定长列：wallMs[n] runId[n] fixtureId[n] stepNameId[n] actionDescId[n] errorTypeId[n]
+ *           stepIndex[n] actionIndex[n] measured[n] threshold[n]
+ *   变长列：boardSerial[n] errorDetail[n]，每项为 quint32 字节数 + UTF-8
+ *
+ * 治具名、步骤名、动作描述、错误类型在整个文件内去重（字符串表），记录中只存编号，0 表示空字符串；
+ * 板号和错误详情几乎不重复，直接存在块内。
+ * 块头带时间和运行编号范围，按条件查询时不匹配的块整块跳过。
+ * 所有字段按小端（主机字节序）存储；异常退出时末尾不完整的块在读取时忽略，写入时截掉。
+ */
+namespace ErrorRecordFormat {
+
+constexpr char MAGIC[8] = {'P', 'C', 'B', 'A', 'E', 'R', 'R', '1'};
+constexpr quint32 VERSION = 1;
+constexpr quint32 BLOCK_MARKER = 0x4B4C4245;   ///< 块标记 "EBLK"
+
+/**
+ * @brief 定长列每条记录的字节数
+ */
+constexpr int FIXED_COLUMN_BYTES = 8 + 8 + 4 * 4 + 2 + 2 + 8 + 8;
+
+#pragma pack(push, 1)
+/**
+ * @brief 文件头
+ */
+struct FileHeader {
+    char magic[8];                  ///< 文件标识 "PCBAERR1"
+    quint32 version;                ///< 格式版本
+    quint32 headerSize;             ///< 文件头大小（字节）
+    quint32 blockHeaderSize;        ///< 块头大小（字节）
+    quint32 reserved0;              ///< 保留
+    qint64 createdWallMs;           ///< 创建时间（毫秒）
+};
+
+/**
+ * @brief 数据块头
+ */
+struct BlockHeader {
+    quint32 marker;                 ///< 块标记 BLOCK_MARKER
+    quint32 payloadBytes;           ///< 块头之后的数据字节数
+    quint32 recordCount;            ///< 记录数
+    quint32 firstStringId;          ///< 本块新增字符串的起始编号
+    quint32 stringCount;            ///< 本块新增字符串数
+    quint32 reserved0;              ///< 保留
+    qint64 minWallMs;               ///< 本块最早记录时间（毫秒）
+    qint64 maxWallMs;               ///< 本块最晚记录时间（毫秒）
+    qint64 minRunId;                ///< 本块最小运行编号
+    qint64 maxRunId;                ///< 本块最大运行编号
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader must be 32 bytes");
+static_assert(sizeof(BlockHeader) == 56, "BlockHeader must be 56 bytes");
+
+} // namespace ErrorRecordFormat
+
+#endif // ERRORRECORDFORMAT_H
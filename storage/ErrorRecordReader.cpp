@@ -0,0 +1,295 @@
+#include "ErrorRecordReader.h"
+#include <QObject>
+#include <algorithm>
+#include <cstring>
+
+using namespace ErrorRecordFormat;
+
+namespace {
+
+/**
+ * @brief 块数据顺序读取游标（越界时置失败标志，之后的读取都失败）
+ */
+class PayloadCursor
+{
+public:
+    PayloadCursor(const char *data, int size) : m_data(data), m_size(size), m_pos(0), m_ok(true) {}
+
+    bool ok() const { return m_ok; }
+
+    /**
+     * @brief 跳过 bytes 字节，返回跳过部分的起始指针
+     */
+    const char *skip(qint64 bytes)
+    {
+        if (!m_ok || bytes < 0 || bytes > m_size - m_pos) {
+            m_ok = false;
+            return nullptr;
+        }
+        const char *p = m_data + m_pos;
+        m_pos += static_cast<int>(bytes);
+        return p;
+    }
+
+    /**
+     * @brief 读取一个 quint32 字节数 + UTF-8 字符串，返回其在块内的位置
+     */
+    bool readString(int &offset, int &length)
+    {
+        const char *p = skip(sizeof(quint32));
+        if (!p) {
+            return false;
+        }
+        quint32 size;
+        std::memcpy(&size, p, sizeof(size));
+        offset = m_pos;
+        length = static_cast<int>(size);
+        return skip(size) != nullptr;
+    }
+
+private:
+    const char *m_data;
+    int m_size;
+    int m_pos;
+    bool m_ok;
+};
+
+template <typename T>
+T columnValue(const char *column, quint32 index)
+{
+    T value;
+    std::memcpy(&value, column + static_cast<size_t>(index) * sizeof(T), sizeof(T));
+    return value;
+}
+
+} // namespace
+
+ErrorRecordReader::ErrorRecordReader()
+    : m_recordCount(0)
+    , m_validSize(0)
+{
+}
+
+ErrorRecordReader::~ErrorRecordReader()
+{
+    close();
+}
+
+bool ErrorRecordReader::open(const QString &filePath, QString *errorString)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = m_file.errorString();
+        }
+        return false;
+    }
+
+    // 校验文件头
+    FileHeader header;
+    if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+        std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != VERSION ||
+        header.headerSize != sizeof(FileHeader) ||
+        header.blockHeaderSize != sizeof(BlockHeader)) {
+        if (errorString) {
+            *errorString = QObject::tr("不是有效的错误记录库文件");
+        }
+        close();
+        return false;
+    }
+
+    scanBlocks();
+    return true;
+}
+
+void ErrorRecordReader::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_blocks.clear();
+    m_strings.clear();
+    m_recordCount = 0;
+    m_validSize = 0;
+}
+
+void ErrorRecordReader::scanBlocks()
+{
+    m_strings.append(QString());    // 编号 0：空字符串
+    m_validSize = sizeof(FileHeader);
+
+    const qint64 fileSize = m_file.size();
+    while (m_validSize + static_cast<qint64>(sizeof(BlockHeader)) <= fileSize) {
+        BlockHeader header;
+        if (!m_file.seek(m_validSize) ||
+            m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+            header.marker != BLOCK_MARKER ||
+            header.firstStringId != static_cast<quint32>(m_strings.size()) ||
+            m_validSize + static_cast<qint64>(sizeof(BlockHeader)) + header.payloadBytes > fileSize) {
+            break;  // 写入中断或损坏，之后的数据忽略
+        }
+
+        // 只读取块首的字符串区，列数据留到查询时再读
+        QVector<QString> added;
+        added.reserve(static_cast<int>(header.stringCount));
+        qint64 remaining = header.payloadBytes;
+        bool ok = true;
+        for (quint32 i = 0; i < header.stringCount; ++i) {
+            quint32 size = 0;
+            if (remaining < static_cast<qint64>(sizeof(size)) ||
+                m_file.read(reinterpret_cast<char*>(&size), sizeof(size)) != sizeof(size) ||
+                size > remaining - static_cast<qint64>(sizeof(size))) {
+                ok = false;
+                break;
+            }
+            const QByteArray utf8 = m_file.read(size);
+            if (utf8.size() != static_cast<int>(size)) {
+                ok = false;
+                break;
+            }
+            added.append(QString::fromUtf8(utf8));
+            remaining -= static_cast<qint64>(sizeof(size)) + size;
+        }
+        if (!ok) {
+            break;
+        }
+
+        BlockIndex index;
+        index.offset = m_validSize;
+        index.payloadBytes = header.payloadBytes;
+        index.recordCount = header.recordCount;
+        index.stringCount = header.stringCount;
+        index.minWallMs = header.minWallMs;
+        index.maxWallMs = header.maxWallMs;
+        index.minRunId = header.minRunId;
+        index.maxRunId = header.maxRunId;
+        m_blocks.append(index);
+
+        m_strings += added;
+        m_recordCount += header.recordCount;
+        m_validSize += static_cast<qint64>(sizeof(BlockHeader)) + header.payloadBytes;
+    }
+}
+
+int ErrorRecordReader::stringId(const QString &text) const
+{
+    return text.isEmpty() ? 0 : m_strings.indexOf(text, 1);
+}
+
+QVector<ErrorRecord> ErrorRecordReader::query(const Filter &filter, int limit) const
+{
+    QVector<ErrorRecord> result;
+    if (!m_file.isOpen() || limit <= 0) {
+        return result;
+    }
+
+    // 驻留字段先换成编号，逐条比较时只比较整数；字符串表中不存在则不可能匹配
+    const int fixtureId = filter.fixture.isEmpty() ? 0 : stringId(filter.fixture);
+    const int errorTypeId = filter.errorType.isEmpty() ? 0 : stringId(filter.errorType);
+    if (fixtureId < 0 || errorTypeId < 0) {
+        return result;
+    }
+
+    QVector<int> textOffsets;
+    QVector<int> textLengths;
+
+    for (int b = m_blocks.size() - 1; b >= 0 && result.size() < limit; --b) {
+        const BlockIndex &block = m_blocks.at(b);
+        if (block.recordCount == 0 ||
+            (filter.runId != 0 && (filter.runId < block.minRunId || filter.runId > block.maxRunId)) ||
+            (filter.fromWallMs != 0 && block.maxWallMs < filter.fromWallMs) ||
+            (filter.toWallMs != 0 && block.minWallMs >= filter.toWallMs)) {
+            continue;   // 整块不匹配
+        }
+
+        if (!m_file.seek(block.offset + static_cast<qint64>(sizeof(BlockHeader)))) {
+            break;
+        }
+        const QByteArray payload = m_file.read(block.payloadBytes);
+        if (payload.size() != static_cast<int>(block.payloadBytes)) {
+            break;
+        }
+
+        // 跳过块首的字符串区（打开时已载入字符串表），定位各列
+        PayloadCursor cursor(payload.constData(), payload.size());
+        int offset = 0;
+        int length = 0;
+        for (quint32 i = 0; i < block.stringCount; ++i) {
+            cursor.readString(offset, length);
+        }
+
+        const quint32 n = block.recordCount;
+        if (static_cast<qint64>(n) * FIXED_COLUMN_BYTES > payload.size()) {
+            continue;   // 块内容与块头不符，跳过该块
+        }
+        const char *wallMs = cursor.skip(qint64(n) * 8);
+        const char *runId = cursor.skip(qint64(n) * 8);
+        const char *fixture = cursor.skip(qint64(n) * 4);
+        const char *stepName = cursor.skip(qint64(n) * 4);
+        const char *actionDesc = cursor.skip(qint64(n) * 4);
+        const char *errorType = cursor.skip(qint64(n) * 4);
+        const char *stepIndex = cursor.skip(qint64(n) * 2);
+        const char *actionIndex = cursor.skip(qint64(n) * 2);
+        const char *measured = cursor.skip(qint64(n) * 8);
+        const char *threshold = cursor.skip(qint64(n) * 8);
+
+        // 变长列：板号、错误详情
+        textOffsets.resize(static_cast<int>(n) * 2);
+        textLengths.resize(static_cast<int>(n) * 2);
+        for (int i = 0; i < static_cast<int>(n) * 2; ++i) {
+            cursor.readString(textOffsets[i], textLengths[i]);
+        }
+        if (!cursor.ok()) {
+            continue;   // 块内容与块头不符，跳过该块
+        }
+
+        for (qint64 i = static_cast<qint64>(n) - 1; i >= 0 && result.size() < limit; --i) {
+            const quint32 row = static_cast<quint32>(i);
+            const qint64 recordWallMs = columnValue<qint64>(wallMs, row);
+            const qint64 recordRunId = columnValue<qint64>(runId, row);
+            const quint32 recordFixture = columnValue<quint32>(fixture, row);
+            const quint32 recordErrorType = columnValue<quint32>(errorType, row);
+
+            if ((filter.runId != 0 && recordRunId != filter.runId) ||
+                (filter.fromWallMs != 0 && recordWallMs < filter.fromWallMs) ||
+                (filter.toWallMs != 0 && recordWallMs >= filter.toWallMs) ||
+                (fixtureId != 0 && recordFixture != static_cast<quint32>(fixtureId)) ||
+                (errorTypeId != 0 && recordErrorType != static_cast<quint32>(errorTypeId))) {
+                continue;
+            }
+
+            const int serialIndex = static_cast<int>(row);
+            const QString serial = QString::fromUtf8(payload.constData() + textOffsets[serialIndex],
+                                                     textLengths[serialIndex]);
+            if (!filter.boardSerial.isEmpty() && serial != filter.boardSerial) {
+                continue;
+            }
+
+            const int detailIndex = static_cast<int>(n + row);
+            const auto text = [this](quint32 id) {
+                return id < static_cast<quint32>(m_strings.size()) ? m_strings.at(static_cast<int>(id)) : QString();
+            };
+
+            ErrorRecord record(columnValue<qint16>(stepIndex, row),
+                               text(columnValue<quint32>(stepName, row)),
+                               columnValue<qint16>(actionIndex, row),
+                               text(columnValue<quint32>(actionDesc, row)),
+                               text(recordErrorType),
+                               QString::fromUtf8(payload.constData() + textOffsets[detailIndex],
+                                                 textLengths[detailIndex]),
+                               columnValue<double>(measured, row),
+                               columnValue<double>(threshold, row));
+            record.timestamp = QDateTime::fromMSecsSinceEpoch(recordWallMs);
+            record.boardSerial = serial;
+            record.fixture = text(recordFixture);
+            record.runId = recordRunId;
+            result.append(record);
+        }
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,114 @@
+#ifndef ERRORRECORDREADER_H
+#define ERRORRECORDREADER_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include "domain/ErrorRecord.h"
+#include "storage/ErrorRecordFormat.h"
+
+/**
+ * @brief 错误记录库读取器
+ *
+ * 职责：
+ * - 打开时只读取块头和字符串表，建立块索引（每块约 50 字节），记录本身按需解码
+ * - 按板号、治具、错误类型、运行编号、时间范围查询，块头范围不匹配的块整块跳过
+ * - 查询从最新的块向前扫描，只保留最近的 limit 条结果，内存占用与文件大小无关
+ *
+ * 文件格式见 ErrorRecordFormat。写入端同时打开时，末尾尚未写完的块忽略。
+ */
+class ErrorRecordReader
+{
+public:
+    /**
+     * @brief 查询条件（字符串为空、数值为0表示不限）
+     */
+    struct Filter {
+        QString boardSerial;    ///< 板号（完全匹配）
+        QString fixture;        ///< 治具（完全匹配）
+        QString errorType;      ///< 错误类型（完全匹配）
+        qint64 runId;           ///< 运行编号
+        qint64 fromWallMs;      ///< 起始时间（含，毫秒）
+        qint64 toWallMs;        ///< 结束时间（不含，毫秒）
+
+        Filter() : runId(0), fromWallMs(0), toWallMs(0) {}
+    };
+
+    ErrorRecordReader();
+    ~ErrorRecordReader();
+
+    /**
+     * @brief 打开记录库并建立块索引
+     * @param filePath 文件路径
+     * @param errorString 失败原因（可选）
+     * @return true 成功
+     */
+    bool open(const QString &filePath, QString *errorString = nullptr);
+
+    /**
+     * @brief 关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * @brief 记录总数（末尾不完整的块不计入）
+     */
+    qint64 recordCount() const { return m_recordCount; }
+
+    /**
+     * @brief 有效数据的字节数（文件头 + 所有完整的块）
+     */
+    qint64 validSize() const { return m_validSize; }
+
+    /**
+     * @brief 字符串表（下标即编号，0 为空字符串）
+     */
+    const QVector<QString> &strings() const { return m_strings; }
+
+    /**
+     * @brief 查询最近的匹配记录
+     * @param filter 查询条件
+     * @param limit 最多返回的记录数
+     * @return 匹配记录，按时间从早到晚排列
+     */
+    QVector<ErrorRecord> query(const Filter &filter, int limit) const;
+
+private:
+    /**
+     * @brief 块索引项
+     */
+    struct BlockIndex {
+        qint64 offset;          ///< 块头在文件中的偏移
+        quint32 payloadBytes;   ///< 块数据字节数
+        quint32 recordCount;    ///< 记录数
+        quint32 stringCount;    ///< 块首新增字符串数
+        qint64 minWallMs;       ///< 最早记录时间
+        qint64 maxWallMs;       ///< 最晚记录时间
+        qint64 minRunId;        ///< 最小运行编号
+        qint64 maxRunId;        ///< 最大运行编号
+    };
+
+    /**
+     * @brief 扫描全部块，建立块索引和字符串表
+     */
+    void scanBlocks();
+
+    /**
+     * @brief 查找字符串编号
+     * @return 编号；不存在时返回 -1（空字符串为 0）
+     */
+    int stringId(const QString &text) const;
+
+    mutable QFile m_file;               ///< 记录库文件（查询时移动读取位置）
+    QVector<BlockIndex> m_blocks;       ///< 块索引
+    QVector<QString> m_strings;         ///< 字符串表
+    qint64 m_recordCount;               ///< 记录总数
+    qint64 m_validSize;                 ///< 有效数据字节数
+};
+
+#endif // ERRORRECORDREADER_H
@@ -0,0 +1,75 @@
+#include "ErrorRecordStore.h"
+#include "ErrorRecordWriter.h"
+#include <QStandardPaths>
+#include <QTimer>
+
+ErrorRecordStore::ErrorRecordStore(const QString &filePath, QObject *parent)
+    : QObject(parent)
+    , m_writer(new ErrorRecordWriter())
+    , m_filePath(filePath)
+    , m_flushTimer(new QTimer(this))
+{
+    qRegisterMetaType<ErrorRecord>("ErrorRecord");
+    qRegisterMetaType<QVector<ErrorRecord>>("QVector<ErrorRecord>");
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &ErrorRecordStore::flush);
+
+    // 写入对象移入后台线程，线程结束时在该线程内销毁（析构时关闭文件）
+    m_thread.setObjectName(QStringLiteral("ErrorRecordStore"));
+    m_writer->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished,
+            m_writer, &QObject::deleteLater);
+    connect(m_writer, &ErrorRecordWriter::errorOccurred,
+            this, &ErrorRecordStore::errorOccurred);
+    m_thread.start(QThread::LowPriority);
+
+    QMetaObject::invokeMethod(m_writer, "open", Qt::QueuedConnection,
+                              Q_ARG(QString, filePath));
+}
+
+ErrorRecordStore::~ErrorRecordStore()
+{
+    flush();
+
+    // 阻塞等待：队列按顺序执行，返回时之前排队的写入都已完成
+    QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QString ErrorRecordStore::defaultFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/results/errors.pcbaerr";
+}
+
+void ErrorRecordStore::append(const ErrorRecord &record)
+{
+    m_pending.append(record);
+
+    if (m_pending.size() >= kMaxBatchRecords) {
+        flush();
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void ErrorRecordStore::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_writer, "writeRecords", Qt::QueuedConnection,
+                              Q_ARG(QVector<ErrorRecord>, m_pending));
+    m_pending.clear();
+}
+
+void ErrorRecordStore::sync()
+{
+    flush();
+    QMetaObject::invokeMethod(m_writer, "sync", Qt::BlockingQueuedConnection);
+}
@@ -0,0 +1,80 @@
+#ifndef ERRORRECORDSTORE_H
+#define ERRORRECORDSTORE_H
+
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <QVector>
+#include "domain/ErrorRecord.h"
+
+class QTimer;
+class ErrorRecordWriter;
+
+/**
+ * @brief 错误记录库（持久化的失效历史）
+ *
+ * 职责：
+ * - 在独立的后台线程中运行ErrorRecordWriter，编码和磁盘写入不占用界面线程和执行引擎
+ * - 合并短时间内到达的记录，一批写成一个数据块
+ *
+ * append() 只负责排队，立即返回；析构时等待后台线程写完所有已排队的记录。
+ * 查询历史使用 ErrorRecordReader（可与写入同时进行）。
+ */
+class ErrorRecordStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kFlushIntervalMs = 1000;  ///< 合并写入的最长等待时间
+    static constexpr int kMaxBatchRecords = 256;   ///< 单批最多记录数（达到后立即写入）
+
+    /**
+     * @brief 构造函数
+     * @param filePath 记录库文件路径
+     * @param parent 父对象指针
+     */
+    explicit ErrorRecordStore(const QString &filePath, QObject *parent = nullptr);
+    ~ErrorRecordStore() override;
+
+    /**
+     * @brief 记录库文件路径
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief 等待已排队的记录全部写入文件（查询历史前调用）
+     */
+    void sync();
+
+    /**
+     * @brief 默认记录库文件路径
+     */
+    static QString defaultFilePath();
+
+public slots:
+    /**
+     * @brief 排队写入一条错误记录
+     */
+    void append(const ErrorRecord &record);
+
+    /**
+     * @brief 立即交给后台线程写入当前批次
+     */
+    void flush();
+
+signals:
+    /**
+     * @brief 文件写入错误时发射
+     * @param errorString 错误描述
+     */
+    void errorOccurred(const QString &errorString);
+
+private:
+    QThread m_thread;               ///< 记录写入线程
+    ErrorRecordWriter *m_writer;    ///< 写入对象（属于写入线程）
+    QString m_filePath;             ///< 记录库文件路径
+    QVector<ErrorRecord> m_pending; ///< 待写入的记录批次
+    QTimer *m_flushTimer;           ///< 合并写入定时器
+};
+
+#endif // ERRORRECORDSTORE_H
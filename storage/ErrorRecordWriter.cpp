@@ -0,0 +1,323 @@
+#include "ErrorRecordWriter.h"
+#include "storage/ErrorRecordFormat.h"
+#include "storage/ErrorRecordReader.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+using namespace ErrorRecordFormat;
+
+namespace {
+
+constexpr int kLockTimeoutMs = 5000;    ///< 等待其他进程释放锁文件的上限
+
+template <typename T>
+void appendValue(QByteArray &column, T value)
+{
+    column.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendText(QByteArray &column, const QString &text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    appendValue<quint32>(column, static_cast<quint32>(utf8.size()));
+    column.append(utf8);
+}
+
+} // namespace
+
+ErrorRecordWriter::ErrorRecordWriter(QObject *parent)
+    : QObject(parent)
+    , m_nextStringId(1)
+    , m_syncedSize(0)
+    , m_failed(false)
+{
+}
+
+ErrorRecordWriter::~ErrorRecordWriter()
+{
+    close();
+}
+
+void ErrorRecordWriter::open(const QString &filePath)
+{
+    close();
+
+    m_stringIds.clear();
+    m_nextStringId = 1;
+    m_syncedSize = 0;
+    m_failed = false;
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    m_file.setFileName(filePath);
+    m_lock.reset(new QLockFile(filePath + QStringLiteral(".lock")));
+    if (!lockStore()) {
+        m_lock.reset();
+        return;
+    }
+
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        fail(tr("无法打开错误记录库 %1: %2").arg(filePath, m_file.errorString()));
+        m_lock->unlock();
+        return;
+    }
+
+    bool ok = true;
+    if (m_file.size() == 0) {
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.headerSize = sizeof(FileHeader);
+        header.blockHeaderSize = sizeof(BlockHeader);
+        header.createdWallMs = QDateTime::currentMSecsSinceEpoch();
+        if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+            !m_file.flush()) {
+            fail(tr("写入错误记录库文件头失败: %1").arg(m_file.errorString()));
+            ok = false;
+        }
+        m_syncedSize = sizeof(FileHeader);
+    } else {
+        ok = loadExisting();
+    }
+
+    m_lock->unlock();
+    if (!ok) {
+        m_file.close();
+    }
+}
+
+void ErrorRecordWriter::writeRecords(const QVector<ErrorRecord> &records)
+{
+    if (!m_file.isOpen() || records.isEmpty()) {
+        return;
+    }
+
+    // 持锁期间先读入其他进程追加的块：字符串编号接着文件中的最后一个编号分配
+    if (!lockStore()) {
+        return;
+    }
+    if (!catchUp()) {
+        m_lock->unlock();
+        m_file.close();
+        return;
+    }
+
+    const int n = records.size();
+    BlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.marker = BLOCK_MARKER;
+    header.recordCount = static_cast<quint32>(n);
+    header.firstStringId = m_nextStringId;
+
+    // 块头是紧凑结构，范围先在局部变量中累计
+    qint64 minWallMs = std::numeric_limits<qint64>::max();
+    qint64 maxWallMs = std::numeric_limits<qint64>::min();
+    qint64 minRunId = std::numeric_limits<qint64>::max();
+    qint64 maxRunId = std::numeric_limits<qint64>::min();
+
+    QByteArray newStrings;
+    quint32 newCount = 0;
+
+    // 按列累积，每列连续存放便于查询时只读取需要的列
+    QByteArray wallMs, runId, fixture, stepName, actionDesc, errorType;
+    QByteArray stepIndex, actionIndex, measured, threshold, serials, details;
+    wallMs.reserve(n * 8);
+    runId.reserve(n * 8);
+
+    for (const ErrorRecord &record : records) {
+        const qint64 recordWallMs = record.timestamp.toMSecsSinceEpoch();
+        minWallMs = qMin(minWallMs, recordWallMs);
+        maxWallMs = qMax(maxWallMs, recordWallMs);
+        minRunId = qMin(minRunId, record.runId);
+        maxRunId = qMax(maxRunId, record.runId);
+
+        appendValue<qint64>(wallMs, recordWallMs);
+        appendValue<qint64>(runId, record.runId);
+        appendValue<quint32>(fixture, intern(record.fixture, newStrings, newCount));
+        appendValue<quint32>(stepName, intern(record.stepName, newStrings, newCount));
+        appendValue<quint32>(actionDesc, intern(record.actionDescription, newStrings, newCount));
+        appendValue<quint32>(errorType, intern(record.errorType, newStrings, newCount));
+        appendValue<qint16>(stepIndex, static_cast<qint16>(record.stepIndex));
+        appendValue<qint16>(actionIndex, static_cast<qint16>(record.actionIndex));
+        appendValue<double>(measured, record.measuredValue);
+        appendValue<double>(threshold, record.thresholdValue);
+        appendText(serials, record.boardSerial);
+        appendText(details, record.errorDetail);
+    }
+    header.stringCount = newCount;
+    header.minWallMs = minWallMs;
+    header.maxWallMs = maxWallMs;
+    header.minRunId = minRunId;
+    header.maxRunId = maxRunId;
+
+    QByteArray block;
+    block.reserve(static_cast<int>(sizeof(header)) + newStrings.size() + n * FIXED_COLUMN_BYTES +
+                  serials.size() + details.size());
+    block.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    block += newStrings;
+    block += wallMs;
+    block += runId;
+    block += fixture;
+    block += stepName;
+    block += actionDesc;
+    block += errorType;
+    block += stepIndex;
+    block += actionIndex;
+    block += measured;
+    block += threshold;
+    block += serials;
+    block += details;
+
+    // 回填数据长度
+    const quint32 payloadBytes = static_cast<quint32>(block.size() - static_cast<int>(sizeof(header)));
+    std::memcpy(block.data() + offsetof(BlockHeader, payloadBytes), &payloadBytes, sizeof(payloadBytes));
+
+    if (!m_file.seek(m_syncedSize) || m_file.write(block) != block.size() || !m_file.flush()) {
+        // 不完整的块在下次打开时截掉；本次不再继续写入
+        fail(tr("写入错误记录库失败，停止记录: %1").arg(m_file.errorString()));
+        m_lock->unlock();
+        m_file.close();
+        return;
+    }
+    m_syncedSize += block.size();
+    m_lock->unlock();
+}
+
+void ErrorRecordWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_lock.reset();
+}
+
+quint32 ErrorRecordWriter::intern(const QString &text, QByteArray &newStrings, quint32 &newCount)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+
+    QHash<QString, quint32>::const_iterator it = m_stringIds.constFind(text);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+
+    const quint32 id = m_nextStringId++;
+    m_stringIds.insert(text, id);
+    appendText(newStrings, text);
+    ++newCount;
+    return id;
+}
+
+bool ErrorRecordWriter::lockStore()
+{
+    if (m_lock->tryLock(kLockTimeoutMs)) {
+        return true;
+    }
+    // 锁持有者异常退出时 QLockFile 按过期锁处理，这里超时说明确实有进程长时间占用
+    fail(tr("错误记录库 %1 被其他进程占用（%2 ms 内未释放锁），停止记录")
+         .arg(m_file.fileName())
+         .arg(kLockTimeoutMs));
+    m_file.close();
+    return false;
+}
+
+bool ErrorRecordWriter::loadExisting()
+{
+    // 用读取器校验文件头、重建字符串表并找到最后一个完整块的位置
+    ErrorRecordReader reader;
+    QString errorString;
+    if (!reader.open(m_file.fileName(), &errorString)) {
+        // 不覆盖无法识别的文件，避免丢失历史记录
+        fail(tr("无法打开错误记录库 %1: %2").arg(m_file.fileName(), errorString));
+        return false;
+    }
+
+    m_stringIds.clear();
+    const QVector<QString> &strings = reader.strings();
+    for (int i = 1; i < strings.size(); ++i) {
+        m_stringIds.insert(strings.at(i), static_cast<quint32>(i));
+    }
+    m_nextStringId = static_cast<quint32>(strings.size());
+    m_syncedSize = reader.validSize();
+
+    // 截掉写入中断留下的不完整块（持有锁，不会是其他进程正在写的块）
+    if (m_file.size() > m_syncedSize && !m_file.resize(m_syncedSize)) {
+        fail(tr("修复错误记录库失败: %1").arg(m_file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+bool ErrorRecordWriter::catchUp()
+{
+    const qint64 fileSize = m_file.size();
+    if (fileSize == m_syncedSize) {
+        return true;
+    }
+    if (fileSize < m_syncedSize) {
+        // 文件被替换或截短：整体重建
+        return loadExisting();
+    }
+
+    // 与 ErrorRecordReader::scanBlocks 相同的规则，只读取块首的字符串区
+    while (m_syncedSize + static_cast<qint64>(sizeof(BlockHeader)) <= fileSize) {
+        BlockHeader header;
+        if (!m_file.seek(m_syncedSize) ||
+            m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+            header.marker != BLOCK_MARKER ||
+            header.firstStringId != m_nextStringId ||
+            m_syncedSize + static_cast<qint64>(sizeof(BlockHeader)) + header.payloadBytes > fileSize) {
+            break;
+        }
+
+        QVector<QString> added;
+        added.reserve(static_cast<int>(header.stringCount));
+        qint64 remaining = header.payloadBytes;
+        bool ok = true;
+        for (quint32 i = 0; i < header.stringCount; ++i) {
+            quint32 size = 0;
+            if (remaining < static_cast<qint64>(sizeof(size)) ||
+                m_file.read(reinterpret_cast<char*>(&size), sizeof(size)) != sizeof(size) ||
+                size > remaining - static_cast<qint64>(sizeof(size))) {
+                ok = false;
+                break;
+            }
+            const QByteArray utf8 = m_file.read(size);
+            if (utf8.size() != static_cast<int>(size)) {
+                ok = false;
+                break;
+            }
+            added.append(QString::fromUtf8(utf8));
+            remaining -= static_cast<qint64>(sizeof(size)) + size;
+        }
+        if (!ok) {
+            break;
+        }
+
+        for (const QString &text : added) {
+            m_stringIds.insert(text, m_nextStringId++);
+        }
+        m_syncedSize += static_cast<qint64>(sizeof(BlockHeader)) + header.payloadBytes;
+    }
+
+    // 其他进程写入中断留下的不完整块
+    if (m_file.size() > m_syncedSize && !m_file.resize(m_syncedSize)) {
+        fail(tr("修复错误记录库失败: %1").arg(m_file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+void ErrorRecordWriter::fail(const QString &errorString)
+{
+    if (!m_failed) {
+        m_failed = true;
+        emit errorOccurred(errorString);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef ERRORRECORDWRITER_H
+#define ERRORRECORDWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QLockFile>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+#include "domain/ErrorRecord.h"
+
+/**
+ * @brief 错误记录库写入对象（运行在ErrorRecordStore的后台线程中）
+ *
+ * 职责：
+ * - 每批记录编码为一个列式数据块，一次写入后刷新
+ * - 维护驻留字符串表：打开已有文件时从文件重建，之后只把新出现的字符串写入块首
+ * - 打开时截掉异常退出留下的不完整块，保证之后追加的块可读
+ *
+ * 同一记录库可由多个进程共用（界面程序和每个无界面执行进程）：修改文件时持有旁边的锁文件（.lock），
+ * 每写一块之前先读入其他进程在本进程上次写入之后追加的块（更新字符串表），再在文件当前末尾追加。
+ *
+ * 该类只应由 ErrorRecordStore 创建和调用（通过队列连接跨线程调用槽函数）。
+ */
+class ErrorRecordWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ErrorRecordWriter(QObject *parent = nullptr);
+    ~ErrorRecordWriter() override;
+
+public slots:
+    /**
+     * @brief 打开记录库（不存在时创建，已存在时追加）
+     * @param filePath 文件路径
+     */
+    void open(const QString &filePath);
+
+    /**
+     * @brief 写入一批记录（一个数据块）
+     */
+    void writeRecords(const QVector<ErrorRecord> &records);
+
+    /**
+     * @brief 空操作，供调用方阻塞等待此前排队的写入完成
+     */
+    void sync() {}
+
+    /**
+     * @brief 关闭记录库
+     */
+    void close();
+
+signals:
+    /**
+     * @brief 文件写入错误时发射
+     * @param errorString 错误描述
+     */
+    void errorOccurred(const QString &errorString);
+
+private:
+    /**
+     * @brief 获取字符串编号，新字符串追加到本块的字符串区
+     */
+    quint32 intern(const QString &text, QByteArray &newStrings, quint32 &newCount);
+
+    /**
+     * @brief 报告错误（每次打开只报告一次）
+     */
+    void fail(const QString &errorString);
+
+    /**
+     * @brief 获取锁文件（等待其他进程写完当前块）
+     * @return false 超时，已报告错误
+     */
+    bool lockStore();
+
+    /**
+     * @brief 从头重建字符串表并截掉不完整的块（需持有锁，文件已打开）
+     */
+    bool loadExisting();
+
+    /**
+     * @brief 读入其他进程在 m_syncedSize 之后追加的块（需持有锁）
+     */
+    bool catchUp();
+
+    QFile m_file;                           ///< 记录库文件
+    QScopedPointer<QLockFile> m_lock;       ///< 记录库旁的锁文件（多进程共用时串行化写入）
+    QHash<QString, quint32> m_stringIds;    ///< 驻留字符串 → 编号
+    quint32 m_nextStringId;                 ///< 下一个字符串编号
+    qint64 m_syncedSize;                    ///< 已读入（或本进程写入）的有效数据末尾
+    bool m_failed;                          ///< 已报告过写入错误（避免重复报告）
+};
+
+#endif // ERRORRECORDWRITER_H
@@ -0,0 +1,70 @@
+#ifndef MEASUREMENTRECORD_H
+#define MEASUREMENTRECORD_H
+
+#include <QtGlobal>
+#include "domain/Measurement.h"
+#include "domain/MonotonicClock.h"
+
+/**
+ * @brief 测量记录文件格式
+ *
+ * 文件 = 文件头(64字节) + 定长记录(24字节) × N，只追加写入。
+ * 所有字段按小端（主机字节序）存储；异常退出时末尾不完整的记录在读取时忽略。
+ */
+namespace MeasurementRecordFormat {
+
+constexpr char MAGIC[8] = {'P', 'C', 'B', 'A', 'R', 'E', 'C', '1'};
+constexpr quint32 VERSION = 1;
+
+/**
+ * @brief 文件头
+ */
+#pragma pack(push, 1)
+struct FileHeader {
+    char magic[8];                  ///< 文件标识 "PCBAREC1"
+    quint32 version;                ///< 格式版本
+    quint32 headerSize;             ///< 文件头大小（字节）
+    quint32 recordSize;             ///< 单条记录大小（字节）
+    quint32 reserved0;              ///< 保留
+    qint64 epochWallMs;             ///< 单调时钟零点对应的墙钟时间（毫秒）
+    qint64 startMonotonicNs;        ///< 开始记录时的单调时间（纳秒）
+    char portName[24];              ///< 串口名称（UTF-8，不足补0）
+};
+
+/**
+ * @brief 单条测量记录
+ */
+struct Record {
+    qint64 monotonicNs;             ///< 单调时间戳（纳秒）
+    float value;                    ///< 原始测量值（mA）
+    quint8 range;                   ///< 档位（Measurement::Range）
+    quint8 channel;                 ///< 通道（Measurement::Channel）
+    qint16 stepIndex;               ///< 测试步骤索引（-1 表示不在测试序列中）
+    qint16 actionIndex;             ///< 子动作索引（-1 表示不在测试序列中）
+    quint16 reserved0;              ///< 保留
+    quint32 reserved1;              ///< 保留
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+static_assert(sizeof(Record) == 24, "Record must be 24 bytes");
+
+/**
+ * @brief 记录转换为测量值
+ * @param record 记录
+ * @param epochWallMs 文件头中的墙钟零点
+ */
+inline Measurement toMeasurement(const Record &record, qint64 epochWallMs)
+{
+    Measurement m;
+    m.rawValue = record.value;
+    m.range = static_cast<Measurement::Range>(record.range);
+    m.channel = static_cast<Measurement::Channel>(record.channel);
+    m.timestamp = MonotonicClock::toDateTime(record.monotonicNs, epochWallMs);
+    m.monotonicNs = record.monotonicNs;
+    return m;
+}
+
+} // namespace MeasurementRecordFormat
+
+#endif // MEASUREMENTRECORD_H
@@ -0,0 +1,130 @@
+#include "MeasurementRecorder.h"
+#include "domain/MonotonicClock.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <cstring>
+
+using namespace MeasurementRecordFormat;
+
+MeasurementRecorder::MeasurementRecorder(QObject *parent)
+    : QObject(parent)
+    , m_flushTimer(new QTimer(this))
+    , m_recordCount(0)
+    , m_stepIndex(-1)
+    , m_actionIndex(-1)
+{
+    m_buffer.reserve(kBufferBytes);
+
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &MeasurementRecorder::flush);
+}
+
+MeasurementRecorder::~MeasurementRecorder()
+{
+    stop();
+}
+
+bool MeasurementRecorder::start(const QString &filePath, const QString &portName)
+{
+    stop();
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        emit logMessage(tr("无法创建测量记录文件 %1: %2").arg(filePath, m_file.errorString()));
+        return false;
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(FileHeader);
+    header.recordSize = sizeof(Record);
+    header.epochWallMs = MonotonicClock::epochWallMs();
+    header.startMonotonicNs = MonotonicClock::nowNs();
+    QByteArray port = portName.toUtf8().left(static_cast<int>(sizeof(header.portName)) - 1);
+    std::memcpy(header.portName, port.constData(), static_cast<size_t>(port.size()));
+
+    if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+        emit logMessage(tr("写入测量记录文件头失败: %1").arg(m_file.errorString()));
+        m_file.close();
+        return false;
+    }
+
+    m_buffer.clear();
+    m_recordCount = 0;
+    m_flushTimer->start();
+
+    emit logMessage(tr("开始记录测量数据: %1").arg(filePath));
+    return true;
+}
+
+void MeasurementRecorder::stop()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    flush();
+    m_flushTimer->stop();
+    m_file.close();
+
+    emit logMessage(tr("测量数据记录已保存: %1 (%2 条)").arg(m_file.fileName()).arg(m_recordCount));
+}
+
+void MeasurementRecorder::append(const QVector<Measurement> &measurements)
+{
+    if (!m_file.isOpen() || measurements.isEmpty()) {
+        return;
+    }
+
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+    record.stepIndex = m_stepIndex;
+    record.actionIndex = m_actionIndex;
+
+    for (const Measurement &measurement : measurements) {
+        record.monotonicNs = measurement.monotonicNs;   // 读取边界处推算的到达时刻，与主线程何时处理无关
+        record.value = measurement.rawValue;
+        record.range = static_cast<quint8>(measurement.range);
+        record.channel = static_cast<quint8>(measurement.channel);
+        m_buffer.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    m_recordCount += measurements.size();
+
+    if (m_buffer.size() >= kBufferBytes) {
+        flush();
+    }
+}
+
+void MeasurementRecorder::setContext(int stepIndex, int actionIndex)
+{
+    m_stepIndex = static_cast<qint16>(stepIndex);
+    m_actionIndex = static_cast<qint16>(actionIndex);
+}
+
+void MeasurementRecorder::flush()
+{
+    if (!m_file.isOpen() || m_buffer.isEmpty()) {
+        return;
+    }
+
+    if (m_file.write(m_buffer) != m_buffer.size()) {
+        emit logMessage(tr("写入测量记录失败，停止记录: %1").arg(m_file.errorString()));
+        m_buffer.clear();
+        m_flushTimer->stop();
+        m_file.close();
+        return;
+    }
+
+    m_file.flush();
+    m_buffer.clear();   // 保留已分配的容量
+}
+
+QString MeasurementRecorder::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/recordings";
+}
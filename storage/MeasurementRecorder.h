@@ -0,0 +1,106 @@
+#ifndef MEASUREMENTRECORDER_H
+#define MEASUREMENTRECORDER_H
+
+#include <QObject>
+#include <QFile>
+#include <QByteArray>
+#include <QVector>
+#include <QTimer>
+#include "domain/Measurement.h"
+#include "storage/MeasurementRecord.h"
+
+/**
+ * @brief 测量数据记录器（定长二进制记录，只追加写入）
+ *
+ * 职责：
+ * - 将每个测量样本写入记录文件，保留完整精度的电流波形用于失效分析
+ * - 每条记录包含单调时间戳、测量值、档位、通道以及当前测试步骤/子动作索引
+ * - 记录先进入内存缓冲，缓冲满或定时器到期时一次性写入文件
+ *
+ * 文件格式见 MeasurementRecordFormat，回放使用 MeasurementRecordingReader。
+ */
+class MeasurementRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MeasurementRecorder(QObject *parent = nullptr);
+    ~MeasurementRecorder() override;
+
+    /**
+     * @brief 开始记录到新文件
+     * @param filePath 记录文件路径（已存在时覆盖）
+     * @param portName 串口名称（写入文件头）
+     * @return true 成功
+     */
+    bool start(const QString &filePath, const QString &portName = QString());
+
+    /**
+     * @brief 停止记录（写出缓冲并关闭文件）
+     */
+    void stop();
+
+    /**
+     * @brief 是否正在记录
+     */
+    bool isRecording() const { return m_file.isOpen(); }
+
+    /**
+     * @brief 当前记录文件路径
+     */
+    QString filePath() const { return m_file.fileName(); }
+
+    /**
+     * @brief 本次记录的样本数
+     */
+    qint64 recordCount() const { return m_recordCount; }
+
+    /**
+     * @brief 默认记录目录
+     */
+    static QString defaultDirectory();
+
+public slots:
+    /**
+     * @brief 追加一批测量样本
+     * @param measurements 测量样本（记录各样本自带的单调时间戳 Measurement::monotonicNs）
+     */
+    void append(const QVector<Measurement> &measurements);
+
+    /**
+     * @brief 设置当前测试步骤和子动作（之后的样本都带此标记）
+     * @param stepIndex 步骤索引
+     * @param actionIndex 子动作索引
+     */
+    void setContext(int stepIndex, int actionIndex);
+
+    /**
+     * @brief 清除测试步骤标记
+     */
+    void clearContext() { setContext(-1, -1); }
+
+    /**
+     * @brief 将缓冲中的记录写入文件
+     */
+    void flush();
+
+signals:
+    /**
+     * @brief 日志消息信号
+     * @param message 日志内容
+     */
+    void logMessage(const QString &message);
+
+private:
+    static constexpr int kBufferBytes = 64 * 1024;  ///< 缓冲区大小（约2700条记录）
+    static constexpr int kFlushIntervalMs = 500;    ///< 定时写出间隔
+
+    QFile m_file;                   ///< 记录文件
+    QByteArray m_buffer;            ///< 待写出的记录
+    QTimer *m_flushTimer;           ///< 定时写出定时器
+    qint64 m_recordCount;           ///< 已记录样本数
+    qint16 m_stepIndex;             ///< 当前步骤索引
+    qint16 m_actionIndex;           ///< 当前子动作索引
+};
+
+#endif // MEASUREMENTRECORDER_H
@@ -0,0 +1,150 @@
+#include "MeasurementRecordingReader.h"
+#include <QObject>
+#include <cstring>
+#include <limits>
+
+using namespace MeasurementRecordFormat;
+
+MeasurementRecordingReader::MeasurementRecordingReader()
+    : m_records(nullptr)
+    , m_count(0)
+{
+    std::memset(&m_header, 0, sizeof(m_header));
+}
+
+MeasurementRecordingReader::~MeasurementRecordingReader()
+{
+    close();
+}
+
+bool MeasurementRecordingReader::open(const QString &filePath, QString *errorString)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = m_file.errorString();
+        }
+        return false;
+    }
+
+    // 校验文件头
+    if (m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header)) != sizeof(m_header) ||
+        std::memcmp(m_header.magic, MAGIC, sizeof(m_header.magic)) != 0 ||
+        m_header.version != VERSION ||
+        m_header.headerSize != sizeof(FileHeader) ||
+        m_header.recordSize != sizeof(Record)) {
+        if (errorString) {
+            *errorString = QObject::tr("不是有效的测量记录文件");
+        }
+        close();
+        return false;
+    }
+
+    // 末尾不完整的记录（写入中断）忽略
+    const qint64 fileSize = m_file.size();
+    m_count = (fileSize - static_cast<qint64>(sizeof(FileHeader))) / static_cast<qint64>(sizeof(Record));
+    if (m_count <= 0) {
+        m_count = 0;
+        return true;
+    }
+
+    const qint64 mappedSize = static_cast<qint64>(sizeof(FileHeader)) + m_count * static_cast<qint64>(sizeof(Record));
+    uchar *mapped = m_file.map(0, mappedSize);
+    if (!mapped) {
+        if (errorString) {
+            *errorString = QObject::tr("映射记录文件失败: %1").arg(m_file.errorString());
+        }
+        close();
+        return false;
+    }
+
+    m_records = reinterpret_cast<const Record*>(mapped + sizeof(FileHeader));
+    return true;
+}
+
+void MeasurementRecordingReader::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();     // close() 会解除所有映射
+    }
+    m_records = nullptr;
+    m_count = 0;
+}
+
+QString MeasurementRecordingReader::portName() const
+{
+    return QString::fromUtf8(m_header.portName,
+                             static_cast<int>(qstrnlen(m_header.portName, sizeof(m_header.portName))));
+}
+
+qint64 MeasurementRecordingReader::lowerBound(qint64 monotonicNs) const
+{
+    // 记录按到达顺序写入，时间戳单调不减
+    qint64 low = 0;
+    qint64 high = m_count;
+    while (low < high) {
+        const qint64 mid = low + (high - low) / 2;
+        if (m_records[mid].monotonicNs < monotonicNs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+QPair<qint64, qint64> MeasurementRecordingReader::timeRange(qint64 fromNs, qint64 toNs) const
+{
+    const qint64 first = lowerBound(fromNs);
+    const qint64 last = qMax(first, lowerBound(toNs));
+    return qMakePair(first, last);
+}
+
+MeasurementRecordingReader::RangeStats MeasurementRecordingReader::stats(qint64 first, qint64 last) const
+{
+    RangeStats result;
+    result.count = 0;
+    result.minValue = 0.0;
+    result.maxValue = 0.0;
+    result.mean = 0.0;
+
+    first = qMax<qint64>(0, first);
+    last = qMin(last, m_count);
+    if (last <= first) {
+        return result;
+    }
+
+    double minValue = std::numeric_limits<double>::max();
+    double maxValue = std::numeric_limits<double>::lowest();
+    double sum = 0.0;
+    for (qint64 i = first; i < last; ++i) {
+        const double v = m_records[i].value;
+        minValue = qMin(minValue, v);
+        maxValue = qMax(maxValue, v);
+        sum += v;
+    }
+
+    result.count = last - first;
+    result.minValue = minValue;
+    result.maxValue = maxValue;
+    result.mean = sum / static_cast<double>(result.count);
+    return result;
+}
+
+void MeasurementRecordingReader::readMeasurements(qint64 first, qint64 last, QVector<Measurement> &out) const
+{
+    out.clear();
+
+    first = qMax<qint64>(0, first);
+    last = qMin(last, m_count);
+    if (last <= first) {
+        return;
+    }
+
+    out.reserve(static_cast<int>(last - first));
+    for (qint64 i = first; i < last; ++i) {
+        out.append(toMeasurement(m_records[i], m_header.epochWallMs));
+    }
+}
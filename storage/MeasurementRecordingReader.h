@@ -0,0 +1,102 @@
+#ifndef MEASUREMENTRECORDINGREADER_H
+#define MEASUREMENTRECORDINGREADER_H
+
+#include <QFile>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "storage/MeasurementRecord.h"
+
+/**
+ * @brief 测量记录文件读取器（内存映射）
+ *
+ * 职责：
+ * - 映射整个记录文件，按序号直接访问记录，不逐条读取
+ * - 按单调时间戳二分查找，支持时间区间查询
+ * - 区间统计（最小/最大/平均），以及批量转换为 Measurement 供图表回放
+ */
+class MeasurementRecordingReader
+{
+public:
+    /**
+     * @brief 区间统计结果
+     */
+    struct RangeStats {
+        qint64 count;       ///< 样本数
+        double minValue;    ///< 最小值（mA）
+        double maxValue;    ///< 最大值（mA）
+        double mean;        ///< 平均值（mA）
+    };
+
+    MeasurementRecordingReader();
+    ~MeasurementRecordingReader();
+
+    /**
+     * @brief 打开并映射记录文件
+     * @param filePath 文件路径
+     * @param errorString 失败原因（可选）
+     * @return true 成功
+     */
+    bool open(const QString &filePath, QString *errorString = nullptr);
+
+    /**
+     * @brief 关闭文件并解除映射
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * @brief 记录数（末尾不完整的记录不计入）
+     */
+    qint64 count() const { return m_count; }
+
+    /**
+     * @brief 读取记录（调用方保证 0 <= index < count()）
+     */
+    const MeasurementRecordFormat::Record &record(qint64 index) const { return m_records[index]; }
+
+    /**
+     * @brief 文件头
+     */
+    const MeasurementRecordFormat::FileHeader &header() const { return m_header; }
+
+    /**
+     * @brief 记录时的串口名称
+     */
+    QString portName() const;
+
+    /**
+     * @brief 第一条时间戳不小于 monotonicNs 的记录序号（不存在时返回 count()）
+     */
+    qint64 lowerBound(qint64 monotonicNs) const;
+
+    /**
+     * @brief 时间区间 [fromNs, toNs) 内的记录序号区间 [first, last)
+     */
+    QPair<qint64, qint64> timeRange(qint64 fromNs, qint64 toNs) const;
+
+    /**
+     * @brief 序号区间 [first, last) 的统计
+     */
+    RangeStats stats(qint64 first, qint64 last) const;
+
+    /**
+     * @brief 序号区间 [first, last) 转换为测量值
+     * @param first 起始序号（含）
+     * @param last 结束序号（不含）
+     * @param[out] out 输出测量值（复用调用方的缓冲）
+     */
+    void readMeasurements(qint64 first, qint64 last, QVector<Measurement> &out) const;
+
+private:
+    QFile m_file;                                       ///< 记录文件
+    MeasurementRecordFormat::FileHeader m_header;       ///< 文件头
+    const MeasurementRecordFormat::Record *m_records;   ///< 映射的记录区
+    qint64 m_count;                                     ///< 记录数
+};
+
+#endif // MEASUREMENTRECORDINGREADER_H
@@ -15,40 +15,48 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+include(core.pri)
+
 SOURCES += \
     main.cpp \
     user.cpp \
     widget.cpp \
     SerialPortManager.cpp \
-    SerialPortService.cpp \
-    DeviceController.cpp \
+    SerialHotplugWatcher.cpp \
     InteractiveChartView.cpp \
     MeasurementChartWidget.cpp \
     TaskListWidget.cpp \
     OtaController.cpp \
+    OtaFrameCache.cpp \
+    OtaBatchManager.cpp \
     ErrorRecordDialog.cpp \
-    app/TestSequenceRunner.cpp
+    ErrorHistoryDialog.cpp \
+    LatencyDiagnosticsDialog.cpp \
+    YieldDashboardDialog.cpp \
+    StationWidget.cpp \
+    log/LogModel.cpp \
+    log/LogView.cpp
 
 HEADERS += \
     user.h \
     widget.h \
     SerialPortManager.h \
-    DeviceProtocol.h \
-    SerialPortService.h \
-    DeviceController.h \
-    domain/Command.h \
-    domain/Measurement.h \
-    domain/StepSpec.h \
-    domain/ErrorRecord.h \
-    protocol/ProtocolParser.h \
+    SerialHotplugWatcher.h \
     InteractiveChartView.h \
     MeasurementChartWidget.h \
     TaskListWidget.h \
     OtaProtocol.h \
     OtaController.h \
+    OtaFrameCache.h \
+    OtaFirmwareImage.h \
+    OtaBatchManager.h \
     ErrorRecordDialog.h \
-    app/TestSequenceRunner.h \
-    app/TestStepFactory.h
+    ErrorHistoryDialog.h \
+    LatencyDiagnosticsDialog.h \
+    YieldDashboardDialog.h \
+    StationWidget.h \
+    log/LogModel.h \
+    log/LogView.h
 
 FORMS += \
     user.ui \
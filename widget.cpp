@@ -7,31 +7,44 @@
 #include "MeasurementChartWidget.h"
 #include "TaskListWidget.h"
 #include "OtaController.h"
+#include "storage/MeasurementRecorder.h"
+#include "log/LogFileSink.h"
+#include "storage/ErrorRecordStore.h"
+#include "app/YieldAggregator.h"
+#include "log/LogView.h"
+#include "SimulatedDeviceTransport.h"
 #include <QDoubleValidator>
-#include <QScrollBar>
-#include <QTime>
 #include <QButtonGroup>
 #include <QRadioButton>
 #include <QAbstractButton>
 #include <QEvent>
 #include <QFocusEvent>
 #include <QCloseEvent>
+#include <QShowEvent>
+#include <QTimer>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QVBoxLayout>
 #include <QDateTime>
 #include <QPushButton>
 #include <QApplication>
+#include <QRegularExpression>
+#include <QStringList>
 
 #include <QDebug>
 
 Widget::Widget(QWidget *parent)
     : QWidget(parent),
       ui(new Ui::Widget),
+      m_logFileSink(new LogFileSink(LogFileSink::defaultFilePath(),
+                                    LogFileSink::kDefaultMaxFileBytes,
+                                    LogFileSink::kDefaultMaxBackupFiles, this)),
+      m_errorRecordStore(new ErrorRecordStore(ErrorRecordStore::defaultFilePath(), this)),
+      m_yieldAggregator(new YieldAggregator(this)),
       m_serialPortManager(new SerialPortManager(this)),
       m_serialPortService(new SerialPortService(this)),
       m_deviceController(new DeviceController(m_serialPortService.data(), this)),
-      m_otaController(new OtaController(this)),
+      m_measurementRecorder(new MeasurementRecorder(this)),
       m_isInitialized(false),
       m_v1ButtonGroup(new QButtonGroup(this)),
       m_v1ChannelGroup(new QButtonGroup(this)),
@@ -49,15 +62,8 @@ Widget::Widget(QWidget *parent)
     initConnections();
     m_isInitialized = true;
 
-    // 初始化测量数据图表组件
-    m_chartWidget = new MeasurementChartWidget(ui->widget_chart);
-    QVBoxLayout *chartLayout = new QVBoxLayout(ui->widget_chart);
-    chartLayout->setContentsMargins(0, 0, 0, 0);
-    chartLayout->addWidget(m_chartWidget);
-    
-    // 连接图表组件的日志信号（可选）
-    connect(m_chartWidget, &MeasurementChartWidget::logMessage,
-            this, &Widget::appendTextWithAutoScroll);
+    // 测量图表、OTA 控制器和任务列表窗口均在首次使用时创建：
+    // 启动时主界面是隐藏的，先显示的是任务列表窗口，图表的历史缓冲和 QtCharts 场景无需提前构造
 }
 
 Widget::~Widget()
@@ -71,6 +77,26 @@ DeviceController* Widget::deviceController() const
     return m_deviceController.data();
 }
 
+MeasurementRecorder* Widget::measurementRecorder() const
+{
+    return m_measurementRecorder.data();
+}
+
+LogFileSink* Widget::logFileSink() const
+{
+    return m_logFileSink.data();
+}
+
+ErrorRecordStore* Widget::errorRecordStore() const
+{
+    return m_errorRecordStore.data();
+}
+
+YieldAggregator* Widget::yieldAggregator() const
+{
+    return m_yieldAggregator.data();
+}
+
 /// @brief
 /// @param watched
 /// @param event
@@ -103,8 +129,13 @@ void Widget::initializeComponents()
     // 禁用串口选择框，等待串口检测完成
     setPortComboBoxEnabled(false);
 
-    // 设置textEdit为只读模式，允许选择和复制但禁止编辑
-    ui->textEdit_receive->setReadOnly(true);
+    // 日志视图：合并刷新、定长缓冲，同时写入日志文件
+    ui->logView_receive->setTimestampFormat("(hh:mm)");
+    ui->logView_receive->setFileSink(m_logFileSink.data(), tr("主界面"));
+    connect(m_logFileSink.data(), &LogFileSink::errorOccurred,
+            this, &Widget::appendTextWithAutoScroll);
+    connect(m_errorRecordStore.data(), &ErrorRecordStore::errorOccurred,
+            this, &Widget::appendTextWithAutoScroll);
 
     // 初始化清空日志按钮（位于日志显示框右上角）
     m_clearLogButton = new QPushButton(tr("清空"), ui->groupBox_receive);
@@ -302,21 +333,47 @@ void Widget::initConnections()
     connect(ui->pushButton_update, &QPushButton::clicked,
             this, &Widget::onUpdateClicked);
 
-    // OTA 控制器信号连接
-    connect(m_otaController.data(), &OtaController::progressChanged,
-            this, &Widget::onOtaProgressChanged);
-    connect(m_otaController.data(), &OtaController::upgradeFinished,
-            this, &Widget::onOtaUpgradeFinished);
-    connect(m_otaController.data(), &OtaController::logMessage,
-            this, &Widget::appendTextWithAutoScroll);
+    // OTA 控制器在首次升级时创建，信号连接见 otaController()
 
     // 在所有信号连接完成后，启动串口管理器监控
     // 这样可以确保首次端口检测的结果能被 onSerialPortsChanged 槽函数接收到
     // 解决了"下位机先连接、上位机后启动时无法识别串口"的问题
-    // 默认检测间隔为2000ms，占位参数
+    // 优先使用系统热插拔通知，不可用时按默认2000ms间隔轮询
     m_serialPortManager->startMonitoring();
 }
 
+OtaController* Widget::otaController()
+{
+    if (!m_otaController)
+    {
+        m_otaController.reset(new OtaController(this));
+        connect(m_otaController.data(), &OtaController::progressChanged,
+                this, &Widget::onOtaProgressChanged);
+        connect(m_otaController.data(), &OtaController::upgradeFinished,
+                this, &Widget::onOtaUpgradeFinished);
+        connect(m_otaController.data(), &OtaController::logMessage,
+                this, &Widget::appendTextWithAutoScroll);
+    }
+    return m_otaController.data();
+}
+
+void Widget::ensureChartWidget()
+{
+    if (m_chartWidget)
+    {
+        return;
+    }
+
+    m_chartWidget = new MeasurementChartWidget(ui->widget_chart);
+    QVBoxLayout *chartLayout = new QVBoxLayout(ui->widget_chart);
+    chartLayout->setContentsMargins(0, 0, 0, 0);
+    chartLayout->addWidget(m_chartWidget);
+
+    // 连接图表组件的日志信号（可选）
+    connect(m_chartWidget, &MeasurementChartWidget::logMessage,
+            this, &Widget::appendTextWithAutoScroll);
+}
+
 void Widget::initDeviceController()
 {
     // 连接设备控制器信号
@@ -324,6 +381,8 @@ void Widget::initDeviceController()
     // 显示日志信息，信号参数为日志信息
     connect(m_deviceController.data(), &DeviceController::logMessage,
             this, &Widget::onDeviceLogMessage);
+    connect(m_measurementRecorder.data(), &MeasurementRecorder::logMessage,
+            this, &Widget::onDeviceLogMessage);
 
     // 串口连接状态改变信号，信号参数为连接状态和串口名称
     // 当串口连接状态改变时——连上串口还是断开串口
@@ -336,8 +395,8 @@ void Widget::initDeviceController()
             this, &Widget::onDeviceCommandConfirmed);
 
     // 外部电流表测量数据接收信号（来自RS485电流表，经MCU转发）
-    connect(m_deviceController.data(), &DeviceController::externalMeasurementReceived,
-            this, &Widget::onExternalMeasurementReceived);
+    connect(m_deviceController.data(), &DeviceController::externalMeasurementsReceived,
+            this, &Widget::onExternalMeasurementsReceived);
 }
 
 
@@ -409,6 +468,9 @@ void Widget::onOpenSerialPortClicked()
     {
         m_deviceController->disconnectDevice();
         ui->pushButton_openSerial->setText(tr("打开串口"));
+
+        // 结束本次测量记录
+        m_measurementRecorder->stop();
         return;
     }
 
@@ -857,7 +919,7 @@ void Widget::onSw6Clicked()
 void Widget::onUpdateClicked()
 {
     // 检查是否正在升级
-    if (m_otaController->isUpgrading())
+    if (m_otaController && m_otaController->isUpgrading())
     {
         QMessageBox::warning(this, tr("提示"), tr("升级正在进行中，请等待完成"));
         return;
@@ -946,7 +1008,7 @@ void Widget::startOtaProcess(const QString &portName, const QString &filePath)
     appendTextWithAutoScroll(tr("固件文件: %1").arg(filePath));
 
     // 启动 OTA 控制器（它会以 9600bps 打开串口）
-    if (!m_otaController->startUpgrade(portName, filePath))
+    if (!otaController()->startUpgrade(portName, filePath))
     {
         // 启动失败
         ui->pushButton_update->setEnabled(true);
@@ -996,10 +1058,19 @@ void Widget::setPortComboBoxEnabled(bool enabled)
     ui->comboBox_serialList->setEnabled(enabled);
 }
 
-void Widget::updatePortComboBox(const QStringList &ports, bool keepSelection)
+void Widget::updatePortComboBox(const QStringList &availablePorts, bool keepSelection)
 {
     QString currentSelection;
 
+    // 设置了环境变量 PCBA_SIMULATOR 时追加模拟设备，变量值为模拟参数（如 rate=2000,chunk=1）
+    QStringList ports = availablePorts;
+    if (qEnvironmentVariableIsSet("PCBA_SIMULATOR"))
+    {
+        QString options = qEnvironmentVariable("PCBA_SIMULATOR");
+        QString simulatedPort = QLatin1String(SimulatedDeviceTransport::kPortPrefix);
+        ports << (options.isEmpty() ? simulatedPort : simulatedPort + ":" + options);
+    }
+
     // 保持当前选中的串口
     if (keepSelection)
     {
@@ -1045,12 +1116,17 @@ void Widget::onDeviceLogMessage(const QString &message)
 
 void Widget::onDeviceConnectionChanged(bool isConnected, const QString &portName)
 {
-    Q_UNUSED(portName);
-    
     if (isConnected)
     {
         ui->pushButton_openSerial->setText(tr("关闭串口"));
 
+        // 连接期间的全部测量样本写入记录文件
+        QString recordPath = QString("%1/%2_%3.pcbarec")
+                             .arg(MeasurementRecorder::defaultDirectory(),
+                                  QString(portName).replace(QRegularExpression("[^A-Za-z0-9_.-]"), "_"),
+                                  QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+        m_measurementRecorder->start(recordPath, portName);
+
         // 启用继电器按钮
         ui->pushButton_power_confirm->setEnabled(true);
         ui->pushButton_right->setEnabled(true);
@@ -1078,22 +1154,50 @@ void Widget::onDeviceConnectionChanged(bool isConnected, const QString &portName
     }
 }
 
-void Widget::onExternalMeasurementReceived(float valueMa)
+void Widget::onExternalMeasurementsReceived(const QVector<Measurement> &measurements)
 {
-    // 更新lineEdit_detection显示外部电流表的测量值
-    QString displayText = QString("%1 mA").arg(valueMa, 0, 'f', 5);
+    if (measurements.isEmpty())
+        return;
+
+    // 更新lineEdit_detection显示外部电流表的测量值（每批只刷新一次，显示最新值）
+    QString displayText;
+    if (measurements.last().channel == Measurement::Channel::Unknown)
+    {
+        displayText = QString("%1 mA").arg(measurements.last().rawValue, 0, 'f', 5);
+    }
+    else
+    {
+        // 多通道扫描：显示本批中各通道的最新值
+        double latest[MultiChannelHistory::kChannelCount];
+        bool seen[MultiChannelHistory::kChannelCount] = {};
+        for (const Measurement &measurement : measurements)
+        {
+            const int slot = MultiChannelHistory::slotOf(measurement.channel);
+            if (slot >= 0)
+            {
+                latest[slot] = measurement.rawValue;
+                seen[slot] = true;
+            }
+        }
+        QStringList parts;
+        for (int slot = 0; slot < MultiChannelHistory::kChannelCount; ++slot)
+        {
+            if (seen[slot])
+            {
+                parts << QString("CH%1 %2").arg(slot + 1).arg(latest[slot], 0, 'f', 5);
+            }
+        }
+        displayText = parts.join(QStringLiteral(" | ")) + QStringLiteral(" mA");
+    }
     ui->lineEdit_detection->setText(displayText);
 
-    // 将测量数据添加到图表
+    // 写入测量记录
+    m_measurementRecorder->append(measurements);
+
+    // 将整批测量数据添加到图表
     if (m_chartWidget)
     {
-        Measurement measurement;
-        measurement.rawValue = valueMa;
-        measurement.range = Measurement::Range::MilliAmp;  // 默认mA档
-        measurement.channel = Measurement::Channel::Unknown;
-        measurement.timestamp = QDateTime::currentDateTime();
-        
-        m_chartWidget->appendMeasurement(measurement);
+        m_chartWidget->appendMeasurements(measurements);
     }
 
     // 同时输出到日志（可选，DeviceController已经记录）
@@ -1102,26 +1206,8 @@ void Widget::onExternalMeasurementReceived(float valueMa)
 
 void Widget::appendTextWithAutoScroll(const QString &text)
 {
-    // 获取滚动条
-    QScrollBar *scrollBar = ui->textEdit_receive->verticalScrollBar();
-
-    // 检查是否接近底部（允许一定的容差，比如10像素）
-    bool wasAtBottom = (scrollBar->value() >= scrollBar->maximum() - 10);
-
-    // 获取当前时间并格式化为 (HH:mm) 格式
-    QString currentTime = QTime::currentTime().toString("(hh:mm)");
-
-    // 为文本添加时间戳前缀
-    QString textWithTimestamp = currentTime + " " + text;
-
-    // 追加带时间戳的文本
-    ui->textEdit_receive->append(textWithTimestamp);
-
-    // 如果之前接近底部，自动滚动到新的底部
-    if (wasAtBottom)
-    {
-        scrollBar->setValue(scrollBar->maximum());
-    }
+    // 时间戳、合并刷新和自动滚动由日志视图处理
+    ui->logView_receive->appendMessage(text);
 }
 
 void Widget::onDeviceCommandConfirmed(Command command, bool success, const QByteArray &sentData, const QByteArray &responseData)
@@ -1461,13 +1547,18 @@ void Widget::onAutoTestClicked()
     showTaskList();
 }
 
-void Widget::showTaskList()
+void Widget::ensureTaskListWidget()
 {
     // 如果任务列表窗口尚未创建，则创建它（传入设备控制器和主界面指针）
     if (!m_taskListWidget)
     {
         m_taskListWidget.reset(new TaskListWidget(m_deviceController.data(), this));
     }
+}
+
+void Widget::showTaskList()
+{
+    ensureTaskListWidget();
 
     // 显示任务列表窗口
     m_taskListWidget->show();
@@ -1487,13 +1578,21 @@ void Widget::closeEvent(QCloseEvent *event)
     showTaskList();
 }
 
-void Widget::onExportTaskClicked()
+void Widget::showEvent(QShowEvent *event)
 {
-    // 确保 TaskListWidget 已创建（但不显示窗口）
-    if (!m_taskListWidget)
+    QWidget::showEvent(event);
+
+    // 先完成本次显示，再在下一轮事件循环中创建图表
+    if (!m_chartWidget)
     {
-        m_taskListWidget.reset(new TaskListWidget(m_deviceController.data(), this));
+        QTimer::singleShot(0, this, &Widget::ensureChartWidget);
     }
+}
+
+void Widget::onExportTaskClicked()
+{
+    // 确保 TaskListWidget 已创建（但不显示窗口）
+    ensureTaskListWidget();
 
     // 调用 TaskListWidget 的导出方法
     m_taskListWidget->exportConfiguration();
@@ -1502,10 +1601,7 @@ void Widget::onExportTaskClicked()
 void Widget::onImportTaskClicked()
 {
     // 确保 TaskListWidget 已创建（但不显示窗口）
-    if (!m_taskListWidget)
-    {
-        m_taskListWidget.reset(new TaskListWidget(m_deviceController.data(), this));
-    }
+    ensureTaskListWidget();
 
     // 调用 TaskListWidget 的导入方法
     m_taskListWidget->importConfiguration();
@@ -1688,6 +1784,6 @@ void Widget::setControlsEnabled(bool enabled)
 // 处理清空日志按钮点击
 void Widget::onClearLogClicked()
 {
-    // 清空日志显示框中的所有内容
-    ui->textEdit_receive->clear();
+    // 清空日志显示框中的所有内容（日志文件保留）
+    ui->logView_receive->clear();
 }
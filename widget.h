@@ -17,6 +17,10 @@ class SerialPortManager;
 class SerialPortService;
 class DeviceController;
 class OtaController;
+class MeasurementRecorder;
+class LogFileSink;
+class ErrorRecordStore;
+class YieldAggregator;
 class QButtonGroup;
 class TaskListWidget;
 class MeasurementChartWidget;
@@ -51,6 +55,30 @@ public:
      */
     DeviceController* deviceController() const;
 
+    /**
+     * @brief 获取测量数据记录器指针
+     * @return MeasurementRecorder 指针（串口连接期间持续记录）
+     */
+    MeasurementRecorder* measurementRecorder() const;
+
+    /**
+     * @brief 获取日志文件输出服务（各界面的日志视图共用）
+     * @return LogFileSink指针
+     */
+    LogFileSink* logFileSink() const;
+
+    /**
+     * @brief 获取错误记录库（单工位和多工位的执行引擎共用）
+     * @return ErrorRecordStore指针
+     */
+    ErrorRecordStore* errorRecordStore() const;
+
+    /**
+     * @brief 获取良率统计（单工位和多工位的执行引擎共用）
+     * @return YieldAggregator指针
+     */
+    YieldAggregator* yieldAggregator() const;
+
     /**
      * @brief 显示任务列表窗口（自动测试界面）
      * @details 创建或显示 TaskListWidget，并隐藏主界面
@@ -72,6 +100,12 @@ protected:
      */
     void closeEvent(QCloseEvent *event) override;
 
+    /**
+     * @brief 重写显示事件，首次显示后再创建测量图表
+     * @param event 显示事件对象
+     */
+    void showEvent(QShowEvent *event) override;
+
 public slots:
     /**
      * @brief 设置选定的串口名称
@@ -204,10 +238,10 @@ private slots:
     void onDeviceCommandConfirmed(Command command, bool success, const QByteArray &sentData, const QByteArray &responseData);
     
     /**
-     * @brief 处理外部电流表测量值接收
-     * @param valueMa 电流值（mA）
+     * @brief 处理外部电流表测量值批量接收
+     * @param measurements 一次串口读取解码出的全部测量值（mA）
      */
-    void onExternalMeasurementReceived(float valueMa);
+    void onExternalMeasurementsReceived(const QVector<Measurement> &measurements);
 
 private:
     /**
@@ -232,6 +266,23 @@ private:
      */
     void initDeviceController();
 
+    /**
+     * @brief 获取 OTA 升级控制器，首次使用时创建并连接信号
+     * @return OtaController 指针
+     */
+    OtaController* otaController();
+
+    /**
+     * @brief 确保任务列表窗口已创建（首次使用时创建，不显示）
+     */
+    void ensureTaskListWidget();
+
+    /**
+     * @brief 确保测量图表已创建（主界面首次显示时创建）
+     * @details 创建之前收到的测量数据不绘制，可通过图表的回放功能从测量记录中查看
+     */
+    void ensureChartWidget();
+
     /**
      * @brief 获取当前选中的串口名称
      * @return 串口名称，如果没有选中返回空字符串
@@ -252,9 +303,9 @@ private:
     void updatePortComboBox(const QStringList &ports, bool keepSelection = true);
 
     /**
-     * @brief 智能追加文本到textEdit并自动滚动
+     * @brief 追加日志到日志视图
      * @param text 要追加的文本
-     * @details 只有当用户接近textEdit底部时才自动滚动，否则保持当前位置
+     * @details 日志合并后按帧刷新；只有当视图停在底部时才自动滚动，否则保持当前位置
      */
     void appendTextWithAutoScroll(const QString &text);
 
@@ -326,11 +377,15 @@ private:
 private:
     // 成员变量
     QScopedPointer<Ui::Widget> ui;                          ///< UI指针，使用智能指针托管
+    QScopedPointer<LogFileSink> m_logFileSink;              ///< 日志文件输出（后台线程写入）
+    QScopedPointer<ErrorRecordStore> m_errorRecordStore;    ///< 错误记录库（后台线程写入）
+    QScopedPointer<YieldAggregator> m_yieldAggregator;      ///< 跨运行的良率与电流分布统计
     QScopedPointer<SerialPortManager> m_serialPortManager;  ///< 串口管理器
     QScopedPointer<SerialPortService> m_serialPortService;  ///< 串口服务
     QScopedPointer<DeviceController> m_deviceController;    ///< 设备控制器
-    QScopedPointer<OtaController> m_otaController;          ///< OTA 升级控制器
-    QScopedPointer<TaskListWidget> m_taskListWidget;        ///< 任务列表窗口
+    QScopedPointer<OtaController> m_otaController;          ///< OTA 升级控制器（首次升级时创建）
+    QScopedPointer<MeasurementRecorder> m_measurementRecorder; ///< 测量数据记录器
+    QScopedPointer<TaskListWidget> m_taskListWidget;        ///< 任务列表窗口（首次使用时创建）
     bool m_isInitialized;                                   ///< 初始化完成标志
     
     // 单选按钮组
@@ -351,7 +406,7 @@ private:
     uint8_t m_currentChannelCode;                           ///< 当前开启的通道码
 
     // 图表组件
-    MeasurementChartWidget *m_chartWidget = nullptr;        ///< 测量数据图表组件
+    MeasurementChartWidget *m_chartWidget = nullptr;        ///< 测量数据图表组件（主界面首次显示时创建）
     
     // 日志清空按钮
     QPushButton *m_clearLogButton = nullptr;                ///< 清空日志按钮